@@ -4,7 +4,7 @@
  * SAGE (Simple Amiga Game Engine) project
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_H_
@@ -27,7 +27,9 @@
 #include <sage/sage_picture.h>
 #include <sage/sage_draw.h>
 #include <sage/sage_layer.h>
+#include <sage/sage_parallax.h>
 #include <sage/sage_sprite.h>
+#include <sage/sage_collision.h>
 #include <sage/sage_tile.h>
 #include <sage/sage_video.h>
 #include <sage/sage_audio.h>
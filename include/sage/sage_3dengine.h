@@ -5,7 +5,7 @@
  * 3D engine functions
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 22/06/2025)
  */
 
 #ifndef _SAGE_3DENGINE_H_
@@ -20,6 +20,7 @@
 #include <sage/sage_3dmaterial.h>
 #include <sage/sage_3dskybox.h>
 #include <sage/sage_3dterrain.h>
+#include <sage/sage_3dtree.h>
 
 #define S3DE_ONEDEGREE        SMTH_PRECISION        // One degree unity
 #define S3DE_HAFLDEGREE       SMTH_PRECISION/2      // Half degree unity
@@ -44,9 +45,14 @@
 #define S3DE_LOD_MEDIUM       2                     // Average LOD reduction
 #define S3DE_LOD_LOW          3                     // Huge LOD reduction
 
-#define S3DE_LOD_L1           200.0                 // Distance of level 1 reduction
-#define S3DE_LOD_L2           300.0                 // Distance of level 2 reduction
-#define S3DE_LOD_L3           400.0                 // Distance of level 3 reduction
+#define S3DE_SORT_SKYBOX      0                     // Sort history of the skybox queue
+#define S3DE_SORT_WORLD       1                     // Sort history of the world queue
+
+#define S3DE_KEY_ENTITY       0x40000000            // Element keys of the entities faces
+#define S3DE_KEY_ZONE         0x80000000            // Element keys of the terrain zones faces
+#define S3DE_KEY_SKYBOX       0xC0000000            // Element keys of the skybox faces
+#define S3DE_KEY_OWNER        18                    // Shift of the entity, zone or skybox plane index
+#define S3DE_KEY_FACE         2                     // Shift of the face index, a face gives up to 4 elements
 
 #if _SAGE_DEBUG_MODE_ == 1
 #define SED(x) if (engine_debug) { x }
@@ -62,6 +68,10 @@ typedef struct {
   ULONG calculated_vertices, rendered_vertices, total_vertices;   // World vertices
   ULONG rendered_faces, total_faces;          // World faces
   ULONG rendered_elements;                    // Rendered elements
+  ULONG moved_elements;                       // Elements moved by the sort
+  ULONG tested_nodes;                         // Bounding tree nodes tested by the culling
+  ULONG rejected_triangles, rejected_tiles;   // Triangles and tiles rejected by the Hi-Z buffer
+  ULONG cleared_tiles;                        // Z buffer tiles cleared by the lazy clear
 } SAGE_EngineMetrics;
 
 /** World structure */
@@ -76,7 +86,11 @@ typedef struct {
   SAGE_Terrain terrain;
   UWORD nb_entities;
   SAGE_Entity *entities[S3DE_MAX_ENTITIES];
+  BOOL use_trees;
+  SAGE_BoundingTree entity_tree;
   SAGE_TransformedVertex *transformed_vertices;
+  BOOL use_streams;
+  SAGE_VertexStreams vertex_streams;
   SAGE_EngineMetrics metrics;
 } SAGE_3DWorld;
 
@@ -89,6 +103,12 @@ VOID SAGE_Release3DEngine(VOID);
 /** Render the 3D world */
 VOID SAGE_RenderWorld(VOID);
 
+/** Enable/Disable the vertex streams pipeline for entities */
+BOOL SAGE_EnableVertexStreams(BOOL);
+
+/** Enable/Disable the bounding trees culling */
+BOOL SAGE_EnableBoundingTrees(BOOL);
+
 /** Get the engine metrics */
 SAGE_EngineMetrics *SAGE_GetEngineMetrics(VOID);
 
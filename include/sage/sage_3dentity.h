@@ -5,7 +5,7 @@
  * 3D entity management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_3DENTITY_H_
@@ -21,6 +21,7 @@
 #define S3DE_UNDEFINED        0                     // Undefined file type
 #define S3DE_LWOB             1                     // Lightwave object file
 #define S3DE_WFOB             2                     // Wavefront object file
+#define S3DE_SENT             3                     // SAGE binary entity file
 
 #define S3DE_TEXT_NOCALC      0                     // Do not recalcul entity texture coordinates
 #define S3DE_TEXT_RECALC      1                     // Recalcul entity texture coordinates (0.0 -> 1.0)
@@ -60,6 +61,9 @@ VOID SAGE_SetEntityRadius(SAGE_Entity *);
 /** Calculate entity faces normal */
 VOID SAGE_SetEntityNormals(SAGE_Entity *);
 
+/** Refit the entities tree for the changed entities */
+VOID SAGE_RefreshEntityTree(VOID);
+
 /** Add an entity to the world */
 BOOL SAGE_AddEntity(UWORD, SAGE_Entity *);
 
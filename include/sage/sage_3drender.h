@@ -5,7 +5,7 @@
  * 3D rendering management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 10/03/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_3DRENDER_H_
@@ -20,6 +20,11 @@
 #define S3DR_GOURAUD          4
 #define S3DR_BILINEAR         8
 #define S3DR_FOGGING          16
+#define S3DR_RADIXSORT        32
+#define S3DR_COHERENTSORT     64
+#define S3DR_HIZBUFFER        128
+#define S3DR_LAZYZBUFFER      256
+#define S3DR_REFMAPPER        512
 
 #define S3DR_RENDER_WIRE      0                     // Wireframe rendering
 #define S3DR_RENDER_FLAT      1                     // Flat rendering
@@ -31,6 +36,22 @@
 #define S3DR_ELEM_QUAD        3                     // Quad element
 
 #define S3DR_MAX_ELEMENTS     8192                  // Maximum number of elements to render
+#define S3DR_MIN_ELEMENTS     256                   // First size of the rendering queue, doubled when full
+#define S3DR_QUEUE_BYTES      (sizeof(SAGE_SortedElement)*2+sizeof(SAGE_3DElement)+sizeof(ULONG)*(3+S3DR_SORT_HISTORIES)+sizeof(UWORD)*2) // Queue bytes by element
+#define S3DR_WIRE_BATCH       64                    // Lines drawn by each wireframe batch
+
+#define S3DR_RADIX_BITS       8                     // Bits of depth key sorted by each radix pass
+#define S3DR_RADIX_BUCKETS    (1L<<S3DR_RADIX_BITS) // Buckets by radix pass
+#define S3DR_RADIX_PASSES     4                     // Radix passes for a 32 bits depth key
+
+#define S3DR_SORT_HISTORIES   2                     // Number of element orders kept from previous frame
+#define S3DR_COHERENT_SHIFTS  8                     // Average shifts by element before giving up the insertion pass
+#define S3DR_KEY_HASH         0x9E3779B1            // Multiplier of the element key hash
+#define S3DR_KEY_MATCHED      0x8000                // Key table entry found in the previous frame order
+
+#define S3DR_HIZ_SHIFT        3                     // Hi-Z tiles are 8x8 pixels
+#define S3DR_HIZ_SIZE         (1L<<S3DR_HIZ_SHIFT)  // Hi-Z tile size in pixels
+#define S3DR_HIZ_FAR          0xFFFF                // Depth of a cleared Z buffer
 
 typedef struct {
   FLOAT x1, y1, z1, u1, v1;
@@ -49,25 +70,81 @@ typedef struct {
 typedef struct {
   UWORD width, height, bpr, bpp;
   APTR buffer;
+  UWORD tiles_width, tiles_height;  // Hi-Z tiles by row and by column
+  UWORD *tiles;                     // Max depth of each tile
+  UBYTE *epochs;                    // Frame epoch of each tile (lazy clear)
+  UBYTE epoch;                      // Current frame epoch
+  ULONG rejected_triangles;         // Triangles rejected by the Hi-Z test
+  ULONG rejected_tiles;             // Tiles of span bands rejected by the Hi-Z test
+  ULONG cleared_tiles;              // Tiles cleared by the lazy clear
 } SAGE_ZBuffer;
 
 typedef struct {
   LONGBITS options;
   UWORD render_elements, render_mode;
-  SAGE_3DElement s3d_elements[S3DR_MAX_ELEMENTS];
-  SAGE_SortedElement ordered_elements[S3DR_MAX_ELEMENTS];
+  UWORD max_elements;               // Size of the rendering queue
+  SAGE_3DElement *s3d_elements;
+  SAGE_SortedElement *ordered_elements;
+  SAGE_SortedElement *sort_buffer;
+  ULONG *sort_keys[2];
+  ULONG sort_counts[S3DR_RADIX_PASSES][S3DR_RADIX_BUCKETS];
+  ULONG element_key;                // Key of the next pushed element
+  ULONG *element_keys;              // Key of each queued element, the identity used by coherent sort
+  UWORD *key_table;                 // Queued elements hashed by key (slot + 1, 0 is free)
+  UWORD sort_history, history_size[S3DR_SORT_HISTORIES];
+  ULONG *history_keys[S3DR_SORT_HISTORIES];  // Keys of the previous orders, in the queue bloc
+  ULONG moved_elements;
   SAGE_ZBuffer zbuffer;
 } SAGE_Render;
 
 /** Initialize the 3D renderer */
 BOOL SAGE_Init3DRender(VOID);
 
+/** Release the 3D renderer queue */
+VOID SAGE_Release3DRender(VOID);
+
 /** Enable/disable Z buffer */
 BOOL SAGE_EnableZBuffer(BOOL);
 
+/** Enable/disable Hi-Z buffer */
+BOOL SAGE_EnableHiZBuffer(BOOL);
+
+/** Enable/disable lazy Z buffer clear */
+BOOL SAGE_EnableLazyZBuffer(BOOL);
+
+/** Enable/disable perspective correction */
+BOOL SAGE_EnablePerspective(BOOL);
+
+/** Enable/disable the C reference mappers */
+BOOL SAGE_EnableReferenceMappers(BOOL);
+
 /** Enable/disable filtering */
 BOOL SAGE_EnableFiltering(BOOL);
 
+/** Enable/disable radix sort of the elements */
+BOOL SAGE_EnableRadixSort(BOOL);
+
+/** Enable/disable coherent sort of the elements */
+BOOL SAGE_EnableCoherentSort(BOOL);
+
+/** Select the element order history used by coherent sort */
+BOOL SAGE_Set3DSortHistory(UWORD);
+
+/** Set the key of the next element pushed in the rendering queue */
+BOOL SAGE_Set3DElementKey(ULONG);
+
+/** Get the number of elements moved by the last sort */
+ULONG SAGE_GetMoved3DElements(VOID);
+
+/** Get the number of triangles rejected by the Hi-Z buffer */
+ULONG SAGE_GetRejected3DTriangles(VOID);
+
+/** Get the number of tiles rejected by the Hi-Z buffer */
+ULONG SAGE_GetRejected3DTiles(VOID);
+
+/** Get the number of tiles cleared by the lazy Z buffer clear */
+ULONG SAGE_GetCleared3DTiles(VOID);
+
 /** Tell if a render option is active */
 BOOL SAGE_Get3DRenderOption(LONGBITS);
 
@@ -86,6 +163,9 @@ BOOL SAGE_ClearZBuffer(VOID);
 /** Add an element to the rendering queue */
 BOOL SAGE_Push3DElement(SAGE_3DElement *);
 
+/** Remove all elements from the rendering queue */
+BOOL SAGE_Flush3DElements(VOID);
+
 /** Sort the elements in the rendering queue */
 BOOL SAGE_Sort3DElements(BOOL);
 
@@ -0,0 +1,53 @@
+/**
+ * sage_3dsort.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * 3D rendering queue sort functions
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_3DSORT_H_
+#define _SAGE_3DSORT_H_
+
+#include <exec/types.h>
+
+#include <sage/sage_3drender.h>
+
+#define S3DR_DEPTH_KEY        0xFFFFFFFF            // Bits of the depth key
+
+/** Forget the element orders of previous frames */
+VOID SAGE_ClearSortHistory(SAGE_Render *);
+
+/** Ascending quick sort of the elements */
+VOID SAGE_AscQuicksortElements(SAGE_SortedElement *, LONG, LONG);
+
+/** Descending quick sort of the elements */
+VOID SAGE_DescQuicksortElements(SAGE_SortedElement *, LONG, LONG);
+
+/** Build an unsigned key from the element depth */
+ULONG SAGE_ElementDepthKey(DOUBLE);
+
+/** Radix sort of the rendering queue */
+VOID SAGE_RadixSortElements(SAGE_Render *, BOOL);
+
+/** Sort the rendering queue with radix or quick sort */
+VOID SAGE_FullSortElements(SAGE_Render *, BOOL);
+
+/** Adaptive insertion sort of a run of elements */
+BOOL SAGE_InsertionSortElements(SAGE_SortedElement *, ULONG, BOOL, ULONG, ULONG *);
+
+/** Hash the keys of the queued elements */
+UWORD SAGE_HashElementKeys(SAGE_Render *);
+
+/** Find an element of the queue by its key */
+LONG SAGE_MatchElementKey(SAGE_Render *, ULONG, UWORD);
+
+/** Sort the rendering queue using the order of the previous frame */
+BOOL SAGE_CoherentSortElements(SAGE_Render *, BOOL);
+
+/** Keep the keys of the sorted elements for the next frame */
+VOID SAGE_SaveSortHistory(SAGE_Render *);
+
+#endif
@@ -5,7 +5,7 @@
  * 3D terrain management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 20/06/2025)
  */
 
 #ifndef _SAGE_3DTERRAIN_H_
@@ -15,6 +15,7 @@
 
 #include <sage/sage_picture.h>
 #include <sage/sage_3dstruct.h>
+#include <sage/sage_3dtree.h>
 
 #define S3DT_MINSIZE          64
 #define S3DT_MAXSIZE          128
@@ -24,6 +25,20 @@
 #define S3DT_CELLS_ZONE       8
 #define S3DT_CELL_SIZE        4.0
 #define S3DT_HEIGHT_ZOOM      1.0
+#define S3DT_ZONE_CELLS       (S3DT_CELLS_ZONE*S3DT_CELLS_ZONE)
+#define S3DT_ZONE_FACES       (S3DT_ZONE_CELLS*2)   // Max faces of a zone at any level
+#define S3DT_ZONE_EDGES       4                     // Top, right, bottom, left
+
+#define S3DT_LOD_LEVELS       4                     // Cell step of 1, 2, 4 and 8
+#define S3DT_LOD_BLOCKS       (1+S3DT_ZONE_EDGES*S3DT_LOD_LEVELS)   // Inner block and edge strips of a level
+#define S3DT_LOD_FACES        320                   // Faces of all levels blocks
+#define S3DT_LOD_ERROR        1.0                   // Default max screen error in pixels
+
+/** Level of detail face, vertices are offsets from the first zone vertex */
+typedef struct {
+  UWORD p1, p2, p3;
+  UWORD cell;                       // Cell giving the face color and texture
+} SAGE_LodFace;
 
 /** Terrain definition */
 typedef struct {
@@ -32,6 +47,11 @@ typedef struct {
   UWORD nb_faces, lod;
   SAGE_Face *faces;
   SAGE_Vector *normals;
+  UWORD base;                       // First vertex of the zone
+  UWORD lod_key;                    // Level and edge levels of the current faces
+  FLOAT lod_errors[S3DT_LOD_LEVELS];    // Max height error of each level
+  ULONG colors[S3DT_ZONE_CELLS];
+  WORD textures[S3DT_ZONE_CELLS];
 } SAGE_Zone;
 
 typedef struct {
@@ -41,6 +61,11 @@ typedef struct {
   FLOAT cell_size, height_zoom;
   SAGE_Vertex *vertices;
   SAGE_Zone *zones[S3DT_MAX_ZONES];
+  SAGE_BoundingTree tree;     // Quadtree of the zones grid
+  UWORD lod_max;              // Coarsest allowed level
+  FLOAT lod_error;            // Max screen error in pixels
+  UWORD lod_first[S3DT_LOD_LEVELS][S3DT_LOD_BLOCKS], lod_count[S3DT_LOD_LEVELS][S3DT_LOD_BLOCKS];
+  SAGE_LodFace lod_faces[S3DT_LOD_FACES];
 } SAGE_Terrain;
 
 /** Calculate the zone radius */
@@ -49,6 +74,9 @@ VOID SAGE_SetZoneRadius(SAGE_Zone *);
 /** Calculate zone faces normal */
 VOID SAGE_SetZoneNormals(SAGE_Zone *);
 
+/** Build the zone faces for a level and its edges levels */
+VOID SAGE_SetZoneLevel(SAGE_Zone *, UWORD, UWORD *);
+
 /** Load a heightmap terrain */
 BOOL SAGE_LoadHeightmapTerrain(STRPTR, STRPTR, STRPTR);
 
@@ -58,6 +86,9 @@ VOID SAGE_SetHeighmapCellSize(FLOAT);
 /** Set the zoom factor of a point height */
 VOID SAGE_SetHeightmapZoom(FLOAT);
 
+/** Set the terrain max screen error and coarsest level of detail */
+VOID SAGE_SetTerrainLevelOfDetail(FLOAT, UWORD);
+
 /** Release 3D terrain resources */
 VOID SAGE_ReleaseTerrain(VOID);
 
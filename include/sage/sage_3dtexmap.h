@@ -5,7 +5,7 @@
  * 3D texture mapper
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 10/03/2025)
+ * @version 25.1 February 2025 (updated: 24/06/2025)
  */
 
 #ifndef _SAGE_3DTEXMAP_H_
@@ -27,6 +27,9 @@
 #define FIXP16_SHIFT          16
 #define FIXP16_ROUND_UP       0x8000
 
+#define PERSP_SPAN_SHIFT      4
+#define PERSP_SPAN            (1L<<PERSP_SPAN_SHIFT)   // Pixels between two perspective divides
+
 #define NO_TRANSP_COLOR       0xBADCBADC
 
 typedef signed long FIXED;
@@ -53,6 +56,11 @@ typedef struct {
   FIXED xl, xr;                     // X left & right coordinates
   FIXED zl, zr;                     // Z left & right coordinates
   FIXED ul, ur, vl, vr;             // U&V texture coordinates
+// Perspective rendering
+  DOUBLE w0, dwdx, dwdy;            // 1/Z screen plane
+  DOUBLE s0, dsdx, dsdy;            // U/Z screen plane
+  DOUBLE t0, dtdx, dtdy;            // V/Z screen plane
+  FIXED umax, vmax;                 // Texture coordinates limits
 } SAGE_TextureMapping;
 
 /** Internal triangle structure */
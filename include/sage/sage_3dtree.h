@@ -0,0 +1,64 @@
+/**
+ * sage_3dtree.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * 3D bounding volume tree functions
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 18/06/2025)
+ */
+
+#ifndef _SAGE_3DTREE_H_
+#define _SAGE_3DTREE_H_
+
+#include <exec/types.h>
+
+#define S3DE_NO_NODE          0xFFFF                // Item is not in the tree
+
+#define S3DE_TREE_OUTSIDE     0                     // Item is outside of the view
+#define S3DE_TREE_CLIPPED     1                     // Item is partially in the view
+#define S3DE_TREE_INSIDE      2                     // Item is totally in the view
+
+/** Bounding sphere of an item */
+typedef struct {
+  FLOAT posx, posy, posz, radius;
+} SAGE_BoundingSphere;
+
+/** Tree node, nodes are stored in depth first order */
+typedef struct {
+  FLOAT posx, posy, posz, radius;   // Sphere enclosing all the subtree items
+  UWORD parent;                     // Parent node (S3DE_NO_NODE for the root)
+  UWORD skip;                       // Next node after this subtree
+  UWORD first, count;               // Subtree items in the tree item list
+} SAGE_BoundingNode;
+
+/** Bounding volume tree */
+typedef struct {
+  UWORD max_items, nb_items, nb_nodes;
+  BOOL dirty;                       // Tree should be rebuilt
+  SAGE_BoundingSphere *spheres;     // Item bounding spheres (by item index)
+  UWORD *leaves;                    // Item leaf node (by item index)
+  UWORD *items;                     // Items in tree order
+  UBYTE *visibility;                // Item visibility after culling (by item index)
+  SAGE_BoundingNode *nodes;
+} SAGE_BoundingTree;
+
+/** Allocate the tree buffers */
+BOOL SAGE_AllocBoundingTree(SAGE_BoundingTree *, UWORD);
+
+/** Release the tree buffers */
+VOID SAGE_ReleaseBoundingTree(SAGE_BoundingTree *);
+
+/** Set the bounding sphere of an item */
+VOID SAGE_SetBoundingSphere(SAGE_BoundingTree *, UWORD, FLOAT, FLOAT, FLOAT, FLOAT);
+
+/** Build a quadtree over a grid of items */
+BOOL SAGE_BuildGridTree(SAGE_BoundingTree *, UWORD, UWORD);
+
+/** Build a binary tree over a list of items */
+BOOL SAGE_BuildBinaryTree(SAGE_BoundingTree *, UWORD *, UWORD);
+
+/** Refit the tree after an item has moved */
+UWORD SAGE_RefitBoundingTree(SAGE_BoundingTree *, UWORD);
+
+#endif
@@ -5,7 +5,7 @@
  * Bitmap management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_BITMAP_H_
@@ -71,8 +71,13 @@ typedef struct {
   APTR bitmap_buffer;
   /** Fast draw buffers */
   LONG *first_buffer, *second_buffer;
+  /** Offset of each row in pixel */
+  ULONG *row_offsets;
 } SAGE_Bitmap;
 
+/** Bitmap copy function for a depth */
+typedef VOID (*SAGE_BitmapBlitter)(SAGE_Bitmap *, ULONG, ULONG, ULONG, ULONG, SAGE_Bitmap *, ULONG, ULONG);
+
 /** Return the full name of pixel format */
 STRPTR SAGE_GetPixelFormatName(ULONG);
 
@@ -106,6 +111,9 @@ BOOL SAGE_FillBitmap(SAGE_Bitmap *, ULONG, ULONG, ULONG, ULONG, ULONG);
 /** Blit a block from a bitmap to another */
 BOOL SAGE_BlitBitmap(SAGE_Bitmap *, ULONG, ULONG, ULONG, ULONG, SAGE_Bitmap *, ULONG, ULONG);
 
+/** Get the blit function of a depth */
+SAGE_BitmapBlitter SAGE_GetBitmapBlitter(ULONG);
+
 /** Blit a block from a bitmap to another with zoom */
 BOOL SAGE_BlitZoomedBitmap(SAGE_Bitmap *, ULONG, ULONG, ULONG, ULONG, SAGE_Bitmap *, ULONG, ULONG, ULONG, ULONG);
 
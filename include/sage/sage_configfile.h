@@ -5,7 +5,7 @@
  * Configuration file management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_CONFIGFILE_H_
@@ -15,26 +15,79 @@
 
 #define SCFG_BUFFER_SIZE      1024
 
+#define SCFG_SECTION_BUCKETS  32                    // Power of 2
+#define SCFG_MIN_BUCKETS      64                    // Power of 2
+#define SCFG_BYTES_PER_PARAM  16                    // File bytes per parameter, to size the table
+#define SCFG_LOAD_FACTOR      2                     // Parameters per bucket before growing the table
+#define SCFG_CHUNK_SIZE       4096                  // String arena chunk
+#define SCFG_ARENA_ALIGN      8
+
+#define SCFG_HASH_OFFSET      2166136261UL          // FNV-1a
+#define SCFG_HASH_PRIME       16777619UL
+
+#define SCFG_INTEGER          1                     // Cached value flags
+#define SCFG_FLOAT            2
+#define SCFG_BOOLEAN          4
+#define SCFG_BADINTEGER       8
+#define SCFG_BADFLOAT         16
+#define SCFG_BADBOOLEAN       32
+
+/** SAGE configuration parameter structure */
 typedef struct {
   STRPTR param_name;
   STRPTR param_value;
   APTR next_param;
+  /** Owner section (NULL for a global parameter) and hash chain */
+  APTR section;
+  ULONG hash;
+  APTR next_hash;
+  /** Typed values parsed on first use */
+  UWORD cached;
+  LONG integer_value;
+  FLOAT float_value;
+  BOOL boolean_value;
 } SAGE_ConfParameter;
 
+/** SAGE configuration section structure */
 typedef struct {
   STRPTR section_name;
   SAGE_ConfParameter *parameters;
   APTR next_section;
+  /** Last parameter of the section and hash chain */
+  SAGE_ConfParameter *last_param;
+  ULONG hash;
+  APTR next_hash;
 } SAGE_ConfSection;
 
+/** SAGE configuration string arena chunk */
 typedef struct {
-  SAGE_ConfParameter *parameters;
-  SAGE_ConfSection *sections;
+  ULONG size, used;
+  APTR next_chunk;
+} SAGE_ConfChunk;
+
+/** SAGE configuration structure */
+typedef struct {
+  /** Global parameters and sections in file order */
+  SAGE_ConfParameter *parameters, *last_param;
+  SAGE_ConfSection *sections, *last_section;
+  /** Hash tables */
+  SAGE_ConfSection *section_buckets[SCFG_SECTION_BUCKETS];
+  SAGE_ConfParameter **param_buckets;
+  ULONG param_mask, nb_params;
+  /** File parsed in place and string arena */
+  UBYTE *file_buffer;
+  SAGE_ConfChunk *chunks;
 } SAGE_Configuration;
 
 /** Get a parameter value from a config file */
 BOOL SAGE_GetParameterFromFile(STRPTR, STRPTR, STRPTR, STRPTR, STRPTR, LONG);
 
+/** Release the config file kept by SAGE_GetParameterFromFile */
+VOID SAGE_ReleaseConfigurationCache(VOID);
+
+/** Release the config file kept by SAGE_GetParameterFromFile if it changed */
+BOOL SAGE_RefreshConfigurationCache(VOID);
+
 /** Load a configuration file */
 SAGE_Configuration *SAGE_LoadConfigurationFile(STRPTR);
 
@@ -47,6 +100,15 @@ VOID SAGE_ReleaseConfigurationFile(SAGE_Configuration *);
 /** Get a parameter value from a config */
 STRPTR SAGE_GetParameterValue(SAGE_Configuration *, STRPTR, STRPTR, STRPTR);
 
+/** Get an integer parameter from a config */
+LONG SAGE_GetParameterInteger(SAGE_Configuration *, STRPTR, STRPTR, LONG);
+
+/** Get a float parameter from a config */
+FLOAT SAGE_GetParameterFloat(SAGE_Configuration *, STRPTR, STRPTR, FLOAT);
+
+/** Get a boolean parameter from a config */
+BOOL SAGE_GetParameterBoolean(SAGE_Configuration *, STRPTR, STRPTR, BOOL);
+
 /** Set a parameter value to a config */
 BOOL SAGE_SetParameterValue(SAGE_Configuration *, STRPTR, STRPTR, STRPTR);
 
@@ -0,0 +1,74 @@
+/**
+ * sage_dirtyrect.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Dirty rectangles management
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_DIRTYRECT_H_
+#define _SAGE_DIRTYRECT_H_
+
+#include <exec/types.h>
+
+#define SDRT_MAXRECTS         32                    // Rectangles per buffer
+#define SDRT_MAXBUFFERS       3                     // Triple buffering
+#define SDRT_MAXBACKGROUNDS   4                     // Background restores per frame
+#define SDRT_MERGEGAP         8                     // Rectangles closer than this are merged
+
+#define SDRT_BACKNONE         0
+#define SDRT_BACKCLEAR        1                     // SAGE_ClearScreen
+#define SDRT_BACKPICTURE      2                     // SAGE_BlitPictureToScreen
+#define SDRT_BACKLAYER        3                     // SAGE_BlitLayerToScreen
+
+/** Dirty rectangle, right and bottom are inclusive */
+typedef struct {
+  LONG left, top, right, bottom;
+} SAGE_DirtyRect;
+
+/** Dirty rectangles of a buffer */
+typedef struct {
+  APTR buffer;                // Buffer owning the list
+  BOOL full;                  // The whole buffer is dirty
+  UWORD count;
+  SAGE_DirtyRect rects[SDRT_MAXRECTS];
+} SAGE_DirtyList;
+
+/** Background restored every frame */
+typedef struct {
+  ULONG type;
+  APTR source;
+  LONG left, top, width, height, x_pos, y_pos;
+} SAGE_DirtyBackground;
+
+/** Dirty rectangles manager */
+typedef struct {
+  BOOL enable;
+  UWORD nb_backgrounds;                                 // Background restores done in this frame
+  SAGE_DirtyBackground backgrounds[SDRT_MAXBACKGROUNDS];
+  SAGE_DirtyList restore;                               // Rectangles restored in this frame
+  SAGE_DirtyList bitmaps[SDRT_MAXBUFFERS];              // Damaged parts of the screen bitmaps
+  SAGE_DirtyList displays[SDRT_MAXBUFFERS];             // Damaged parts of the display buffers (indirect mode)
+} SAGE_DirtyRects;
+
+/** Enable/disable the dirty rectangles */
+BOOL SAGE_EnableDirtyRects(BOOL);
+
+/** Add a damaged area of the back bitmap */
+BOOL SAGE_AddDirtyRect(LONG, LONG, LONG, LONG);
+
+/** Set all buffers as fully damaged */
+BOOL SAGE_InvalidateDirtyRects(VOID);
+
+/** Get the rectangles to restore with a background */
+SAGE_DirtyList *SAGE_GetDirtyRestore(SAGE_DirtyBackground *);
+
+/** Get the part of an area inside a rectangle */
+BOOL SAGE_IntersectDirtyRect(SAGE_DirtyRect *, LONG, LONG, LONG, LONG, SAGE_DirtyRect *);
+
+/** Copy the damaged parts of the back bitmap to a display buffer */
+BOOL SAGE_CopyDirtyRects(APTR, UBYTE *);
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * sage_loadsen.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * SAGE binary entity loading
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_LOADSEN_H_
+#define _SAGE_LOADSEN_H_
+
+#include <exec/types.h>
+#include <dos/dos.h>
+
+#include <sage/sage_3dentity.h>
+
+#define S3DE_SENTAG           0x53454E54            // "SENT"
+#define S3DE_SENVERSION       1
+#define S3DE_SENFILESIZE      64                    // Texture file name size
+#define S3DE_SENNOMATERIAL    -1
+
+/**
+ * SEN file layout, big endian with 68k alignment :
+ *  SAGE_SENHeader
+ *  SAGE_SENMaterial * nb_materials
+ *  SAGE_Vertex * nb_vertices (duplicates removed)
+ *  SAGE_Face * nb_faces (texture = material index, uv from 0.0 to 1.0)
+ *  SAGE_Vector * nb_faces (faces normal)
+ */
+
+/** SEN structures */
+
+typedef struct {
+  ULONG tag;
+  UWORD version;
+  UWORD nb_materials;
+  UWORD nb_vertices;
+  UWORD nb_faces;
+  FLOAT radius;
+} SAGE_SENHeader;
+
+typedef struct {
+  UBYTE file[S3DE_SENFILESIZE];     // Texture file, relative to the entity file
+  ULONG color;
+  ULONG tcolor;
+  BOOL transparent;
+  WORD texture;                     // Texture index once loaded
+} SAGE_SENMaterial;
+
+/** Load a SEN file */
+SAGE_Entity *SAGE_LoadSEN(BPTR, STRPTR);
+
+#endif
@@ -5,7 +5,7 @@
  * Memory allocation management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_MEMORY_H_
@@ -13,30 +13,130 @@
 
 #include <exec/exec.h>
 
+// Memory accounting by tag, not in the fast build
+#if _SAGE_DEBUG_MODE_ == 1 || _SAGE_SAFE_MODE_ == 1
+#define _SAGE_MEMORY_TAGS_ 1
+#define SMT(x) x
+#else
+#define SMT(x)
+#endif
+
 // Little endian to Big endian conversion
 #define SAGE_WORDTOBE(value)  ((value & 0xff00) >> 8) | ((value & 0xff) << 8)
 #define SAGE_LONGTOBE(value)  ((value & 0xff) << 24) | ((value & 0xff00) << 8) | ((value & 0xff000000) >> 24) | ((value & 0xff0000) >> 8)
 
-/** Memory node */
+#define SMEM_NODEMAGIC        0x53414745            // "SAGE", header of a live bloc
+#define SMEM_FREEMAGIC        0x46524545            // "FREE", header of a released bloc
+#define SMEM_POOLMAGIC        0x504F0000            // "PO", header of a pool bloc with its size class
+#define SMEM_POOLMASK         0xFFFF0000
+
+#define SMEM_POOLCLASSES      5                     // Pool size classes of 16, 32, 64, 128 and 256 bytes
+#define SMEM_POOLMINSHIFT     4
+#define SMEM_POOLCHUNK        8192                  // Size of the memory chunks carved by the pools
+
+#define SMEM_ARENAS           2                     // Frame arenas, the previous one is still read by the wait buffer
+#define SMEM_ARENAALIGN       8                     // Alignment of the frame allocations
+
+#define SMEM_MAXTAGS          16                    // Memory accounting tags
+#define SMEM_TAGNAME          16                    // Size of a tag name
+#define SMEM_TAG_DEFAULT      0                     // Untagged blocs
+#define SMEM_TAG_POOL         1                     // Chunks of the small object pools
+#define SMEM_TAG_ARENA        2                     // Frame arenas
+#define SMEM_TAG_LAYER        3
+#define SMEM_TAG_SPRITE       4
+#define SMEM_TAG_TILEMAP      5
+#define SMEM_TAG_TEXTURE      6
+#define SMEM_TAG_ENTITY       7
+#define SMEM_TAG_SOUND        8
+#define SMEM_TAG_MUSIC        9
+#define SMEM_TAG_USER         10                    // First tag free for the application
+
+#define SMEM_LOCATIONS        2                     // Memory really used by the blocs
+#define SMEM_LOC_CHIP         0
+#define SMEM_LOC_FAST         1
+
+/** Memory node, stored just before the memory bloc (its size is a multiple of 8 to keep the blocs aligned like AllocMem) */
 typedef struct _sage_memory_node {
-  /** Base address of bloc, before alignment */
+  /** Base address of bloc, before the node and the alignment */
   APTR base_address;
-  /** Address of memory bloc */
-  APTR memory_bloc;
-  /** Size of memory bloc */
+  /** Size of allocated bloc, with the node and the alignment */
   ULONG bloc_size;
+  /** Bloc attributes */
+  ULONG flags;
   /** Previous memory node */
   struct _sage_memory_node *previous;
   /** Next memory node */
   struct _sage_memory_node *next;
+#if _SAGE_MEMORY_TAGS_ == 1
+  /** Accounting tag and memory location, longs keep the node size a multiple of 8 */
+  ULONG tag, location;
+#endif
+  /** Guard of the node */
+  ULONG magic;
 } SAGE_MemoryNode;
 
+/** Pool bloc, stored just before the memory bloc */
+typedef struct _sage_pool_bloc {
+  /** Next free bloc of the pool */
+  struct _sage_pool_bloc *next;
+  /** Guard of the bloc and size class */
+  ULONG magic;
+} SAGE_PoolBloc;
+
+/** Memory pool of a size class */
+typedef struct {
+  /** Size of the blocs */
+  ULONG bloc_size;
+  /** Free blocs */
+  SAGE_PoolBloc *free_list;
+  /** Pool statistics */
+  ULONG chunks, used, peak, allocations;
+} SAGE_MemoryPool;
+
+/** Frame arena, bump allocated and reset by each screen refresh */
+typedef struct {
+  /** Arena buffer and size */
+  UBYTE *buffer;
+  ULONG size;
+  /** Arena statistics */
+  ULONG used, peak, allocations;
+} SAGE_FrameArena;
+
+/** Memory accounting of a tag */
+typedef struct {
+  /** Tag name */
+  char name[SMEM_TAGNAME];
+  /** Live and highest bytes in CHIP and FAST memory */
+  ULONG live_bytes[SMEM_LOCATIONS], peak_bytes[SMEM_LOCATIONS];
+  /** Live blocs and number of allocations */
+  ULONG live_blocs, allocations;
+} SAGE_MemoryTag;
+
+/** Memory accounting snapshot */
+typedef struct {
+  /** Accounting of each tag */
+  SAGE_MemoryTag tags[SMEM_MAXTAGS];
+  /** Live and highest bytes of all the tags */
+  ULONG live_bytes[SMEM_LOCATIONS], peak_bytes[SMEM_LOCATIONS];
+} SAGE_MemorySnapshot;
+
 /** Memory manager */
 typedef struct {
   /** Head of memory list */
   SAGE_MemoryNode *head;
   /** Tail of memory list */
   SAGE_MemoryNode *tail;
+  /** Small object pools */
+  SAGE_MemoryPool pools[SMEM_POOLCLASSES];
+  /** Frame arenas, current arena and number of resets */
+  SAGE_FrameArena arenas[SMEM_ARENAS];
+  UWORD arena;
+  ULONG arena_frame;
+#if _SAGE_MEMORY_TAGS_ == 1
+  /** Tag of the new blocs and memory accounting */
+  UWORD tag;
+  SAGE_MemorySnapshot accounting;
+#endif
 } SAGE_MemoryManager;
 
 /** Allocate public memory */
@@ -60,10 +160,52 @@ APTR SAGE_AllocAlignFastMem(ULONG, ULONG);
 /** Free any kind of memory */
 VOID SAGE_FreeMem(APTR);
 
+/** Allocate a small object from the pools */
+APTR SAGE_PoolAlloc(ULONG);
+
+/** Free a small object of the pools */
+VOID SAGE_PoolFree(APTR);
+
+/** Create the frame arenas */
+BOOL SAGE_CreateFrameArenas(ULONG);
+
+/** Release the frame arenas */
+VOID SAGE_ReleaseFrameArenas(VOID);
+
+/** Check for the frame arenas */
+BOOL SAGE_HasFrameArenas(VOID);
+
+/** Allocate transient memory from the current frame arena */
+APTR SAGE_FrameAlloc(ULONG);
+
+/** Get the free bytes of the current frame arena */
+ULONG SAGE_GetFrameArenaFree(VOID);
+
+/** Get the number of frame arena resets */
+ULONG SAGE_GetFrameArenaFrame(VOID);
+
+/** Switch to the other frame arena and reset it */
+VOID SAGE_ResetFrameArena(VOID);
+
+/** Set the accounting tag of the new blocs */
+UWORD SAGE_SetMemoryTag(UWORD);
+
+/** Set the name of an accounting tag */
+BOOL SAGE_SetMemoryTagName(UWORD, STRPTR);
+
+/** Reset the highest bytes to the live bytes */
+VOID SAGE_ResetMemoryPeaks(VOID);
+
+/** Get a snapshot of the memory accounting */
+BOOL SAGE_GetMemorySnapshot(SAGE_MemorySnapshot *);
+
+/** Dump a memory accounting snapshot as CSV */
+BOOL SAGE_DumpMemorySnapshot(SAGE_MemorySnapshot *, STRPTR);
+
 /** Release all memory blocs */
 VOID SAGE_ReleaseMem(VOID);
 
-/** Dump the memory list */
+/** Dump the memory list, the pool and the arena statistics */
 VOID SAGE_DumpMemory(VOID);
 
 /** Get the available public memory in bytes */
@@ -0,0 +1,60 @@
+/**
+ * sage_parallax.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Parallax layers compositor
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_PARALLAX_H_
+#define _SAGE_PARALLAX_H_
+
+#include <exec/types.h>
+
+#include <sage/sage_layer.h>
+
+#define SPLX_MAXPLANES        32                    // One bit per plane in the band masks
+
+/** SAGE parallax plane structure */
+typedef struct {
+  /** Layer index */
+  UWORD index;
+  /** Screen position of the layer view */
+  LONG x_pos, y_pos;
+  /** Rows of the layer bitmap without transparent pixel (NULL when the layer is opaque) */
+  UBYTE *opaque_rows;
+  /** Working values of the composition */
+  SAGE_Layer *layer;
+  LONG left, top, right, bottom;
+} SAGE_ParallaxPlane;
+
+/** SAGE parallax structure */
+typedef struct {
+  /** Planes, from back to front */
+  UWORD max_planes, nb_planes;
+  SAGE_ParallaxPlane *planes;
+  /** Pixels written by the last composition */
+  ULONG drawn_pixels;
+} SAGE_Parallax;
+
+/** Create a parallax */
+SAGE_Parallax *SAGE_CreateParallax(UWORD);
+
+/** Release a parallax */
+VOID SAGE_ReleaseParallax(SAGE_Parallax *);
+
+/** Add a layer in front of the parallax planes */
+BOOL SAGE_AddParallaxLayer(SAGE_Parallax *, UWORD, LONG, LONG);
+
+/** Update the opaque rows of a parallax layer */
+BOOL SAGE_UpdateParallaxLayer(SAGE_Parallax *, UWORD);
+
+/** Blit all the parallax layers to the screen */
+BOOL SAGE_BlitParallaxToScreen(SAGE_Parallax *);
+
+/** Get the number of pixels written by the last composition */
+ULONG SAGE_GetParallaxPixels(SAGE_Parallax *);
+
+#endif
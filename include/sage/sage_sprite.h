@@ -5,7 +5,7 @@
  * Sprite management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_SPRITE_H_
@@ -31,6 +31,41 @@
 #define SSPR_VFLIPPED         4
 #define SSPR_ZOOMED           8
 #define SSPR_STMASK           0xFFF0
+#define SSPR_ROTATED          16                    // Kept when the sprite is flipped or zoomed
+
+#define SSPR_BATCHBUCKETS     256
+
+#define SSPR_MASKS            4                     // Normal, horizontal, vertical and both flipped
+#define SSPR_MASKHFLIP        1
+#define SSPR_MASKVFLIP        2
+
+#define SSPR_SPANHEADER       4                     // Skip and length words of a span
+
+#define SSPR_FIXSHIFT         16                    // Rotation map fixed point
+
+/** SAGE rotated sprite frame structure */
+typedef struct {
+  /** Frame angle (1/SMTH_PRECISION degree), zoom and flipping */
+  WORD angle;
+  FLOAT horizontal_zoom, vertical_zoom;
+  BOOL horizontal_flip, vertical_flip;
+  /** Rotated sprite and its position from the hotspot */
+  SAGE_Bitmap *bitmap;
+  LONG x_offset, y_offset, width, height;
+  /** Last use of the frame */
+  ULONG last_use;
+} SAGE_RotatedFrame;
+
+/** SAGE rotation map structure */
+typedef struct {
+  /** Destination box */
+  LONG left, top, right, bottom;
+  /** Sprite coordinates of the box top left pixel and steps (16.16) */
+  LONG u_start, v_start;
+  LONG du_x, dv_x, du_y, dv_y;
+  /** Sprite size (16.16) */
+  LONG u_size, v_size;
+} SAGE_RotationMap;
 
 /** SAGE Sprite structure */
 typedef struct {
@@ -48,6 +83,14 @@ typedef struct {
   LONG hs_x, hs_y;
   /** Sprite flags */
   LONGBITS flags;
+  /** Collision masks, 1 bit per pixel and mask_words longs per row */
+  ULONG *masks[SSPR_MASKS];
+  UWORD mask_words;
+  /** Transparent spans, offset of each row in the spans */
+  ULONG *span_rows;
+  UBYTE *spans;
+  /** Cache of rotated frames */
+  SAGE_RotatedFrame *rotated_frames;
 } SAGE_Sprite;
 
 /** SAGE Sprite bank structure */
@@ -58,8 +101,35 @@ typedef struct {
   SAGE_Sprite *sprites;
   /** Sprite page bitmap */
   SAGE_Bitmap *bitmap;
+  /** Build the collision masks of the added sprites */
+  BOOL collision_masks;
+  /** Build the transparent spans of the added sprites */
+  BOOL sprite_spans;
+  /** Rotated frames cached for each sprite */
+  UWORD rotation_frames;
+  ULONG rotation_clock;
 } SAGE_SpriteBank;
 
+/** SAGE batched sprite structure */
+typedef struct {
+  /** Sprite bank and sprite index */
+  UWORD index, sprite;
+  /** Sprite position */
+  LONG x_pos, y_pos;
+  /** Drawing priority, lowest first */
+  UBYTE priority;
+} SAGE_BatchedSprite;
+
+/** SAGE sprite batch structure */
+typedef struct {
+  /** Batch size and number of queued sprites */
+  UWORD size, count;
+  /** Queued sprites */
+  SAGE_BatchedSprite *sprites;
+  /** Sort keys */
+  ULONG *keys, *sorted;
+} SAGE_SpriteBatch;
+
 /** Create a sprite bank */
 BOOL SAGE_CreateSpriteBank(UWORD, UWORD, SAGE_Picture *);
 
@@ -72,6 +142,15 @@ BOOL SAGE_ReleaseSpriteBank(UWORD);
 /** Set the sprites transparency */
 BOOL SAGE_SetSpriteBankTransparency(UWORD, ULONG);
 
+/** Enable the sprites collision masks */
+BOOL SAGE_SetSpriteBankMasks(UWORD, BOOL);
+
+/** Enable the sprites transparent spans */
+BOOL SAGE_SetSpriteBankSpans(UWORD, BOOL);
+
+/** Enable the cache of rotated sprites */
+BOOL SAGE_SetSpriteBankRotationCache(UWORD, UWORD);
+
 /** Add a sprite to the bank */
 BOOL SAGE_AddSpriteToBank(UWORD, UWORD, ULONG, ULONG, ULONG, ULONG, UWORD);
 
@@ -84,13 +163,34 @@ BOOL SAGE_SetSpriteFlipping(UWORD, UWORD, BOOL, BOOL);
 /** Set the sprite zoom factor */
 BOOL SAGE_SetSpriteZoom(UWORD, UWORD, FLOAT, FLOAT);
 
+/** Set the sprite rotation angle */
+BOOL SAGE_SetSpriteRotation(UWORD, UWORD, FLOAT);
+
 /** Set the sprite hotspot */
 BOOL SAGE_SetSpriteHotspot(UWORD, UWORD, UWORD);
 
+/** Check for collision between two boxes */
+BOOL SAGE_BoxCollide(LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG);
+
+/** Check for collision between two sprite masks */
+BOOL SAGE_MaskCollide(SAGE_Sprite *, LONG, LONG, SAGE_Sprite *, LONG, LONG);
+
 /** Check for collision between two sprites */
 BOOL SAGE_SpriteCollide(UWORD, UWORD, LONG, LONG, UWORD, UWORD, LONG, LONG);
 
 /** Blit a sprite to the screen */
 BOOL SAGE_BlitSpriteToScreen(UWORD, UWORD, LONG, LONG);
 
+/** Create the sprite batch */
+BOOL SAGE_CreateSpriteBatch(UWORD);
+
+/** Release the sprite batch */
+BOOL SAGE_ReleaseSpriteBatch(VOID);
+
+/** Queue a sprite in the batch */
+BOOL SAGE_AddSpriteToBatch(UWORD, UWORD, LONG, LONG, UBYTE);
+
+/** Blit all the queued sprites to the screen */
+BOOL SAGE_FlushSpriteBatch(VOID);
+
 #endif
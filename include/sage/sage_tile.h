@@ -5,7 +5,7 @@
  * Tile management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_TILE_H_
@@ -18,6 +18,9 @@
 #define STIL_MAPINBYTE        1
 #define STIL_MAPINWORD        2
 
+#define STIL_MAX_TILEANIM     16
+#define STIL_NOANIM           0
+
 /** SAGE tile */
 typedef struct {
   /** Tile position */
@@ -26,8 +29,18 @@ typedef struct {
   LONGBITS flags;
   /** Tile user data */
   APTR user_data;
+  /** Tile animation (index + 1) and tile drawn in place of this one */
+  UWORD animation, display;
 } SAGE_Tile;
 
+/** SAGE tile animation */
+typedef struct {
+  /** First tile and number of tiles of the cycle */
+  UWORD first, frames;
+  /** Frame delay, delay counter and current frame */
+  UWORD delay, counter, frame;
+} SAGE_TileAnimation;
+
 /** SAGE tile bank */
 typedef struct {
   /** Size of a tile */
@@ -38,6 +51,11 @@ typedef struct {
   SAGE_Tile *tiles;
   /** Tile bitmap */
   SAGE_Bitmap * bitmap;
+  /** Animated tiles */
+  UWORD nb_animations;
+  SAGE_TileAnimation animations[STIL_MAX_TILEANIM];
+  /** Incremented each time an animation changes of frame */
+  ULONG anim_step;
 } SAGE_TileBank;
 
 /** Create a tilebank */
@@ -70,6 +88,15 @@ BOOL SAGE_SetTileUserData(UWORD, UWORD, APTR);
 /** Get tile user data */
 APTR SAGE_GetTileUserData(UWORD, UWORD);
 
+/** Add a tile animation cycle */
+BOOL SAGE_AddTileAnimation(UWORD, UWORD, UWORD, UWORD);
+
+/** Animate the tiles of a bank */
+BOOL SAGE_AnimateTiles(UWORD);
+
+/** Get the tile to draw for a tile */
+UWORD SAGE_GetTileDisplay(SAGE_TileBank *, UWORD);
+
 /** Blit a tile to a layer */
 BOOL SAGE_BlitTileToLayer(UWORD, UWORD, UWORD, ULONG, ULONG);
 
@@ -4,7 +4,7 @@
  * SAGE (Simple Amiga Game Engine) project
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <exec/exec.h>
@@ -130,6 +130,7 @@ VOID SAGE_Exit(VOID)
     SAGE_ReleaseVideoModule();
   }
   SageContext.LoadedModules = SMOD_NONE;
+  SAGE_ReleaseConfigurationCache();
   // Finally clean memory
   SD(SAGE_DumpMemory();)
   SAGE_ReleaseMem();  // Free all remaining memory
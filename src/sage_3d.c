@@ -5,7 +5,7 @@
  * 3D module management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 26/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <exec/execbase.h>
@@ -170,6 +170,8 @@ BOOL SAGE_Free3DDevice(VOID)
   SAGE_ClearTextures();
   // Release Z buffer
   SAGE_ReleaseZBuffer();
+  // Release rendering queue
+  SAGE_Release3DRender();
   // Release Warp3D context
   if (device->w3d_context != NULL) {
     W3D_DestroyContext(device->w3d_context);
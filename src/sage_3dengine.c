@@ -5,10 +5,11 @@
  * 3D engine functions
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <string.h>
+#include <math.h>
 
 #include <proto/exec.h>
 
@@ -22,6 +23,7 @@
 #include <sage/sage_3drender.h>
 #include <sage/sage_3dtexture.h>
 #include <sage/sage_3dengine.h>
+#include <sage/sage_3dstream.h>
 
 #include <sage/sage_debug.h>
 
@@ -33,9 +35,15 @@
 SAGE_Matrix CameraMatrix;
 SAGE_Matrix EntityMatrix;
 
+/** Normal length of the camera side planes */
+FLOAT FrustumXLength, FrustumYLength;
+
 /** Our 3D world */
 SAGE_3DWorld sage_world;
 
+/** Entities list for the tree build */
+UWORD EntityTreeItems[S3DE_MAX_ENTITIES];
+
 /** For debug purpose */
 BOOL engine_debug;
 
@@ -125,6 +133,9 @@ VOID SAGE_SetupCameraMatrix(SAGE_Camera *camera)
   CameraMatrix.m31 = -sin_y;
   CameraMatrix.m32 = cos_y*sin_x;
   CameraMatrix.m33 = cos_y*cos_x;
+  // Side planes are x = (centerx * z) / view_dist and y = (centery * z) / view_dist
+  FrustumXLength = sqrt((camera->view_dist * camera->view_dist) + (camera->centerx * camera->centerx));
+  FrustumYLength = sqrt((camera->view_dist * camera->view_dist) + (camera->centery * camera->centery));
   SED(SAGE_DumpCameraMatrix();)
 }
 
@@ -402,9 +413,10 @@ VOID SAGE_ClipTwoFacePoint(SAGE_TransformedVertex *vertices, SAGE_Face *face, SA
 }
 
 /**
- * Set the list of faces to render and clip them against near plane if necessary
+ * Set the list of faces to render and clip them against near plane if necessary,
+ * the elements of each face are keyed from the key of the face list
  */
-VOID SAGE_SetClippedFaceList(SAGE_TransformedVertex *vertices, SAGE_Face *faces, UWORD nb_faces, SAGE_Camera *camera)
+VOID SAGE_SetClippedFaceList(SAGE_TransformedVertex *vertices, SAGE_Face *faces, UWORD nb_faces, SAGE_Camera *camera, ULONG key)
 {
   UWORD index;
   SAGE_Face *face, clipped_face;
@@ -413,6 +425,7 @@ VOID SAGE_SetClippedFaceList(SAGE_TransformedVertex *vertices, SAGE_Face *faces,
   for (index = 0;index < nb_faces;index++) {
     face = &(faces[index]);
     if (!face->culled) {
+      SAGE_Set3DElementKey(key + ((ULONG)index << S3DE_KEY_FACE));
       if (face->clipped == S3DE_NOCLIP) {
         if (face->is_quad) {
           SAGE_AddTexturedQuad(vertices, face);
@@ -730,7 +743,7 @@ VOID SAGE_TransformSkybox(SAGE_Camera *camera)
   SAGE_VerticesProjection(sage_world.transformed_vertices, S3DE_SKYBOX_VERTICES, camera);
   for (plane = 0;plane < S3DE_SKYBOX_PLANES;plane++) {
     if (!skybox->planes[plane].culled) {
-      SAGE_SetClippedFaceList(sage_world.transformed_vertices, skybox->planes[plane].faces, S3DE_SKYBOX_FACEBYPLANE, camera);
+      SAGE_SetClippedFaceList(sage_world.transformed_vertices, skybox->planes[plane].faces, S3DE_SKYBOX_FACEBYPLANE, camera, S3DE_KEY_SKYBOX | ((ULONG)plane << S3DE_KEY_OWNER));
     }
   }
 }
@@ -738,85 +751,206 @@ VOID SAGE_TransformSkybox(SAGE_Camera *camera)
 #endif
 
 /*****************************************************************************
- *            TERRAIN TRANSFORMATIONS
+ *            BOUNDING TREES CULLING
  *****************************************************************************/
 
-#if SAGE_ENABLE_TERRAIN == 1
-
 /**
- * Tell if the zone is in the camera view, partially clipped or totally culled
+ * Tell if a sphere is outside, partially inside or totally inside the camera view
+ * The sphere is tested with its distance to each plane of the view, so a
+ * sphere inside another one never gets a wider visibility (bounding trees)
  */
-BOOL SAGE_TerrainZoneVisibility(SAGE_Zone *zone, SAGE_Camera *camera)
+UWORD SAGE_SphereVisibility(FLOAT posx, FLOAT posy, FLOAT posz, FLOAT radius, SAGE_Camera *camera)
 {
   FLOAT cx, cy, cz, x, y ,z;
-  FLOAT radius, xplane, yplane;
+  FLOAT xplane, yplane, xradius, yradius;
 
-  SED(SAGE_DebugLog("** SAGE_TerrainZoneVisibility()");)
-  zone->culled = TRUE;
-  cx = zone->posx - camera->posx;
-  cy = zone->posy - camera->posy;
-  cz = zone->posz - camera->posz;
+  cx = posx - camera->posx;
+  cy = posy - camera->posy;
+  cz = posz - camera->posz;
   x = cx*CameraMatrix.m11 + cy*CameraMatrix.m21 + cz*CameraMatrix.m31;
   y = cx*CameraMatrix.m12 + cy*CameraMatrix.m22 + cz*CameraMatrix.m32;
   z = cx*CameraMatrix.m13 + cy*CameraMatrix.m23 + cz*CameraMatrix.m33;
-  radius = zone->radius;
   SED(SAGE_DebugLog("  => x %f  y %f  z %f  r %f", x, y, z, radius);)
   // Check against Z planes
   if (((z-radius) > camera->far_plane) || ((z+radius) < camera->near_plane)) {
-    SED(SAGE_DebugLog("  => this zone is outside (far or near)");)
-    return FALSE;
+    return S3DE_TREE_OUTSIDE;
   }
-  // Check against X planes
-  xplane = (camera->centerx * z) / camera->view_dist;
-  if (((x-radius) > xplane) || ((x+radius) < -xplane)) {
-    SED(SAGE_DebugLog("  => this zone is outside (X plane)");)
-    return FALSE;
+  // Check against X planes, distances are scaled by view_dist
+  x = x * camera->view_dist;
+  xplane = camera->centerx * z;
+  xradius = radius * FrustumXLength;
+  if (((x-xplane) > xradius) || ((-x-xplane) > xradius)) {
+    return S3DE_TREE_OUTSIDE;
   }
   // Check against Y planes
-  yplane = (camera->centery * z) / camera->view_dist;
-  if (((y-radius) > yplane) || ((y+radius) < -yplane)) {
-    SED(SAGE_DebugLog("  => this zone is outside (Y plane)");)
-    return FALSE;
+  y = y * camera->view_dist;
+  yplane = camera->centery * z;
+  yradius = radius * FrustumYLength;
+  if (((y-yplane) > yradius) || ((-y-yplane) > yradius)) {
+    return S3DE_TREE_OUTSIDE;
   }
   // Check for partial clipping
   if (((z+radius) > camera->far_plane) || ((z-radius) < camera->near_plane)) {
-    zone->clipped = TRUE;
-  } else if (((x+radius) > xplane) || ((x-radius) < -xplane)) {
-    zone->clipped = TRUE;
-  } else if (((y+radius) > yplane) || ((y-radius) < -yplane)) {
-    zone->clipped = TRUE;
-  } else {
-    zone->clipped = FALSE;
+    return S3DE_TREE_CLIPPED;
+  } else if (((x-xplane) > -xradius) || ((-x-xplane) > -xradius)) {
+    return S3DE_TREE_CLIPPED;
+  } else if (((y-yplane) > -yradius) || ((-y-yplane) > -yradius)) {
+    return S3DE_TREE_CLIPPED;
   }
-  zone->culled = FALSE;
-  SED(SAGE_DebugLog("  => this zone is visible");)
-  return TRUE;
+  return S3DE_TREE_INSIDE;
+}
+
+/**
+ * Set the visibility of all the tree items
+ * A subtree outside or totally inside the view gives its status to all its
+ * items without testing them, only partially visible subtrees are opened
+ */
+VOID SAGE_CullBoundingTree(SAGE_BoundingTree *tree, SAGE_Camera *camera)
+{
+  SAGE_BoundingNode *node;
+  UWORD index, item, status;
+
+  SED(SAGE_DebugLog("** SAGE_CullBoundingTree(%d nodes)", tree->nb_nodes);)
+  index = 0;
+  while (index < tree->nb_nodes) {
+    node = &(tree->nodes[index]);
+    status = SAGE_SphereVisibility(node->posx, node->posy, node->posz, node->radius, camera);
+    sage_world.metrics.tested_nodes++;
+    if (status == S3DE_TREE_CLIPPED && node->skip != (index + 1)) {
+      index++;
+    } else {
+      for (item = node->first;item < (node->first + node->count);item++) {
+        tree->visibility[tree->items[item]] = status;
+      }
+      index = node->skip;
+    }
+  }
+}
+
+/**
+ * Get the visibility of a tree item after the culling
+ */
+BOOL SAGE_BoundingItemVisibility(SAGE_BoundingTree *tree, UWORD item, BOOL *culled, BOOL *clipped)
+{
+  switch (tree->visibility[item]) {
+    case S3DE_TREE_INSIDE:
+      *culled = FALSE;
+      *clipped = FALSE;
+      return TRUE;
+    case S3DE_TREE_CLIPPED:
+      *culled = FALSE;
+      *clipped = TRUE;
+      return TRUE;
+  }
+  *culled = TRUE;
+  return FALSE;
+}
+
+/**
+ * Rebuild the entities tree
+ */
+BOOL SAGE_BuildEntityTree(VOID)
+{
+  SAGE_Entity *entity;
+  UWORD index, nb_items;
+
+  SED(SAGE_DebugLog("** SAGE_BuildEntityTree()");)
+  nb_items = 0;
+  for (index = 0;index < S3DE_MAX_ENTITIES;index++) {
+    entity = sage_world.entities[index];
+    if (entity != NULL) {
+      SAGE_SetBoundingSphere(&sage_world.entity_tree, index, entity->posx, entity->posy, entity->posz, entity->radius);
+      EntityTreeItems[nb_items++] = index;
+    }
+  }
+  return SAGE_BuildBinaryTree(&sage_world.entity_tree, EntityTreeItems, nb_items);
+}
+
+/*****************************************************************************
+ *            TERRAIN TRANSFORMATIONS
+ *****************************************************************************/
+
+#if SAGE_ENABLE_TERRAIN == 1
+
+/**
+ * Tell if the zone is in the camera view, partially clipped or totally culled
+ */
+BOOL SAGE_TerrainZoneVisibility(SAGE_Zone *zone, SAGE_Camera *camera)
+{
+  UWORD status;
+
+  SED(SAGE_DebugLog("** SAGE_TerrainZoneVisibility()");)
+  status = SAGE_SphereVisibility(zone->posx, zone->posy, zone->posz, zone->radius, camera);
+  zone->culled = (status == S3DE_TREE_OUTSIDE);
+  zone->clipped = (status == S3DE_TREE_CLIPPED);
+  SED(SAGE_DebugLog("  => this zone is %s", (zone->culled ? "outside" : "visible"));)
+  return (BOOL)!zone->culled;
 }
 
 /**
  * Set the level of detail of the terrain zone
+ * The zone takes the coarsest level whose height error, seen from the camera
+ * at the nearest zone point, is under the terrain max screen error
  */
-VOID SAGE_TerrainZoneLevelOfDetail(SAGE_Zone *zone, SAGE_Camera *camera)
+VOID SAGE_TerrainZoneLevelOfDetail(SAGE_Terrain *terrain, SAGE_Zone *zone, SAGE_Camera *camera, FLOAT error_ratio)
 {
-  FLOAT distance, x, y, z;
+  FLOAT distance, limit, x, y, z;
+  UWORD level;
 
   SED(SAGE_DebugLog("** SAGE_TerrainZoneLevelOfDetail()");)
   x = camera->posx - zone->posx;
   y = camera->posy - zone->posy;
   z = camera->posz - zone->posz;
-  distance = sqrt((x*x) + (y*y) + (z*z));
-  if (distance > S3DE_LOD_L3) {
-    zone->lod = S3DE_LOD_LOW;
-  } else if (distance > S3DE_LOD_L2) {
-    zone->lod = S3DE_LOD_MEDIUM;
-  } else if (distance > S3DE_LOD_L1) {
-    zone->lod = S3DE_LOD_HIGH;
-  } else {
-    zone->lod = S3DE_LOD_FULL;
+  // Compare squared distances to avoid the square root
+  distance = (x*x) + (y*y) + (z*z);
+  zone->lod = S3DE_LOD_FULL;
+  for (level = terrain->lod_max;level > S3DE_LOD_FULL;level--) {
+    limit = (zone->lod_errors[level] * error_ratio) + zone->radius;
+    if ((limit*limit) <= distance) {
+      zone->lod = level;
+      break;
+    }
   }
   SED(SAGE_DebugLog("  => lod is %d", zone->lod);)
 }
 
+/**
+ * Get the level of a zone edge, it's the coarsest level of the zone and its neighbor
+ */
+UWORD SAGE_TerrainEdgeLevel(SAGE_Terrain *terrain, SAGE_Zone *zone, WORD x, WORD y, UWORD width)
+{
+  SAGE_Zone *neighbor;
+
+  if (x < 0 || y < 0 || x >= width || y >= width) {
+    return zone->lod;
+  }
+  neighbor = terrain->zones[(y * width) + x];
+  if (neighbor == NULL || neighbor->disabled || neighbor->culled || neighbor->lod < zone->lod) {
+    return zone->lod;
+  }
+  return neighbor->lod;
+}
+
+/**
+ * Build the zone faces for its level and the level of its neighbors
+ */
+VOID SAGE_TerrainZoneStitching(SAGE_Terrain *terrain, SAGE_Zone *zone, UWORD index)
+{
+  UWORD edges[S3DT_ZONE_EDGES], width;
+  WORD x, y;
+
+  SED(SAGE_DebugLog("** SAGE_TerrainZoneStitching()");)
+  width = terrain->size / S3DT_CELLS_ZONE;
+  x = index % width;
+  y = index / width;
+  edges[0] = SAGE_TerrainEdgeLevel(terrain, zone, x, y - 1, width);
+  edges[1] = SAGE_TerrainEdgeLevel(terrain, zone, x + 1, y, width);
+  edges[2] = SAGE_TerrainEdgeLevel(terrain, zone, x, y + 1, width);
+  edges[3] = SAGE_TerrainEdgeLevel(terrain, zone, x - 1, y, width);
+  SAGE_SetZoneLevel(zone, zone->lod, edges);
+  SED(SAGE_DebugLog("  => level %d  edges %d,%d,%d,%d  faces %d", zone->lod, edges[0], edges[1], edges[2], edges[3], zone->nb_faces);)
+}
+
 /**
  * Remove not visible faces for a zone
  */
@@ -959,24 +1093,47 @@ VOID SAGE_TransformTerrain(SAGE_Camera *camera)
 {
   SAGE_Zone * zone;
   UWORD index;
+  BOOL use_tree, visible;
+  FLOAT error_ratio;
 
   SED(SAGE_DebugLog("** Transform terrain **");)
   SAGE_ClearTransformedVertices(sage_world.transformed_vertices, sage_world.terrain.nb_vertices);
   sage_world.metrics.total_vertices += sage_world.terrain.nb_vertices;
+  use_tree = sage_world.use_trees && !sage_world.terrain.tree.dirty;
+  if (use_tree) {
+    SAGE_CullBoundingTree(&sage_world.terrain.tree, camera);
+  }
+  // A height error of one unit at this distance is one pixel of max screen error
+  error_ratio = 0.0;
+  if (sage_world.terrain.lod_max > S3DE_LOD_FULL) {
+    error_ratio = camera->view_dist / sage_world.terrain.lod_error;
+  }
+  // All levels should be known before stitching the zones
   for (index = 0;index < sage_world.terrain.nb_zones;index++) {
     zone = sage_world.terrain.zones[index];
     if (zone != NULL && !zone->disabled) {
       SED(SAGE_DebugLog("** Processing zone %d", index);)
       sage_world.metrics.total_zones++;
-      sage_world.metrics.total_faces += zone->nb_faces;
-      if (SAGE_TerrainZoneVisibility(zone, camera)) {
-        sage_world.metrics.rendered_zones++;
-        SAGE_TerrainZoneLevelOfDetail(zone, camera);
-        SAGE_TerrainZoneBackfaceCulling(&sage_world.terrain, zone, camera, sage_world.transformed_vertices);
-        SAGE_TerrainZoneWorldToCamera(&sage_world.terrain, zone, camera, sage_world.transformed_vertices);
-        if (zone->clipped) {
-          SAGE_TerrainZoneFaceClipping(&sage_world.terrain, zone, camera, sage_world.transformed_vertices);
-        }
+      sage_world.metrics.total_faces += S3DT_ZONE_FACES;
+      if (use_tree) {
+        visible = SAGE_BoundingItemVisibility(&sage_world.terrain.tree, index, &zone->culled, &zone->clipped);
+      } else {
+        visible = SAGE_TerrainZoneVisibility(zone, camera);
+      }
+      if (visible) {
+        SAGE_TerrainZoneLevelOfDetail(&sage_world.terrain, zone, camera, error_ratio);
+      }
+    }
+  }
+  for (index = 0;index < sage_world.terrain.nb_zones;index++) {
+    zone = sage_world.terrain.zones[index];
+    if (zone != NULL && !zone->disabled && !zone->culled) {
+      sage_world.metrics.rendered_zones++;
+      SAGE_TerrainZoneStitching(&sage_world.terrain, zone, index);
+      SAGE_TerrainZoneBackfaceCulling(&sage_world.terrain, zone, camera, sage_world.transformed_vertices);
+      SAGE_TerrainZoneWorldToCamera(&sage_world.terrain, zone, camera, sage_world.transformed_vertices);
+      if (zone->clipped) {
+        SAGE_TerrainZoneFaceClipping(&sage_world.terrain, zone, camera, sage_world.transformed_vertices);
       }
     }
   }
@@ -985,7 +1142,7 @@ VOID SAGE_TransformTerrain(SAGE_Camera *camera)
   for (index = 0;index < sage_world.terrain.nb_zones;index++) {
     zone = sage_world.terrain.zones[index];
     if (zone != NULL && !zone->disabled && !zone->culled) {
-      SAGE_SetClippedFaceList(sage_world.transformed_vertices, zone->faces, zone->nb_faces, camera);
+      SAGE_SetClippedFaceList(sage_world.transformed_vertices, zone->faces, zone->nb_faces, camera, S3DE_KEY_ZONE | ((ULONG)index << S3DE_KEY_OWNER));
     }
   }
 }
@@ -1003,49 +1160,14 @@ VOID SAGE_TransformTerrain(SAGE_Camera *camera)
  */
 BOOL SAGE_EntityVisibility(SAGE_Entity *entity, SAGE_Camera *camera)
 {
-  FLOAT cx, cy, cz, x, y ,z;
-  FLOAT radius, xplane, yplane;
+  UWORD status;
 
   SED(SAGE_DebugLog("** SAGE_EntityVisibility()");)
-  entity->culled = TRUE;
-  cx = entity->posx - camera->posx;
-  cy = entity->posy - camera->posy;
-  cz = entity->posz - camera->posz;
-  x = cx*CameraMatrix.m11 + cy*CameraMatrix.m21 + cz*CameraMatrix.m31;
-  y = cx*CameraMatrix.m12 + cy*CameraMatrix.m22 + cz*CameraMatrix.m32;
-  z = cx*CameraMatrix.m13 + cy*CameraMatrix.m23 + cz*CameraMatrix.m33;
-  radius = entity->radius;
-  SED(SAGE_DebugLog("  => x %f  y %f  z %f  r %f", x, y, z, radius);)
-  // Check against Z planes
-  if (((z-radius) > camera->far_plane) || ((z+radius) < camera->near_plane)) {
-    SED(SAGE_DebugLog("  => this entity is outside (far or near)");)
-    return FALSE;
-  }
-  // Check against X planes
-  xplane = (camera->centerx * z) / camera->view_dist;
-  if (((x-radius) > xplane) || ((x+radius) < -xplane)) {
-    SED(SAGE_DebugLog("  => this entity is outside (X plane)");)
-    return FALSE;
-  }
-  // Check against Y planes
-  yplane = (camera->centery * z) / camera->view_dist;
-  if (((y-radius) > yplane) || ((y+radius) < -yplane)) {
-    SED(SAGE_DebugLog("  => this entity is outside (Y plane)");)
-    return FALSE;
-  }
-  // Check for partial clipping
-  if (((z+radius) > camera->far_plane) || ((z-radius) < camera->near_plane)) {
-    entity->clipped = TRUE;
-  } else if (((x+radius) > xplane) || ((x-radius) < -xplane)) {
-    entity->clipped = TRUE;
-  } else if (((y+radius) > yplane) || ((y-radius) < -yplane)) {
-    entity->clipped = TRUE;
-  } else {
-    entity->clipped = FALSE;
-  }
-  entity->culled = FALSE;
-  SED(SAGE_DebugLog("  => this entity is visible");)
-  return TRUE;
+  status = SAGE_SphereVisibility(entity->posx, entity->posy, entity->posz, entity->radius, camera);
+  entity->culled = (status == S3DE_TREE_OUTSIDE);
+  entity->clipped = (status == S3DE_TREE_CLIPPED);
+  SED(SAGE_DebugLog("  => this entity is %s", (entity->culled ? "outside" : "visible"));)
+  return (BOOL)!entity->culled;
 }
 
 /**
@@ -1211,6 +1333,217 @@ VOID SAGE_EntityFaceClipping(SAGE_Entity *entity, SAGE_Camera *camera, SAGE_Tran
   }
 }
 
+/*****************************************************************************
+ *            ENTITIES STREAMS TRANSFORMATIONS
+ *****************************************************************************/
+
+/**
+ * Remove not visible faces for an entity using the world coordinates streams
+ */
+VOID SAGE_EntityStreamBackfaceCulling(SAGE_Entity *entity, SAGE_Camera *camera, SAGE_VertexStreams *streams)
+{
+  UWORD index, point;
+  FLOAT res, x, y, z;
+  SAGE_Vector sight, normal;
+
+  SED(SAGE_DebugLog("** SAGE_EntityStreamBackfaceCulling()");)
+  for (index = 0;index < entity->nb_faces;index++) {
+    // Transform face normal to world space
+    x = entity->normals[index].x;
+    y = entity->normals[index].y;
+    z = entity->normals[index].z;
+    normal.x = x*EntityMatrix.m11 + y*EntityMatrix.m21 + z*EntityMatrix.m31;
+    normal.y = x*EntityMatrix.m12 + y*EntityMatrix.m22 + z*EntityMatrix.m32;
+    normal.z = x*EntityMatrix.m13 + y*EntityMatrix.m23 + z*EntityMatrix.m33;
+    // Build the camera sight, vertices are already in world space
+    point = entity->faces[index].p1;
+    sight.x = camera->posx - streams->x[point];
+    sight.y = camera->posy - streams->y[point];
+    sight.z = camera->posz - streams->z[point];
+    // Check face visibility (u*v = xu*xv + yu*yv + zu*zv)
+    res = (normal.x*sight.x) + (normal.y*sight.y) + (normal.z*sight.z);
+    if (res > 0.0) {
+      entity->faces[index].culled = FALSE;
+      // Set all faces vertices as visible
+      S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      point = entity->faces[index].p2;
+      S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      point = entity->faces[index].p3;
+      S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      if (entity->faces[index].is_quad) {
+        point = entity->faces[index].p4;
+        S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      }
+      SED(SAGE_DebugLog(" => face %d is visible", index);)
+    } else {
+      entity->faces[index].culled = TRUE;
+      SED(SAGE_DebugLog(" => face %d is culled", index);)
+    }
+    entity->faces[index].clipped = S3DE_NOCLIP;
+  }
+}
+
+/**
+ * Check if entity faces are clipped using the camera coordinates streams
+ */
+VOID SAGE_EntityStreamFaceClipping(SAGE_Entity *entity, SAGE_Camera *camera, SAGE_VertexStreams *streams)
+{
+  UWORD index, p1, p2, p3, p4;
+  FLOAT nearp, farp, x1plane, y1plane, x2plane, y2plane, x3plane, y3plane, x4plane, y4plane;
+  FLOAT x1, y1, z1, x2, y2, z2, x3, y3, z3, x4, y4, z4;
+
+  SED(SAGE_DebugLog("** SAGE_EntityStreamFaceClipping()");)
+  nearp = camera->near_plane;
+  farp = camera->far_plane;
+  for (index = 0;index < entity->nb_faces;index++) {
+    if (!entity->faces[index].culled) {
+      p1 = entity->faces[index].p1;
+      x1 = streams->x[p1]; y1 = streams->y[p1]; z1 = streams->z[p1];
+      p2 = entity->faces[index].p2;
+      x2 = streams->x[p2]; y2 = streams->y[p2]; z2 = streams->z[p2];
+      p3 = entity->faces[index].p3;
+      x3 = streams->x[p3]; y3 = streams->y[p3]; z3 = streams->z[p3];
+      if (entity->faces[index].is_quad) {
+        p4 = entity->faces[index].p4;
+        x4 = streams->x[p4]; y4 = streams->y[p4]; z4 = streams->z[p4];
+      } else {
+        x4 = x3; y4 = y3; z4 = z3;
+      }
+      // Check if the face is outside of X planes
+      x1plane = (camera->centerx * z1) / camera->view_dist;
+      x2plane = (camera->centerx * z2) / camera->view_dist;
+      x3plane = (camera->centerx * z3) / camera->view_dist;
+      x4plane = (camera->centerx * z4) / camera->view_dist;
+      if ((x1>x1plane && x2>x2plane && x3>x3plane && x4>x4plane) || (x1<-x1plane && x2<-x2plane && x3<-x3plane && x4<-x4plane)) {
+        entity->faces[index].culled = TRUE;
+      } else {
+        // Check if the face is outside of Y planes
+        y1plane = (camera->centery * z1) / camera->view_dist;
+        y2plane = (camera->centery * z2) / camera->view_dist;
+        y3plane = (camera->centery * z3) / camera->view_dist;
+        y4plane = (camera->centery * z4) / camera->view_dist;
+        if ((y1>y1plane && y2>y2plane && y3>y3plane && y4>y4plane) || (y1<-y1plane && y2<-y2plane && y3<-y3plane && y4<-y4plane)) {
+          entity->faces[index].culled = TRUE;
+        } else {
+          // Check if the face is totally or partially outside of Z planes
+          if ((z1<nearp && z2<nearp && z3<nearp && z4<nearp) || (z1>farp && z2>farp && z3>farp && z4>farp)) {
+            entity->faces[index].culled = TRUE;
+          } else {
+            entity->faces[index].clipped = S3DE_NOCLIP;
+            if (z1 < nearp) entity->faces[index].clipped |= S3DE_P1CLIP;
+            if (z2 < nearp) entity->faces[index].clipped |= S3DE_P2CLIP;
+            if (z3 < nearp) entity->faces[index].clipped |= S3DE_P3CLIP;
+            if (z4 < nearp) entity->faces[index].clipped |= S3DE_P4CLIP;
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Copy a stream vertex to the transformed vertices buffer
+ */
+VOID SAGE_StreamToTransformedVertex(SAGE_VertexStreams *streams, SAGE_TransformedVertex *vertices, UWORD point)
+{
+  vertices[point].cx = streams->x[point];
+  vertices[point].cy = streams->y[point];
+  vertices[point].cz = streams->z[point];
+  vertices[point].px = streams->px[point];
+  vertices[point].py = streams->py[point];
+  vertices[point].pz = streams->z[point];
+  vertices[point].iz = streams->iz[point];
+}
+
+/**
+ * Add a not clipped face to render list from the streams
+ */
+VOID SAGE_AddStreamFace(SAGE_VertexStreams *streams, SAGE_Face *face)
+{
+  SAGE_3DElement element;
+
+  SED(SAGE_DebugLog("** SAGE_AddStreamFace()");)
+  element.type = (face->is_quad ? S3DR_ELEM_QUAD : S3DR_ELEM_TRIANGLE);
+  element.x1 = streams->px[face->p1];
+  element.y1 = streams->py[face->p1];
+  element.z1 = streams->z[face->p1];
+  element.u1 = face->u1;
+  element.v1 = face->v1;
+  element.x2 = streams->px[face->p2];
+  element.y2 = streams->py[face->p2];
+  element.z2 = streams->z[face->p2];
+  element.u2 = face->u2;
+  element.v2 = face->v2;
+  element.x3 = streams->px[face->p3];
+  element.y3 = streams->py[face->p3];
+  element.z3 = streams->z[face->p3];
+  element.u3 = face->u3;
+  element.v3 = face->v3;
+  if (face->is_quad) {
+    element.x4 = streams->px[face->p4];
+    element.y4 = streams->py[face->p4];
+    element.z4 = streams->z[face->p4];
+    element.u4 = face->u4;
+    element.v4 = face->v4;
+  }
+  element.texture = face->texture;
+  element.color = face->color;
+  SED(SAGE_Dump3DElement(&element);)
+  SAGE_Push3DElement(&element);
+  sage_world.metrics.rendered_elements++;
+}
+
+/**
+ * Set the list of faces to render from the streams
+ * Faces crossing the near plane are handed to the standard clipping code
+ */
+VOID SAGE_SetStreamFaceList(SAGE_VertexStreams *streams, SAGE_Face *faces, UWORD nb_faces, SAGE_Camera *camera, ULONG key)
+{
+  UWORD index;
+  SAGE_Face *face;
+
+  SED(SAGE_DebugLog("** SAGE_SetStreamFaceList(nb_faces %d)", nb_faces);)
+  for (index = 0;index < nb_faces;index++) {
+    face = &(faces[index]);
+    if (!face->culled) {
+      if (face->clipped == S3DE_NOCLIP) {
+        SAGE_Set3DElementKey(key + ((ULONG)index << S3DE_KEY_FACE));
+        SAGE_AddStreamFace(streams, face);
+        sage_world.metrics.rendered_faces++;
+      } else {
+        SAGE_StreamToTransformedVertex(streams, sage_world.transformed_vertices, face->p1);
+        SAGE_StreamToTransformedVertex(streams, sage_world.transformed_vertices, face->p2);
+        SAGE_StreamToTransformedVertex(streams, sage_world.transformed_vertices, face->p3);
+        if (face->is_quad) {
+          SAGE_StreamToTransformedVertex(streams, sage_world.transformed_vertices, face->p4);
+        }
+        SAGE_SetClippedFaceList(sage_world.transformed_vertices, face, 1, camera, key + ((ULONG)index << S3DE_KEY_FACE));
+      }
+    }
+  }
+}
+
+/**
+ * Transform an entity to camera view with the vertex streams and build element list
+ */
+VOID SAGE_TransformStreamEntity(SAGE_Entity *entity, SAGE_Camera *camera, ULONG key)
+{
+  SAGE_VertexStreams *streams;
+
+  SED(SAGE_DebugLog("** SAGE_TransformStreamEntity()");)
+  streams = &sage_world.vertex_streams;
+  SAGE_ClearStreamVisibility(streams, entity->nb_vertices);
+  SAGE_StreamLocalToWorld(streams, entity->vertices, entity->nb_vertices, &EntityMatrix, entity->posx, entity->posy, entity->posz);
+  sage_world.metrics.calculated_vertices += entity->nb_vertices;
+  SAGE_EntityStreamBackfaceCulling(entity, camera, streams);
+  SAGE_StreamWorldToCamera(streams, entity->nb_vertices, &CameraMatrix, camera->posx, camera->posy, camera->posz);
+  if (entity->clipped) {
+    SAGE_EntityStreamFaceClipping(entity, camera, streams);
+  }
+  sage_world.metrics.rendered_vertices += SAGE_StreamProjection(streams, entity->nb_vertices, camera->view_dist, camera->centerx, camera->centery);
+  SAGE_SetStreamFaceList(streams, entity->faces, entity->nb_faces, camera, key);
+}
+
 /**
  * Transform entities to camera view and build element list
  */
@@ -1218,8 +1551,17 @@ VOID SAGE_TransformEntities(SAGE_Camera *camera)
 {
   SAGE_Entity * entity;
   UWORD index;
+  BOOL use_tree, visible;
 
   SED(SAGE_DebugLog("** Transform entities **");)
+  use_tree = FALSE;
+  if (sage_world.use_trees) {
+    if (!sage_world.entity_tree.dirty || SAGE_BuildEntityTree()) {
+      SAGE_RefreshEntityTree();
+      SAGE_CullBoundingTree(&sage_world.entity_tree, camera);
+      use_tree = TRUE;
+    }
+  }
   for (index = 0;index < S3DE_MAX_ENTITIES;index++) {
     entity = sage_world.entities[index];
     if (entity != NULL && !entity->disabled) {
@@ -1227,18 +1569,27 @@ VOID SAGE_TransformEntities(SAGE_Camera *camera)
       sage_world.metrics.total_entities++;
       sage_world.metrics.total_vertices += entity->nb_vertices;
       sage_world.metrics.total_faces += entity->nb_faces;
-      if (SAGE_EntityVisibility(entity, camera)) {
+      if (use_tree) {
+        visible = SAGE_BoundingItemVisibility(&sage_world.entity_tree, index, &entity->culled, &entity->clipped);
+      } else {
+        visible = SAGE_EntityVisibility(entity, camera);
+      }
+      if (visible) {
         sage_world.metrics.rendered_entities++;
-        SAGE_ClearTransformedVertices(sage_world.transformed_vertices, entity->nb_vertices);
         SAGE_SetupEntityMatrix(entity);
-        SAGE_EntityBackfaceCulling(entity, camera, sage_world.transformed_vertices);
-        SAGE_EntityLocalToWorld(entity, sage_world.transformed_vertices);
-        SAGE_EntityWorldToCamera(entity, camera, sage_world.transformed_vertices);
-        if (entity->clipped) {
-          SAGE_EntityFaceClipping(entity, camera, sage_world.transformed_vertices);
+        if (sage_world.use_streams) {
+          SAGE_TransformStreamEntity(entity, camera, S3DE_KEY_ENTITY | ((ULONG)index << S3DE_KEY_OWNER));
+        } else {
+          SAGE_ClearTransformedVertices(sage_world.transformed_vertices, entity->nb_vertices);
+          SAGE_EntityBackfaceCulling(entity, camera, sage_world.transformed_vertices);
+          SAGE_EntityLocalToWorld(entity, sage_world.transformed_vertices);
+          SAGE_EntityWorldToCamera(entity, camera, sage_world.transformed_vertices);
+          if (entity->clipped) {
+            SAGE_EntityFaceClipping(entity, camera, sage_world.transformed_vertices);
+          }
+          SAGE_VerticesProjection(sage_world.transformed_vertices, entity->nb_vertices, camera);
+          SAGE_SetClippedFaceList(sage_world.transformed_vertices, entity->faces, entity->nb_faces, camera, S3DE_KEY_ENTITY | ((ULONG)index << S3DE_KEY_OWNER));
         }
-        SAGE_VerticesProjection(sage_world.transformed_vertices, entity->nb_vertices, camera);
-        SAGE_SetClippedFaceList(sage_world.transformed_vertices, entity->faces, entity->nb_faces, camera);
       }
     }
   }
@@ -1250,6 +1601,107 @@ VOID SAGE_TransformEntities(SAGE_Camera *camera)
  *            3D WORLD RENDERING
  *****************************************************************************/
 
+/**
+ * Release the vertex streams
+ */
+VOID SAGE_ReleaseVertexStreams(VOID)
+{
+  SAGE_VertexStreams *streams;
+
+  streams = &sage_world.vertex_streams;
+  if (streams->x != NULL) {
+    SAGE_FreeMem(streams->x);
+  }
+  if (streams->y != NULL) {
+    SAGE_FreeMem(streams->y);
+  }
+  if (streams->z != NULL) {
+    SAGE_FreeMem(streams->z);
+  }
+  if (streams->px != NULL) {
+    SAGE_FreeMem(streams->px);
+  }
+  if (streams->py != NULL) {
+    SAGE_FreeMem(streams->py);
+  }
+  if (streams->iz != NULL) {
+    SAGE_FreeMem(streams->iz);
+  }
+  if (streams->visible != NULL) {
+    SAGE_FreeMem(streams->visible);
+  }
+  memset(streams, 0, sizeof(SAGE_VertexStreams));
+  sage_world.use_streams = FALSE;
+}
+
+/**
+ * Allocate the vertex streams
+ */
+BOOL SAGE_AllocateVertexStreams(VOID)
+{
+  SAGE_VertexStreams *streams;
+
+  streams = &sage_world.vertex_streams;
+  if (streams->x != NULL) {
+    return TRUE;
+  }
+  streams->x = (FLOAT *)SAGE_AllocMem(sizeof(FLOAT) * S3DE_MAX_VERTICES);
+  streams->y = (FLOAT *)SAGE_AllocMem(sizeof(FLOAT) * S3DE_MAX_VERTICES);
+  streams->z = (FLOAT *)SAGE_AllocMem(sizeof(FLOAT) * S3DE_MAX_VERTICES);
+  streams->px = (FLOAT *)SAGE_AllocMem(sizeof(FLOAT) * S3DE_MAX_VERTICES);
+  streams->py = (FLOAT *)SAGE_AllocMem(sizeof(FLOAT) * S3DE_MAX_VERTICES);
+  streams->iz = (FLOAT *)SAGE_AllocMem(sizeof(FLOAT) * S3DE_MAX_VERTICES);
+  streams->visible = (ULONG *)SAGE_AllocMem(sizeof(ULONG) * S3DE_STREAM_WORDS(S3DE_MAX_VERTICES));
+  if (streams->x != NULL && streams->y != NULL && streams->z != NULL && streams->px != NULL
+    && streams->py != NULL && streams->iz != NULL && streams->visible != NULL) {
+    return TRUE;
+  }
+  SAGE_ReleaseVertexStreams();
+  return FALSE;
+}
+
+/**
+ * Enable/disable the vertex streams (structure of arrays) pipeline for entities
+ *
+ * @param status Vertex streams status
+ *
+ * @return New vertex streams status
+ */
+BOOL SAGE_EnableVertexStreams(BOOL status)
+{
+  if (status) {
+    SD(SAGE_DebugLog("Enable vertex streams");)
+    if (SAGE_AllocateVertexStreams()) {
+      sage_world.use_streams = TRUE;
+    }
+  } else {
+    SD(SAGE_DebugLog("Disable vertex streams");)
+    sage_world.use_streams = FALSE;
+  }
+  return sage_world.use_streams;
+}
+
+/**
+ * Enable/disable the bounding trees culling for terrain zones and entities
+ *
+ * @param status Bounding trees status
+ *
+ * @return New bounding trees status
+ */
+BOOL SAGE_EnableBoundingTrees(BOOL status)
+{
+  if (status) {
+    SD(SAGE_DebugLog("Enable bounding trees");)
+    if (sage_world.entity_tree.nodes != NULL) {
+      sage_world.use_trees = TRUE;
+    }
+  } else {
+    SD(SAGE_DebugLog("Disable bounding trees");)
+    sage_world.use_trees = FALSE;
+  }
+  return sage_world.use_trees;
+}
+
 /**
  * Init the 3D engine
  */
@@ -1262,10 +1714,16 @@ BOOL SAGE_Init3DEngine(VOID)
   sage_world.active_skybox = FALSE;
   sage_world.active_terrain = FALSE;
   sage_world.nb_entities = 0;
+  sage_world.use_streams = FALSE;
+  memset(&sage_world.vertex_streams, 0, sizeof(SAGE_VertexStreams));
   sage_world.transformed_vertices = (SAGE_TransformedVertex *)SAGE_AllocMem(sizeof(SAGE_TransformedVertex) * (S3DE_MAX_VERTICES+S3DE_CLIP_VERTICES));
   if (sage_world.transformed_vertices == NULL) {
     return FALSE;
   }
+  if (!SAGE_AllocBoundingTree(&sage_world.entity_tree, S3DE_MAX_ENTITIES)) {
+    return FALSE;
+  }
+  sage_world.use_trees = TRUE;
   return TRUE;
 }
 
@@ -1278,10 +1736,12 @@ VOID SAGE_Release3DEngine()
   if (sage_world.transformed_vertices != NULL) {
     SAGE_FreeMem(sage_world.transformed_vertices);
   }
+  SAGE_ReleaseVertexStreams();
   if (sage_world.active_terrain) {
     SAGE_ReleaseTerrain();
   }
   SAGE_FlushEntities();
+  SAGE_ReleaseBoundingTree(&sage_world.entity_tree);
   SAGE_FlushCameras();
   SAGE_FlushTextures();
   SAGE_FlushMaterials();
@@ -1304,6 +1764,11 @@ VOID SAGE_ClearEngineMetrics(VOID)
   sage_world.metrics.rendered_faces = 0;
   sage_world.metrics.total_faces = 0;
   sage_world.metrics.rendered_elements = 0;
+  sage_world.metrics.moved_elements = 0;
+  sage_world.metrics.tested_nodes = 0;
+  sage_world.metrics.rejected_triangles = 0;
+  sage_world.metrics.rejected_tiles = 0;
+  sage_world.metrics.cleared_tiles = 0;
 }
 
 /**
@@ -1322,10 +1787,16 @@ VOID SAGE_RenderWorld(VOID)
     SAGE_SetupCameraMatrix(camera);
 #if SAGE_ENABLE_SKYBOX == 1
     if (sage_world.active_skybox) {
+      SAGE_Set3DSortHistory(S3DE_SORT_SKYBOX);
       SAGE_TransformSkybox(camera);
       SAGE_Render3DElements();
+      sage_world.metrics.moved_elements += SAGE_GetMoved3DElements();
+      sage_world.metrics.rejected_triangles += SAGE_GetRejected3DTriangles();
+      sage_world.metrics.rejected_tiles += SAGE_GetRejected3DTiles();
+      sage_world.metrics.cleared_tiles += SAGE_GetCleared3DTiles();
     }
 #endif
+    SAGE_Set3DSortHistory(S3DE_SORT_WORLD);
 #if SAGE_ENABLE_TERRAIN == 1
     if (sage_world.active_terrain) {
       SAGE_TransformTerrain(camera);
@@ -1337,6 +1808,10 @@ VOID SAGE_RenderWorld(VOID)
     }
 #endif
     SAGE_Render3DElements();
+    sage_world.metrics.moved_elements += SAGE_GetMoved3DElements();
+    sage_world.metrics.rejected_triangles += SAGE_GetRejected3DTriangles();
+    sage_world.metrics.rejected_tiles += SAGE_GetRejected3DTiles();
+    sage_world.metrics.cleared_tiles += SAGE_GetCleared3DTiles();
   }
 }
 
@@ -5,7 +5,7 @@
  * 3D entity management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <string.h>
@@ -19,6 +19,7 @@
 #include <sage/sage_memory.h>
 #include <sage/sage_loadlwo.h>
 #include <sage/sage_loadobj.h>
+#include <sage/sage_loadsen.h>
 #include <sage/sage_screen.h>
 #include <sage/sage_3dtexture.h>
 #include <sage/sage_3dentity.h>
@@ -123,12 +124,14 @@ VOID SAGE_DumpRemapVertex(SAGE_RemapVertex *remap, UWORD nb_vertices)
 SAGE_Entity *SAGE_CreateEntity(UWORD nb_vertices, UWORD nb_faces)
 {
   SAGE_Entity *entity;
+  UWORD tag;
 
   SD(SAGE_DebugLog("Create entity (%d, %d)", nb_vertices, nb_faces);)
   if (nb_vertices >= S3DE_MAX_VERTICES) {
     SAGE_SetError(SERR_ENTITY_SIZE);
     return NULL;
   }
+  tag = SAGE_SetMemoryTag(SMEM_TAG_ENTITY);
   entity = (SAGE_Entity *)SAGE_AllocMem(sizeof(SAGE_Entity));
   if (entity != NULL) {
     entity->nb_vertices = nb_vertices;
@@ -136,6 +139,9 @@ SAGE_Entity *SAGE_CreateEntity(UWORD nb_vertices, UWORD nb_faces)
     entity->vertices = (SAGE_Vertex *)SAGE_AllocMem(sizeof(SAGE_Vertex) * nb_vertices);
     entity->faces = (SAGE_Face *)SAGE_AllocMem(sizeof(SAGE_Face) * nb_faces);
     entity->normals = (SAGE_Vector *)SAGE_AllocMem(sizeof(SAGE_Vector) * nb_faces);
+  }
+  SAGE_SetMemoryTag(tag);
+  if (entity != NULL) {
     if (entity->vertices != NULL && entity->faces != NULL && entity->normals != NULL) {
       return entity;
     }
@@ -352,6 +358,18 @@ UWORD SAGE_GetEntityFileType(BPTR file_handle)
   BYTE byte;
   LONG bytes_read, entity_tag;
 
+  // Check for SAGE binary entity
+  bytes_read = Seek(file_handle, 0, OFFSET_BEGINNING);
+  bytes_read = Read(file_handle, &entity_tag, 4);
+  if (bytes_read != 4) {
+    SAGE_SetError(SERR_READFILE);
+    return S3DE_UNDEFINED;
+  }
+  if (entity_tag == S3DE_SENTAG) {
+    SD(SAGE_DebugLog("This is a SAGE binary entity");)
+    bytes_read = Seek(file_handle, 0, OFFSET_BEGINNING);
+    return S3DE_SENT;
+  }
   // Check for Ligthwave object
   bytes_read = Seek(file_handle, S3DE_LWOBOFFSET, OFFSET_BEGINNING);
   bytes_read = Read(file_handle, &entity_tag, 4);
@@ -386,10 +404,11 @@ SAGE_Entity *SAGE_LoadEntity(STRPTR filename)
 {
   SAGE_Entity *entity;
   BPTR file_handle;
-  UWORD type;
+  UWORD type, tag;
 
   SD(SAGE_DebugLog("Load entity %s", filename);)
   entity = NULL;
+  tag = SAGE_SetMemoryTag(SMEM_TAG_ENTITY);
   file_handle = Open(filename, MODE_OLDFILE);
   if (file_handle != 0) {
     type = SAGE_GetEntityFileType(file_handle);
@@ -397,6 +416,8 @@ SAGE_Entity *SAGE_LoadEntity(STRPTR filename)
       entity = SAGE_LoadLWO(file_handle);
     } else if (type == S3DE_WFOB) {
       entity = SAGE_LoadOBJ(file_handle, filename);
+    } else if (type == S3DE_SENT) {
+      entity = SAGE_LoadSEN(file_handle, filename);
     } else {
       SAGE_SetError(SERR_FILEFORMAT);
     }
@@ -404,6 +425,7 @@ SAGE_Entity *SAGE_LoadEntity(STRPTR filename)
   } else {
     SAGE_SetError(SERR_OPENFILE);
   }
+  SAGE_SetMemoryTag(tag);
   return entity;
 }
 
@@ -452,6 +474,38 @@ VOID SAGE_SetEntityNormals(SAGE_Entity *entity)
   }
 }
 
+/**
+ * Refit the entities tree after the entity has moved
+ */
+VOID SAGE_RefitEntityTree(UWORD index, SAGE_Entity *entity)
+{
+  if (!sage_world.entity_tree.dirty) {
+    SAGE_SetBoundingSphere(&sage_world.entity_tree, index, entity->posx, entity->posy, entity->posz, entity->radius);
+    SAGE_RefitBoundingTree(&sage_world.entity_tree, index);
+  }
+}
+
+/**
+ * Refit the entities tree for the entities whose bounding sphere has changed
+ * since the last refit (radius computed again, position set directly)
+ */
+VOID SAGE_RefreshEntityTree(VOID)
+{
+  SAGE_BoundingSphere *sphere;
+  SAGE_Entity *entity;
+  UWORD index;
+
+  for (index = 0;index < S3DE_MAX_ENTITIES;index++) {
+    entity = sage_world.entities[index];
+    if (entity != NULL) {
+      sphere = &(sage_world.entity_tree.spheres[index]);
+      if (sphere->radius != entity->radius || sphere->posx != entity->posx || sphere->posy != entity->posy || sphere->posz != entity->posz) {
+        SAGE_RefitEntityTree(index, entity);
+      }
+    }
+  }
+}
+
 /**
  * Add an entity to the world
  */
@@ -468,6 +522,7 @@ BOOL SAGE_AddEntity(UWORD index, SAGE_Entity *entity)
   }
   sage_world.entities[index] = entity;
   sage_world.nb_entities++;
+  sage_world.entity_tree.dirty = TRUE;
   return TRUE;
 }
 
@@ -485,6 +540,7 @@ VOID SAGE_RemoveEntity(UWORD index)
       SAGE_ReleaseEntity(entity);
       sage_world.entities[index] = NULL;
       sage_world.nb_entities--;
+      sage_world.entity_tree.dirty = TRUE;
     }
   } else {
     SAGE_SetError(SERR_ENTITY_INDEX);
@@ -506,6 +562,7 @@ VOID SAGE_FlushEntities()
     sage_world.entities[index] = NULL;
   }
   sage_world.nb_entities = 0;
+  sage_world.entity_tree.dirty = TRUE;
 }
 
 /**
@@ -586,6 +643,7 @@ BOOL SAGE_SetEntityPosition(UWORD index, FLOAT posx, FLOAT posy, FLOAT posz)
     entity->posx = posx;
     entity->posy = posy;
     entity->posz = posz;
+    SAGE_RefitEntityTree(index, entity);
     return TRUE;
   }
   return FALSE;
@@ -603,6 +661,7 @@ BOOL SAGE_MoveEntity(UWORD index, FLOAT dx, FLOAT dy, FLOAT dz)
     entity->posx += dx;
     entity->posy += dy;
     entity->posz += dz;
+    SAGE_RefitEntityTree(index, entity);
     return TRUE;
   }
   return FALSE;
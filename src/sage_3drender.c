@@ -5,7 +5,7 @@
  * 3D rendering management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 10/03/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <exec/types.h>
@@ -24,6 +24,7 @@
 #include <sage/sage_3dtexture.h>
 #include <sage/sage_3dtexmap.h>
 #include <sage/sage_3drender.h>
+#include <sage/sage_3dsort.h>
 
 #include <sage/sage_debug.h>
 
@@ -97,6 +98,11 @@ VOID SAGE_DumpRenderModeState(VOID)
     SAGE_DebugLog(" - Gouraud shading is %s", ((states&S3DR_GOURAUD) ? "active" : "inactive"));
     SAGE_DebugLog(" - Bilinear filtering is %s", ((states&S3DR_BILINEAR) ? "active" : "inactive"));
     SAGE_DebugLog(" - Fogging is %s", ((states&S3DR_FOGGING) ? "active" : "inactive"));
+    SAGE_DebugLog(" - Radix sort is %s", ((states&S3DR_RADIXSORT) ? "active" : "inactive"));
+    SAGE_DebugLog(" - Coherent sort is %s", ((states&S3DR_COHERENTSORT) ? "active" : "inactive"));
+    SAGE_DebugLog(" - Hi-Z buffer is %s", ((states&S3DR_HIZBUFFER) ? "active" : "inactive"));
+    SAGE_DebugLog(" - Lazy Z buffer clear is %s", ((states&S3DR_LAZYZBUFFER) ? "active" : "inactive"));
+    SAGE_DebugLog(" - Reference mappers are %s", ((states&S3DR_REFMAPPER) ? "active" : "inactive"));
   } else {
     SAGE_DebugLog("3D Device not available !");
   }
@@ -114,11 +120,60 @@ BOOL SAGE_Init3DRender()
 {
   if (SageContext.Sage3D != NULL) {
     SageContext.Sage3D->render.render_elements = 0;
+    SageContext.Sage3D->render.element_key = 0;
     SageContext.Sage3D->render.render_mode = S3DR_RENDER_TEXT;
+    SAGE_ClearSortHistory(&(SageContext.Sage3D->render));
   }
   return TRUE;
 }
 
+/**
+ * Release the rendering queue bloc and forget the sort histories
+ */
+VOID SAGE_Release3DRender()
+{
+  SAGE_Render *render;
+  UWORD history;
+
+  if (SageContext.Sage3D != NULL) {
+    render = &(SageContext.Sage3D->render);
+    if (render->ordered_elements != NULL) {
+      SAGE_FreeMem(render->ordered_elements);
+    }
+    render->max_elements = 0;
+    render->render_elements = 0;
+    render->ordered_elements = NULL;
+    render->sort_buffer = NULL;
+    render->s3d_elements = NULL;
+    render->sort_keys[0] = NULL;
+    render->sort_keys[1] = NULL;
+    render->element_keys = NULL;
+    render->key_table = NULL;
+    for (history = 0;history < S3DR_SORT_HISTORIES;history++) {
+      render->history_keys[history] = NULL;
+    }
+    SAGE_ClearSortHistory(render);
+  }
+}
+
+/**
+ * Mark all the tiles as stale, epoch 0 is never a current epoch
+ *
+ * @param zbuffer Z buffer
+ */
+VOID SAGE_ResetZBufferEpochs(SAGE_ZBuffer *zbuffer)
+{
+  UBYTE *epochs;
+  ULONG index, nb_tiles;
+
+  epochs = zbuffer->epochs;
+  nb_tiles = zbuffer->tiles_width * zbuffer->tiles_height;
+  for (index = 0;index < nb_tiles;index++) {
+    *epochs++ = 0;
+  }
+  zbuffer->epoch = 0;
+}
+
 /**
  * Allocate the Z buffer
  *
@@ -145,6 +200,8 @@ BOOL SAGE_AllocateZBuffer()
     }
     M3D_SetState(SageContext.Sage3D->m3d_context, M3D_ZBUFFER, M3D_ENABLE);
     SageContext.Sage3D->render.zbuffer.buffer = NULL;
+    SageContext.Sage3D->render.zbuffer.tiles = NULL;
+    SageContext.Sage3D->render.zbuffer.epochs = NULL;
   } else {
     // If Z-buffer is already allocated just return
     if (SageContext.Sage3D->render.zbuffer.buffer != NULL) {
@@ -159,6 +216,19 @@ BOOL SAGE_AllocateZBuffer()
     if (SageContext.Sage3D->render.zbuffer.buffer == NULL) {
       return FALSE;
     }
+    // Allocate the Hi-Z tiles
+    SageContext.Sage3D->render.zbuffer.tiles_width = (SageContext.Sage3D->render.zbuffer.width + S3DR_HIZ_SIZE - 1) >> S3DR_HIZ_SHIFT;
+    SageContext.Sage3D->render.zbuffer.tiles_height = (SageContext.Sage3D->render.zbuffer.height + S3DR_HIZ_SIZE - 1) >> S3DR_HIZ_SHIFT;
+    SageContext.Sage3D->render.zbuffer.tiles = (UWORD *) SAGE_AllocMem(
+      SageContext.Sage3D->render.zbuffer.tiles_width * SageContext.Sage3D->render.zbuffer.tiles_height * sizeof(UWORD)
+    );
+    SageContext.Sage3D->render.zbuffer.epochs = (UBYTE *) SAGE_AllocMem(
+      SageContext.Sage3D->render.zbuffer.tiles_width * SageContext.Sage3D->render.zbuffer.tiles_height
+    );
+    if (SageContext.Sage3D->render.zbuffer.tiles == NULL || SageContext.Sage3D->render.zbuffer.epochs == NULL) {
+      SAGE_ReleaseZBuffer();
+      return FALSE;
+    }
   }
   return TRUE;
 }
@@ -179,8 +249,16 @@ VOID SAGE_ReleaseZBuffer(VOID)
     if (SageContext.Sage3D->render.zbuffer.buffer != NULL) {
       SAGE_FreeMem(SageContext.Sage3D->render.zbuffer.buffer);
     }
+    if (SageContext.Sage3D->render.zbuffer.tiles != NULL) {
+      SAGE_FreeMem(SageContext.Sage3D->render.zbuffer.tiles);
+    }
+    if (SageContext.Sage3D->render.zbuffer.epochs != NULL) {
+      SAGE_FreeMem(SageContext.Sage3D->render.zbuffer.epochs);
+    }
   }
   SageContext.Sage3D->render.zbuffer.buffer = NULL;
+  SageContext.Sage3D->render.zbuffer.tiles = NULL;
+  SageContext.Sage3D->render.zbuffer.epochs = NULL;
 }
 
 /**
@@ -208,6 +286,118 @@ BOOL SAGE_EnableZBuffer(BOOL status)
   return (BOOL)(SageContext.Sage3D->render.options & S3DR_ZBUFFER);
 }
 
+/**
+ * Enable/disable Hi-Z buffer
+ * The Hi-Z buffer keeps the max depth of each 8x8 tile of the Z buffer, the
+ * internal renderer uses it to reject triangles and span bands hidden behind
+ * the tiles before mapping them, it needs the Z buffer to be active
+ *
+ * @param status Hi-Z buffer status
+ *
+ * @return New Hi-Z buffer status
+ */
+BOOL SAGE_EnableHiZBuffer(BOOL status)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  if (status && SageContext.Sage3D->render_system == S3DD_S3DRENDER) {
+    SD(SAGE_DebugLog("Enable Hi-Z buffer");)
+    if (SAGE_AllocateZBuffer()) {
+      SageContext.Sage3D->render.options |= S3DR_HIZBUFFER;
+    }
+  } else {
+    SD(SAGE_DebugLog("Disable Hi-Z buffer");)
+    SageContext.Sage3D->render.options &= ~S3DR_HIZBUFFER;
+  }
+  return (BOOL)(SageContext.Sage3D->render.options & S3DR_HIZBUFFER);
+}
+
+/**
+ * Enable/disable lazy Z buffer clear
+ * Each 8x8 tile of the Z buffer is tagged with a frame epoch, clearing the
+ * Z buffer only starts a new epoch and the internal renderer clears a tile
+ * the first time it draws in it during the frame, tags are reset when the
+ * epoch wraps
+ *
+ * @param status Lazy clear status
+ *
+ * @return New lazy clear status
+ */
+BOOL SAGE_EnableLazyZBuffer(BOOL status)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  if (status && SageContext.Sage3D->render_system == S3DD_S3DRENDER) {
+    SD(SAGE_DebugLog("Enable lazy Z buffer clear");)
+    if (SAGE_AllocateZBuffer()) {
+      SAGE_ResetZBufferEpochs(&(SageContext.Sage3D->render.zbuffer));
+      SageContext.Sage3D->render.options |= S3DR_LAZYZBUFFER;
+    }
+  } else {
+    SD(SAGE_DebugLog("Disable lazy Z buffer clear");)
+    SageContext.Sage3D->render.options &= ~S3DR_LAZYZBUFFER;
+  }
+  return (BOOL)(SageContext.Sage3D->render.options & S3DR_LAZYZBUFFER);
+}
+
+/**
+ * Enable/disable perspective correction of the textures
+ * The internal renderer computes the true texture coordinates every
+ * PERSP_SPAN pixels and interpolates them linearly in between
+ *
+ * @param status Perspective correction status
+ *
+ * @return New perspective correction status
+ */
+BOOL SAGE_EnablePerspective(BOOL status)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  if (SageContext.Sage3D->render_system == S3DD_W3DRENDER) {
+    W3D_SetState(SageContext.Sage3D->w3d_context, W3D_PERSPECTIVE, (status ? W3D_ENABLE : W3D_DISABLE));
+  }
+  if (status) {
+    SD(SAGE_DebugLog("Enable perspective correction");)
+    SageContext.Sage3D->render.options |= S3DR_PERSPECTIVE;
+  } else {
+    SD(SAGE_DebugLog("Disable perspective correction");)
+    SageContext.Sage3D->render.options &= ~S3DR_PERSPECTIVE;
+  }
+  return (BOOL)(SageContext.Sage3D->render.options & S3DR_PERSPECTIVE);
+}
+
+/**
+ * Enable/disable the C reference mappers
+ * The internal renderer maps the triangle spans with the portable C mappers
+ * instead of the fast assembler ones, both should render the same pixels so
+ * the reference mappers can check and measure any change of the fast ones
+ *
+ * @param status Reference mappers status
+ *
+ * @return New reference mappers status
+ */
+BOOL SAGE_EnableReferenceMappers(BOOL status)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  if (status && SageContext.Sage3D->render_system == S3DD_S3DRENDER) {
+    SD(SAGE_DebugLog("Enable reference mappers");)
+    SageContext.Sage3D->render.options |= S3DR_REFMAPPER;
+  } else {
+    SD(SAGE_DebugLog("Disable reference mappers");)
+    SageContext.Sage3D->render.options &= ~S3DR_REFMAPPER;
+  }
+  return (BOOL)(SageContext.Sage3D->render.options & S3DR_REFMAPPER);
+}
+
 /**
  * Enable/disable filtering
  *
@@ -239,6 +429,154 @@ BOOL SAGE_EnableFiltering(BOOL status)
   return (BOOL)(SageContext.Sage3D->render.options & S3DR_BILINEAR);
 }
 
+/**
+ * Enable/disable radix sort of the elements (quick sort is used otherwise)
+ *
+ * @param status Radix sort status
+ *
+ * @return New radix sort status
+ */
+BOOL SAGE_EnableRadixSort(BOOL status)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  if (status) {
+    SD(SAGE_DebugLog("Enable radix sort");)
+    SageContext.Sage3D->render.options |= S3DR_RADIXSORT;
+  } else {
+    SD(SAGE_DebugLog("Disable radix sort");)
+    SageContext.Sage3D->render.options &= ~S3DR_RADIXSORT;
+  }
+  return (BOOL)(SageContext.Sage3D->render.options & S3DR_RADIXSORT);
+}
+
+/**
+ * Enable/disable coherent sort of the elements
+ * Elements are put back in the order of the previous frame and an insertion
+ * pass fixes the few elements that changed depth order
+ *
+ * @param status Coherent sort status
+ *
+ * @return New coherent sort status
+ */
+BOOL SAGE_EnableCoherentSort(BOOL status)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  SAGE_ClearSortHistory(&(SageContext.Sage3D->render));
+  if (status) {
+    SD(SAGE_DebugLog("Enable coherent sort");)
+    SageContext.Sage3D->render.options |= S3DR_COHERENTSORT;
+  } else {
+    SD(SAGE_DebugLog("Disable coherent sort");)
+    SageContext.Sage3D->render.options &= ~S3DR_COHERENTSORT;
+  }
+  return (BOOL)(SageContext.Sage3D->render.options & S3DR_COHERENTSORT);
+}
+
+/**
+ * Select the element order history used by coherent sort, each rendering
+ * queue of a frame (skybox, world...) should use its own history
+ *
+ * @param history History index
+ *
+ * @return Operation success
+ */
+BOOL SAGE_Set3DSortHistory(UWORD history)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  if (history >= S3DR_SORT_HISTORIES) {
+    SAGE_SetError(SERR_SORT_HISTORY);
+    return FALSE;
+  }
+  SageContext.Sage3D->render.sort_history = history;
+  return TRUE;
+}
+
+/**
+ * Set the key of the next element pushed in the rendering queue, each push
+ * increments the key. Coherent sort finds the elements of the previous frame
+ * by their key, so a face should keep the same key from frame to frame. The
+ * elements pushed without a key are numbered from 0 after each flush.
+ *
+ * @param key Element key
+ *
+ * @return Operation success
+ */
+BOOL SAGE_Set3DElementKey(ULONG key)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  SageContext.Sage3D->render.element_key = key;
+  return TRUE;
+}
+
+/**
+ * Get the number of elements moved by the last sort
+ *
+ * @return Number of moved elements
+ */
+ULONG SAGE_GetMoved3DElements(VOID)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return 0;
+  })
+  return SageContext.Sage3D->render.moved_elements;
+}
+
+/**
+ * Get the number of triangles rejected by the Hi-Z buffer during the last render
+ *
+ * @return Number of rejected triangles
+ */
+ULONG SAGE_GetRejected3DTriangles(VOID)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return 0;
+  })
+  return SageContext.Sage3D->render.zbuffer.rejected_triangles;
+}
+
+/**
+ * Get the number of tiles rejected by the Hi-Z buffer during the last render,
+ * each tile crossed by a rejected span band is counted
+ *
+ * @return Number of rejected tiles
+ */
+ULONG SAGE_GetRejected3DTiles(VOID)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return 0;
+  })
+  return SageContext.Sage3D->render.zbuffer.rejected_tiles;
+}
+
+/**
+ * Get the number of tiles cleared by the lazy Z buffer clear during the last render
+ *
+ * @return Number of cleared tiles
+ */
+ULONG SAGE_GetCleared3DTiles(VOID)
+{
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return 0;
+  })
+  return SageContext.Sage3D->render.zbuffer.cleared_tiles;
+}
+
 /**
  * Tell if a render option is active
  */
@@ -264,6 +602,38 @@ BOOL SAGE_Set3DRenderMode(UWORD mode)
   return TRUE;
 }
 
+/**
+ * Reset the Hi-Z tiles to the depth of a cleared Z buffer
+ *
+ * @param zbuffer Z buffer
+ */
+VOID SAGE_ClearHiZTiles(SAGE_ZBuffer *zbuffer)
+{
+  UWORD *tiles;
+  ULONG index, nb_tiles;
+
+  tiles = zbuffer->tiles;
+  nb_tiles = zbuffer->tiles_width * zbuffer->tiles_height;
+  for (index = 0;index < nb_tiles;index++) {
+    *tiles++ = S3DR_HIZ_FAR;
+  }
+}
+
+/**
+ * Start a new frame epoch, all the tiles of the previous frames become stale
+ *
+ * @param zbuffer Z buffer
+ */
+VOID SAGE_NextZBufferEpoch(SAGE_ZBuffer *zbuffer)
+{
+  zbuffer->epoch++;
+  if (zbuffer->epoch == 0) {
+    SD(SAGE_DebugLog("Z buffer epoch wraps");)
+    SAGE_ResetZBufferEpochs(zbuffer);
+    zbuffer->epoch = 1;
+  }
+}
+
 /**
  * Clear Z buffer
  */
@@ -278,6 +648,13 @@ BOOL SAGE_ClearZBuffer()
       SAGE_SetError(SERR_ZBUFFER);
       return FALSE;
     })
+    if (SageContext.Sage3D->render.options & S3DR_LAZYZBUFFER) {
+      SAGE_NextZBufferEpoch(&(SageContext.Sage3D->render.zbuffer));
+      return TRUE;
+    }
+    if (SageContext.Sage3D->render.zbuffer.tiles != NULL) {
+      SAGE_ClearHiZTiles(&(SageContext.Sage3D->render.zbuffer));
+    }
     return SAGE_FastClearZBuffer(
       (ULONG)SageContext.Sage3D->render.zbuffer.buffer,
       (UWORD)SageContext.Sage3D->render.zbuffer.height,
@@ -287,7 +664,61 @@ BOOL SAGE_ClearZBuffer()
 }
 
 /**
- * Add an element to the rendering queue
+ * Grow the rendering queue, its size doubles each time it is full up to
+ * S3DR_MAX_ELEMENTS. The queue is one memory bloc kept from frame to frame, a
+ * larger bloc replaces it and gets the queued elements, their keys and the
+ * sort histories. The bloc is released with the 3D device.
+ *
+ * @param render Renderer
+ *
+ * @return Operation success
+ */
+BOOL SAGE_Grow3DQueue(SAGE_Render *render)
+{
+  SAGE_SortedElement *ordered, *buffer;
+  SAGE_3DElement *elements;
+  ULONG index, capacity, *keys;
+  UWORD history;
+
+  capacity = (render->max_elements == 0) ? S3DR_MIN_ELEMENTS : render->max_elements * 2;
+  if (capacity > S3DR_MAX_ELEMENTS) {
+    capacity = S3DR_MAX_ELEMENTS;
+  }
+  SD(SAGE_DebugLog("Grow the rendering queue to %d elements", capacity);)
+  if ((ordered = (SAGE_SortedElement *)SAGE_AllocMem(capacity * S3DR_QUEUE_BYTES)) == NULL) {
+    return FALSE;
+  }
+  buffer = ordered + capacity;
+  elements = (SAGE_3DElement *)(buffer + capacity);
+  keys = (ULONG *)(elements + capacity);
+  if (render->ordered_elements != NULL) {
+    memcpy(elements, render->s3d_elements, sizeof(SAGE_3DElement) * render->render_elements);
+    memcpy(keys, render->element_keys, sizeof(ULONG) * render->render_elements);
+    for (index = 0;index < render->render_elements;index++) {
+      ordered[index].element = elements + (render->ordered_elements[index].element - render->s3d_elements);
+      ordered[index].avgz = render->ordered_elements[index].avgz;
+    }
+    for (history = 0;history < S3DR_SORT_HISTORIES;history++) {
+      memcpy(keys + capacity * (3 + history), render->history_keys[history], sizeof(ULONG) * render->history_size[history]);
+    }
+    SAGE_FreeMem(render->ordered_elements);
+  }
+  render->ordered_elements = ordered;
+  render->sort_buffer = buffer;
+  render->s3d_elements = elements;
+  render->element_keys = keys;
+  render->sort_keys[0] = keys + capacity;
+  render->sort_keys[1] = keys + capacity * 2;
+  for (history = 0;history < S3DR_SORT_HISTORIES;history++) {
+    render->history_keys[history] = keys + capacity * (3 + history);
+  }
+  render->key_table = (UWORD *)(keys + capacity * (3 + S3DR_SORT_HISTORIES));
+  render->max_elements = (UWORD)capacity;
+  return TRUE;
+}
+
+/**
+ * Add an element to the rendering queue, the queue grows when it is full
  *
  * @param elementt Element to add to the queue
  *
@@ -302,9 +733,18 @@ BOOL SAGE_Push3DElement(SAGE_3DElement *element)
     return FALSE;
   })
   render = &(SageContext.Sage3D->render);
-  if (render->render_elements < S3DR_MAX_ELEMENTS) {
+  if (render->render_elements >= S3DR_MAX_ELEMENTS) {
+    return FALSE;
+  }
+  if (render->render_elements >= render->max_elements) {
+    if (!SAGE_Grow3DQueue(render)) {
+      return FALSE;
+    }
+  }
+  if (render->render_elements < render->max_elements) {
     memcpy(&(render->s3d_elements[render->render_elements]), element, sizeof(SAGE_3DElement));
     render->ordered_elements[render->render_elements].element = &(render->s3d_elements[render->render_elements]);
+    render->element_keys[render->render_elements] = render->element_key++;
     if (element->type == S3DR_ELEM_POINT) {
       render->ordered_elements[render->render_elements].avgz = element->z1;
     } else if (element->type == S3DR_ELEM_LINE) {
@@ -321,85 +761,19 @@ BOOL SAGE_Push3DElement(SAGE_3DElement *element)
 }
 
 /**
- * Ascending quick sort the elements in the rendering queue
+ * Remove all elements from the rendering queue
  *
- * @param elements Elements queue
- * @param low      Lower index for sorting
- * @param high     Higher index for sorting
+ * @return Operation success
  */
-VOID SAGE_AscQuicksortElements(SAGE_SortedElement *elements, LONG low, LONG high)
+BOOL SAGE_Flush3DElements(VOID)
 {
-  SAGE_SortedElement temp;
-  DOUBLE pivot;
-  LONG idx_low, idx_high;
-
-  if (low >= high) return;
-  idx_low = low+1;
-  idx_high = high;
-  pivot = elements[low].avgz;
-  while (idx_low <= idx_high) {
-    while (elements[idx_low].avgz <= pivot && idx_low <= high) idx_low++;
-    while (elements[idx_high].avgz > pivot && idx_high >= low) idx_high--;
-    if (idx_low < idx_high) {
-      temp.element = elements[idx_low].element;
-      temp.avgz = elements[idx_low].avgz;
-      elements[idx_low].element = elements[idx_high].element;
-      elements[idx_low].avgz = elements[idx_high].avgz;
-      elements[idx_high].element = temp.element;
-      elements[idx_high].avgz = temp.avgz;
-      idx_low++;
-      idx_high--;
-    }
-  }
-  temp.element = elements[low].element;
-  temp.avgz = elements[low].avgz;
-  elements[low].element = elements[idx_high].element;
-  elements[low].avgz = elements[idx_high].avgz;
-  elements[idx_high].element = temp.element;
-  elements[idx_high].avgz = temp.avgz;
-  SAGE_AscQuicksortElements(elements, low, idx_high-1);
-  SAGE_AscQuicksortElements(elements, idx_high+1, high);
-}
-
-/**
- * Descending quick sort the elements in the rendering queue
- *
- * @param elements Elements queue
- * @param low      Lower index for sorting
- * @param high     Higher index for sorting
- */
-VOID SAGE_DescQuicksortElements(SAGE_SortedElement *elements, LONG low, LONG high)
-{
-  SAGE_SortedElement temp;
-  DOUBLE pivot;
-  LONG idx_low, idx_high;
-
-  if (low >= high) return;
-  idx_low = low+1;
-  idx_high = high;
-  pivot = elements[low].avgz;
-  while (idx_low <= idx_high) {
-    while (elements[idx_low].avgz >= pivot && idx_low <= high) idx_low++;
-    while (elements[idx_high].avgz < pivot && idx_high >= low) idx_high--;
-    if (idx_low < idx_high) {
-      temp.element = elements[idx_low].element;
-      temp.avgz = elements[idx_low].avgz;
-      elements[idx_low].element = elements[idx_high].element;
-      elements[idx_low].avgz = elements[idx_high].avgz;
-      elements[idx_high].element = temp.element;
-      elements[idx_high].avgz = temp.avgz;
-      idx_low++;
-      idx_high--;
-    }
-  }
-  temp.element = elements[low].element;
-  temp.avgz = elements[low].avgz;
-  elements[low].element = elements[idx_high].element;
-  elements[low].avgz = elements[idx_high].avgz;
-  elements[idx_high].element = temp.element;
-  elements[idx_high].avgz = temp.avgz;
-  SAGE_DescQuicksortElements(elements, low, idx_high-1);
-  SAGE_DescQuicksortElements(elements, idx_high+1, high);
+  SAFE(if (SageContext.Sage3D == NULL) {
+    SAGE_SetError(SERR_NO_3DDEVICE);
+    return FALSE;
+  })
+  SageContext.Sage3D->render.render_elements = 0;
+  SageContext.Sage3D->render.element_key = 0;
+  return TRUE;
 }
 
 /**
@@ -419,48 +793,63 @@ BOOL SAGE_Sort3DElements(BOOL ascending)
     return FALSE;
   })
   render = &(SageContext.Sage3D->render);
-  if (ascending) {
-    SAGE_AscQuicksortElements(render->ordered_elements, 0, render->render_elements-1);
+  if (render->options & S3DR_COHERENTSORT) {
+    if (!SAGE_CoherentSortElements(render, ascending)) {
+      SAGE_FullSortElements(render, ascending);
+    }
+    SAGE_SaveSortHistory(render);
   } else {
-    SAGE_DescQuicksortElements(render->ordered_elements, 0, render->render_elements-1);
+    SAGE_FullSortElements(render, ascending);
   }
   return TRUE;
 }
 
 /**
- * Render elements in wireframe mode
+ * Render elements in wireframe mode, the edges are queued and drawn by batch
  */
 VOID SAGE_RenderWired3DElements(SAGE_SortedElement *elements, UWORD nb_elements)
 {
   SAGE_3DElement *element;
-  UWORD index;
+  SAGE_Line lines[S3DR_WIRE_BATCH];
+  LONG xcoords[4], ycoords[4];
+  UWORD index, nb_points, nb_edges, edge, nb_lines;
 
   SD(SAGE_TraceLog("** SAGE_RenderWired3DElements(nb_elements %d)", nb_elements);)
+  nb_lines = 0;
   for (index = 0;index < nb_elements;index++) {
     element = elements[index].element;
+    xcoords[0] = (LONG)(element->x1); ycoords[0] = (LONG)(element->y1);
+    xcoords[1] = (LONG)(element->x2); ycoords[1] = (LONG)(element->y2);
     if (element->type == S3DR_ELEM_LINE) {
-      SAGE_DrawClippedLine((LONG)(element->x1), (LONG)(element->y1),
-        (LONG)(element->x2), (LONG)(element->y2), element->color);
+      nb_points = 2;
+      nb_edges = 1;
+    } else if (element->type == S3DR_ELEM_TRIANGLE) {
+      xcoords[2] = (LONG)(element->x3); ycoords[2] = (LONG)(element->y3);
+      nb_points = 3;
+      nb_edges = 3;
+    } else if (element->type == S3DR_ELEM_QUAD) {
+      xcoords[2] = (LONG)(element->x3); ycoords[2] = (LONG)(element->y3);
+      xcoords[3] = (LONG)(element->x4); ycoords[3] = (LONG)(element->y4);
+      nb_points = 4;
+      nb_edges = 4;
+    } else {
+      continue;
     }
-    if (element->type == S3DR_ELEM_TRIANGLE) {
-      SAGE_DrawClippedLine((LONG)(element->x1), (LONG)(element->y1),
-        (LONG)(element->x2), (LONG)(element->y2), element->color);
-      SAGE_DrawClippedLine((LONG)(element->x2), (LONG)(element->y2),
-        (LONG)(element->x3),(LONG)(element->y3), element->color);
-      SAGE_DrawClippedLine((LONG)(element->x3), (LONG)(element->y3),
-        (LONG)(element->x1), (LONG)(element->y1), element->color);
+    if ((nb_lines + nb_edges) > S3DR_WIRE_BATCH) {
+      SAGE_DrawClippedLineArray(lines, nb_lines);
+      nb_lines = 0;
     }
-    if (element->type == S3DR_ELEM_QUAD) {
-      SAGE_DrawClippedLine((LONG)(element->x1), (LONG)(element->y1),
-        (LONG)(element->x2), (LONG)(element->y2), element->color);
-      SAGE_DrawClippedLine((LONG)(element->x2), (LONG)(element->y2),
-        (LONG)(element->x3),(LONG)(element->y3), element->color);
-      SAGE_DrawClippedLine((LONG)(element->x3), (LONG)(element->y3),
-        (LONG)(element->x4), (LONG)(element->y4), element->color);
-      SAGE_DrawClippedLine((LONG)(element->x4), (LONG)(element->y4),
-        (LONG)(element->x1), (LONG)(element->y1), element->color);
+    for (edge = 0;edge < nb_edges;edge++) {
+      lines[nb_lines].x1 = xcoords[edge];
+      lines[nb_lines].y1 = ycoords[edge];
+      lines[nb_lines].x2 = xcoords[(edge + 1) % nb_points];
+      lines[nb_lines].y2 = ycoords[(edge + 1) % nb_points];
+      lines[nb_lines++].color = element->color;
     }
   }
+  if (nb_lines > 0) {
+    SAGE_DrawClippedLineArray(lines, nb_lines);
+  }
 }
 
 /**
@@ -786,6 +1175,9 @@ BOOL SAGE_Render3DElements()
     SAGE_SetError(SERR_NO_3DDEVICE);
     return FALSE;
   })
+  device->render.zbuffer.rejected_triangles = 0;
+  device->render.zbuffer.rejected_tiles = 0;
+  device->render.zbuffer.cleared_tiles = 0;
   // Sort elements list
   if (!SAGE_Get3DRenderOption(S3DR_ZBUFFER)) {
     SD(SAGE_TraceLog("** ZBuffer is disable");)
@@ -814,5 +1206,6 @@ BOOL SAGE_Render3DElements()
     }
   }
   device->render.render_elements = 0;
+  device->render.element_key = 0;
   return TRUE;
 }
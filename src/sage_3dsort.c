@@ -0,0 +1,427 @@
+/**
+ * sage_3dsort.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * 3D rendering queue sort functions
+ * 
+ * Those functions only work on the renderer queue, they don't call any
+ * system function so they can be compiled and profiled on any host.
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <exec/types.h>
+
+#include <sage/sage_logger.h>
+#include <sage/sage_3drender.h>
+#include <sage/sage_3dsort.h>
+
+#include <sage/sage_debug.h>
+
+/**
+ * Forget the element orders of previous frames
+ */
+VOID SAGE_ClearSortHistory(SAGE_Render *render)
+{
+  UWORD index;
+
+  for (index = 0;index < S3DR_SORT_HISTORIES;index++) {
+    render->history_size[index] = 0;
+  }
+  render->sort_history = 0;
+  render->moved_elements = 0;
+}
+
+/**
+ * Ascending quick sort the elements in the rendering queue
+ *
+ * @param elements Elements queue
+ * @param low      Lower index for sorting
+ * @param high     Higher index for sorting
+ */
+VOID SAGE_AscQuicksortElements(SAGE_SortedElement *elements, LONG low, LONG high)
+{
+  SAGE_SortedElement temp;
+  DOUBLE pivot;
+  LONG idx_low, idx_high;
+
+  if (low >= high) return;
+  idx_low = low+1;
+  idx_high = high;
+  pivot = elements[low].avgz;
+  while (idx_low <= idx_high) {
+    while (elements[idx_low].avgz <= pivot && idx_low <= high) idx_low++;
+    while (elements[idx_high].avgz > pivot && idx_high >= low) idx_high--;
+    if (idx_low < idx_high) {
+      temp.element = elements[idx_low].element;
+      temp.avgz = elements[idx_low].avgz;
+      elements[idx_low].element = elements[idx_high].element;
+      elements[idx_low].avgz = elements[idx_high].avgz;
+      elements[idx_high].element = temp.element;
+      elements[idx_high].avgz = temp.avgz;
+      idx_low++;
+      idx_high--;
+    }
+  }
+  temp.element = elements[low].element;
+  temp.avgz = elements[low].avgz;
+  elements[low].element = elements[idx_high].element;
+  elements[low].avgz = elements[idx_high].avgz;
+  elements[idx_high].element = temp.element;
+  elements[idx_high].avgz = temp.avgz;
+  SAGE_AscQuicksortElements(elements, low, idx_high-1);
+  SAGE_AscQuicksortElements(elements, idx_high+1, high);
+}
+
+/**
+ * Descending quick sort the elements in the rendering queue
+ *
+ * @param elements Elements queue
+ * @param low      Lower index for sorting
+ * @param high     Higher index for sorting
+ */
+VOID SAGE_DescQuicksortElements(SAGE_SortedElement *elements, LONG low, LONG high)
+{
+  SAGE_SortedElement temp;
+  DOUBLE pivot;
+  LONG idx_low, idx_high;
+
+  if (low >= high) return;
+  idx_low = low+1;
+  idx_high = high;
+  pivot = elements[low].avgz;
+  while (idx_low <= idx_high) {
+    while (elements[idx_low].avgz >= pivot && idx_low <= high) idx_low++;
+    while (elements[idx_high].avgz < pivot && idx_high >= low) idx_high--;
+    if (idx_low < idx_high) {
+      temp.element = elements[idx_low].element;
+      temp.avgz = elements[idx_low].avgz;
+      elements[idx_low].element = elements[idx_high].element;
+      elements[idx_low].avgz = elements[idx_high].avgz;
+      elements[idx_high].element = temp.element;
+      elements[idx_high].avgz = temp.avgz;
+      idx_low++;
+      idx_high--;
+    }
+  }
+  temp.element = elements[low].element;
+  temp.avgz = elements[low].avgz;
+  elements[low].element = elements[idx_high].element;
+  elements[low].avgz = elements[idx_high].avgz;
+  elements[idx_high].element = temp.element;
+  elements[idx_high].avgz = temp.avgz;
+  SAGE_DescQuicksortElements(elements, low, idx_high-1);
+  SAGE_DescQuicksortElements(elements, idx_high+1, high);
+}
+
+/**
+ * Build an unsigned key from the element depth
+ * IEEE floats keep their order when compared as integers once the sign bit
+ * is flipped for positive values and all bits are flipped for negative values.
+ * The key is masked to 32 bits for the hosts where ULONG is larger than FLOAT.
+ *
+ * @param avgz Element depth
+ *
+ * @return Depth key
+ */
+ULONG SAGE_ElementDepthKey(DOUBLE avgz)
+{
+  union {
+    FLOAT depth;
+    ULONG key;
+  } value;
+
+  value.key = 0;
+  value.depth = (FLOAT)avgz;
+  if (value.key & 0x80000000) {
+    return ~value.key & S3DR_DEPTH_KEY;
+  }
+  return (value.key | 0x80000000) & S3DR_DEPTH_KEY;
+}
+
+/**
+ * Radix sort the elements in the rendering queue (LSD, 8 bits by pass)
+ * The sort is stable so elements at the same depth keep their push order,
+ * passes where all the elements share the same digit are skipped
+ *
+ * @param render    Renderer
+ * @param ascending Ascending sort
+ */
+VOID SAGE_RadixSortElements(SAGE_Render *render, BOOL ascending)
+{
+  SAGE_SortedElement *source, *target, *swap_elements;
+  ULONG *source_keys, *target_keys, *swap_keys, *counts;
+  ULONG index, nb_elements, key, offset, count, pass, shift, digit;
+
+  nb_elements = render->render_elements;
+  if (nb_elements < 2) {
+    return;
+  }
+  for (pass = 0;pass < S3DR_RADIX_PASSES;pass++) {
+    for (digit = 0;digit < S3DR_RADIX_BUCKETS;digit++) {
+      render->sort_counts[pass][digit] = 0;
+    }
+  }
+  // Build the keys and all the histograms in one pass
+  source = render->ordered_elements;
+  source_keys = render->sort_keys[0];
+  for (index = 0;index < nb_elements;index++) {
+    key = SAGE_ElementDepthKey(source[index].avgz);
+    if (!ascending) {
+      key ^= S3DR_DEPTH_KEY;
+    }
+    source_keys[index] = key;
+    render->sort_counts[0][key & 0xFF]++;
+    render->sort_counts[1][(key >> 8) & 0xFF]++;
+    render->sort_counts[2][(key >> 16) & 0xFF]++;
+    render->sort_counts[3][(key >> 24) & 0xFF]++;
+  }
+  target = render->sort_buffer;
+  target_keys = render->sort_keys[1];
+  for (pass = 0;pass < S3DR_RADIX_PASSES;pass++) {
+    shift = pass * S3DR_RADIX_BITS;
+    counts = render->sort_counts[pass];
+    if (counts[(source_keys[0] >> shift) & 0xFF] == nb_elements) {
+      continue;
+    }
+    offset = 0;
+    for (digit = 0;digit < S3DR_RADIX_BUCKETS;digit++) {
+      count = counts[digit];
+      counts[digit] = offset;
+      offset += count;
+    }
+    for (index = 0;index < nb_elements;index++) {
+      key = source_keys[index];
+      offset = counts[(key >> shift) & 0xFF]++;
+      target[offset] = source[index];
+      target_keys[offset] = key;
+    }
+    swap_elements = source; source = target; target = swap_elements;
+    swap_keys = source_keys; source_keys = target_keys; target_keys = swap_keys;
+  }
+  if (source != render->ordered_elements) {
+    memcpy(render->ordered_elements, source, sizeof(SAGE_SortedElement) * nb_elements);
+  }
+}
+
+/**
+ * Sort the elements in the rendering queue with radix or quick sort
+ *
+ * @param render    Renderer
+ * @param ascending Ascending sort
+ */
+VOID SAGE_FullSortElements(SAGE_Render *render, BOOL ascending)
+{
+  if (render->options & S3DR_RADIXSORT) {
+    SAGE_RadixSortElements(render, ascending);
+  } else if (ascending) {
+    SAGE_AscQuicksortElements(render->ordered_elements, 0, render->render_elements-1);
+  } else {
+    SAGE_DescQuicksortElements(render->ordered_elements, 0, render->render_elements-1);
+  }
+  render->moved_elements = render->render_elements;
+}
+
+/**
+ * Adaptive insertion sort of a run of elements, cost is close to O(n) when
+ * the run is almost sorted
+ *
+ * @param elements    Elements run
+ * @param nb_elements Number of elements in the run
+ * @param ascending   Ascending sort
+ * @param limit       Maximum number of shifts
+ * @param moved       Number of moved elements (updated)
+ *
+ * @return FALSE if the run needs more shifts than the limit
+ */
+BOOL SAGE_InsertionSortElements(SAGE_SortedElement *elements, ULONG nb_elements, BOOL ascending, ULONG limit, ULONG *moved)
+{
+  SAGE_SortedElement temp;
+  ULONG index, position, shifts;
+
+  shifts = 0;
+  for (index = 1;index < nb_elements;index++) {
+    if (ascending ? (elements[index-1].avgz > elements[index].avgz) : (elements[index-1].avgz < elements[index].avgz)) {
+      temp = elements[index];
+      position = index;
+      if (ascending) {
+        while (position > 0 && elements[position-1].avgz > temp.avgz) {
+          elements[position] = elements[position-1];
+          position--;
+        }
+      } else {
+        while (position > 0 && elements[position-1].avgz < temp.avgz) {
+          elements[position] = elements[position-1];
+          position--;
+        }
+      }
+      elements[position] = temp;
+      shifts += index - position;
+      *moved += 1;
+      if (shifts > limit) {
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Hash the keys of the queued elements with linear probing, each entry keeps
+ * the slot of an element plus one
+ *
+ * @param render Renderer
+ *
+ * @return Number of bits of the table index
+ */
+UWORD SAGE_HashElementKeys(SAGE_Render *render)
+{
+  UWORD *table, bits, slot;
+  ULONG index, size, mask;
+
+  table = render->key_table;
+  // Largest power of two up to two entries by element, always more than the queue size
+  bits = 1;
+  while ((1L << (bits + 1)) <= (render->max_elements * 2)) {
+    bits++;
+  }
+  size = 1L << bits;
+  mask = size - 1;
+  for (index = 0;index < size;index++) {
+    table[index] = 0;
+  }
+  for (slot = 0;slot < render->render_elements;slot++) {
+    index = ((render->element_keys[slot] * S3DR_KEY_HASH) >> (32 - bits)) & mask;
+    while (table[index] != 0) {
+      index = (index + 1) & mask;
+    }
+    table[index] = slot + 1;
+  }
+  return bits;
+}
+
+/**
+ * Find an element of the queue by its key and mark it as matched
+ *
+ * @param render Renderer
+ * @param key    Element key
+ * @param bits   Number of bits of the table index
+ *
+ * @return Slot of the element or -1 if the key is not in the queue
+ */
+LONG SAGE_MatchElementKey(SAGE_Render *render, ULONG key, UWORD bits)
+{
+  UWORD *table, entry;
+  ULONG index, mask;
+
+  table = render->key_table;
+  mask = (1L << bits) - 1;
+  index = ((key * S3DR_KEY_HASH) >> (32 - bits)) & mask;
+  while ((entry = table[index]) != 0) {
+    if (!(entry & S3DR_KEY_MATCHED) && render->element_keys[entry - 1] == key) {
+      table[index] = entry | S3DR_KEY_MATCHED;
+      return (LONG)(entry - 1);
+    }
+    index = (index + 1) & mask;
+  }
+  return -1;
+}
+
+/**
+ * Sort the elements using the order of the previous frame
+ * Elements are identified by their key (entity and face for the engine), so
+ * a culled or new face doesn't change the identity of the others. Elements
+ * already known are put back in the previous order and fixed by an insertion
+ * pass, new elements are sorted apart and both runs are merged. The sort
+ * gives up when the known elements are too far from being sorted.
+ *
+ * @param render    Renderer
+ * @param ascending Ascending sort
+ *
+ * @return TRUE if the queue is sorted, FALSE if a full sort is needed
+ */
+BOOL SAGE_CoherentSortElements(SAGE_Render *render, BOOL ascending)
+{
+  SAGE_SortedElement *elements, *known, *added;
+  ULONG *keys, index, size, nb_known, nb_added, idx_known, idx_added, moved, added_moved;
+  UWORD previous, nb_elements, bits, entry;
+  LONG slot;
+
+  keys = render->history_keys[render->sort_history];
+  previous = render->history_size[render->sort_history];
+  nb_elements = render->render_elements;
+  if (previous == 0) {
+    return FALSE;
+  }
+  // Put known elements back in the previous frame order, new ones at the end
+  elements = render->ordered_elements;
+  bits = SAGE_HashElementKeys(render);
+  nb_known = 0;
+  for (index = 0;index < previous;index++) {
+    if ((slot = SAGE_MatchElementKey(render, keys[index], bits)) >= 0) {
+      render->sort_buffer[nb_known++] = elements[slot];
+    }
+  }
+  nb_added = 0;
+  size = 1L << bits;
+  for (index = 0;index < size;index++) {
+    entry = render->key_table[index];
+    if (entry != 0 && !(entry & S3DR_KEY_MATCHED)) {
+      render->sort_buffer[nb_known + nb_added++] = elements[entry - 1];
+    }
+  }
+  known = render->sort_buffer;
+  added = render->sort_buffer + nb_known;
+  moved = 0;
+  if (!SAGE_InsertionSortElements(known, nb_known, ascending, nb_known * S3DR_COHERENT_SHIFTS, &moved)) {
+    SD(SAGE_TraceLog("** Coherent sort gives up after %d moves", moved);)
+    return FALSE;
+  }
+  // New elements have no history, quick sort them if they are not almost sorted
+  added_moved = 0;
+  if (!SAGE_InsertionSortElements(added, nb_added, ascending, nb_added * S3DR_COHERENT_SHIFTS, &added_moved)) {
+    if (ascending) {
+      SAGE_AscQuicksortElements(added, 0, nb_added-1);
+    } else {
+      SAGE_DescQuicksortElements(added, 0, nb_added-1);
+    }
+  }
+  // Every new element counts as moved once
+  moved += nb_added;
+  // Merge both runs back in the queue
+  idx_known = 0;
+  idx_added = 0;
+  for (index = 0;index < nb_elements;index++) {
+    if (idx_added >= nb_added) {
+      elements[index] = known[idx_known++];
+    } else if (idx_known >= nb_known) {
+      elements[index] = added[idx_added++];
+    } else if (ascending ? (added[idx_added].avgz < known[idx_known].avgz) : (added[idx_added].avgz > known[idx_known].avgz)) {
+      elements[index] = added[idx_added++];
+    } else {
+      elements[index] = known[idx_known++];
+    }
+  }
+  render->moved_elements = moved;
+  return TRUE;
+}
+
+/**
+ * Keep the keys of the sorted elements for the next frame
+ *
+ * @param render Renderer
+ */
+VOID SAGE_SaveSortHistory(SAGE_Render *render)
+{
+  ULONG *keys;
+  UWORD index;
+
+  keys = render->history_keys[render->sort_history];
+  for (index = 0;index < render->render_elements;index++) {
+    keys[index] = render->element_keys[render->ordered_elements[index].element - render->s3d_elements];
+  }
+  render->history_size[render->sort_history] = render->render_elements;
+}
@@ -0,0 +1,180 @@
+/**
+ * sage_3dstream.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * 3D vertex streams (structure of arrays) functions
+ * 
+ * Those kernels only use plain C and the SAGE base types, they don't call
+ * any system function so they can be compiled and profiled on any host.
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 12/06/2025)
+ */
+
+#include <sage/sage_3dstream.h>
+
+/** Number of bits set in a nibble */
+static const UBYTE StreamBitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+/**
+ * Clear the visibility bitset of the streams
+ *
+ * @param streams     Vertex streams
+ * @param nb_vertices Number of vertices
+ */
+VOID SAGE_ClearStreamVisibility(SAGE_VertexStreams *streams, UWORD nb_vertices)
+{
+  ULONG index, words;
+
+  words = S3DE_STREAM_WORDS(nb_vertices);
+  for (index = 0;index < words;index++) {
+    streams->visible[index] = 0;
+  }
+}
+
+/**
+ * Transform all the local vertices to world coordinates
+ * This kernel has no branch and works on 4 vertices per loop
+ *
+ * @param streams     Vertex streams
+ * @param vertices    Local vertices
+ * @param nb_vertices Number of vertices
+ * @param matrix      Rotation matrix
+ * @param tx          X translation
+ * @param ty          Y translation
+ * @param tz          Z translation
+ */
+VOID SAGE_StreamLocalToWorld(SAGE_VertexStreams *streams, SAGE_Vertex *vertices, UWORD nb_vertices, SAGE_Matrix *matrix, FLOAT tx, FLOAT ty, FLOAT tz)
+{
+  FLOAT m11, m12, m13, m21, m22, m23, m31, m32, m33;
+  FLOAT *wx, *wy, *wz, x0, y0, z0, x1, y1, z1, x2, y2, z2, x3, y3, z3;
+  ULONG index, batch;
+
+  m11 = matrix->m11; m12 = matrix->m12; m13 = matrix->m13;
+  m21 = matrix->m21; m22 = matrix->m22; m23 = matrix->m23;
+  m31 = matrix->m31; m32 = matrix->m32; m33 = matrix->m33;
+  wx = streams->x;
+  wy = streams->y;
+  wz = streams->z;
+  batch = nb_vertices & ~3L;
+  for (index = 0;index < batch;index += 4) {
+    x0 = vertices[index].x; y0 = vertices[index].y; z0 = vertices[index].z;
+    x1 = vertices[index+1].x; y1 = vertices[index+1].y; z1 = vertices[index+1].z;
+    x2 = vertices[index+2].x; y2 = vertices[index+2].y; z2 = vertices[index+2].z;
+    x3 = vertices[index+3].x; y3 = vertices[index+3].y; z3 = vertices[index+3].z;
+    wx[index] = x0*m11 + y0*m21 + z0*m31 + tx;
+    wx[index+1] = x1*m11 + y1*m21 + z1*m31 + tx;
+    wx[index+2] = x2*m11 + y2*m21 + z2*m31 + tx;
+    wx[index+3] = x3*m11 + y3*m21 + z3*m31 + tx;
+    wy[index] = x0*m12 + y0*m22 + z0*m32 + ty;
+    wy[index+1] = x1*m12 + y1*m22 + z1*m32 + ty;
+    wy[index+2] = x2*m12 + y2*m22 + z2*m32 + ty;
+    wy[index+3] = x3*m12 + y3*m22 + z3*m32 + ty;
+    wz[index] = x0*m13 + y0*m23 + z0*m33 + tz;
+    wz[index+1] = x1*m13 + y1*m23 + z1*m33 + tz;
+    wz[index+2] = x2*m13 + y2*m23 + z2*m33 + tz;
+    wz[index+3] = x3*m13 + y3*m23 + z3*m33 + tz;
+  }
+  for (;index < nb_vertices;index++) {
+    x0 = vertices[index].x; y0 = vertices[index].y; z0 = vertices[index].z;
+    wx[index] = x0*m11 + y0*m21 + z0*m31 + tx;
+    wy[index] = x0*m12 + y0*m22 + z0*m32 + ty;
+    wz[index] = x0*m13 + y0*m23 + z0*m33 + tz;
+  }
+}
+
+/**
+ * Transform the world vertices to camera coordinates (in place)
+ * Batches of 8 vertices without any visible vertex are skipped, the other
+ * batches are transformed without checking each vertex
+ *
+ * @param streams     Vertex streams
+ * @param nb_vertices Number of vertices
+ * @param matrix      Camera matrix
+ * @param posx        Camera X position
+ * @param posy        Camera Y position
+ * @param posz        Camera Z position
+ *
+ * @return Number of transformed vertices
+ */
+ULONG SAGE_StreamWorldToCamera(SAGE_VertexStreams *streams, UWORD nb_vertices, SAGE_Matrix *matrix, FLOAT posx, FLOAT posy, FLOAT posz)
+{
+  FLOAT m11, m12, m13, m21, m22, m23, m31, m32, m33;
+  FLOAT *sx, *sy, *sz, x, y, z;
+  ULONG index, vertex, last, count;
+
+  m11 = matrix->m11; m12 = matrix->m12; m13 = matrix->m13;
+  m21 = matrix->m21; m22 = matrix->m22; m23 = matrix->m23;
+  m31 = matrix->m31; m32 = matrix->m32; m33 = matrix->m33;
+  sx = streams->x;
+  sy = streams->y;
+  sz = streams->z;
+  count = 0;
+  for (index = 0;index < nb_vertices;index += S3DE_STREAM_BATCH) {
+    if ((streams->visible[index >> 5] >> (index & 31)) & 0xFF) {
+      last = index + S3DE_STREAM_BATCH;
+      if (last > nb_vertices) {
+        last = nb_vertices;
+      }
+      for (vertex = index;vertex < last;vertex++) {
+        x = sx[vertex] - posx;
+        y = sy[vertex] - posy;
+        z = sz[vertex] - posz;
+        sx[vertex] = x*m11 + y*m21 + z*m31;
+        sy[vertex] = x*m12 + y*m22 + z*m32;
+        sz[vertex] = x*m13 + y*m23 + z*m33;
+      }
+      count += last - index;
+    }
+  }
+  return count;
+}
+
+/**
+ * Calculate perspective projection of the camera vertices
+ * Batches of 8 vertices without any visible vertex are skipped
+ *
+ * @param streams     Vertex streams
+ * @param nb_vertices Number of vertices
+ * @param view_dist   Camera view distance
+ * @param centerx     Camera X center
+ * @param centery     Camera Y center
+ *
+ * @return Number of visible vertices
+ */
+ULONG SAGE_StreamProjection(SAGE_VertexStreams *streams, UWORD nb_vertices, FLOAT view_dist, FLOAT centerx, FLOAT centery)
+{
+  FLOAT *sx, *sy, *sz, *px, *py, *iz, inverse;
+  ULONG index, vertex, last, mask, count;
+
+  sx = streams->x;
+  sy = streams->y;
+  sz = streams->z;
+  px = streams->px;
+  py = streams->py;
+  iz = streams->iz;
+  count = 0;
+  for (index = 0;index < nb_vertices;index += S3DE_STREAM_BATCH) {
+    mask = (streams->visible[index >> 5] >> (index & 31)) & 0xFF;
+    if (mask) {
+      last = index + S3DE_STREAM_BATCH;
+      if (last > nb_vertices) {
+        last = nb_vertices;
+      }
+      for (vertex = index;vertex < last;vertex++) {
+        if (sz[vertex] > 0.0) {
+          inverse = (FLOAT)1.0 / sz[vertex];
+          px[vertex] = (sx[vertex] * view_dist * inverse) + centerx;
+          py[vertex] = (-sy[vertex] * view_dist * inverse) + centery;
+          iz[vertex] = inverse;
+        } else {
+          px[vertex] = 0.0;
+          py[vertex] = 0.0;
+          iz[vertex] = 0.0;
+        }
+      }
+      count += StreamBitCount[mask & 0x0F] + StreamBitCount[mask >> 4];
+    }
+  }
+  return count;
+}
@@ -0,0 +1,38 @@
+/**
+ * sage_3dstream.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * 3D vertex streams (structure of arrays) functions
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 12/06/2025)
+ */
+
+#ifndef _SAGE_3DSTREAM_H_
+#define _SAGE_3DSTREAM_H_
+
+#include <exec/types.h>
+
+#include <sage/sage_maths.h>
+#include <sage/sage_3dstruct.h>
+
+#define S3DE_STREAM_BATCH     8                     // Vertices in a visibility batch (one byte of the bitset)
+
+/** Visibility bitset helpers */
+#define S3DE_STREAM_WORDS(n)          (((n) + 31) >> 5)
+#define S3DE_STREAM_SETVISIBLE(b,i)   ((b)[(i) >> 5] |= (1L << ((i) & 31)))
+#define S3DE_STREAM_ISVISIBLE(b,i)    ((b)[(i) >> 5] & (1L << ((i) & 31)))
+
+/** Clear the visibility bitset */
+VOID SAGE_ClearStreamVisibility(SAGE_VertexStreams *, UWORD);
+
+/** Transform local vertices to world coordinates, 4 vertices at a time */
+VOID SAGE_StreamLocalToWorld(SAGE_VertexStreams *, SAGE_Vertex *, UWORD, SAGE_Matrix *, FLOAT, FLOAT, FLOAT);
+
+/** Transform visible world vertices to camera coordinates, 8 vertices at a time */
+ULONG SAGE_StreamWorldToCamera(SAGE_VertexStreams *, UWORD, SAGE_Matrix *, FLOAT, FLOAT, FLOAT);
+
+/** Project visible camera vertices, 8 vertices at a time */
+ULONG SAGE_StreamProjection(SAGE_VertexStreams *, UWORD, FLOAT, FLOAT, FLOAT);
+
+#endif
@@ -5,7 +5,7 @@
  * 3D base structures
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 12/06/2025)
  */
 
 #ifndef _SAGE_3DSTRUCT_H_
@@ -28,6 +28,14 @@ typedef struct {
   FLOAT iz;                   // Z inverse (for z-buffer)
 } SAGE_TransformedVertex;
 
+/** Transformed vertices as separated streams (structure of arrays) */
+typedef struct {
+  FLOAT *x, *y, *z;           // World coordinates, then camera coordinates
+  FLOAT *px, *py;             // Projected coordinates
+  FLOAT *iz;                  // Z inverse (for z-buffer)
+  ULONG *visible;             // Visibility bitset (one bit per vertex)
+} SAGE_VertexStreams;
+
 /** Face definiton */
 typedef struct {
   BOOL is_quad, culled;
@@ -5,7 +5,7 @@
  * 3D terrain management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 28/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 /**
@@ -331,6 +331,100 @@ VOID SAGE_SetZoneNormals(SAGE_Zone *zone)
   }
 }
 
+/**
+ * Calculate the max height error of each level of detail, the error of a
+ * level is the max distance between the zone vertices and the surface made
+ * by the cells of this level
+ *
+ * @param zone  Terrain zone
+ * @param width Heightmap width in vertices
+ */
+VOID SAGE_SetZoneErrors(SAGE_Zone *zone, UWORD width)
+{
+  SAGE_Vertex *vertices;
+  UWORD level, step, x, y, cx, cy;
+  FLOAT u, v, h00, h10, h01, h11, height, error;
+
+  vertices = &(sage_world.terrain.vertices[zone->base]);
+  zone->lod_errors[0] = 0.0;
+  for (level = 1;level < S3DT_LOD_LEVELS;level++) {
+    step = 1 << level;
+    zone->lod_errors[level] = zone->lod_errors[level - 1];
+    for (y = 0;y < S3DT_VERTICES_ZONE;y++) {
+      for (x = 0;x < S3DT_VERTICES_ZONE;x++) {
+        cx = (x < S3DT_CELLS_ZONE) ? (x / step) * step : S3DT_CELLS_ZONE - step;
+        cy = (y < S3DT_CELLS_ZONE) ? (y / step) * step : S3DT_CELLS_ZONE - step;
+        u = (FLOAT)(x - cx) / (FLOAT)step;
+        v = (FLOAT)(y - cy) / (FLOAT)step;
+        h00 = vertices[(cy * width) + cx].y;
+        h10 = vertices[(cy * width) + cx + step].y;
+        h01 = vertices[((cy + step) * width) + cx].y;
+        h11 = vertices[((cy + step) * width) + cx + step].y;
+        // Cells are cut in two faces like the full level
+        if ((u + v) <= 1.0) {
+          height = h00 + u * (h10 - h00) + v * (h01 - h00);
+        } else {
+          height = h11 + (1.0 - u) * (h01 - h11) + (1.0 - v) * (h10 - h11);
+        }
+        error = vertices[(y * width) + x].y - height;
+        if (error < 0.0) {
+          error = -error;
+        }
+        if (error > zone->lod_errors[level]) {
+          zone->lod_errors[level] = error;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Build the zone faces for a level of detail
+ * Each edge uses the coarsest level between the zone and its neighbor so
+ * both zones share the same vertices on the edge and there is no crack
+ *
+ * @param zone  Terrain zone
+ * @param level Zone level
+ * @param edges Level of the top, right, bottom and left edges
+ */
+VOID SAGE_SetZoneLevel(SAGE_Zone *zone, UWORD level, UWORD *edges)
+{
+  SAGE_LodFace *lod_face;
+  SAGE_Face *face;
+  UWORD key, edge, block, index, first, count;
+
+  key = level;
+  for (edge = 0;edge < S3DT_ZONE_EDGES;edge++) {
+    key |= edges[edge] << (2 + edge * 2);
+  }
+  if (key == zone->lod_key) {
+    return;
+  }
+  zone->nb_faces = 0;
+  for (edge = 0;edge <= S3DT_ZONE_EDGES;edge++) {
+    if (edge == 0) {
+      block = 0;
+    } else {
+      block = 1 + ((edge - 1) * S3DT_LOD_LEVELS) + edges[edge - 1];
+    }
+    first = sage_world.terrain.lod_first[level][block];
+    count = sage_world.terrain.lod_count[level][block];
+    for (index = first;index < (first + count);index++) {
+      lod_face = &(sage_world.terrain.lod_faces[index]);
+      face = &(zone->faces[zone->nb_faces++]);
+      face->is_quad = FALSE;
+      face->p1 = zone->base + lod_face->p1;
+      face->p2 = zone->base + lod_face->p2;
+      face->p3 = zone->base + lod_face->p3;
+      face->color = zone->colors[lod_face->cell];
+      face->texture = zone->textures[lod_face->cell];
+    }
+  }
+  zone->lod = level;
+  zone->lod_key = key;
+  SAGE_SetZoneNormals(zone);
+}
+
 /**
  * Create a new heightmap zone from height map data
  *
@@ -347,12 +441,10 @@ VOID SAGE_SetZoneNormals(SAGE_Zone *zone)
 SAGE_Zone *SAGE_CreateHeightmapZone(UWORD startx, UWORD starty, UBYTE *hmap, UBYTE *cmap, UBYTE *tmap, UWORD size)
 {
   SAGE_Zone *zone;
-  UWORD width, idx_face, x, y;
-  LONG color;
-  WORD texture;
+  UWORD width, idx_face, idx_cell, x, y;
 
   SD(SAGE_DebugLog("SAGE_CreateHeightmapZone(%d, %d)", startx, starty);)
-  zone = SAGE_CreateZone((S3DT_CELLS_ZONE*2)*S3DT_CELLS_ZONE);
+  zone = SAGE_CreateZone(S3DT_ZONE_FACES);
   if (zone == NULL) {
     return NULL;
   }
@@ -360,37 +452,44 @@ SAGE_Zone *SAGE_CreateHeightmapZone(UWORD startx, UWORD starty, UBYTE *hmap, UBY
   zone->posx = (FLOAT)((startx + S3DT_CENTER_ZONE) * S3DT_CELL_SIZE);
   zone->posy = (FLOAT)(hmap[(starty + S3DT_CENTER_ZONE) * width + (startx + S3DT_CENTER_ZONE)] * S3DT_HEIGHT_ZOOM);
   zone->posz = (FLOAT)(-1 * (((starty  + S3DT_CENTER_ZONE) * S3DT_CELL_SIZE) - (width * S3DT_CELL_SIZE)));
+  zone->base = startx + (starty * width);
   idx_face = 0;
+  idx_cell = 0;
   for (y = 0;y < S3DT_CELLS_ZONE;y++) {
     for (x = 0;x < S3DT_CELLS_ZONE;x++) {
       if (cmap != NULL) {
-        color = sage_world.terrain.colors[cmap[(startx + x) + ((starty + y) * size)]];
+        zone->colors[idx_cell] = sage_world.terrain.colors[cmap[(startx + x) + ((starty + y) * size)]];
       } else {
-        color = sage_world.terrain.colors[hmap[(startx + x) + ((starty + y) * width)]];
+        zone->colors[idx_cell] = sage_world.terrain.colors[hmap[(startx + x) + ((starty + y) * width)]];
       }
       if (tmap != NULL) {
-        texture = tmap[(startx + x) + ((starty + y) * size)];
+        zone->textures[idx_cell] = tmap[(startx + x) + ((starty + y) * size)];
       } else {
-        texture = STEX_USECOLOR;
+        zone->textures[idx_cell] = STEX_USECOLOR;
       }
       zone->faces[idx_face].is_quad = FALSE;
       zone->faces[idx_face].p1 = (startx + x) + ((starty + y) * width);
       zone->faces[idx_face].p2 = (startx + x + 1) + ((starty + y) * width);
       zone->faces[idx_face].p3 = (startx + x) + ((starty + y + 1) * width);
-      zone->faces[idx_face].color = color;
-      zone->faces[idx_face].texture = texture;
+      zone->faces[idx_face].color = zone->colors[idx_cell];
+      zone->faces[idx_face].texture = zone->textures[idx_cell];
       idx_face++;
       zone->faces[idx_face].is_quad = FALSE;
       zone->faces[idx_face].p1 = (startx + x + 1) + ((starty + y) * width);
       zone->faces[idx_face].p2 = (startx + x + 1) + ((starty + y + 1) * width);
       zone->faces[idx_face].p3 = (startx + x) + ((starty + y + 1) * width);
-      zone->faces[idx_face].color = color;
-      zone->faces[idx_face].texture = texture;
+      zone->faces[idx_face].color = zone->colors[idx_cell];
+      zone->faces[idx_face].texture = zone->textures[idx_cell];
       idx_face++;
+      idx_cell++;
     }
   }
+  // Full level with full edges
+  zone->lod = 0;
+  zone->lod_key = 0;
   SAGE_SetZoneRadius(zone);
   SAGE_SetZoneNormals(zone);
+  SAGE_SetZoneErrors(zone, width);
   return zone;
 }
 
@@ -439,6 +538,185 @@ BOOL SAGE_BuildHeightmapZones(UBYTE *heightmap, UWORD size, SAGE_Picture *colorm
   return TRUE;
 }
 
+/**
+ * Add a face to the levels of detail faces, the face is turned in the same
+ * way as the full level faces
+ */
+BOOL SAGE_AddLodFace(UWORD *nb_faces, UWORD width, WORD x1, WORD y1, WORD x2, WORD y2, WORD x3, WORD y3)
+{
+  SAGE_LodFace *face;
+  LONG cross;
+  WORD cx, cy;
+
+  if (*nb_faces >= S3DT_LOD_FACES) {
+    return FALSE;
+  }
+  face = &(sage_world.terrain.lod_faces[(*nb_faces)++]);
+  cross = ((x2 - x1) * (y3 - y1)) - ((y2 - y1) * (x3 - x1));
+  face->p1 = (y1 * width) + x1;
+  if (cross > 0) {
+    face->p2 = (y2 * width) + x2;
+    face->p3 = (y3 * width) + x3;
+  } else {
+    face->p2 = (y3 * width) + x3;
+    face->p3 = (y2 * width) + x2;
+  }
+  // The face takes the color of the cell under its center
+  cx = (x1 + x2 + x3) / 3;
+  cy = (y1 + y2 + y3) / 3;
+  if (cx >= S3DT_CELLS_ZONE) cx = S3DT_CELLS_ZONE - 1;
+  if (cy >= S3DT_CELLS_ZONE) cy = S3DT_CELLS_ZONE - 1;
+  face->cell = (cy * S3DT_CELLS_ZONE) + cx;
+  return TRUE;
+}
+
+/**
+ * Get the coordinates of a point on an edge strip
+ *
+ * @param edge   Zone edge
+ * @param pos    Position along the edge
+ * @param depth  Distance from the edge to the zone center
+ * @param x      Point x coord
+ * @param y      Point y coord
+ */
+VOID SAGE_GetEdgePoint(UWORD edge, WORD pos, WORD depth, WORD *x, WORD *y)
+{
+  switch (edge) {
+    case 0:
+      *x = pos; *y = depth;
+      break;
+    case 1:
+      *x = S3DT_CELLS_ZONE - depth; *y = pos;
+      break;
+    case 2:
+      *x = pos; *y = S3DT_CELLS_ZONE - depth;
+      break;
+    default:
+      *x = depth; *y = pos;
+      break;
+  }
+}
+
+/**
+ * Build the faces shared by all zones for each level of detail
+ *   - the inner block has the cells of the level except the border ones
+ *   - each edge strip links the border of the inner block to the zone edge
+ *     for all the edge levels, it's a zipper between both lines
+ *
+ * @param width Heightmap width in vertices
+ *
+ * @return Operation success
+ */
+BOOL SAGE_BuildHeightmapLevels(UWORD width)
+{
+  UWORD level, step, edge, edge_level, edge_step, block, nb_faces;
+  WORD x, y, outer, inner, ox1, oy1, ox2, oy2, ix1, iy1, ix2, iy2;
+
+  SD(SAGE_DebugLog("Build heightmap levels of detail");)
+  nb_faces = 0;
+  for (level = 0;level < S3DT_LOD_LEVELS;level++) {
+    step = 1 << level;
+    for (block = 0;block < S3DT_LOD_BLOCKS;block++) {
+      sage_world.terrain.lod_first[level][block] = 0;
+      sage_world.terrain.lod_count[level][block] = 0;
+    }
+    // Inner block
+    sage_world.terrain.lod_first[level][0] = nb_faces;
+    if (step == S3DT_CELLS_ZONE) {
+      if (!SAGE_AddLodFace(&nb_faces, width, 0, 0, step, 0, 0, step)
+        || !SAGE_AddLodFace(&nb_faces, width, step, 0, step, step, 0, step)) {
+        return FALSE;
+      }
+    } else {
+      for (y = step;y < (S3DT_CELLS_ZONE - step);y += step) {
+        for (x = step;x < (S3DT_CELLS_ZONE - step);x += step) {
+          if (!SAGE_AddLodFace(&nb_faces, width, x, y, x + step, y, x, y + step)
+            || !SAGE_AddLodFace(&nb_faces, width, x + step, y, x + step, y + step, x, y + step)) {
+            return FALSE;
+          }
+        }
+      }
+    }
+    sage_world.terrain.lod_count[level][0] = nb_faces - sage_world.terrain.lod_first[level][0];
+    if (step == S3DT_CELLS_ZONE) {
+      continue;
+    }
+    // Edge strips, the inner line goes from step to size-step (a single point for the half zone step)
+    for (edge = 0;edge < S3DT_ZONE_EDGES;edge++) {
+      for (edge_level = level;edge_level < S3DT_LOD_LEVELS;edge_level++) {
+        edge_step = 1 << edge_level;
+        block = 1 + (edge * S3DT_LOD_LEVELS) + edge_level;
+        sage_world.terrain.lod_first[level][block] = nb_faces;
+        outer = 0;
+        inner = step;
+        while (outer < S3DT_CELLS_ZONE || inner < (S3DT_CELLS_ZONE - step)) {
+          SAGE_GetEdgePoint(edge, outer, 0, &ox1, &oy1);
+          SAGE_GetEdgePoint(edge, inner, step, &ix1, &iy1);
+          if (inner >= (S3DT_CELLS_ZONE - step) || (outer < S3DT_CELLS_ZONE && (outer + edge_step) <= (inner + step))) {
+            SAGE_GetEdgePoint(edge, outer + edge_step, 0, &ox2, &oy2);
+            if (!SAGE_AddLodFace(&nb_faces, width, ox1, oy1, ox2, oy2, ix1, iy1)) {
+              return FALSE;
+            }
+            outer += edge_step;
+          } else {
+            SAGE_GetEdgePoint(edge, inner + step, step, &ix2, &iy2);
+            if (!SAGE_AddLodFace(&nb_faces, width, ox1, oy1, ix2, iy2, ix1, iy1)) {
+              return FALSE;
+            }
+            inner += step;
+          }
+        }
+        sage_world.terrain.lod_count[level][block] = nb_faces - sage_world.terrain.lod_first[level][block];
+      }
+    }
+  }
+  SD(SAGE_DebugLog("Levels of detail use %d faces", nb_faces);)
+  return TRUE;
+}
+
+/**
+ * Set the terrain max screen error and coarsest level of detail
+ *
+ * @param error     Max screen error of a zone in pixels, 0 disable the levels of detail
+ * @param max_level Coarsest level (0 to 3)
+ */
+VOID SAGE_SetTerrainLevelOfDetail(FLOAT error, UWORD max_level)
+{
+  SD(SAGE_DebugLog("Set terrain level of detail error %f max level %d", error, max_level);)
+  if (max_level >= S3DT_LOD_LEVELS) {
+    max_level = S3DT_LOD_LEVELS - 1;
+  }
+  if (error <= 0.0) {
+    max_level = 0;
+  }
+  sage_world.terrain.lod_error = error;
+  sage_world.terrain.lod_max = max_level;
+}
+
+/**
+ * Build the quadtree of the heightmap zones
+ *
+ * @return Operation success
+ */
+BOOL SAGE_BuildHeightmapTree(VOID)
+{
+  SAGE_Zone *zone;
+  UWORD width, idx_zone;
+
+  SD(SAGE_DebugLog("Build heightmap zones tree");)
+  // A terrain loaded again replaces the tree of the previous one
+  SAGE_ReleaseBoundingTree(&sage_world.terrain.tree);
+  if (!SAGE_AllocBoundingTree(&sage_world.terrain.tree, sage_world.terrain.nb_zones)) {
+    return FALSE;
+  }
+  for (idx_zone = 0;idx_zone < sage_world.terrain.nb_zones;idx_zone++) {
+    zone = sage_world.terrain.zones[idx_zone];
+    SAGE_SetBoundingSphere(&sage_world.terrain.tree, idx_zone, zone->posx, zone->posy, zone->posz, zone->radius);
+  }
+  width = sage_world.terrain.size / S3DT_CELLS_ZONE;
+  return SAGE_BuildGridTree(&sage_world.terrain.tree, width, width);
+}
+
 /**
  * Load a heightmap terrain
  *
@@ -497,6 +775,19 @@ BOOL SAGE_LoadHeightmapTerrain(STRPTR heightmap, STRPTR colormap, STRPTR texmap)
     SAGE_ReleasePicture(hmpic);
     return FALSE;
   }
+  if (!SAGE_BuildHeightmapLevels(sage_world.terrain.size + 1)) {
+    SAGE_ReleasePicture(tmpic);
+    SAGE_ReleasePicture(cmpic);
+    SAGE_ReleasePicture(hmpic);
+    return FALSE;
+  }
+  SAGE_SetTerrainLevelOfDetail(S3DT_LOD_ERROR, S3DT_LOD_LEVELS - 1);
+  if (!SAGE_BuildHeightmapTree()) {
+    SAGE_ReleasePicture(tmpic);
+    SAGE_ReleasePicture(cmpic);
+    SAGE_ReleasePicture(hmpic);
+    return FALSE;
+  }
   SAGE_ReleasePicture(tmpic);
   SAGE_ReleasePicture(cmpic);
   SAGE_ReleasePicture(hmpic);
@@ -531,5 +822,6 @@ VOID SAGE_ReleaseTerrain()
     sage_world.terrain.zones[index] = NULL;
   }
   sage_world.terrain.nb_zones = 0;
+  SAGE_ReleaseBoundingTree(&sage_world.terrain.tree);
   sage_world.active_terrain = FALSE;
 }
@@ -5,7 +5,7 @@
  * 3D texture mapper
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 10/03/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <exec/types.h>
@@ -20,7 +20,9 @@
 
 #include <proto/graphics.h>
 
-#define SAGE_MAPPER_ASM       1
+#ifndef SAGE_MAPPER_ASM
+#define SAGE_MAPPER_ASM       1                     // 0 to build the C mappers only
+#endif
 
 #if SAGE_MAPPER_ASM == 1
 
@@ -62,6 +64,18 @@ extern SAGE_Context SageContext;
 /** Mapper data */
 SAGE_TextureMapping s3dm_texmap;
 
+/** Z buffer tiles used by the mapping (NULL when Hi-Z and lazy clear are inactive) */
+SAGE_ZBuffer *s3dm_hiz = NULL;
+
+/** Hi-Z test & lazy clear of the tiles */
+BOOL s3dm_hiztest = FALSE, s3dm_lazyclear = FALSE;
+
+/** Use the C reference mappers instead of the fast ones */
+BOOL s3dm_refmapper = FALSE;
+
+/** Map the textures with perspective correction */
+BOOL s3dm_perspective = FALSE;
+
 /*****************************************************************************
  *                   START DEBUG
  *****************************************************************************/
@@ -101,8 +115,6 @@ VOID SAGE_DebugTexMap(VOID)
  *                   END DEBUG
  *****************************************************************************/
 
-#if SAGE_MAPPER_ASM == 0
-
 /**
  * Map a 8bits color
  */
@@ -131,6 +143,8 @@ VOID SAGE_ColorMapper8Bits(VOID)
       // DX could be 0 in some situations
       if (dx > 0) {
         dz /= dx;
+      } else {
+        dx = 0;
       }
       SD(SAGE_TraceLog(" => dz=0x%X", dz);)
       // Calcul Z value
@@ -164,7 +178,7 @@ VOID SAGE_ColorMapper8Bits(VOID)
             // Write the texel
             *screen++ = col;
           } else {
-            screen += 2;
+            screen++;
           }
           zbuffer++;
           // Interpolate z
@@ -221,6 +235,8 @@ VOID SAGE_TextureMapper8Bits(VOID)
         du /= dx;
         dv /= dx;
         dz /= dx;
+      } else {
+        dx = 0;
       }
       SD(SAGE_TraceLog(" => du=0x%X  dv=0x%X  dz=0x%X", du, dv, dz);)
       // Calcul texture coords
@@ -323,6 +339,8 @@ VOID SAGE_ColorMapper16Bits(VOID)
       // DX could be 0 in some situations
       if (dx > 0) {
         dz /= dx;
+      } else {
+        dx = 0;
       }
       SD(SAGE_TraceLog(" => dz=0x%X", dz);)
       // Calcul Z value
@@ -416,6 +434,8 @@ VOID SAGE_TextureMapper16Bits(VOID)
         du /= dx;
         dv /= dx;
         dz /= dx;
+      } else {
+        dx = 0;
       }
       SD(SAGE_TraceLog(" => du=0x%X  dv=0x%X  dz=0x%X", du, dv, dz);)
       // Calcul texture coords
@@ -493,10 +513,563 @@ VOID SAGE_TextureMapper16Bits(VOID)
   }
 }
 
-#endif
+/**
+ * Get a perspective correct texture coordinate in fixed point
+ *
+ * @param s   Coordinate divided by the depth
+ * @param w   Inverse of the depth
+ * @param max Coordinate limit
+ *
+ * @return Texture coordinate
+ */
+FIXED SAGE_PerspectiveCoord(DOUBLE s, DOUBLE w, FIXED max)
+{
+  DOUBLE coord;
+
+  if (w <= 0.0) {
+    return 0;
+  }
+  coord = s / w + FIXP16_ROUND_UP;
+  if (coord <= 0.0) {
+    return 0;
+  }
+  if (coord >= (DOUBLE)max) {
+    return max;
+  }
+  return (FIXED)coord;
+}
+
+/**
+ * Map a 8bits texture with perspective correction, the true texture
+ * coordinates are computed every PERSP_SPAN pixels and interpolated in
+ * between
+ */
+VOID SAGE_PerspectiveMapper8Bits(VOID)
+{
+  LONG nblines, dx, dz, xs, xe, zi, y, span, step;
+  FIXED ui, vi, un, vn, du, dv;
+  DOUBLE sw, ss, st;
+  UBYTE *fb_line, *zb_line, *screen, *texture;
+  UWORD *zbuffer;
+
+  fb_line = s3dm_texmap.frame_buffer + (s3dm_texmap.start_y * s3dm_texmap.fb_bpr);
+  zb_line = s3dm_texmap.z_buffer + (s3dm_texmap.start_y * s3dm_texmap.zb_bpr);
+  nblines = s3dm_texmap.nb_line;
+  y = s3dm_texmap.start_y;
+  SD(SAGE_TraceLog("SAGE_PerspectiveMapper8Bits %d lines", nblines);)
+  while (nblines--) {
+    // Calcul edge coords
+    xs = (s3dm_texmap.xl + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    xe = (s3dm_texmap.xr + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    if (xs < s3dm_texmap.rclip && xe >= s3dm_texmap.lclip) {
+      // Calcul Z interpolation
+      dz = s3dm_texmap.zr - s3dm_texmap.zl;
+      dx = xe - xs;
+      if (dx > 0) {
+        dz /= dx;
+      } else {
+        dx = 0;
+      }
+      zi = s3dm_texmap.zl + FIXP16_ROUND_UP;
+      // Horizontal clipping
+      if (xs < s3dm_texmap.lclip) {
+        zi += (s3dm_texmap.lclip - xs) * dz;
+        xs = s3dm_texmap.lclip;
+        dx = xe - xs;
+      }
+      if (xe >= s3dm_texmap.rclip) {
+        dx = (s3dm_texmap.rclip - 1) - xs;
+      }
+      // Start address
+      screen = fb_line + xs;
+      zbuffer = (UWORD *)(zb_line + (xs * 2));
+      dx++;
+      // Texture coords of the first pixel
+      sw = s3dm_texmap.w0 + s3dm_texmap.dwdx * xs + s3dm_texmap.dwdy * y;
+      ss = s3dm_texmap.s0 + s3dm_texmap.dsdx * xs + s3dm_texmap.dsdy * y;
+      st = s3dm_texmap.t0 + s3dm_texmap.dtdx * xs + s3dm_texmap.dtdy * y;
+      ui = SAGE_PerspectiveCoord(ss, sw, s3dm_texmap.umax);
+      vi = SAGE_PerspectiveCoord(st, sw, s3dm_texmap.vmax);
+      while (dx > 0) {
+        // Last span ends on its last pixel to stay inside the triangle
+        if (dx > PERSP_SPAN) {
+          span = PERSP_SPAN;
+          step = PERSP_SPAN;
+        } else {
+          span = dx;
+          step = dx - 1;
+        }
+        dx -= span;
+        // Texture coords at the end of the span
+        un = ui;
+        vn = vi;
+        du = 0;
+        dv = 0;
+        if (step > 0) {
+          sw += s3dm_texmap.dwdx * step;
+          ss += s3dm_texmap.dsdx * step;
+          st += s3dm_texmap.dtdx * step;
+          un = SAGE_PerspectiveCoord(ss, sw, s3dm_texmap.umax);
+          vn = SAGE_PerspectiveCoord(st, sw, s3dm_texmap.vmax);
+          if (step == PERSP_SPAN) {
+            du = (un - ui) >> PERSP_SPAN_SHIFT;
+            dv = (vn - vi) >> PERSP_SPAN_SHIFT;
+          } else {
+            du = (un - ui) / step;
+            dv = (vn - vi) / step;
+          }
+        }
+        if (s3dm_texmap.z_buffer != NULL) {
+          while (span--) {
+            if (*zbuffer > (UWORD)(zi >> FIXP16_SHIFT)) {
+              *zbuffer = (UWORD)(zi >> FIXP16_SHIFT);
+              texture = (UBYTE *)s3dm_texmap.tex_buffer + (ui >> FIXP16_SHIFT) + ((vi >> FIXP16_SHIFT) * s3dm_texmap.tb_bpr);
+              *screen = *texture;
+            }
+            screen++;
+            zbuffer++;
+            ui += du;
+            vi += dv;
+            zi += dz;
+          }
+        } else {
+          while (span--) {
+            texture = (UBYTE *)s3dm_texmap.tex_buffer + (ui >> FIXP16_SHIFT) + ((vi >> FIXP16_SHIFT) * s3dm_texmap.tb_bpr);
+            *screen++ = *texture;
+            ui += du;
+            vi += dv;
+          }
+        }
+        ui = un;
+        vi = vn;
+      }
+    }
+    // Interpolate next points
+    s3dm_texmap.xl += s3dm_texmap.dxdyl;
+    s3dm_texmap.xr += s3dm_texmap.dxdyr;
+    s3dm_texmap.zl += s3dm_texmap.dzdyl;
+    s3dm_texmap.zr += s3dm_texmap.dzdyr;
+    s3dm_texmap.ul += s3dm_texmap.dudyl;
+    s3dm_texmap.ur += s3dm_texmap.dudyr;
+    s3dm_texmap.vl += s3dm_texmap.dvdyl;
+    s3dm_texmap.vr += s3dm_texmap.dvdyr;
+    // Next line address
+    fb_line += s3dm_texmap.fb_bpr;
+    zb_line += s3dm_texmap.zb_bpr;
+    y++;
+  }
+}
+
+/**
+ * Map a 16bits texture with perspective correction, the true texture
+ * coordinates are computed every PERSP_SPAN pixels and interpolated in
+ * between
+ */
+VOID SAGE_PerspectiveMapper16Bits(VOID)
+{
+  LONG nblines, dx, dz, xs, xe, zi, y, span, step;
+  FIXED ui, vi, un, vn, du, dv;
+  DOUBLE sw, ss, st;
+  UBYTE *fb_line, *zb_line, *screen, *texture;
+  UWORD *zbuffer;
+
+  fb_line = s3dm_texmap.frame_buffer + (s3dm_texmap.start_y * s3dm_texmap.fb_bpr);
+  zb_line = s3dm_texmap.z_buffer + (s3dm_texmap.start_y * s3dm_texmap.zb_bpr);
+  nblines = s3dm_texmap.nb_line;
+  y = s3dm_texmap.start_y;
+  SD(SAGE_TraceLog("SAGE_PerspectiveMapper16Bits %d lines", nblines);)
+  while (nblines--) {
+    // Calcul edge coords
+    xs = (s3dm_texmap.xl + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    xe = (s3dm_texmap.xr + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    if (xs < s3dm_texmap.rclip && xe >= s3dm_texmap.lclip) {
+      // Calcul Z interpolation
+      dz = s3dm_texmap.zr - s3dm_texmap.zl;
+      dx = xe - xs;
+      if (dx > 0) {
+        dz /= dx;
+      } else {
+        dx = 0;
+      }
+      zi = s3dm_texmap.zl + FIXP16_ROUND_UP;
+      // Horizontal clipping
+      if (xs < s3dm_texmap.lclip) {
+        zi += (s3dm_texmap.lclip - xs) * dz;
+        xs = s3dm_texmap.lclip;
+        dx = xe - xs;
+      }
+      if (xe >= s3dm_texmap.rclip) {
+        dx = (s3dm_texmap.rclip - 1) - xs;
+      }
+      // Start address
+      screen = fb_line + (xs * 2);
+      zbuffer = (UWORD *)(zb_line + (xs * 2));
+      dx++;
+      // Texture coords of the first pixel
+      sw = s3dm_texmap.w0 + s3dm_texmap.dwdx * xs + s3dm_texmap.dwdy * y;
+      ss = s3dm_texmap.s0 + s3dm_texmap.dsdx * xs + s3dm_texmap.dsdy * y;
+      st = s3dm_texmap.t0 + s3dm_texmap.dtdx * xs + s3dm_texmap.dtdy * y;
+      ui = SAGE_PerspectiveCoord(ss, sw, s3dm_texmap.umax);
+      vi = SAGE_PerspectiveCoord(st, sw, s3dm_texmap.vmax);
+      while (dx > 0) {
+        // Last span ends on its last pixel to stay inside the triangle
+        if (dx > PERSP_SPAN) {
+          span = PERSP_SPAN;
+          step = PERSP_SPAN;
+        } else {
+          span = dx;
+          step = dx - 1;
+        }
+        dx -= span;
+        // Texture coords at the end of the span
+        un = ui;
+        vn = vi;
+        du = 0;
+        dv = 0;
+        if (step > 0) {
+          sw += s3dm_texmap.dwdx * step;
+          ss += s3dm_texmap.dsdx * step;
+          st += s3dm_texmap.dtdx * step;
+          un = SAGE_PerspectiveCoord(ss, sw, s3dm_texmap.umax);
+          vn = SAGE_PerspectiveCoord(st, sw, s3dm_texmap.vmax);
+          if (step == PERSP_SPAN) {
+            du = (un - ui) >> PERSP_SPAN_SHIFT;
+            dv = (vn - vi) >> PERSP_SPAN_SHIFT;
+          } else {
+            du = (un - ui) / step;
+            dv = (vn - vi) / step;
+          }
+        }
+        if (s3dm_texmap.z_buffer != NULL) {
+          while (span--) {
+            if (*zbuffer > (UWORD)(zi >> FIXP16_SHIFT)) {
+              *zbuffer = (UWORD)(zi >> FIXP16_SHIFT);
+              texture = (UBYTE *)s3dm_texmap.tex_buffer + ((ui >> FIXP16_SHIFT) * 2) + ((vi >> FIXP16_SHIFT) * s3dm_texmap.tb_bpr);
+              *screen = *texture++;
+              *(screen + 1) = *texture;
+            }
+            screen += 2;
+            zbuffer++;
+            ui += du;
+            vi += dv;
+            zi += dz;
+          }
+        } else {
+          while (span--) {
+            texture = (UBYTE *)s3dm_texmap.tex_buffer + ((ui >> FIXP16_SHIFT) * 2) + ((vi >> FIXP16_SHIFT) * s3dm_texmap.tb_bpr);
+            *screen++ = *texture++;
+            *screen++ = *texture;
+            ui += du;
+            vi += dv;
+          }
+        }
+        ui = un;
+        vi = vn;
+      }
+    }
+    // Interpolate next points
+    s3dm_texmap.xl += s3dm_texmap.dxdyl;
+    s3dm_texmap.xr += s3dm_texmap.dxdyr;
+    s3dm_texmap.zl += s3dm_texmap.dzdyl;
+    s3dm_texmap.zr += s3dm_texmap.dzdyr;
+    s3dm_texmap.ul += s3dm_texmap.dudyl;
+    s3dm_texmap.ur += s3dm_texmap.dudyr;
+    s3dm_texmap.vl += s3dm_texmap.dvdyl;
+    s3dm_texmap.vr += s3dm_texmap.dvdyr;
+    // Next line address
+    fb_line += s3dm_texmap.fb_bpr;
+    zb_line += s3dm_texmap.zb_bpr;
+    y++;
+  }
+}
 
 /*****************************************************************************/
 
+/**
+ * Call the mapper matching the bitmap depth, the C reference mappers are
+ * used when the fast mappers are not built or not wanted and textures with
+ * perspective correction always use the C perspective mappers
+ *
+ * @param bitmap   Bitmap to render
+ * @param textured Use the texture mapper
+ *
+ */
+VOID SAGE_CallMapper(SAGE_Bitmap *bitmap, BOOL textured)
+{
+  if (textured && s3dm_perspective) {
+    if (bitmap->depth == SBMP_DEPTH8) {
+      SAGE_PerspectiveMapper8Bits();
+    } else if (bitmap->depth == SBMP_DEPTH16) {
+      SAGE_PerspectiveMapper16Bits();
+    }
+    return;
+  }
+#if SAGE_MAPPER_ASM == 1
+  if (!s3dm_refmapper) {
+    if (bitmap->depth == SBMP_DEPTH8) {
+      if (textured) {
+        SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", s3dm_texmap.nb_line);)
+        SAGE_FastMap8BitsTexture(&s3dm_texmap);
+      } else {
+        SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", s3dm_texmap.nb_line);)
+        SAGE_FastMap8BitsColor(&s3dm_texmap);
+      }
+    } else if (bitmap->depth == SBMP_DEPTH16) {
+      if (textured) {
+        SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", s3dm_texmap.nb_line);)
+        SAGE_FastMap16BitsTexture(&s3dm_texmap);
+      } else {
+        SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", s3dm_texmap.nb_line);)
+        SAGE_FastMap16BitsColor(&s3dm_texmap);
+      }
+    }
+    return;
+  }
+#endif
+  if (bitmap->depth == SBMP_DEPTH8) {
+    if (textured) {
+      SAGE_TextureMapper8Bits();
+    } else {
+      SAGE_ColorMapper8Bits();
+    }
+  } else if (bitmap->depth == SBMP_DEPTH16) {
+    if (textured) {
+      SAGE_TextureMapper16Bits();
+    } else {
+      SAGE_ColorMapper16Bits();
+    }
+  }
+}
+
+/**
+ * Set the mapping data for a part of the lines
+ *
+ * @param lines    Mapping data of all the lines
+ * @param first    First line to map
+ * @param nb_line  Number of lines to map
+ * @param textured Set the texture coordinates
+ *
+ */
+VOID SAGE_SetMapperLines(SAGE_TextureMapping *lines, LONG first, LONG nb_line, BOOL textured)
+{
+  s3dm_texmap.start_y = lines->start_y + first;
+  s3dm_texmap.nb_line = nb_line;
+  s3dm_texmap.xl = lines->dxdyl * first + lines->xl;
+  s3dm_texmap.xr = lines->dxdyr * first + lines->xr;
+  s3dm_texmap.zl = lines->dzdyl * first + lines->zl;
+  s3dm_texmap.zr = lines->dzdyr * first + lines->zr;
+  if (textured) {
+    s3dm_texmap.ul = lines->dudyl * first + lines->ul;
+    s3dm_texmap.ur = lines->dudyr * first + lines->ur;
+    s3dm_texmap.vl = lines->dvdyl * first + lines->vl;
+    s3dm_texmap.vr = lines->dvdyr * first + lines->vr;
+  }
+}
+
+/**
+ * Clear the stale tiles of a row of tiles (lazy clear)
+ *
+ * @param zbuffer Z buffer
+ * @param tile_y  Row of tiles
+ * @param first   First tile of the row
+ * @param last    Last tile of the row
+ *
+ */
+VOID SAGE_RefreshZBufferTiles(SAGE_ZBuffer *zbuffer, LONG tile_y, LONG first, LONG last)
+{
+  UBYTE *epochs;
+  UWORD *tiles, *zline;
+  LONG tile, width, height, line, index;
+
+  epochs = zbuffer->epochs + tile_y * zbuffer->tiles_width;
+  tiles = zbuffer->tiles + tile_y * zbuffer->tiles_width;
+  height = zbuffer->height - (tile_y << S3DR_HIZ_SHIFT);
+  if (height > S3DR_HIZ_SIZE) {
+    height = S3DR_HIZ_SIZE;
+  }
+  for (tile = first;tile <= last;tile++) {
+    if (epochs[tile] != zbuffer->epoch) {
+      epochs[tile] = zbuffer->epoch;
+      tiles[tile] = S3DR_HIZ_FAR;
+      width = zbuffer->width - (tile << S3DR_HIZ_SHIFT);
+      if (width > S3DR_HIZ_SIZE) {
+        width = S3DR_HIZ_SIZE;
+      }
+      zline = (UWORD *)((UBYTE *)zbuffer->buffer + (tile_y << S3DR_HIZ_SHIFT) * zbuffer->bpr) + (tile << S3DR_HIZ_SHIFT);
+      for (line = 0;line < height;line++) {
+        for (index = 0;index < width;index++) {
+          zline[index] = S3DR_HIZ_FAR;
+        }
+        zline = (UWORD *)((UBYTE *)zline + zbuffer->bpr);
+      }
+      zbuffer->cleared_tiles++;
+    }
+  }
+}
+
+/**
+ * Map the lines, band by band when the Z buffer tiles are active
+ * A band is the part of the lines inside a row of tiles. With lazy clear
+ * the stale tiles crossed by a band are cleared before mapping it. With
+ * Hi-Z, a band which is behind all the tiles it crosses is skipped and the
+ * tiles fully covered by a band get a lower max depth. Like the mappers,
+ * the edges are left after the last line because the generic triangles go
+ * on with them.
+ *
+ * @param bitmap   Bitmap to render
+ * @param textured Use the texture mapper
+ *
+ */
+VOID SAGE_MapLines(SAGE_Bitmap *bitmap, BOOL textured)
+{
+  SAGE_TextureMapping lines;
+  UWORD *tiles;
+  LONG line, last, next, first, y, xs1, xe1, xs2, xe2, left, right, tile;
+  FIXED zl1, zr1, zl2, zr2, zmin, zmax;
+  BOOL hidden;
+
+  if (s3dm_hiz == NULL || s3dm_texmap.nb_line <= 0) {
+    SAGE_CallMapper(bitmap, textured);
+    return;
+  }
+  lines = s3dm_texmap;
+  first = 0;
+  for (line = 0;line < lines.nb_line;line = next) {
+    y = lines.start_y + line;
+    next = (((y >> S3DR_HIZ_SHIFT) + 1) << S3DR_HIZ_SHIFT) - lines.start_y;
+    if (next > lines.nb_line) {
+      next = lines.nb_line;
+    }
+    last = next - 1;
+    // Span edges & depth on the first and the last line of the band
+    xs1 = (lines.dxdyl * line + lines.xl + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    xe1 = (lines.dxdyr * line + lines.xr + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    xs2 = (lines.dxdyl * last + lines.xl + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    xe2 = (lines.dxdyr * last + lines.xr + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    zl1 = lines.dzdyl * line + lines.zl;
+    zr1 = lines.dzdyr * line + lines.zr;
+    zl2 = lines.dzdyl * last + lines.zl;
+    zr2 = lines.dzdyr * last + lines.zr;
+    zmin = zl1;
+    if (zr1 < zmin) zmin = zr1;
+    if (zl2 < zmin) zmin = zl2;
+    if (zr2 < zmin) zmin = zr2;
+    zmax = zl1;
+    if (zr1 > zmax) zmax = zr1;
+    if (zl2 > zmax) zmax = zl2;
+    if (zr2 > zmax) zmax = zr2;
+    zmin = (zmin + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    zmax = (zmax + FIXP16_ROUND_UP) >> FIXP16_SHIFT;
+    // Pixels the band could write
+    left = xs1;
+    if (xs2 < left) left = xs2;
+    if (xe1 < left) left = xe1;
+    if (xe2 < left) left = xe2;
+    right = xe1;
+    if (xe2 > right) right = xe2;
+    if (xs1 > right) right = xs1;
+    if (xs2 > right) right = xs2;
+    if (left < lines.lclip) left = lines.lclip;
+    if (right >= lines.rclip) right = lines.rclip - 1;
+    if (left > right) {
+      continue;
+    }
+    if (s3dm_lazyclear) {
+      SAGE_RefreshZBufferTiles(s3dm_hiz, y >> S3DR_HIZ_SHIFT, left >> S3DR_HIZ_SHIFT, right >> S3DR_HIZ_SHIFT);
+    }
+    if (!s3dm_hiztest || zmin < 0 || zmax > S3DR_HIZ_FAR) {
+      continue;
+    }
+    tiles = s3dm_hiz->tiles + (y >> S3DR_HIZ_SHIFT) * s3dm_hiz->tiles_width;
+    hidden = TRUE;
+    for (tile = left >> S3DR_HIZ_SHIFT;tile <= (right >> S3DR_HIZ_SHIFT) && hidden;tile++) {
+      if (tiles[tile] > zmin) {
+        hidden = FALSE;
+      }
+    }
+    if (hidden) {
+      if (line > first) {
+        SAGE_SetMapperLines(&lines, first, line - first, textured);
+        SAGE_CallMapper(bitmap, textured);
+      }
+      first = next;
+      s3dm_hiz->rejected_tiles += (right >> S3DR_HIZ_SHIFT) - (left >> S3DR_HIZ_SHIFT) + 1;
+    } else if ((next - line) == S3DR_HIZ_SIZE) {
+      // Pixels written on all the lines of the band
+      left = (xs1 > xs2) ? xs1 : xs2;
+      right = (xe1 < xe2) ? xe1 : xe2;
+      if (left < lines.lclip) left = lines.lclip;
+      if (right >= lines.rclip) right = lines.rclip - 1;
+      for (tile = (left + S3DR_HIZ_SIZE - 1) >> S3DR_HIZ_SHIFT;tile < ((right + 1) >> S3DR_HIZ_SHIFT);tile++) {
+        if (tiles[tile] > zmax) {
+          tiles[tile] = (UWORD)zmax;
+        }
+      }
+    }
+  }
+  if (first < lines.nb_line) {
+    SAGE_SetMapperLines(&lines, first, lines.nb_line - first, textured);
+    SAGE_CallMapper(bitmap, textured);
+  } else {
+    // Edges should end after the last line like the mapper does
+    SAGE_SetMapperLines(&lines, lines.nb_line, 0, textured);
+  }
+}
+
+/**
+ * Tell if a triangle is behind all the Hi-Z tiles of its bounding box,
+ * stale tiles of the lazy clear are always in front
+ *
+ * @param triangle Triangle to check (vertices ordered from top to bottom)
+ * @param clipping Screen clipping
+ *
+ * @return TRUE if the triangle is hidden
+ */
+BOOL SAGE_HiddenTriangle(S3D_Triangle *triangle, SAGE_Clipping *clipping)
+{
+  UBYTE *epochs;
+  UWORD *tiles;
+  LONG left, right, top, bottom, zmin, zmax, tile_x, tile_y;
+
+  if (s3dm_hiz == NULL || !s3dm_hiztest) {
+    return FALSE;
+  }
+  zmin = triangle->z1;
+  if (triangle->z2 < zmin) zmin = triangle->z2;
+  if (triangle->z3 < zmin) zmin = triangle->z3;
+  zmax = triangle->z1;
+  if (triangle->z2 > zmax) zmax = triangle->z2;
+  if (triangle->z3 > zmax) zmax = triangle->z3;
+  if (zmin < 0 || zmax > S3DR_HIZ_FAR) {
+    return FALSE;
+  }
+  left = triangle->x1;
+  if (triangle->x2 < left) left = triangle->x2;
+  if (triangle->x3 < left) left = triangle->x3;
+  right = triangle->x1;
+  if (triangle->x2 > right) right = triangle->x2;
+  if (triangle->x3 > right) right = triangle->x3;
+  top = triangle->y1;
+  bottom = triangle->y3 - 1;
+  if (left < clipping->left) left = clipping->left;
+  if (right >= clipping->right) right = clipping->right - 1;
+  if (top < clipping->top) top = clipping->top;
+  if (bottom >= clipping->bottom) bottom = clipping->bottom - 1;
+  if (left > right || top > bottom) {
+    return FALSE;
+  }
+  for (tile_y = top >> S3DR_HIZ_SHIFT;tile_y <= (bottom >> S3DR_HIZ_SHIFT);tile_y++) {
+    tiles = s3dm_hiz->tiles + tile_y * s3dm_hiz->tiles_width;
+    epochs = s3dm_hiz->epochs + tile_y * s3dm_hiz->tiles_width;
+    for (tile_x = left >> S3DR_HIZ_SHIFT;tile_x <= (right >> S3DR_HIZ_SHIFT);tile_x++) {
+      if (tiles[tile_x] > zmin || (s3dm_lazyclear && epochs[tile_x] != s3dm_hiz->epoch)) {
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
 /**
  * Draw a colored flat top triangle
  *
@@ -550,21 +1123,7 @@ VOID SAGE_DrawFlatTopColored(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_C
   s3dm_texmap.nb_line = dy;
   // Go for mapping
   SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", dy);)
-    SAGE_FastMap8BitsColor(&s3dm_texmap);
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", dy);)
-    SAGE_FastMap16BitsColor(&s3dm_texmap);
-  }
-#else
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SAGE_ColorMapper8Bits();
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SAGE_ColorMapper16Bits();
-  }
-#endif
+  SAGE_MapLines(bitmap, FALSE);
 }
 
 /**
@@ -632,21 +1191,7 @@ VOID SAGE_DrawFlatTopTextured(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_
   s3dm_texmap.nb_line = dy;
   // Go for mapping
   SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", dy);)
-    SAGE_FastMap8BitsTexture(&s3dm_texmap);
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", dy);)
-    SAGE_FastMap16BitsTexture(&s3dm_texmap);
-  }
-#else
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SAGE_TextureMapper8Bits();
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SAGE_TextureMapper16Bits();
-  }
-#endif
+  SAGE_MapLines(bitmap, TRUE);
 }
 
 /**
@@ -702,21 +1247,7 @@ VOID SAGE_DrawFlatBottomColored(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAG
   s3dm_texmap.nb_line = dy;
   // Go for mapping
   SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", dy);)
-    SAGE_FastMap8BitsColor(&s3dm_texmap);
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", dy);)
-    SAGE_FastMap16BitsColor(&s3dm_texmap);
-  }
-#else
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SAGE_ColorMapper8Bits();
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SAGE_ColorMapper16Bits();
-  }
-#endif
+  SAGE_MapLines(bitmap, FALSE);
 }
 
 /**
@@ -784,21 +1315,7 @@ VOID SAGE_DrawFlatBottomTextured(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SA
   s3dm_texmap.nb_line = dy;
   // Go for mapping
   SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", dy);)
-    SAGE_FastMap8BitsTexture(&s3dm_texmap);
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", dy);)
-    SAGE_FastMap16BitsTexture(&s3dm_texmap);
-  }
-#else
-  if (bitmap->depth == SBMP_DEPTH8) {
-    SAGE_TextureMapper8Bits();
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    SAGE_TextureMapper16Bits();
-  }
-#endif
+  SAGE_MapLines(bitmap, TRUE);
 }
 
 /**
@@ -886,21 +1403,7 @@ VOID SAGE_DrawGenericColored(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_C
     s3dm_texmap.nb_line = dy3;
     // Go for mapping
     SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-    if (bitmap->depth == SBMP_DEPTH8) {
-      SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", dy3);)
-      SAGE_FastMap8BitsColor(&s3dm_texmap);
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", dy3);)
-      SAGE_FastMap16BitsColor(&s3dm_texmap);
-    }
-#else
-    if (bitmap->depth == SBMP_DEPTH8) {
-      SAGE_ColorMapper8Bits();
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      SAGE_ColorMapper16Bits();
-    }
-#endif
+    SAGE_MapLines(bitmap, FALSE);
   } else {
     SD(SAGE_TraceLog(" => draw first sub-triangle");)
     // y1 top clipping
@@ -929,41 +1432,13 @@ VOID SAGE_DrawGenericColored(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_C
       s3dm_texmap.nb_line = dy1;
       // Go for mapping
       SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", dy1);)
-        SAGE_FastMap8BitsColor(&s3dm_texmap);
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", dy1);)
-        SAGE_FastMap16BitsColor(&s3dm_texmap);
-      }
-#else
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SAGE_ColorMapper8Bits();
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SAGE_ColorMapper16Bits();
-      }
-#endif
+      SAGE_MapLines(bitmap, FALSE);
     } else {
       // Lines to draw
       s3dm_texmap.nb_line = dy1;
       // Go for mapping
       SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", dy1);)
-        SAGE_FastMap8BitsColor(&s3dm_texmap);
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", dy1);)
-        SAGE_FastMap16BitsColor(&s3dm_texmap);
-      }
-#else
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SAGE_ColorMapper8Bits();
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SAGE_ColorMapper16Bits();
-      }
-#endif
+      SAGE_MapLines(bitmap, FALSE);
       SD(SAGE_TraceLog(" => draw second sub-triangle");)
       dy3 = triangle->y3 - triangle->y2;
       if (dy3 <= 0) {
@@ -991,21 +1466,7 @@ VOID SAGE_DrawGenericColored(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_C
       s3dm_texmap.nb_line = dy3;
       // Go for mapping
       SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SD(SAGE_TraceLog("SAGE_FastMap8BitsColor %d lines", dy3);)
-        SAGE_FastMap8BitsColor(&s3dm_texmap);
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SD(SAGE_TraceLog("SAGE_FastMap16BitsColor %d lines", dy3);)
-        SAGE_FastMap16BitsColor(&s3dm_texmap);
-      }
-#else
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SAGE_ColorMapper8Bits();
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SAGE_ColorMapper16Bits();
-      }
-#endif
+      SAGE_MapLines(bitmap, FALSE);
     }
   }
 }
@@ -1119,21 +1580,7 @@ VOID SAGE_DrawGenericTextured(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_
     s3dm_texmap.nb_line = dy3;
     // Go for mapping
     SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-    if (bitmap->depth == SBMP_DEPTH8) {
-      SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", dy3);)
-      SAGE_FastMap8BitsTexture(&s3dm_texmap);
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", dy3);)
-      SAGE_FastMap16BitsTexture(&s3dm_texmap);
-    }
-#else
-    if (bitmap->depth == SBMP_DEPTH8) {
-      SAGE_TextureMapper8Bits();
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      SAGE_TextureMapper16Bits();
-    }
-#endif
+    SAGE_MapLines(bitmap, TRUE);
   } else {
     SD(SAGE_TraceLog(" => draw first sub-triangle");)
     // y1 top clipping
@@ -1170,40 +1617,12 @@ VOID SAGE_DrawGenericTextured(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_
       s3dm_texmap.nb_line = dy1;
       // Go for mapping
       SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", dy1);)
-        SAGE_FastMap8BitsTexture(&s3dm_texmap);
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", dy1);)
-        SAGE_FastMap16BitsTexture(&s3dm_texmap);
-      }
-#else
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SAGE_TextureMapper8Bits();
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SAGE_TextureMapper16Bits();
-      }
-#endif
+      SAGE_MapLines(bitmap, TRUE);
     } else {
       // Lines to draw
       s3dm_texmap.nb_line = dy1;
       SD(SAGE_DebugTexMap();)
-#if SAGE_MAPPER_ASM == 1
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", dy1);)
-        SAGE_FastMap8BitsTexture(&s3dm_texmap);
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", dy1);)
-        SAGE_FastMap16BitsTexture(&s3dm_texmap);
-      }
-#else
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SAGE_TextureMapper8Bits();
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SAGE_TextureMapper16Bits();
-      }
-#endif
+      SAGE_MapLines(bitmap, TRUE);
       SD(SAGE_TraceLog(" => draw second sub-triangle");)
       dy3 = triangle->y3 - triangle->y2;
       if (dy3 <= 0) {
@@ -1238,21 +1657,7 @@ VOID SAGE_DrawGenericTextured(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_
       // Lines to draw
       s3dm_texmap.nb_line = dy3;
       // Go for mapping
-#if SAGE_MAPPER_ASM == 1
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SD(SAGE_TraceLog("SAGE_FastMap8BitsTexture %d lines", dy3);)
-        SAGE_FastMap8BitsTexture(&s3dm_texmap);
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SD(SAGE_TraceLog("SAGE_FastMap16BitsTexture %d lines", dy3);)
-        SAGE_FastMap16BitsTexture(&s3dm_texmap);
-      }
-#else
-      if (bitmap->depth == SBMP_DEPTH8) {
-        SAGE_TextureMapper8Bits();
-      } else if (bitmap->depth == SBMP_DEPTH16) {
-        SAGE_TextureMapper16Bits();
-      }
-#endif
+      SAGE_MapLines(bitmap, TRUE);
     }
   }
 }
@@ -1323,6 +1728,50 @@ ULONG SAGE_CheckTriangleType(S3D_Triangle *triangle, SAGE_Clipping *clipping)
   return TRI_GENERIC;
 }
 
+/**
+ * Set the screen planes of 1/Z, U/Z & V/Z used by the perspective mappers,
+ * these values are linear in screen space
+ *
+ * @param triangle Triangle to draw
+ *
+ * @return FALSE if the triangle can't be mapped with perspective correction
+ */
+BOOL SAGE_SetPerspectivePlanes(S3D_Triangle *triangle)
+{
+  DOUBLE dx2, dy2, dx3, dy3, area, w1, w2, w3, s1, s2, s3, t1, t2, t3;
+
+  if (triangle->z1 <= 0 || triangle->z2 <= 0 || triangle->z3 <= 0) {
+    return FALSE;
+  }
+  dx2 = (DOUBLE)(triangle->x2 - triangle->x1);
+  dy2 = (DOUBLE)(triangle->y2 - triangle->y1);
+  dx3 = (DOUBLE)(triangle->x3 - triangle->x1);
+  dy3 = (DOUBLE)(triangle->y3 - triangle->y1);
+  area = dx2 * dy3 - dx3 * dy2;
+  if (area == 0.0) {
+    return FALSE;
+  }
+  w1 = 1.0 / (DOUBLE)triangle->z1;
+  w2 = 1.0 / (DOUBLE)triangle->z2;
+  w3 = 1.0 / (DOUBLE)triangle->z3;
+  s1 = (DOUBLE)(triangle->u1 << FIXP16_SHIFT) * w1;
+  s2 = (DOUBLE)(triangle->u2 << FIXP16_SHIFT) * w2;
+  s3 = (DOUBLE)(triangle->u3 << FIXP16_SHIFT) * w3;
+  t1 = (DOUBLE)(triangle->v1 << FIXP16_SHIFT) * w1;
+  t2 = (DOUBLE)(triangle->v2 << FIXP16_SHIFT) * w2;
+  t3 = (DOUBLE)(triangle->v3 << FIXP16_SHIFT) * w3;
+  s3dm_texmap.dwdx = ((w2 - w1) * dy3 - (w3 - w1) * dy2) / area;
+  s3dm_texmap.dwdy = ((w3 - w1) * dx2 - (w2 - w1) * dx3) / area;
+  s3dm_texmap.w0 = w1 - s3dm_texmap.dwdx * triangle->x1 - s3dm_texmap.dwdy * triangle->y1;
+  s3dm_texmap.dsdx = ((s2 - s1) * dy3 - (s3 - s1) * dy2) / area;
+  s3dm_texmap.dsdy = ((s3 - s1) * dx2 - (s2 - s1) * dx3) / area;
+  s3dm_texmap.s0 = s1 - s3dm_texmap.dsdx * triangle->x1 - s3dm_texmap.dsdy * triangle->y1;
+  s3dm_texmap.dtdx = ((t2 - t1) * dy3 - (t3 - t1) * dy2) / area;
+  s3dm_texmap.dtdy = ((t3 - t1) * dx2 - (t2 - t1) * dx3) / area;
+  s3dm_texmap.t0 = t1 - s3dm_texmap.dtdx * triangle->x1 - s3dm_texmap.dtdy * triangle->y1;
+  return TRUE;
+}
+
 /**
  * Draw a colored triangle
  */
@@ -1347,10 +1796,24 @@ BOOL SAGE_DrawColoredTriangle(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE_
     s3dm_texmap.z_buffer = NULL;
     s3dm_texmap.zb_bpr = 0;
   }
+  // Z buffer tiles
+  s3dm_hiztest = SAGE_Get3DRenderOption(S3DR_HIZBUFFER);
+  s3dm_lazyclear = SAGE_Get3DRenderOption(S3DR_LAZYZBUFFER);
+  s3dm_refmapper = SAGE_Get3DRenderOption(S3DR_REFMAPPER);
+  if (s3dm_texmap.z_buffer != NULL && (s3dm_hiztest || s3dm_lazyclear)) {
+    s3dm_hiz = &(SageContext.Sage3D->render.zbuffer);
+  } else {
+    s3dm_hiz = NULL;
+  }
   // Color
   s3dm_texmap.color = triangle->color;
   // Check for triangle type
   type = SAGE_CheckTriangleType(triangle, clipping);
+  // Reject the triangle if it's behind the Hi-Z tiles
+  if (type != TRI_REJECTED && SAGE_HiddenTriangle(triangle, clipping)) {
+    s3dm_hiz->rejected_triangles++;
+    return TRUE;
+  }
   // Render triangle depending on his type
   if (type == TRI_FLATTOP) {
     SAGE_DrawFlatTopColored(triangle, bitmap, clipping);
@@ -1386,6 +1849,15 @@ BOOL SAGE_DrawTexturedTriangle(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE
     s3dm_texmap.z_buffer = NULL;
     s3dm_texmap.zb_bpr = 0;
   }
+  // Z buffer tiles
+  s3dm_hiztest = SAGE_Get3DRenderOption(S3DR_HIZBUFFER);
+  s3dm_lazyclear = SAGE_Get3DRenderOption(S3DR_LAZYZBUFFER);
+  s3dm_refmapper = SAGE_Get3DRenderOption(S3DR_REFMAPPER);
+  if (s3dm_texmap.z_buffer != NULL && (s3dm_hiztest || s3dm_lazyclear)) {
+    s3dm_hiz = &(SageContext.Sage3D->render.zbuffer);
+  } else {
+    s3dm_hiz = NULL;
+  }
   // Texture
   s3dm_texmap.tex_buffer = triangle->tex->bitmap->bitmap_buffer;
   s3dm_texmap.tb_bpr = triangle->tex->bitmap->bpr;
@@ -1396,6 +1868,18 @@ BOOL SAGE_DrawTexturedTriangle(S3D_Triangle *triangle, SAGE_Bitmap *bitmap, SAGE
   }
   // Check for triangle type
   type = SAGE_CheckTriangleType(triangle, clipping);
+  // Reject the triangle if it's behind the Hi-Z tiles
+  if (type != TRI_REJECTED && SAGE_HiddenTriangle(triangle, clipping)) {
+    s3dm_hiz->rejected_triangles++;
+    return TRUE;
+  }
+  // Perspective correction
+  s3dm_perspective = FALSE;
+  if (type != TRI_REJECTED && SAGE_Get3DRenderOption(S3DR_PERSPECTIVE)) {
+    s3dm_texmap.umax = (triangle->tex->bitmap->width << FIXP16_SHIFT) - 1;
+    s3dm_texmap.vmax = (triangle->tex->bitmap->height << FIXP16_SHIFT) - 1;
+    s3dm_perspective = SAGE_SetPerspectivePlanes(triangle);
+  }
   // Render triangle depending on his type
   if (type == TRI_FLATTOP) {
     SAGE_DrawFlatTopTextured(triangle, bitmap, clipping);       // New version
@@ -5,7 +5,7 @@
  * 3D texture management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 26/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <exec/types.h>
@@ -91,7 +91,7 @@ BOOL SAGE_CreateTextureFromPicture(UWORD index, UWORD left, UWORD top, UWORD siz
 {
   SAGE_Screen *screen;
   SAGE_3DTexture *texture;
-  UWORD idxcol;
+  UWORD idxcol, tag;
 
   SD(SAGE_DebugLog("Create texture #%d (%d,%d)x%d", index, left, top, size);)
   // Check for video device
@@ -128,10 +128,15 @@ BOOL SAGE_CreateTextureFromPicture(UWORD index, UWORD left, UWORD top, UWORD siz
     SAGE_ReleaseTexture(index);
   }
   // Allocate and init texture
+  tag = SAGE_SetMemoryTag(SMEM_TAG_TEXTURE);
   texture = (SAGE_3DTexture *)SAGE_AllocMem(sizeof(SAGE_3DTexture));
   if (texture != NULL) {
     texture->size = size;
-    if ((texture->bitmap = SAGE_AllocBitmap(texture->size, texture->size, picture->bitmap->depth, 0, picture->bitmap->pixformat, NULL)) != NULL) {
+    texture->bitmap = SAGE_AllocBitmap(texture->size, texture->size, picture->bitmap->depth, 0, picture->bitmap->pixformat, NULL);
+  }
+  SAGE_SetMemoryTag(tag);
+  if (texture != NULL) {
+    if (texture->bitmap != NULL) {
       texture->w3dtex = NULL;
       texture->m3dtex = NULL;
       if (SAGE_BlitPictureToBitmap(picture, left, top, texture->size, texture->size, texture->bitmap, 0, 0)) {
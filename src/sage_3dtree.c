@@ -0,0 +1,364 @@
+/**
+ * sage_3dtree.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * 3D bounding volume tree functions
+ * 
+ * Nodes are stored in depth first order, each node knows the index of the
+ * next node after its subtree so a whole subtree can be skipped without any
+ * recursion, and the items of a subtree are contiguous in the item list.
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 18/06/2025)
+ */
+
+#include <math.h>
+
+#include <sage/sage_logger.h>
+#include <sage/sage_memory.h>
+#include <sage/sage_3dtree.h>
+
+#include <sage/sage_debug.h>
+
+/**
+ * Allocate the tree buffers
+ *
+ * @param tree      Bounding volume tree
+ * @param max_items Max number of items in the tree
+ *
+ * @return Operation success
+ */
+BOOL SAGE_AllocBoundingTree(SAGE_BoundingTree *tree, UWORD max_items)
+{
+  UWORD index;
+
+  SD(SAGE_DebugLog("Alloc bounding tree of %d items", max_items);)
+  tree->max_items = max_items;
+  tree->nb_items = 0;
+  tree->nb_nodes = 0;
+  tree->dirty = TRUE;
+  tree->spheres = (SAGE_BoundingSphere *)SAGE_AllocMem(sizeof(SAGE_BoundingSphere) * max_items);
+  tree->leaves = (UWORD *)SAGE_AllocMem(sizeof(UWORD) * max_items);
+  tree->items = (UWORD *)SAGE_AllocMem(sizeof(UWORD) * max_items);
+  tree->visibility = (UBYTE *)SAGE_AllocMem(sizeof(UBYTE) * max_items);
+  // A tree where each inner node has at least two children never has more than 2n-1 nodes
+  tree->nodes = (SAGE_BoundingNode *)SAGE_AllocMem(sizeof(SAGE_BoundingNode) * max_items * 2);
+  if (tree->spheres != NULL && tree->leaves != NULL && tree->items != NULL && tree->visibility != NULL && tree->nodes != NULL) {
+    for (index = 0;index < max_items;index++) {
+      tree->leaves[index] = S3DE_NO_NODE;
+      tree->visibility[index] = S3DE_TREE_OUTSIDE;
+    }
+    return TRUE;
+  }
+  SAGE_ReleaseBoundingTree(tree);
+  return FALSE;
+}
+
+/**
+ * Release the tree buffers
+ *
+ * @param tree Bounding volume tree
+ */
+VOID SAGE_ReleaseBoundingTree(SAGE_BoundingTree *tree)
+{
+  SD(SAGE_DebugLog("Release bounding tree");)
+  if (tree->spheres != NULL) {
+    SAGE_FreeMem(tree->spheres);
+    tree->spheres = NULL;
+  }
+  if (tree->leaves != NULL) {
+    SAGE_FreeMem(tree->leaves);
+    tree->leaves = NULL;
+  }
+  if (tree->items != NULL) {
+    SAGE_FreeMem(tree->items);
+    tree->items = NULL;
+  }
+  if (tree->visibility != NULL) {
+    SAGE_FreeMem(tree->visibility);
+    tree->visibility = NULL;
+  }
+  if (tree->nodes != NULL) {
+    SAGE_FreeMem(tree->nodes);
+    tree->nodes = NULL;
+  }
+  tree->max_items = 0;
+  tree->nb_items = 0;
+  tree->nb_nodes = 0;
+  tree->dirty = TRUE;
+}
+
+/**
+ * Set the bounding sphere of an item
+ *
+ * @param tree   Bounding volume tree
+ * @param item   Item index
+ * @param posx   Sphere center X
+ * @param posy   Sphere center Y
+ * @param posz   Sphere center Z
+ * @param radius Sphere radius
+ */
+VOID SAGE_SetBoundingSphere(SAGE_BoundingTree *tree, UWORD item, FLOAT posx, FLOAT posy, FLOAT posz, FLOAT radius)
+{
+  if (item < tree->max_items) {
+    tree->spheres[item].posx = posx;
+    tree->spheres[item].posy = posy;
+    tree->spheres[item].posz = posz;
+    tree->spheres[item].radius = radius;
+  }
+}
+
+/**
+ * Fit the node sphere around its item (leaf) or its children (inner node)
+ *
+ * @param tree Bounding volume tree
+ * @param node Node index
+ */
+VOID SAGE_FitBoundingNode(SAGE_BoundingTree *tree, UWORD node)
+{
+  SAGE_BoundingNode *bnode, *child;
+  SAGE_BoundingSphere *sphere;
+  UWORD index;
+  FLOAT minx, miny, minz, maxx, maxy, maxz, x, y, z, radius;
+
+  bnode = &(tree->nodes[node]);
+  if (bnode->skip == (node + 1)) {
+    sphere = &(tree->spheres[tree->items[bnode->first]]);
+    bnode->posx = sphere->posx;
+    bnode->posy = sphere->posy;
+    bnode->posz = sphere->posz;
+    bnode->radius = sphere->radius;
+    return;
+  }
+  // Center the sphere on the box enclosing the children spheres
+  child = &(tree->nodes[node + 1]);
+  minx = child->posx - child->radius; maxx = child->posx + child->radius;
+  miny = child->posy - child->radius; maxy = child->posy + child->radius;
+  minz = child->posz - child->radius; maxz = child->posz + child->radius;
+  for (index = child->skip;index < bnode->skip;index = child->skip) {
+    child = &(tree->nodes[index]);
+    if ((child->posx - child->radius) < minx) minx = child->posx - child->radius;
+    if ((child->posx + child->radius) > maxx) maxx = child->posx + child->radius;
+    if ((child->posy - child->radius) < miny) miny = child->posy - child->radius;
+    if ((child->posy + child->radius) > maxy) maxy = child->posy + child->radius;
+    if ((child->posz - child->radius) < minz) minz = child->posz - child->radius;
+    if ((child->posz + child->radius) > maxz) maxz = child->posz + child->radius;
+  }
+  bnode->posx = (minx + maxx) / 2.0;
+  bnode->posy = (miny + maxy) / 2.0;
+  bnode->posz = (minz + maxz) / 2.0;
+  // Then grow the radius until all children are inside
+  bnode->radius = 0.0;
+  for (index = node + 1;index < bnode->skip;index = child->skip) {
+    child = &(tree->nodes[index]);
+    x = child->posx - bnode->posx;
+    y = child->posy - bnode->posy;
+    z = child->posz - bnode->posz;
+    radius = sqrt((x*x) + (y*y) + (z*z)) + child->radius;
+    if (radius > bnode->radius) {
+      bnode->radius = radius;
+    }
+  }
+}
+
+/**
+ * Add a leaf node for an item already stored in the item list
+ */
+UWORD SAGE_AddBoundingLeaf(SAGE_BoundingTree *tree, UWORD parent, UWORD first)
+{
+  UWORD node;
+
+  node = tree->nb_nodes++;
+  tree->nodes[node].parent = parent;
+  tree->nodes[node].first = first;
+  tree->nodes[node].count = 1;
+  tree->nodes[node].skip = tree->nb_nodes;
+  tree->leaves[tree->items[first]] = node;
+  SAGE_FitBoundingNode(tree, node);
+  return node;
+}
+
+/**
+ * Build the quadtree node of a grid area
+ */
+VOID SAGE_BuildGridNode(SAGE_BoundingTree *tree, UWORD parent, UWORD grid_width, UWORD startx, UWORD starty, UWORD width, UWORD height)
+{
+  UWORD node, half_width, half_height;
+
+  if (width == 1 && height == 1) {
+    tree->items[tree->nb_items] = starty * grid_width + startx;
+    SAGE_AddBoundingLeaf(tree, parent, tree->nb_items++);
+    return;
+  }
+  node = tree->nb_nodes++;
+  tree->nodes[node].parent = parent;
+  tree->nodes[node].first = tree->nb_items;
+  half_width = (width + 1) / 2;
+  half_height = (height + 1) / 2;
+  SAGE_BuildGridNode(tree, node, grid_width, startx, starty, half_width, half_height);
+  if (width > half_width) {
+    SAGE_BuildGridNode(tree, node, grid_width, startx + half_width, starty, width - half_width, half_height);
+  }
+  if (height > half_height) {
+    SAGE_BuildGridNode(tree, node, grid_width, startx, starty + half_height, half_width, height - half_height);
+    if (width > half_width) {
+      SAGE_BuildGridNode(tree, node, grid_width, startx + half_width, starty + half_height, width - half_width, height - half_height);
+    }
+  }
+  tree->nodes[node].count = tree->nb_items - tree->nodes[node].first;
+  tree->nodes[node].skip = tree->nb_nodes;
+  SAGE_FitBoundingNode(tree, node);
+}
+
+/**
+ * Build a quadtree over a grid of items, item index is y * width + x
+ *
+ * @param tree   Bounding volume tree
+ * @param width  Grid width
+ * @param height Grid height
+ *
+ * @return Operation success
+ */
+BOOL SAGE_BuildGridTree(SAGE_BoundingTree *tree, UWORD width, UWORD height)
+{
+  SD(SAGE_DebugLog("Build grid tree %dx%d", width, height);)
+  tree->nb_items = 0;
+  tree->nb_nodes = 0;
+  if (width == 0 || height == 0 || (ULONG)(width * height) > tree->max_items) {
+    return FALSE;
+  }
+  SAGE_BuildGridNode(tree, S3DE_NO_NODE, width, 0, 0, width, height);
+  tree->dirty = FALSE;
+  SD(SAGE_DebugLog("Grid tree has %d nodes for %d items", tree->nb_nodes, tree->nb_items);)
+  return TRUE;
+}
+
+/**
+ * Build the binary tree node of a range of the item list
+ * Items are split at the middle of the widest axis of their centers
+ */
+VOID SAGE_BuildBinaryNode(SAGE_BoundingTree *tree, UWORD parent, UWORD first, UWORD count)
+{
+  SAGE_BoundingSphere *sphere;
+  UWORD node, index, middle, item;
+  FLOAT minx, miny, minz, maxx, maxy, maxz, split, value;
+  UWORD axis;
+
+  if (count == 1) {
+    SAGE_AddBoundingLeaf(tree, parent, first);
+    return;
+  }
+  node = tree->nb_nodes++;
+  tree->nodes[node].parent = parent;
+  tree->nodes[node].first = first;
+  tree->nodes[node].count = count;
+  sphere = &(tree->spheres[tree->items[first]]);
+  minx = maxx = sphere->posx;
+  miny = maxy = sphere->posy;
+  minz = maxz = sphere->posz;
+  for (index = first + 1;index < (first + count);index++) {
+    sphere = &(tree->spheres[tree->items[index]]);
+    if (sphere->posx < minx) minx = sphere->posx;
+    if (sphere->posx > maxx) maxx = sphere->posx;
+    if (sphere->posy < miny) miny = sphere->posy;
+    if (sphere->posy > maxy) maxy = sphere->posy;
+    if (sphere->posz < minz) minz = sphere->posz;
+    if (sphere->posz > maxz) maxz = sphere->posz;
+  }
+  if ((maxx - minx) >= (maxy - miny) && (maxx - minx) >= (maxz - minz)) {
+    axis = 0;
+    split = (minx + maxx) / 2.0;
+  } else if ((maxy - miny) >= (maxz - minz)) {
+    axis = 1;
+    split = (miny + maxy) / 2.0;
+  } else {
+    axis = 2;
+    split = (minz + maxz) / 2.0;
+  }
+  // Move the items below the split at the start of the range
+  middle = first;
+  for (index = first;index < (first + count);index++) {
+    sphere = &(tree->spheres[tree->items[index]]);
+    if (axis == 0) {
+      value = sphere->posx;
+    } else if (axis == 1) {
+      value = sphere->posy;
+    } else {
+      value = sphere->posz;
+    }
+    if (value < split) {
+      item = tree->items[index];
+      tree->items[index] = tree->items[middle];
+      tree->items[middle] = item;
+      middle++;
+    }
+  }
+  // All centers are at the same place, just cut the range in two
+  if (middle == first || middle == (first + count)) {
+    middle = first + count / 2;
+  }
+  SAGE_BuildBinaryNode(tree, node, first, middle - first);
+  SAGE_BuildBinaryNode(tree, node, middle, (first + count) - middle);
+  tree->nodes[node].skip = tree->nb_nodes;
+  SAGE_FitBoundingNode(tree, node);
+}
+
+/**
+ * Build a binary tree over a list of items
+ *
+ * @param tree     Bounding volume tree
+ * @param items    Item index list
+ * @param nb_items Number of items
+ *
+ * @return Operation success
+ */
+BOOL SAGE_BuildBinaryTree(SAGE_BoundingTree *tree, UWORD *items, UWORD nb_items)
+{
+  UWORD index;
+
+  SD(SAGE_DebugLog("Build binary tree of %d items", nb_items);)
+  tree->nb_items = 0;
+  tree->nb_nodes = 0;
+  if (nb_items > tree->max_items) {
+    return FALSE;
+  }
+  for (index = 0;index < tree->max_items;index++) {
+    tree->leaves[index] = S3DE_NO_NODE;
+  }
+  for (index = 0;index < nb_items;index++) {
+    tree->items[index] = items[index];
+  }
+  if (nb_items > 0) {
+    SAGE_BuildBinaryNode(tree, S3DE_NO_NODE, 0, nb_items);
+  }
+  tree->nb_items = nb_items;
+  tree->dirty = FALSE;
+  return TRUE;
+}
+
+/**
+ * Refit the tree after an item has moved, the item sphere should have been
+ * updated with SAGE_SetBoundingSphere before, only the nodes on the path from
+ * the item leaf to the root are fitted again
+ *
+ * @param tree Bounding volume tree
+ * @param item Item index
+ *
+ * @return Number of refitted nodes
+ */
+UWORD SAGE_RefitBoundingTree(SAGE_BoundingTree *tree, UWORD item)
+{
+  UWORD node, refitted;
+
+  refitted = 0;
+  if (tree->dirty || item >= tree->max_items) {
+    return refitted;
+  }
+  node = tree->leaves[item];
+  while (node != S3DE_NO_NODE) {
+    SAGE_FitBoundingNode(tree, node);
+    refitted++;
+    node = tree->nodes[node].parent;
+  }
+  return refitted;
+}
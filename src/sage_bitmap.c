@@ -5,7 +5,7 @@
  * Bitmap management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <exec/exec.h>
@@ -256,7 +256,10 @@ BOOL SAGE_CheckSizeConstraint(ULONG width, ULONG depth)
 }
 
 /**
- * Allocate fast draw buffers for the bitmap
+ * Allocate fast draw buffers for the bitmap, the edge buffers and the row
+ * offsets used by the batched primitives. The edge buffers are not taken from
+ * the frame arenas, they are the scratch of one primitive and every draw call
+ * reuses them
  * 
  * @param bitmap SAGE bitmap pointer
  * 
@@ -264,6 +267,8 @@ BOOL SAGE_CheckSizeConstraint(ULONG width, ULONG depth)
  */
 BOOL SAGE_AllocateFastDrawBuffers(SAGE_Bitmap *bitmap)
 {
+  ULONG row;
+
   if (bitmap != NULL) {
     if (bitmap->first_buffer != NULL) {
       SAGE_FreeMem(bitmap->first_buffer);
@@ -271,9 +276,16 @@ BOOL SAGE_AllocateFastDrawBuffers(SAGE_Bitmap *bitmap)
     if (bitmap->second_buffer != NULL) {
       SAGE_FreeMem(bitmap->second_buffer);
     }
+    if (bitmap->row_offsets != NULL) {
+      SAGE_FreeMem(bitmap->row_offsets);
+    }
     bitmap->first_buffer = (LONG *)SAGE_AllocMem(SBMP_DRAWBUFSIZE);
     bitmap->second_buffer = (LONG *)SAGE_AllocMem(SBMP_DRAWBUFSIZE);
-    if (bitmap->first_buffer != NULL && bitmap->second_buffer != NULL) {
+    bitmap->row_offsets = (ULONG *)SAGE_AllocMem(sizeof(ULONG) * bitmap->height);
+    if (bitmap->first_buffer != NULL && bitmap->second_buffer != NULL && bitmap->row_offsets != NULL) {
+      for (row = 0;row < bitmap->height;row++) {
+        bitmap->row_offsets[row] = row * bitmap->width;
+      }
       return TRUE;
     }
   } else {
@@ -303,7 +315,7 @@ SAGE_Bitmap *SAGE_AllocBitmap(ULONG width, ULONG height, ULONG depth, ULONG bpr,
     return NULL;
   }
   // Allocate and init bitmap
-  bitmap = (SAGE_Bitmap *)SAGE_AllocMem(sizeof(SAGE_Bitmap));
+  bitmap = (SAGE_Bitmap *)SAGE_PoolAlloc(sizeof(SAGE_Bitmap));
   if (bitmap != NULL) {
     bitmap->properties = SBMP_NO_PROPERTY;
     bitmap->width = width;
@@ -323,6 +335,7 @@ SAGE_Bitmap *SAGE_AllocBitmap(ULONG width, ULONG height, ULONG depth, ULONG bpr,
     bitmap->bitmap_buffer = NULL;
     bitmap->first_buffer = NULL;
     bitmap->second_buffer = NULL;
+    bitmap->row_offsets = NULL;
     if (custom_bitmap != NULL) {
       bitmap->properties |= SBMP_CUSTOM;
       bitmap->bitmap_buffer = custom_bitmap;
@@ -369,10 +382,13 @@ VOID SAGE_ReleaseBitmap(SAGE_Bitmap *bitmap)
     if (bitmap->second_buffer != NULL) {
       SAGE_FreeMem(bitmap->second_buffer);
     }
+    if (bitmap->row_offsets != NULL) {
+      SAGE_FreeMem(bitmap->row_offsets);
+    }
     if (!(bitmap->properties & SBMP_CUSTOM) && bitmap->bitmap_buffer != NULL) {
       SAGE_FreeMem(bitmap->bitmap_buffer);
     }
-    SAGE_FreeMem(bitmap);
+    SAGE_PoolFree(bitmap);
   }
 }
 
@@ -925,6 +941,29 @@ BOOL SAGE_BlitBitmap(SAGE_Bitmap *source, ULONG left, ULONG top, ULONG width, UL
   return TRUE;
 }
 
+/**
+ * Get the copy function of a depth, for callers doing many blits between
+ * bitmaps they have already checked
+ * 
+ * @param depth Bitmap depth
+ *
+ * @return Blit function or NULL if the depth is unknown
+ */
+SAGE_BitmapBlitter SAGE_GetBitmapBlitter(ULONG depth)
+{
+  if (depth == SBMP_DEPTH8) {
+    return SAGE_Blit8BitsBitmap;
+  } else if (depth == SBMP_DEPTH16) {
+    return SAGE_Blit16BitsBitmap;
+  } else if (depth == SBMP_DEPTH24) {
+    return SAGE_Blit24BitsBitmap;
+  } else if (depth == SBMP_DEPTH32) {
+    return SAGE_Blit32BitsBitmap;
+  }
+  SAGE_SetError(SERR_UNKNOWN_DEPTH);
+  return NULL;
+}
+
 /**
  * Copy a part of a 8bits bitmap buffer into another 8bits bitmap buffer with zoom
  * 
@@ -0,0 +1,351 @@
+/**
+ * sage_collision.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Sprite collision world
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <sage/sage_debug.h>
+#include <sage/sage_error.h>
+#include <sage/sage_logger.h>
+#include <sage/sage_memory.h>
+#include <sage/sage_sprite.h>
+#include <sage/sage_collision.h>
+
+/**
+ * Create a collision world, the objects are sorted in a spatial hash so only
+ * the objects sharing a cell are tested against each other
+ * 
+ * @param max_objects Maximum number of objects
+ * @param max_pairs   Maximum number of colliding pairs
+ * @param cell_size   Spatial hash cell size, rounded to a power of 2 (should
+ *                    be larger than most of the sprites)
+ * 
+ * @return Collision world or NULL on error
+ */
+SAGE_CollisionWorld *SAGE_CreateCollisionWorld(UWORD max_objects, ULONG max_pairs, UWORD cell_size)
+{
+  SAGE_CollisionWorld *world;
+  ULONG hash_size;
+
+  SD(SAGE_DebugLog("Create collision world (%d objects, %d pairs, cell %d)", max_objects, max_pairs, cell_size);)
+  SAFE(if (max_objects == 0 || max_pairs == 0) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return NULL;
+  })
+  if ((world = (SAGE_CollisionWorld *)SAGE_AllocMem(sizeof(SAGE_CollisionWorld))) != NULL) {
+    world->max_objects = max_objects;
+    world->cell_shift = 0;
+    while ((1 << world->cell_shift) < cell_size && world->cell_shift < SCOL_MAXCELLSHIFT) {
+      world->cell_shift++;
+    }
+    hash_size = 64;
+    while (hash_size < ((ULONG)max_objects * 2)) {
+      hash_size <<= 1;
+    }
+    world->hash_mask = hash_size - 1;
+    world->max_entries = (ULONG)max_objects * SCOL_CELLSPEROBJECT;
+    world->max_pairs = max_pairs;
+    world->nb_pairs = 0;
+    world->objects = (SAGE_CollisionObject *)SAGE_AllocMem(sizeof(SAGE_CollisionObject) * max_objects);
+    world->buckets = (ULONG *)SAGE_AllocMem(sizeof(ULONG) * hash_size);
+    world->entries = (SAGE_CollisionEntry *)SAGE_AllocMem(sizeof(SAGE_CollisionEntry) * world->max_entries);
+    world->pairs = (SAGE_CollisionPair *)SAGE_AllocMem(sizeof(SAGE_CollisionPair) * max_pairs);
+    if (world->objects != NULL && world->buckets != NULL && world->entries != NULL && world->pairs != NULL) {
+      return world;
+    }
+    SAGE_ReleaseCollisionWorld(world);
+  }
+  SAGE_SetError(SERR_NO_MEMORY);
+  return NULL;
+}
+
+/**
+ * Release a collision world
+ * 
+ * @param world Collision world
+ */
+VOID SAGE_ReleaseCollisionWorld(SAGE_CollisionWorld *world)
+{
+  SD(SAGE_DebugLog("Release collision world");)
+  if (world != NULL) {
+    if (world->objects != NULL) {
+      SAGE_FreeMem(world->objects);
+    }
+    if (world->buckets != NULL) {
+      SAGE_FreeMem(world->buckets);
+    }
+    if (world->entries != NULL) {
+      SAGE_FreeMem(world->entries);
+    }
+    if (world->pairs != NULL) {
+      SAGE_FreeMem(world->pairs);
+    }
+    SAGE_FreeMem(world);
+  }
+}
+
+/**
+ * Add a sprite object to the world, the object is not tested until it has
+ * been moved
+ * 
+ * @param world  Collision world
+ * @param index  Sprite bank index
+ * @param sprite Sprite index
+ * @param layer  Collision layers of the object
+ * @param mask   Collision layers the object collides with
+ * 
+ * @return Object id or SCOL_NOOBJECT on error
+ */
+WORD SAGE_AddCollisionObject(SAGE_CollisionWorld *world, UWORD index, UWORD sprite, ULONG layer, ULONG mask)
+{
+  SAGE_CollisionObject *object;
+  UWORD id;
+
+  SAFE(if (world == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return SCOL_NOOBJECT;
+  })
+  if (SAGE_GetSprite(index, sprite) == NULL) {
+    return SCOL_NOOBJECT;
+  }
+  for (id = 0;id < world->max_objects;id++) {
+    object = &(world->objects[id]);
+    if (!object->active) {
+      object->active = TRUE;
+      object->index = index;
+      object->sprite = sprite;
+      object->layer = layer;
+      object->mask = mask;
+      object->left = 0;
+      object->top = 0;
+      object->width = -1;
+      object->height = -1;
+      return (WORD)id;
+    }
+  }
+  SAGE_SetError(SERR_COLLISION_FULL);
+  return SCOL_NOOBJECT;
+}
+
+/**
+ * Remove an object from the world
+ * 
+ * @param world Collision world
+ * @param id    Object id
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_RemoveCollisionObject(SAGE_CollisionWorld *world, WORD id)
+{
+  SAFE(if (world == NULL || id < 0 || id >= (WORD)world->max_objects) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  world->objects[id].active = FALSE;
+  return TRUE;
+}
+
+/**
+ * Move an object, the box is placed with the sprite hotspot like in
+ * SAGE_BlitSpriteToScreen
+ * 
+ * @param world Collision world
+ * @param id    Object id
+ * @param x_pos Horizontal position
+ * @param y_pos Vertical position
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_MoveCollisionObject(SAGE_CollisionWorld *world, WORD id, LONG x_pos, LONG y_pos)
+{
+  SAGE_CollisionObject *object;
+  SAGE_Sprite *sprite;
+
+  SAFE(if (world == NULL || id < 0 || id >= (WORD)world->max_objects) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  object = &(world->objects[id]);
+  if ((sprite = SAGE_GetSprite(object->index, object->sprite)) == NULL) {
+    return FALSE;
+  }
+  object->left = x_pos - sprite->hs_x;
+  object->top = y_pos - sprite->hs_y;
+  object->width = (LONG)sprite->width;
+  object->height = (LONG)sprite->height;
+  return TRUE;
+}
+
+/**
+ * Get the hash bucket of a cell
+ */
+ULONG SAGE_CollisionBucket(SAGE_CollisionWorld *world, LONG cell_x, LONG cell_y)
+{
+  return (((ULONG)cell_x * 73856093) ^ ((ULONG)cell_y * 19349663)) & world->hash_mask;
+}
+
+/**
+ * Test two objects sharing a cell and keep the pair if they collide
+ */
+BOOL SAGE_TestCollisionPair(SAGE_CollisionWorld *world, SAGE_CollisionEntry *entry1, SAGE_CollisionEntry *entry2)
+{
+  SAGE_CollisionObject *obj1, *obj2;
+  SAGE_CollisionPair *pair;
+  SAGE_Sprite *spr1, *spr2;
+  LONG corner_x, corner_y;
+
+  obj1 = &(world->objects[entry1->object]);
+  obj2 = &(world->objects[entry2->object]);
+  if (!(obj1->layer & obj2->mask) && !(obj2->layer & obj1->mask)) {
+    return TRUE;
+  }
+  // Boxes which touch each other collide, like SAGE_SpriteCollide
+  if (!SAGE_BoxCollide(obj1->left, obj1->top, obj1->width, obj1->height, obj2->left, obj2->top, obj2->width, obj2->height)) {
+    return TRUE;
+  }
+  // Objects sharing several cells are reported only by the cell holding the top left corner of their intersection
+  corner_x = (obj1->left > obj2->left) ? obj1->left : obj2->left;
+  corner_y = (obj1->top > obj2->top) ? obj1->top : obj2->top;
+  if ((corner_x >> world->cell_shift) != entry1->cell_x || (corner_y >> world->cell_shift) != entry1->cell_y) {
+    return TRUE;
+  }
+  // Refine with the collision masks when both sprites have some
+  spr1 = SAGE_GetSprite(obj1->index, obj1->sprite);
+  spr2 = SAGE_GetSprite(obj2->index, obj2->sprite);
+  if (spr1 != NULL && spr2 != NULL && spr1->mask_words != 0 && spr2->mask_words != 0
+      && !SAGE_MaskCollide(spr1, obj1->left, obj1->top, spr2, obj2->left, obj2->top)) {
+    return TRUE;
+  }
+  if (world->nb_pairs >= world->max_pairs) {
+    SAGE_SetError(SERR_COLLISION_FULL);
+    return FALSE;
+  }
+  pair = &(world->pairs[world->nb_pairs++]);
+  if (entry1->object < entry2->object) {
+    pair->first = entry1->object;
+    pair->second = entry2->object;
+  } else {
+    pair->first = entry2->object;
+    pair->second = entry1->object;
+  }
+  return TRUE;
+}
+
+/**
+ * Find all the colliding pairs of objects, the objects are hashed in all the
+ * cells covered by their boxes then the objects of a same cell are checked
+ * with SAGE_BoxCollide (boxes which touch each other collide) and with
+ * SAGE_MaskCollide when both sprites have a mask
+ * 
+ * @param world Collision world
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_FindCollisions(SAGE_CollisionWorld *world)
+{
+  SAGE_CollisionObject *object;
+  SAGE_CollisionEntry *entry, *other, *entries;
+  ULONG bucket, nb_entries, idx, next;
+  LONG cell_x, cell_y, last_x, last_y;
+  UWORD id;
+
+  SAFE(if (world == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  world->nb_pairs = 0;
+  for (bucket = 0;bucket <= world->hash_mask;bucket++) {
+    world->buckets[bucket] = SCOL_ENDLIST;
+  }
+  // Count the covered cells, the entries grow when the objects are larger than the cells
+  nb_entries = 0;
+  for (id = 0;id < world->max_objects;id++) {
+    object = &(world->objects[id]);
+    if (object->active && object->width > 0 && object->height > 0) {
+      // Cover the pixel after the box too, touching boxes must share a cell
+      cell_x = ((object->left + object->width) >> world->cell_shift) - (object->left >> world->cell_shift) + 1;
+      cell_y = ((object->top + object->height) >> world->cell_shift) - (object->top >> world->cell_shift) + 1;
+      nb_entries += (ULONG)(cell_x * cell_y);
+    }
+  }
+  if (nb_entries > world->max_entries) {
+    SD(SAGE_DebugLog("Grow collision entries to %d", nb_entries);)
+    if ((entries = (SAGE_CollisionEntry *)SAGE_AllocMem(sizeof(SAGE_CollisionEntry) * nb_entries)) == NULL) {
+      return FALSE;
+    }
+    SAGE_FreeMem(world->entries);
+    world->entries = entries;
+    world->max_entries = nb_entries;
+  }
+  // Hash the objects
+  nb_entries = 0;
+  for (id = 0;id < world->max_objects;id++) {
+    object = &(world->objects[id]);
+    if (object->active && object->width > 0 && object->height > 0) {
+      last_x = (object->left + object->width) >> world->cell_shift;
+      last_y = (object->top + object->height) >> world->cell_shift;
+      for (cell_y = object->top >> world->cell_shift;cell_y <= last_y;cell_y++) {
+        for (cell_x = object->left >> world->cell_shift;cell_x <= last_x;cell_x++) {
+          bucket = SAGE_CollisionBucket(world, cell_x, cell_y);
+          entry = &(world->entries[nb_entries]);
+          entry->cell_x = cell_x;
+          entry->cell_y = cell_y;
+          entry->object = id;
+          entry->next = world->buckets[bucket];
+          world->buckets[bucket] = nb_entries++;
+        }
+      }
+    }
+  }
+  // Test the objects of the same cell
+  for (bucket = 0;bucket <= world->hash_mask;bucket++) {
+    for (idx = world->buckets[bucket];idx != SCOL_ENDLIST;idx = entry->next) {
+      entry = &(world->entries[idx]);
+      for (next = entry->next;next != SCOL_ENDLIST;next = other->next) {
+        other = &(world->entries[next]);
+        if (other->cell_x == entry->cell_x && other->cell_y == entry->cell_y) {
+          if (!SAGE_TestCollisionPair(world, entry, other)) {
+            return FALSE;
+          }
+        }
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Get the number of colliding pairs found by the last search
+ * 
+ * @param world Collision world
+ * 
+ * @return Number of pairs
+ */
+ULONG SAGE_GetNbCollisions(SAGE_CollisionWorld *world)
+{
+  SAFE(if (world == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return 0;
+  })
+  return world->nb_pairs;
+}
+
+/**
+ * Get the colliding pairs found by the last search
+ * 
+ * @param world Collision world
+ * 
+ * @return Pairs of object id, the first id is the lowest
+ */
+SAGE_CollisionPair *SAGE_GetCollisionPairs(SAGE_CollisionWorld *world)
+{
+  SAFE(if (world == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return NULL;
+  })
+  return world->pairs;
+}
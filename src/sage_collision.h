@@ -0,0 +1,87 @@
+/**
+ * sage_collision.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Sprite collision world
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_COLLISION_H_
+#define _SAGE_COLLISION_H_
+
+#include <exec/types.h>
+
+#define SCOL_NOOBJECT         -1
+#define SCOL_ENDLIST          0xFFFFFFFF
+#define SCOL_CELLSPEROBJECT   4                     // Hash entries reserved per object, grown by the search when needed
+#define SCOL_MAXCELLSHIFT     10
+
+#define SCOL_ALLLAYERS        0xFFFFFFFF
+
+/** SAGE collision object structure */
+typedef struct {
+  /** Object is in the world */
+  BOOL active;
+  /** Sprite bank and sprite index */
+  UWORD index, sprite;
+  /** Layers of the object and layers it collides with */
+  ULONG layer, mask;
+  /** Hotspot adjusted box */
+  LONG left, top, width, height;
+} SAGE_CollisionObject;
+
+/** SAGE collision pair structure */
+typedef struct {
+  WORD first, second;
+} SAGE_CollisionPair;
+
+/** SAGE collision hash entry */
+typedef struct {
+  LONG cell_x, cell_y;
+  UWORD object;
+  ULONG next;
+} SAGE_CollisionEntry;
+
+/** SAGE collision world structure */
+typedef struct {
+  /** Objects */
+  UWORD max_objects;
+  SAGE_CollisionObject *objects;
+  /** Spatial hash cell size (power of 2) */
+  UWORD cell_shift;
+  /** Spatial hash buckets and entries */
+  ULONG hash_mask, *buckets;
+  ULONG max_entries;
+  SAGE_CollisionEntry *entries;
+  /** Colliding pairs of the last search */
+  ULONG max_pairs, nb_pairs;
+  SAGE_CollisionPair *pairs;
+} SAGE_CollisionWorld;
+
+/** Create a collision world */
+SAGE_CollisionWorld *SAGE_CreateCollisionWorld(UWORD, ULONG, UWORD);
+
+/** Release a collision world */
+VOID SAGE_ReleaseCollisionWorld(SAGE_CollisionWorld *);
+
+/** Add a sprite object to the world */
+WORD SAGE_AddCollisionObject(SAGE_CollisionWorld *, UWORD, UWORD, ULONG, ULONG);
+
+/** Remove an object from the world */
+BOOL SAGE_RemoveCollisionObject(SAGE_CollisionWorld *, WORD);
+
+/** Move an object of the world */
+BOOL SAGE_MoveCollisionObject(SAGE_CollisionWorld *, WORD, LONG, LONG);
+
+/** Find all the colliding pairs of objects */
+BOOL SAGE_FindCollisions(SAGE_CollisionWorld *);
+
+/** Get the number of colliding pairs of the last search */
+ULONG SAGE_GetNbCollisions(SAGE_CollisionWorld *);
+
+/** Get the colliding pairs of the last search */
+SAGE_CollisionPair *SAGE_GetCollisionPairs(SAGE_CollisionWorld *);
+
+#endif
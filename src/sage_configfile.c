@@ -5,11 +5,13 @@
  * Configuration file management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 #include <dos/dos.h>
 #include <clib/dos_protos.h>
@@ -20,9 +22,17 @@
 #include <sage/sage_memory.h>
 #include <sage/sage_configfile.h>
 
-UBYTE line_buffer[SCFG_BUFFER_SIZE];
 STRPTR empty_string = "";
 
+/** Config file kept by SAGE_GetParameterFromFile and its date when it was loaded */
+SAGE_Configuration *cached_config = NULL;
+STRPTR cached_filename = NULL;
+struct DateStamp cached_date;
+
+/** Boolean values */
+STRPTR true_words[] = { "TRUE", "YES", "ON", "1", NULL };
+STRPTR false_words[] = { "FALSE", "NO", "OFF", "0", NULL };
+
 /******************************************************************************/
 
 /**
@@ -32,8 +42,8 @@ VOID SAGE_DumpConfiguration(SAGE_Configuration *config)
 {
   SAGE_ConfSection *section;
   SAGE_ConfParameter *parameter;
-  
-  SAGE_DebugLog("** Configuration dump");
+
+  SAGE_DebugLog("** Configuration dump (%d parameters, %d buckets)", config->nb_params, config->param_mask + 1);
   if (config->parameters != NULL) {
     parameter = config->parameters;
     while (parameter != NULL) {
@@ -60,283 +70,347 @@ VOID SAGE_DumpConfiguration(SAGE_Configuration *config)
 /******************************************************************************/
 
 /**
- * Find a section in config file
- *
- * @param section Section name
- * @param fdesc   File descriptor
- *
- * @return Operation success
+ * Hash a name (FNV-1a), parameters are seeded with the hash of their section
  */
-BOOL SAGE_FindSection(STRPTR section, BPTR fdesc)
+ULONG SAGE_ConfHash(STRPTR name, ULONG seed)
 {
-  UWORD index;
+  while (*name != '\0') {
+    seed = (seed ^ *name++) * SCFG_HASH_PRIME;
+  }
+  return seed;
+}
 
-  while (FGets(fdesc, line_buffer, SCFG_BUFFER_SIZE)) {
-    if (line_buffer[0] == '[') {
-      index = 0;
-      while (line_buffer[index] != ']' && line_buffer[index] != '\0') {
-        index++;
-      }
-      if (line_buffer[index] == ']') {
-        if (strncmp(line_buffer+1, section, index-1) == 0) {
-          return TRUE;
-        }
-      }
+/**
+ * Allocate a bloc from the string arena, the arena is only released with the
+ * configuration
+ */
+APTR SAGE_ConfAlloc(SAGE_Configuration *config, ULONG size)
+{
+  SAGE_ConfChunk *chunk;
+  ULONG chunk_size;
+  UBYTE *bloc;
+
+  size = (size + SCFG_ARENA_ALIGN - 1) & ~(SCFG_ARENA_ALIGN - 1);
+  chunk = config->chunks;
+  if (chunk == NULL || (chunk->used + size) > chunk->size) {
+    chunk_size = (size > SCFG_CHUNK_SIZE) ? size : SCFG_CHUNK_SIZE;
+    if ((chunk = (SAGE_ConfChunk *)SAGE_AllocMem(sizeof(SAGE_ConfChunk) + chunk_size)) == NULL) {
+      SAGE_SetError(SERR_NO_MEMORY);
+      return NULL;
     }
-  }
-  return FALSE;
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    chunk->next_chunk = config->chunks;
+    config->chunks = chunk;
+  }
+  bloc = (UBYTE *)chunk + sizeof(SAGE_ConfChunk) + chunk->used;
+  chunk->used += size;
+  return bloc;
 }
 
 /**
- * Find a parameter in config file
- *
- * @param parameter Parameter name
- * @param buffer    Buffer for parameter
- * @param size      Buffer size
- * @param fdesc     File descriptor
- *
- * @return Operation success
+ * Copy a string to the arena
  */
-BOOL SAGE_FindParameter(STRPTR parameter, STRPTR buffer, ULONG size, BPTR fdesc)
+STRPTR SAGE_ConfString(SAGE_Configuration *config, STRPTR string)
 {
-  UWORD index, debut;
+  STRPTR copy;
 
-  while (FGets(fdesc, line_buffer, SCFG_BUFFER_SIZE)) {
-    // New section, param is not here
-    if (line_buffer[0] == '[') {
-      return FALSE;
-    }
-    // Line is not a comment
-    if (line_buffer[0] != ';') {
-      index = 0;
-      while (line_buffer[index] != '=' && line_buffer[index] != '\0') {
-        index++;
-      }
-      if (line_buffer[index] == '=') {
-        // Param has been found
-        if (strncmp(line_buffer, parameter, index) == 0) {
-          debut = ++index;
-          while (line_buffer[index] != '\n' && line_buffer[index] != '\0') {
-            index++;
-          }
-          line_buffer[index] = '\0';
-          if (strlen(line_buffer+debut) > size) {
-            strncpy(buffer, line_buffer+debut, size-1);
-            buffer[size-1] = '\0';
-          } else {
-            strcpy(buffer, line_buffer+debut);
-          }
-          return TRUE;
-        }
-      }
-    }
+  if ((copy = (STRPTR)SAGE_ConfAlloc(config, strlen(string) + 1)) != NULL) {
+    strcpy(copy, string);
   }
-  return FALSE;
+  return copy;
 }
 
 /**
- * Get a parameter value from a config file
- *
- * @param filename    Config file name
- * @param section     Section name or NULL
- * @param parameter   Parameter name
- * @param defaut      Default value or NULL
- * @param buffer      Buffer for parameter
- * @param buffer_size Buffer size
- *
- * @return Operation success
+ * Set the size of the parameter table (power of 2) and rehash the parameters
  */
-BOOL SAGE_GetParameterFromFile(STRPTR filename, STRPTR section, STRPTR parameter, STRPTR defaut, STRPTR buffer, LONG buffer_size)
+BOOL SAGE_ResizeParameterTable(SAGE_Configuration *config, ULONG size)
 {
-  BPTR fdesc;
+  SAGE_ConfParameter **buckets, *parameter, *next;
+  ULONG idx;
 
-  if (filename == NULL || parameter == NULL || buffer == NULL) {
-    SAGE_SetError(SERR_NULL_POINTER);
-    return FALSE;
-  }
-  if (strlen(defaut) >= buffer_size) {
-    SAGE_SetError(SERR_BUFFERSIZE);
+  if ((buckets = (SAGE_ConfParameter **)SAGE_AllocMem(sizeof(SAGE_ConfParameter *) * size)) == NULL) {
     return FALSE;
   }
-  if (defaut != NULL) {
-    strcpy(buffer, defaut);
-  } else {
-    buffer[0] = '\0';
-  }
-  fdesc = Open(filename, MODE_OLDFILE);
-  if (!fdesc) {
-    SAGE_SetError(SERR_FILENOTFOUND);
-    return FALSE;
-  }
-  if (section != NULL) {
-    if (!SAGE_FindSection(section, fdesc)) {
-      Close(fdesc);
-      SAGE_SetError(SERR_NOSECTION);
-      return FALSE;
+  if (config->param_buckets != NULL) {
+    for (idx = 0;idx <= config->param_mask;idx++) {
+      for (parameter = config->param_buckets[idx];parameter != NULL;parameter = next) {
+        next = (SAGE_ConfParameter *)parameter->next_hash;
+        parameter->next_hash = buckets[parameter->hash & (size - 1)];
+        buckets[parameter->hash & (size - 1)] = parameter;
+      }
     }
+    SAGE_FreeMem(config->param_buckets);
   }
-  if (SAGE_FindParameter(parameter, buffer, buffer_size, fdesc)) {
-    Close(fdesc);
-    return TRUE;
-  }
-  Close(fdesc);
-  SAGE_SetError(SERR_NOPARAMETER);
-  return FALSE;
+  config->param_buckets = buckets;
+  config->param_mask = size - 1;
+  return TRUE;
 }
 
 /**
- * Create a new parameter
+ * Create an empty configuration sized for a number of parameters
  */
-SAGE_ConfParameter *SAGE_CreateParameter(STRPTR name, STRPTR value)
+SAGE_Configuration *SAGE_CreateConfiguration(ULONG nb_params)
 {
-  SAGE_ConfParameter *parameter;
-  
-  parameter = SAGE_AllocMem(sizeof(SAGE_ConfParameter));
-  if (parameter != NULL) {
-    parameter->param_name = SAGE_AllocMem(strlen(name)+1);
-    parameter->param_value = SAGE_AllocMem(strlen(value)+1);
-    if (parameter->param_name != NULL && parameter->param_value != NULL) {
-      strcpy(parameter->param_name, name);
-      strcpy(parameter->param_value, value);
-      parameter->next_param = NULL;
-      return parameter;
+  SAGE_Configuration *config;
+  ULONG size;
+
+  if ((config = (SAGE_Configuration *)SAGE_AllocMem(sizeof(SAGE_Configuration))) != NULL) {
+    size = SCFG_MIN_BUCKETS;
+    while ((size * SCFG_LOAD_FACTOR) < nb_params) {
+      size <<= 1;
     }
+    if (SAGE_ResizeParameterTable(config, size)) {
+      return config;
+    }
+    SAGE_FreeMem(config);
   }
   SAGE_SetError(SERR_NO_MEMORY);
-  return FALSE;
+  return NULL;
 }
 
 /**
- * Release a parameter
+ * Find a section by its name and hash
  */
-VOID SAGE_ReleaseParameter(SAGE_ConfParameter *parameter)
+SAGE_ConfSection *SAGE_FindSection(SAGE_Configuration *config, STRPTR name, ULONG hash)
 {
-  if (parameter->next_param != NULL) {
-    SAGE_ReleaseParameter((SAGE_ConfParameter *)parameter->next_param);
+  SAGE_ConfSection *section;
+
+  section = config->section_buckets[hash & (SCFG_SECTION_BUCKETS - 1)];
+  while (section != NULL) {
+    if (section->hash == hash && strcmp(name, section->section_name) == 0) {
+      return section;
+    }
+    section = (SAGE_ConfSection *)section->next_hash;
   }
-  SAGE_FreeMem(parameter->param_name);
-  SAGE_FreeMem(parameter->param_value);
-  SAGE_FreeMem(parameter);
+  return NULL;
 }
 
 /**
- * Create a new section
+ * Find a parameter of a section (NULL for the global parameters) by its name
+ * and hash
  */
-SAGE_ConfSection *SAGE_CreateSection(STRPTR name)
+SAGE_ConfParameter *SAGE_FindParameter(SAGE_Configuration *config, SAGE_ConfSection *section, STRPTR name, ULONG hash)
 {
-  SAGE_ConfSection *section;
-  
-  section = SAGE_AllocMem(sizeof(SAGE_ConfSection));
-  if (section != NULL) {
-    section->section_name = SAGE_AllocMem(strlen(name)+1);
-    if (section->section_name != NULL) {
-      strcpy(section->section_name, name);
-      section->next_section = NULL;
-      return section;
+  SAGE_ConfParameter *parameter;
+
+  parameter = config->param_buckets[hash & config->param_mask];
+  while (parameter != NULL) {
+    if (parameter->hash == hash && parameter->section == section && strcmp(name, parameter->param_name) == 0) {
+      return parameter;
     }
+    parameter = (SAGE_ConfParameter *)parameter->next_hash;
   }
-  SAGE_SetError(SERR_NO_MEMORY);
-  return FALSE;
+  return NULL;
 }
 
 /**
- * Release a section
+ * Add a section to the config, an existing section is returned so a section
+ * which appears twice in the file keeps all its parameters
  */
-VOID SAGE_ReleaseSection(SAGE_ConfSection *section)
+SAGE_ConfSection *SAGE_AddSection(SAGE_Configuration *config, STRPTR name, ULONG hash, BOOL copy)
 {
-  if (section->next_section != NULL) {
-    SAGE_ReleaseSection((SAGE_ConfSection *)section->next_section);
+  SAGE_ConfSection *section;
+
+  if ((section = SAGE_FindSection(config, name, hash)) != NULL) {
+    return section;
+  }
+  if ((section = (SAGE_ConfSection *)SAGE_ConfAlloc(config, sizeof(SAGE_ConfSection))) == NULL) {
+    return NULL;
+  }
+  if (copy && (name = SAGE_ConfString(config, name)) == NULL) {
+    return NULL;
   }
-  if (section->parameters != NULL) {
-    SAGE_ReleaseParameter(section->parameters);
+  SD(SAGE_DebugLog("Add a section %s", name);)
+  section->section_name = name;
+  section->parameters = NULL;
+  section->last_param = NULL;
+  section->next_section = NULL;
+  section->hash = hash;
+  section->next_hash = config->section_buckets[hash & (SCFG_SECTION_BUCKETS - 1)];
+  config->section_buckets[hash & (SCFG_SECTION_BUCKETS - 1)] = section;
+  if (config->last_section == NULL) {
+    config->sections = section;
+  } else {
+    config->last_section->next_section = section;
   }
-  SAGE_FreeMem(section->section_name);
-  SAGE_FreeMem(section);
+  config->last_section = section;
+  return section;
 }
 
 /**
- * Add a section to the config
+ * Add a parameter to a section (NULL for the global parameters), the caller
+ * checks that the parameter does not exist
  */
-BOOL SAGE_AddSection(SAGE_Configuration *config, STRPTR name)
+SAGE_ConfParameter *SAGE_AddParameter(SAGE_Configuration *config, SAGE_ConfSection *section, STRPTR name, ULONG hash, STRPTR value, BOOL copy)
 {
-  SAGE_ConfSection *section, *parent;
+  SAGE_ConfParameter *parameter;
 
-  section = SAGE_CreateSection(name);
-  if (section != NULL) {
-    SD(SAGE_DebugLog("Add a section %s", section->section_name);)
-    if (config->sections == NULL) {
-      config->sections = section;
+  if ((parameter = (SAGE_ConfParameter *)SAGE_ConfAlloc(config, sizeof(SAGE_ConfParameter))) == NULL) {
+    return NULL;
+  }
+  if (copy && ((name = SAGE_ConfString(config, name)) == NULL || (value = SAGE_ConfString(config, value)) == NULL)) {
+    return NULL;
+  }
+  // A table which can't grow is only slower
+  if (config->nb_params >= ((config->param_mask + 1) * SCFG_LOAD_FACTOR)) {
+    SAGE_ResizeParameterTable(config, (config->param_mask + 1) << 1);
+  }
+  parameter->param_name = name;
+  parameter->param_value = value;
+  parameter->next_param = NULL;
+  parameter->section = section;
+  parameter->hash = hash;
+  parameter->next_hash = config->param_buckets[hash & config->param_mask];
+  parameter->cached = 0;
+  config->param_buckets[hash & config->param_mask] = parameter;
+  config->nb_params++;
+  if (section == NULL) {
+    if (config->last_param == NULL) {
+      config->parameters = parameter;
     } else {
-      parent = config->sections;
-      while (parent->next_section != NULL) {
-        parent = (SAGE_ConfSection *)parent->next_section;
-      }
-      parent->next_section = section;
+      config->last_param->next_param = parameter;
     }
-    return TRUE;
+    config->last_param = parameter;
+  } else {
+    if (section->last_param == NULL) {
+      section->parameters = parameter;
+    } else {
+      section->last_param->next_param = parameter;
+    }
+    section->last_param = parameter;
   }
-  return FALSE;
+  return parameter;
 }
 
 /**
- * Get the section with supplied name
+ * Parse a file buffer in place, names and values are cut in the buffer and
+ * are hashed while they are scanned
+ *
+ * @param config Config structure
+ * @param buffer File buffer, one more byte than the file size
+ * @param size   File size
+ *
+ * @return Operation success
  */
-SAGE_ConfSection *SAGE_GetSection(SAGE_Configuration *config, STRPTR name)
+BOOL SAGE_ParseConfiguration(SAGE_Configuration *config, UBYTE *buffer, ULONG size)
 {
-  SAGE_ConfSection *confsec;
-
-  if (config->sections != NULL) {
-    confsec = config->sections;
-    while (confsec != NULL) {
-      if (strcmp(name, confsec->section_name) == 0) {
-        return confsec;
+  SAGE_ConfSection *section = NULL;
+  UBYTE *line, *end, *eol, *mark;
+  ULONG hash;
+
+  end = buffer + size;
+  *end = '\0';
+  line = buffer;
+  while (line < end) {
+    if ((eol = (UBYTE *)memchr(line, '\n', end - line)) == NULL) {
+      eol = end;
+    }
+    *eol = '\0';
+    if (eol > line && *(eol - 1) == '\r') {
+      *(eol - 1) = '\0';
+    }
+    if (line[0] == '[') {
+      hash = SCFG_HASH_OFFSET;
+      mark = line + 1;
+      while (*mark != ']' && *mark != '\0') {
+        hash = (hash ^ *mark++) * SCFG_HASH_PRIME;
+      }
+      if (*mark == ']') {
+        *mark = '\0';
+        if ((section = SAGE_AddSection(config, line + 1, hash, FALSE)) == NULL) {
+          return FALSE;
+        }
+      }
+    } else if (line[0] != ';' && line[0] != ' ' && line[0] != '\t' && line[0] != '\0') {
+      hash = (section != NULL) ? section->hash : SCFG_HASH_OFFSET;
+      mark = line;
+      while (*mark != '=' && *mark != '\0') {
+        hash = (hash ^ *mark++) * SCFG_HASH_PRIME;
+      }
+      if (*mark == '=') {
+        *mark = '\0';
+        // The first value of a parameter is kept
+        if (SAGE_FindParameter(config, section, line, hash) == NULL) {
+          if (SAGE_AddParameter(config, section, line, hash, mark + 1, FALSE) == NULL) {
+            return FALSE;
+          }
+        }
       }
-      confsec = confsec->next_section;
     }
+    line = eol + 1;
   }
-  SAGE_SetError(SERR_NOSECTION);
-  return NULL;
+  return TRUE;
 }
 
 /**
- * Push a parameter to the config or to the last section
+ * Read a whole file in a buffer ended by a zero
  */
-BOOL SAGE_PushParameter(SAGE_Configuration *config, STRPTR name, STRPTR value)
+UBYTE *SAGE_ReadConfigurationFile(STRPTR filename, ULONG *size)
 {
-  SAGE_ConfSection *section;
-  SAGE_ConfParameter *parameter, *parent;
-
-  parameter = SAGE_CreateParameter(name, value);
-  if (parameter != NULL) {
-    SD(SAGE_DebugLog("Push a parameter %s=%s", parameter->param_name, parameter->param_value);)
-    if (config->sections == NULL) {
-      if (config->parameters == NULL) {
-        config->parameters = parameter;
-      } else {
-        parent = config->parameters;
-        while (parent->next_param != NULL) {
-          parent = (SAGE_ConfParameter *)parent->next_param;
-        }
-        parent->next_param = parameter;
-      }
-    } else {
-      section = config->sections;
-      while (section->next_section != NULL) {
-        section = (SAGE_ConfSection *)section->next_section;
-      }
-      if (section->parameters == NULL) {
-        section->parameters = parameter;
-      } else {
-        parent = section->parameters;
-        while (parent->next_param != NULL) {
-          parent = (SAGE_ConfParameter *)parent->next_param;
-        }
-        parent->next_param = parameter;
+  BPTR fdesc;
+  UBYTE *buffer = NULL;
+  LONG length;
+
+  fdesc = Open(filename, MODE_OLDFILE);
+  if (!fdesc) {
+    SAGE_SetError(SERR_FILENOTFOUND);
+    return NULL;
+  }
+  Seek(fdesc, 0, OFFSET_END);
+  length = Seek(fdesc, 0, OFFSET_BEGINNING);
+  if (length < 0) {
+    SAGE_SetError(SERR_READFILE);
+  } else if ((buffer = (UBYTE *)SAGE_AllocMem(length + 1)) == NULL) {
+    SAGE_SetError(SERR_NO_MEMORY);
+  } else if (Read(fdesc, buffer, length) != length) {
+    SAGE_FreeMem(buffer);
+    buffer = NULL;
+    SAGE_SetError(SERR_READFILE);
+  }
+  Close(fdesc);
+  *size = (ULONG)length;
+  return buffer;
+}
+
+/**
+ * Get the last modification date of a file
+ *
+ * @param filename File name
+ * @param date     Date of the file
+ *
+ * @return Operation success
+ */
+BOOL SAGE_ConfFileDate(STRPTR filename, struct DateStamp *date)
+{
+  struct FileInfoBlock *fib;
+  BPTR lock;
+  BOOL success = FALSE;
+
+  if ((lock = Lock(filename, SHARED_LOCK)) != 0) {
+    if ((fib = (struct FileInfoBlock *)AllocDosObject(DOS_FIB, NULL)) != NULL) {
+      if (Examine(lock, fib)) {
+        *date = fib->fib_Date;
+        success = TRUE;
       }
+      FreeDosObject(DOS_FIB, fib);
     }
-    return TRUE;
+    UnLock(lock);
   }
-  return FALSE;
+  return success;
+}
+
+/**
+ * Get the section with supplied name
+ */
+SAGE_ConfSection *SAGE_GetSection(SAGE_Configuration *config, STRPTR name)
+{
+  SAGE_ConfSection *confsec;
+
+  if ((confsec = SAGE_FindSection(config, name, SAGE_ConfHash(name, SCFG_HASH_OFFSET))) == NULL) {
+    SAGE_SetError(SERR_NOSECTION);
+  }
+  return confsec;
 }
 
 /**
@@ -350,95 +424,60 @@ BOOL SAGE_PushParameter(SAGE_Configuration *config, STRPTR name, STRPTR value)
  */
 SAGE_ConfParameter *SAGE_GetParameter(SAGE_Configuration *config, STRPTR section, STRPTR name)
 {
-  SAGE_ConfSection *confsec;
+  SAGE_ConfSection *confsec = NULL;
   SAGE_ConfParameter *confparam;
-  
+  ULONG hash = SCFG_HASH_OFFSET;
+
   if (section != NULL) {
-    confsec = SAGE_GetSection(config, section);
-    if (confsec == NULL) {
-      SAGE_SetError(SERR_NOSECTION);
+    if ((confsec = SAGE_GetSection(config, section)) == NULL) {
       return NULL;
     }
-    confparam = confsec->parameters;
-  } else {
-    confparam = config->parameters;
+    hash = confsec->hash;
   }
-  if (confparam != NULL) {
-    while (confparam != NULL) {
-      if (strcmp(name, confparam->param_name) == 0) {
-        return confparam;
-      }
-      confparam = confparam->next_param;
-    }
+  if ((confparam = SAGE_FindParameter(config, confsec, name, SAGE_ConfHash(name, hash))) == NULL) {
+    SAGE_SetError(SERR_NOPARAMETER);
   }
-  SAGE_SetError(SERR_NOPARAMETER);
-  return NULL;
+  return confparam;
 }
 
 /**
- * Update/create a parameter in a config
+ * Update/create a parameter in a config, the replaced value stays in the arena
+ * until the config is released
  *
  * @param config  Config structure
  * @param section Section name or NULL
  * @param name    Parameter name
- * @param value   Parameter value or NULL
+ * @param value   Parameter value
  *
  * @return Operation success
  */
 BOOL SAGE_SetParameter(SAGE_Configuration *config, STRPTR section, STRPTR name, STRPTR value)
 {
-  SAGE_ConfSection *confsec;
-  SAGE_ConfParameter *confparam, *parent;
+  SAGE_ConfSection *confsec = NULL;
+  SAGE_ConfParameter *confparam;
+  ULONG hash = SCFG_HASH_OFFSET;
 
-  confparam = SAGE_GetParameter(config, section, name);
-  if (confparam != NULL) {
-    // Parameter exists, update it
-    SAGE_FreeMem(confparam->param_value);
-    confparam->param_value = SAGE_AllocMem(strlen(value)+1);
-    if (confparam->param_value != NULL) {
-      strcpy(confparam->param_value, value);
-      return TRUE;
+  if (section != NULL) {
+    // Section did not exists, create it
+    if ((confsec = SAGE_AddSection(config, section, SAGE_ConfHash(section, SCFG_HASH_OFFSET), TRUE)) == NULL) {
+      return FALSE;
     }
-    SAGE_SetError(SERR_NO_MEMORY);
-  } else {
-    // Parameter did not exists, create it
-    confparam = SAGE_CreateParameter(name, value);
-    if (confparam != NULL) {
-      if (section == NULL) {
-        // Add it to global config
-        if (config->parameters == NULL) {
-          config->parameters = confparam;
-        } else {
-          parent = config->parameters;
-          while (parent->next_param != NULL) {
-            parent = (SAGE_ConfParameter *)parent->next_param;
-          }
-          parent->next_param = confparam;
-        }
-      } else {
-        // Add it to a section
-        confsec = SAGE_GetSection(config, section);
-        if (confsec == NULL) {
-          // Section did not exists, create it
-          if (!SAGE_AddSection(config, section)) {
-            return FALSE;
-          }
-          confsec = SAGE_GetSection(config, section);
-        }
-        // Add the parameter to the section
-        if (confsec->parameters == NULL) {
-          confsec->parameters = confparam;
-        } else {
-          parent = confsec->parameters;
-          while (parent->next_param != NULL) {
-            parent = (SAGE_ConfParameter *)parent->next_param;
-          }
-          parent->next_param = confparam;
-        }
+    hash = confsec->hash;
+  }
+  hash = SAGE_ConfHash(name, hash);
+  if ((confparam = SAGE_FindParameter(config, confsec, name, hash)) != NULL) {
+    // Parameter exists, update it
+    if (strcmp(confparam->param_value, value) != 0) {
+      if ((value = SAGE_ConfString(config, value)) == NULL) {
+        return FALSE;
       }
+      confparam->param_value = value;
+      confparam->cached = 0;
     }
+    return TRUE;
   }
-  return FALSE;
+  // Parameter did not exists, create it
+  return (BOOL)(SAGE_AddParameter(config, confsec, name, hash, value, TRUE) != NULL);
 }
 
 /**
@@ -453,42 +492,165 @@ BOOL SAGE_SetParameter(SAGE_Configuration *config, STRPTR section, STRPTR name,
 BOOL SAGE_RemoveParameter(SAGE_Configuration *config, STRPTR section, STRPTR name)
 {
   SAGE_ConfSection *confsec;
-  SAGE_ConfParameter *confparam, *parent;
+  SAGE_ConfParameter *confparam, *parent, **link;
 
-  if (section != NULL) {
-    confsec = SAGE_GetSection(config, section);
-    if (confsec == NULL) {
-      return FALSE;
-    }
-    parent = confsec->parameters;
-  } else {
-    parent = config->parameters;
-  }
-  confparam = SAGE_GetParameter(config, section, name);
-  if (confparam == NULL) {
+  if ((confparam = SAGE_GetParameter(config, section, name)) == NULL) {
     return FALSE;
   }
+  // Remove it from the hash table
+  link = &(config->param_buckets[confparam->hash & config->param_mask]);
+  while (*link != confparam) {
+    link = (SAGE_ConfParameter **)&((*link)->next_hash);
+  }
+  *link = (SAGE_ConfParameter *)confparam->next_hash;
+  // Remove it from the file order
+  confsec = (SAGE_ConfSection *)confparam->section;
+  parent = (confsec != NULL) ? confsec->parameters : config->parameters;
   if (confparam == parent) {
     // First of the list
-    if (section == NULL) {
-      config->parameters = confparam->next_param;
+    parent = NULL;
+    if (confsec != NULL) {
+      confsec->parameters = (SAGE_ConfParameter *)confparam->next_param;
     } else {
-      confsec->parameters = confparam->next_param;
+      config->parameters = (SAGE_ConfParameter *)confparam->next_param;
     }
   } else {
     // Search the parameter
     while (confparam != parent->next_param) {
-      parent = parent->next_param;
+      parent = (SAGE_ConfParameter *)parent->next_param;
     }
     parent->next_param = confparam->next_param;
   }
-  confparam->next_param = NULL;
-  SAGE_ReleaseParameter(confparam);
+  if (confsec != NULL && confsec->last_param == confparam) {
+    confsec->last_param = parent;
+  } else if (confsec == NULL && config->last_param == confparam) {
+    config->last_param = parent;
+  }
+  config->nb_params--;
   return TRUE;
 }
 
 /**
- * Load a configuration file
+ * Tell if only blanks are left in a value
+ */
+BOOL SAGE_ConfBlank(STRPTR value)
+{
+  while (*value == ' ' || *value == '\t') {
+    value++;
+  }
+  return (BOOL)(*value == '\0');
+}
+
+/**
+ * Compare a value to an upper case word, blanks around the value and case are
+ * ignored
+ */
+BOOL SAGE_ConfWord(STRPTR value, STRPTR word)
+{
+  while (*value == ' ' || *value == '\t') {
+    value++;
+  }
+  while (*word != '\0') {
+    if (toupper(*value++) != *word++) {
+      return FALSE;
+    }
+  }
+  return SAGE_ConfBlank(value);
+}
+
+/**
+ * Get a parameter value from a config file, the last file is kept loaded so
+ * the next calls on the same file only look in the hash tables. A change of
+ * the file is not seen until SAGE_RefreshConfigurationCache or
+ * SAGE_ReleaseConfigurationCache is called.
+ *
+ * @param filename    Config file name
+ * @param section     Section name or NULL
+ * @param parameter   Parameter name
+ * @param defaut      Default value or NULL
+ * @param buffer      Buffer for parameter
+ * @param buffer_size Buffer size
+ *
+ * @return Operation success
+ */
+BOOL SAGE_GetParameterFromFile(STRPTR filename, STRPTR section, STRPTR parameter, STRPTR defaut, STRPTR buffer, LONG buffer_size)
+{
+  SAGE_ConfParameter *confparam;
+
+  if (filename == NULL || parameter == NULL || buffer == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  }
+  if (buffer_size <= 0 || (defaut != NULL && strlen(defaut) >= buffer_size)) {
+    SAGE_SetError(SERR_BUFFERSIZE);
+    return FALSE;
+  }
+  if (defaut != NULL) {
+    strcpy(buffer, defaut);
+  } else {
+    buffer[0] = '\0';
+  }
+  if (cached_config != NULL && strcmp(filename, cached_filename) != 0) {
+    SAGE_ReleaseConfigurationCache();
+  }
+  if (cached_config == NULL) {
+    // Date taken before the load, a write during the load is seen by the next refresh
+    if (!SAGE_ConfFileDate(filename, &cached_date)) {
+      SAGE_SetError(SERR_FILENOTFOUND);
+      return FALSE;
+    }
+    if ((cached_config = SAGE_LoadConfigurationFile(filename)) == NULL) {
+      return FALSE;
+    }
+    if ((cached_filename = SAGE_ConfString(cached_config, filename)) == NULL) {
+      SAGE_ReleaseConfigurationCache();
+      return FALSE;
+    }
+  }
+  if ((confparam = SAGE_GetParameter(cached_config, section, parameter)) == NULL) {
+    return FALSE;
+  }
+  strncpy(buffer, confparam->param_value, buffer_size - 1);
+  buffer[buffer_size - 1] = '\0';
+  return TRUE;
+}
+
+/**
+ * Release the config file kept by SAGE_GetParameterFromFile, the next call
+ * reads the file again
+ */
+VOID SAGE_ReleaseConfigurationCache(VOID)
+{
+  if (cached_config != NULL) {
+    SAGE_ReleaseConfigurationFile(cached_config);
+    cached_config = NULL;
+    cached_filename = NULL;
+  }
+}
+
+/**
+ * Check the date of the config file kept by SAGE_GetParameterFromFile and
+ * release it when the file changed since it was loaded, the next call reads
+ * the file again. A change in the same tick (1/50s) as the load is not seen.
+ *
+ * @return TRUE if the file changed
+ */
+BOOL SAGE_RefreshConfigurationCache(VOID)
+{
+  struct DateStamp date;
+
+  if (cached_config != NULL) {
+    if (!SAGE_ConfFileDate(cached_filename, &date) || CompareDates(&date, &cached_date) != 0) {
+      SAGE_ReleaseConfigurationCache();
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * Load a configuration file, the file is read in one buffer and parsed in a
+ * single pass
  *
  * @param filename Config file name
  *
@@ -496,63 +658,47 @@ BOOL SAGE_RemoveParameter(SAGE_Configuration *config, STRPTR section, STRPTR nam
  */
 SAGE_Configuration *SAGE_LoadConfigurationFile(STRPTR filename)
 {
-  BPTR fdesc;
   SAGE_Configuration *config;
-  UWORD index, pstart;
+  UBYTE *buffer;
+  ULONG size;
 
   if (filename == NULL) {
     SAGE_SetError(SERR_NULL_POINTER);
     return NULL;
   }
-  fdesc = Open(filename, MODE_OLDFILE);
-  if (!fdesc) {
-    SAGE_SetError(SERR_FILENOTFOUND);
+  if ((buffer = SAGE_ReadConfigurationFile(filename, &size)) == NULL) {
     return NULL;
   }
-  config = (SAGE_Configuration *)SAGE_AllocMem(sizeof(SAGE_Configuration));
-  if (config == NULL) {
-    Close(fdesc);
-    SAGE_SetError(SERR_NO_MEMORY);
+  if ((config = SAGE_CreateConfiguration(size / SCFG_BYTES_PER_PARAM)) == NULL) {
+    SAGE_FreeMem(buffer);
     return NULL;
   }
-  while (FGets(fdesc, line_buffer, SCFG_BUFFER_SIZE)) {
-    if (line_buffer[0] != ';' && line_buffer[0] != ' ' && line_buffer[0] != '\t' && line_buffer[0] != '\0') {
-      if (line_buffer[0] == '[') {
-        index = 0;
-        while (line_buffer[index] != ']' && line_buffer[index] != '\0') {
-          index++;
-        }
-        if (line_buffer[index] == ']') {
-          line_buffer[index] = '\0';
-          SAGE_AddSection(config, line_buffer+1);
-        }
-      } else {
-        index = 0;
-        while (line_buffer[index] != '=' && line_buffer[index] != '\0') {
-          index++;
-        }
-        if (line_buffer[index] == '=') {
-          line_buffer[index] = '\0';
-          pstart = ++index;
-          while (line_buffer[index] != '\n' && line_buffer[index] != '\0') {
-            index++;
-          }
-          line_buffer[index] = '\0';
-          SAGE_PushParameter(config, line_buffer, line_buffer+pstart);
-        }
-      }
-    }
+  config->file_buffer = buffer;
+  if (!SAGE_ParseConfiguration(config, buffer, size)) {
+    SAGE_ReleaseConfigurationFile(config);
+    return NULL;
   }
-  Close(fdesc);
   SD(SAGE_DumpConfiguration(config);)
   return config;
 }
 
+/**
+ * Write a parameter line
+ */
+VOID SAGE_WriteParameter(BPTR fdesc, SAGE_ConfParameter *confparam)
+{
+  FPuts(fdesc, confparam->param_name);
+  FPuts(fdesc, "=");
+  FPuts(fdesc, confparam->param_value);
+  FPuts(fdesc, "\n");
+}
+
 /**
  * Save a configuration file
  *
  * @param config   Configuration structure
  * @param filename Config file name
+ * @param header   Header comment or NULL
  *
  * @return Operation success
  */
@@ -562,43 +708,45 @@ BOOL SAGE_SaveConfigurationFile(SAGE_Configuration *config, STRPTR filename, STR
   SAGE_ConfSection *confsec;
   SAGE_ConfParameter *confparam;
 
-  if (filename == NULL) {
+  if (config == NULL || filename == NULL) {
     SAGE_SetError(SERR_NULL_POINTER);
     return FALSE;
   }
+  if (cached_config != NULL && strcmp(filename, cached_filename) == 0) {
+    SAGE_ReleaseConfigurationCache();
+  }
   fdesc = Open(filename, MODE_NEWFILE);
   if (!fdesc) {
     SAGE_SetError(SERR_FILENOTFOUND);
     return FALSE;
   }
   if (header != NULL) {
-    sprintf(line_buffer, "; %s\n", header);
-    FPuts(fdesc, line_buffer);
+    FPuts(fdesc, "; ");
+    FPuts(fdesc, header);
+    FPuts(fdesc, "\n");
   }
   if (config->parameters != NULL) {
-    sprintf(line_buffer, "\n");
-    FPuts(fdesc, line_buffer);
+    FPuts(fdesc, "\n");
     confparam = config->parameters;
     while (confparam != NULL) {
-      sprintf(line_buffer, "%s=%s\n", confparam->param_name, confparam->param_value);
-      FPuts(fdesc, line_buffer);
-      confparam = confparam->next_param;
+      SAGE_WriteParameter(fdesc, confparam);
+      confparam = (SAGE_ConfParameter *)confparam->next_param;
     }
   }
   if (config->sections != NULL) {
     confsec = config->sections;
     while (confsec != NULL) {
-      sprintf(line_buffer, "\n[%s]\n", confsec->section_name);
-      FPuts(fdesc, line_buffer);
+      FPuts(fdesc, "\n[");
+      FPuts(fdesc, confsec->section_name);
+      FPuts(fdesc, "]\n");
       if (confsec->parameters != NULL) {
         confparam = confsec->parameters;
         while (confparam != NULL) {
-          sprintf(line_buffer, "%s=%s\n", confparam->param_name, confparam->param_value);
-          FPuts(fdesc, line_buffer);
-          confparam = confparam->next_param;
+          SAGE_WriteParameter(fdesc, confparam);
+          confparam = (SAGE_ConfParameter *)confparam->next_param;
         }
       }
-      confsec = confsec->next_section;
+      confsec = (SAGE_ConfSection *)confsec->next_section;
     }
   }
   Close(fdesc);
@@ -612,13 +760,21 @@ BOOL SAGE_SaveConfigurationFile(SAGE_Configuration *config, STRPTR filename, STR
  */
 VOID SAGE_ReleaseConfigurationFile(SAGE_Configuration *config)
 {
-  if (config->parameters != NULL) {
-    SAGE_ReleaseParameter(config->parameters);
-  }
-  if (config->sections != NULL) {
-    SAGE_ReleaseSection(config->sections);
+  SAGE_ConfChunk *chunk;
+
+  if (config != NULL) {
+    while ((chunk = config->chunks) != NULL) {
+      config->chunks = (SAGE_ConfChunk *)chunk->next_chunk;
+      SAGE_FreeMem(chunk);
+    }
+    if (config->param_buckets != NULL) {
+      SAGE_FreeMem(config->param_buckets);
+    }
+    if (config->file_buffer != NULL) {
+      SAGE_FreeMem(config->file_buffer);
+    }
+    SAGE_FreeMem(config);
   }
-  SAGE_FreeMem(config);
 }
 
 /**
@@ -649,6 +805,129 @@ STRPTR SAGE_GetParameterValue(SAGE_Configuration *config, STRPTR section, STRPTR
   return confparam->param_value;
 }
 
+/**
+ * Get an integer parameter from a config, the value is decimal or hexadecimal
+ * with a 0x prefix and is parsed only on the first call
+ *
+ * @param config  Config structure
+ * @param section Section name or NULL
+ * @param name    Parameter name
+ * @param defaut  Default value
+ *
+ * @return Parameter value or default value if the parameter is missing or is
+ *         not an integer
+ */
+LONG SAGE_GetParameterInteger(SAGE_Configuration *config, STRPTR section, STRPTR name, LONG defaut)
+{
+  SAGE_ConfParameter *confparam;
+  char *value, *end;
+
+  if (config == NULL || name == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return defaut;
+  }
+  if ((confparam = SAGE_GetParameter(config, section, name)) == NULL) {
+    return defaut;
+  }
+  if (!(confparam->cached & (SCFG_INTEGER|SCFG_BADINTEGER))) {
+    value = (char *)confparam->param_value;
+    while (*value == ' ' || *value == '\t') {
+      value++;
+    }
+    if (value[0] == '0' && (value[1] == 'x' || value[1] == 'X')) {
+      confparam->integer_value = (LONG)strtoul(value, &end, 16);
+    } else {
+      confparam->integer_value = strtol(value, &end, 10);
+    }
+    confparam->cached |= (end != value && SAGE_ConfBlank((STRPTR)end)) ? SCFG_INTEGER : SCFG_BADINTEGER;
+  }
+  if (confparam->cached & SCFG_BADINTEGER) {
+    SAGE_SetError(SERR_BADVALUE);
+    return defaut;
+  }
+  return confparam->integer_value;
+}
+
+/**
+ * Get a float parameter from a config, the value is parsed only on the first
+ * call
+ *
+ * @param config  Config structure
+ * @param section Section name or NULL
+ * @param name    Parameter name
+ * @param defaut  Default value
+ *
+ * @return Parameter value or default value if the parameter is missing or is
+ *         not a number
+ */
+FLOAT SAGE_GetParameterFloat(SAGE_Configuration *config, STRPTR section, STRPTR name, FLOAT defaut)
+{
+  SAGE_ConfParameter *confparam;
+  char *end;
+
+  if (config == NULL || name == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return defaut;
+  }
+  if ((confparam = SAGE_GetParameter(config, section, name)) == NULL) {
+    return defaut;
+  }
+  if (!(confparam->cached & (SCFG_FLOAT|SCFG_BADFLOAT))) {
+    confparam->float_value = (FLOAT)strtod((char *)confparam->param_value, &end);
+    confparam->cached |= (end != (char *)confparam->param_value && SAGE_ConfBlank((STRPTR)end)) ? SCFG_FLOAT : SCFG_BADFLOAT;
+  }
+  if (confparam->cached & SCFG_BADFLOAT) {
+    SAGE_SetError(SERR_BADVALUE);
+    return defaut;
+  }
+  return confparam->float_value;
+}
+
+/**
+ * Get a boolean parameter from a config, TRUE/YES/ON/1 and FALSE/NO/OFF/0 are
+ * recognized whatever the case and the value is parsed only on the first call
+ *
+ * @param config  Config structure
+ * @param section Section name or NULL
+ * @param name    Parameter name
+ * @param defaut  Default value
+ *
+ * @return Parameter value or default value if the parameter is missing or is
+ *         not a boolean
+ */
+BOOL SAGE_GetParameterBoolean(SAGE_Configuration *config, STRPTR section, STRPTR name, BOOL defaut)
+{
+  SAGE_ConfParameter *confparam;
+  UWORD idx;
+
+  if (config == NULL || name == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return defaut;
+  }
+  if ((confparam = SAGE_GetParameter(config, section, name)) == NULL) {
+    return defaut;
+  }
+  if (!(confparam->cached & (SCFG_BOOLEAN|SCFG_BADBOOLEAN))) {
+    confparam->cached |= SCFG_BADBOOLEAN;
+    for (idx = 0;true_words[idx] != NULL;idx++) {
+      if (SAGE_ConfWord(confparam->param_value, true_words[idx])) {
+        confparam->boolean_value = TRUE;
+        confparam->cached ^= SCFG_BADBOOLEAN|SCFG_BOOLEAN;
+        break;
+      } else if (SAGE_ConfWord(confparam->param_value, false_words[idx])) {
+        confparam->boolean_value = FALSE;
+        confparam->cached ^= SCFG_BADBOOLEAN|SCFG_BOOLEAN;
+        break;
+      }
+    }
+  }
+  if (confparam->cached & SCFG_BADBOOLEAN) {
+    SAGE_SetError(SERR_BADVALUE);
+    return defaut;
+  }
+  return confparam->boolean_value;
+}
+
 /**
  * Set a parameter value to a config
  *
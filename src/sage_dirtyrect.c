@@ -0,0 +1,321 @@
+/**
+ * sage_dirtyrect.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Dirty rectangles management
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <sage/sage_debug.h>
+#include <sage/sage_error.h>
+#include <sage/sage_logger.h>
+#include <sage/sage_blitter.h>
+#include <sage/sage_screen.h>
+#include <sage/sage_dirtyrect.h>
+
+/**
+ * Get the dirty list of a buffer, a buffer never seen is fully damaged
+ */
+SAGE_DirtyList *SAGE_GetDirtyList(SAGE_DirtyList *lists, APTR buffer)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < SDRT_MAXBUFFERS;idx++) {
+    if (lists[idx].buffer == buffer) {
+      return &(lists[idx]);
+    }
+  }
+  for (idx = 0;idx < SDRT_MAXBUFFERS;idx++) {
+    if (lists[idx].buffer == NULL) {
+      break;
+    }
+  }
+  if (idx == SDRT_MAXBUFFERS) {
+    idx = 0;
+  }
+  lists[idx].buffer = buffer;
+  lists[idx].full = TRUE;
+  lists[idx].count = 0;
+  return &(lists[idx]);
+}
+
+/**
+ * Get the area of a rectangle
+ */
+LONG SAGE_DirtyRectArea(SAGE_DirtyRect *rect)
+{
+  return (rect->right - rect->left + 1) * (rect->bottom - rect->top + 1);
+}
+
+/**
+ * Grow a rectangle to hold another one
+ */
+VOID SAGE_UnionDirtyRect(SAGE_DirtyRect *rect, SAGE_DirtyRect *other)
+{
+  if (other->left < rect->left) rect->left = other->left;
+  if (other->top < rect->top) rect->top = other->top;
+  if (other->right > rect->right) rect->right = other->right;
+  if (other->bottom > rect->bottom) rect->bottom = other->bottom;
+}
+
+/**
+ * Add a rectangle to a list, the rectangles of a list never overlap so a
+ * pixel is restored or copied only once
+ */
+VOID SAGE_MergeDirtyRect(SAGE_DirtyList *list, SAGE_DirtyRect *area)
+{
+  SAGE_DirtyRect rect, merged, *other;
+  LONG growth, best_growth;
+  UWORD idx, best;
+
+  if (list->full) {
+    return;
+  }
+  rect = *area;
+  while (TRUE) {
+    // Absorb all the rectangles touching this one
+    idx = 0;
+    while (idx < list->count) {
+      other = &(list->rects[idx]);
+      if (rect.left <= (other->right + SDRT_MERGEGAP) && other->left <= (rect.right + SDRT_MERGEGAP)
+          && rect.top <= (other->bottom + SDRT_MERGEGAP) && other->top <= (rect.bottom + SDRT_MERGEGAP)) {
+        SAGE_UnionDirtyRect(&rect, other);
+        list->rects[idx] = list->rects[--list->count];
+        idx = 0;
+      } else {
+        idx++;
+      }
+    }
+    if (list->count < SDRT_MAXRECTS) {
+      list->rects[list->count++] = rect;
+      return;
+    }
+    // List is full, absorb the rectangle with the smallest growth and retry
+    best = 0;
+    best_growth = 0;
+    for (idx = 0;idx < list->count;idx++) {
+      merged = rect;
+      SAGE_UnionDirtyRect(&merged, &(list->rects[idx]));
+      growth = SAGE_DirtyRectArea(&merged) - SAGE_DirtyRectArea(&(list->rects[idx]));
+      if (idx == 0 || growth < best_growth) {
+        best = idx;
+        best_growth = growth;
+      }
+    }
+    SAGE_UnionDirtyRect(&rect, &(list->rects[best]));
+    list->rects[best] = list->rects[--list->count];
+  }
+}
+
+/**
+ * Enable or disable the dirty rectangles, when enabled the screen restores
+ * (clear, picture and layer blits) only redraw the areas damaged by the
+ * sprite, tile and text blits of the buffer
+ * 
+ * @param status Enable/disable the dirty rectangles
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_EnableDirtyRects(BOOL status)
+{
+  SAGE_Screen *screen;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
+    return FALSE;
+  })
+  memset(&(screen->dirty_rects), 0, sizeof(SAGE_DirtyRects));
+  screen->dirty_rects.enable = status;
+  return TRUE;
+}
+
+/**
+ * Add a damaged area of the back bitmap, the area is clipped to the screen
+ * 
+ * @param left   Area left
+ * @param top    Area top
+ * @param width  Area width
+ * @param height Area height
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_AddDirtyRect(LONG left, LONG top, LONG width, LONG height)
+{
+  SAGE_Screen *screen;
+  SAGE_DirtyRect rect;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
+    return FALSE;
+  })
+  if (!screen->dirty_rects.enable) {
+    return TRUE;
+  }
+  rect.left = (left < 0) ? 0 : left;
+  rect.top = (top < 0) ? 0 : top;
+  rect.right = left + width - 1;
+  if (rect.right >= screen->width) {
+    rect.right = screen->width - 1;
+  }
+  rect.bottom = top + height - 1;
+  if (rect.bottom >= screen->height) {
+    rect.bottom = screen->height - 1;
+  }
+  if (rect.left <= rect.right && rect.top <= rect.bottom) {
+    SAGE_MergeDirtyRect(SAGE_GetDirtyList(screen->dirty_rects.bitmaps, screen->back_bitmap->bitmap_buffer), &rect);
+  }
+  return TRUE;
+}
+
+/**
+ * Set all buffers as fully damaged, to call when the background has
+ * changed or after a draw that does not register its area
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_InvalidateDirtyRects(VOID)
+{
+  SAGE_Screen *screen;
+  UWORD idx;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
+    return FALSE;
+  })
+  for (idx = 0;idx < SDRT_MAXBUFFERS;idx++) {
+    screen->dirty_rects.bitmaps[idx].full = TRUE;
+    screen->dirty_rects.bitmaps[idx].count = 0;
+    screen->dirty_rects.displays[idx].full = TRUE;
+    screen->dirty_rects.displays[idx].count = 0;
+  }
+  screen->dirty_rects.restore.full = TRUE;
+  screen->dirty_rects.restore.count = 0;
+  return TRUE;
+}
+
+/**
+ * Get the rectangles to restore with a background
+ * 
+ * The first restore of a frame takes the damaged areas of the back bitmap,
+ * the next ones restore the same areas. When the backgrounds are not the
+ * same as in the last frame all the buffers are damaged.
+ * 
+ * @param background Background restored by the caller
+ * 
+ * @return Rectangles to restore or NULL when the dirty rectangles are off
+ */
+SAGE_DirtyList *SAGE_GetDirtyRestore(SAGE_DirtyBackground *background)
+{
+  SAGE_DirtyRects *dirty;
+  SAGE_DirtyList *list;
+  SAGE_Screen *screen;
+
+  screen = SAGE_GetScreen();
+  if (screen == NULL || !screen->dirty_rects.enable) {
+    return NULL;
+  }
+  dirty = &(screen->dirty_rects);
+  if (dirty->nb_backgrounds == 0) {
+    list = SAGE_GetDirtyList(dirty->bitmaps, screen->back_bitmap->bitmap_buffer);
+    dirty->restore = *list;
+    list->full = FALSE;
+    list->count = 0;
+  }
+  if (dirty->nb_backgrounds >= SDRT_MAXBACKGROUNDS) {
+    SAGE_InvalidateDirtyRects();
+  } else {
+    if (memcmp(&(dirty->backgrounds[dirty->nb_backgrounds]), background, sizeof(SAGE_DirtyBackground)) != 0) {
+      SD(SAGE_DebugLog("Dirty background %d has changed", dirty->nb_backgrounds);)
+      dirty->backgrounds[dirty->nb_backgrounds] = *background;
+      SAGE_InvalidateDirtyRects();
+    }
+    dirty->nb_backgrounds++;
+  }
+  return &(dirty->restore);
+}
+
+/**
+ * Get the part of an area inside a dirty rectangle
+ * 
+ * @param rect   Dirty rectangle
+ * @param left   Area left
+ * @param top    Area top
+ * @param width  Area width
+ * @param height Area height
+ * @param result Part of the area inside the rectangle
+ * 
+ * @return TRUE if the area and the rectangle overlap
+ */
+BOOL SAGE_IntersectDirtyRect(SAGE_DirtyRect *rect, LONG left, LONG top, LONG width, LONG height, SAGE_DirtyRect *result)
+{
+  result->left = (rect->left > left) ? rect->left : left;
+  result->top = (rect->top > top) ? rect->top : top;
+  result->right = (rect->right < (left + width - 1)) ? rect->right : (left + width - 1);
+  result->bottom = (rect->bottom < (top + height - 1)) ? rect->bottom : (top + height - 1);
+  return (BOOL)(result->left <= result->right && result->top <= result->bottom);
+}
+
+/**
+ * Copy the damaged parts of the back bitmap to a display buffer (indirect
+ * mode), the display buffer holds an older frame so its own damaged parts
+ * are copied too
+ * 
+ * @param display Display buffer
+ * @param address Display buffer address
+ * 
+ * @return TRUE if the copy is done, FALSE if the dirty rectangles are off
+ */
+BOOL SAGE_CopyDirtyRects(APTR display, UBYTE *address)
+{
+  SAGE_DirtyList *damaged, *copy;
+  SAGE_DirtyRect *rect;
+  SAGE_Bitmap *bitmap;
+  SAGE_Screen *screen;
+  UBYTE *source, *destination;
+  ULONG offset, bytes;
+  LONG line;
+  UWORD idx;
+
+  screen = SAGE_GetScreen();
+  if (screen == NULL || !screen->dirty_rects.enable) {
+    return FALSE;
+  }
+  bitmap = screen->back_bitmap;
+  damaged = SAGE_GetDirtyList(screen->dirty_rects.bitmaps, bitmap->bitmap_buffer);
+  copy = SAGE_GetDirtyList(screen->dirty_rects.displays, display);
+  if (damaged->full) {
+    copy->full = TRUE;
+  } else {
+    for (idx = 0;idx < damaged->count;idx++) {
+      SAGE_MergeDirtyRect(copy, &(damaged->rects[idx]));
+    }
+  }
+  if (copy->full) {
+    SAGE_FastCopyScreen((ULONG)bitmap->bitmap_buffer, (ULONG)address, bitmap->height, bitmap->bpr, 0);
+  } else {
+    for (idx = 0;idx < copy->count;idx++) {
+      rect = &(copy->rects[idx]);
+      offset = (rect->top * bitmap->bpr) + (rect->left * (bitmap->depth / 8));
+      bytes = (rect->right - rect->left + 1) * (bitmap->depth / 8);
+      source = (UBYTE *)bitmap->bitmap_buffer + offset;
+      destination = address + offset;
+      for (line = rect->top;line <= rect->bottom;line++) {
+        memcpy(destination, source, bytes);
+        source += bitmap->bpr;
+        destination += bitmap->bpr;
+      }
+    }
+  }
+  // The display buffer is now the back bitmap
+  copy->full = damaged->full;
+  copy->count = damaged->count;
+  memcpy(copy->rects, damaged->rects, sizeof(SAGE_DirtyRect) * damaged->count);
+  return TRUE;
+}
@@ -5,7 +5,7 @@
  * Graphics primitive drawing
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 April 2025 (updated: 01/04/2025)
+ * @version 25.1 April 2025 (updated: 26/06/2025)
  */
 
 #include <exec/exec.h>
@@ -20,6 +20,196 @@
 /** SAGE context */
 extern SAGE_Context SageContext;
 
+#if SAGE_DRAW_ASM == 0
+
+/**
+ * Write a pixel of 1, 2 or 4 bytes
+ */
+VOID SAGE_PutDrawPixel(UBYTE *buffer, LONG size, LONG color)
+{
+  if (size == sizeof(UBYTE)) {
+    *buffer = (UBYTE)color;
+  } else if (size == sizeof(UWORD)) {
+    *((UWORD *)buffer) = (UWORD)color;
+  } else {
+    *((ULONG *)buffer) = (ULONG)color;
+  }
+}
+
+/**
+ * Draw a line from top to bottom like the fast line functions, dx pixels to the
+ * right (or to the left when negative) and dy rows down
+ */
+BOOL SAGE_PlotLine(UBYTE *buffer, LONG dx, LONG dy, ULONG offset, LONG color, LONG size)
+{
+  LONG step, length, error;
+
+  step = size;
+  if (dx < 0) {
+    dx = -dx;
+    step = -size;
+  }
+  if (dx >= dy) {
+    for (length = dx, error = dx;length >= 0;length--) {
+      SAGE_PutDrawPixel(buffer, size, color);
+      buffer += step;
+      error -= dy * 2;
+      if (error < 0) {
+        buffer += offset;
+        error += dx * 2;
+      }
+    }
+  } else {
+    for (length = dy, error = dy;length >= 0;length--) {
+      SAGE_PutDrawPixel(buffer, size, color);
+      buffer += offset;
+      error -= dx * 2;
+      if (error < 0) {
+        buffer += step;
+        error += dy * 2;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Draw a line on a 8, 16 or 32 bits bitmap
+ */
+BOOL SAGE_FastLine8Bits(UBYTE *buffer, LONG dx, LONG dy, ULONG offset, LONG color)
+{
+  return SAGE_PlotLine(buffer, dx, dy, offset, color, sizeof(UBYTE));
+}
+
+BOOL SAGE_FastLine16Bits(UWORD *buffer, LONG dx, LONG dy, ULONG offset, LONG color)
+{
+  return SAGE_PlotLine((UBYTE *)buffer, dx, dy, offset, color, sizeof(UWORD));
+}
+
+BOOL SAGE_FastLine32Bits(ULONG *buffer, LONG dx, LONG dy, ULONG offset, LONG color)
+{
+  return SAGE_PlotLine((UBYTE *)buffer, dx, dy, offset, color, sizeof(ULONG));
+}
+
+/**
+ * Get the coordinate of an edge on a row, the coordinate is calculated with
+ * integers and halves are rounded to the even integer like the FPU conversion
+ */
+LONG SAGE_EdgeCoord(LONG x1, LONG dx, LONG dy, LONG row)
+{
+  LONG quotient, remainder, coord;
+
+  quotient = ((dx < 0 ? -dx : dx) * row) / dy;
+  remainder = ((dx < 0 ? -dx : dx) * row) % dy;
+  if (dx >= 0) {
+    coord = x1 + quotient;
+  } else if (remainder == 0) {
+    coord = x1 - quotient;
+  } else {
+    coord = x1 - quotient - 1;
+    remainder = dy - remainder;
+  }
+  if ((remainder * 2) > dy || ((remainder * 2) == dy && (coord & 1))) {
+    coord++;
+  }
+  return coord;
+}
+
+/**
+ * Calculate the coordinates of an edge from its top line to the line before
+ * its bottom line, with or without clipping
+ *
+ * @return Number of calculated coordinates
+ */
+LONG SAGE_EdgeCalc(LONG *buffer, LONG x1, LONG y1, LONG x2, LONG y2)
+{
+  return SAGE_ClippedEdgeCalc(buffer, x1, y1, x2, y2, y1 < y2 ? y1 : y2, (y1 < y2 ? y2 : y1) - 1);
+}
+
+LONG SAGE_ClippedEdgeCalc(LONG *buffer, LONG x1, LONG y1, LONG x2, LONG y2, LONG tclip, LONG bclip)
+{
+  LONG swap, first_row, last_row, row;
+
+  if (y1 == y2) {
+    return 0;
+  }
+  if (y2 < y1) {
+    swap = x1; x1 = x2; x2 = swap;
+    swap = y1; y1 = y2; y2 = swap;
+  }
+  if (bclip < y1 || tclip > y2) {
+    return 0;
+  }
+  first_row = (tclip > y1) ? tclip : y1;
+  // The last line is kept when the edge is clipped
+  last_row = (bclip < y2) ? bclip + 1 : y2;
+  for (row = first_row;row < last_row;row++) {
+    *buffer++ = SAGE_EdgeCoord(x1, x2 - x1, y2 - y1, row - y1);
+  }
+  return (last_row > first_row) ? last_row - first_row : 0;
+}
+
+/**
+ * Fill the lines of a flat quad from its left and right edges, each line is
+ * clipped between lclip and rclip when clipped is set
+ */
+BOOL SAGE_FillFlatQuad(UBYTE *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color, LONG lclip, LONG rclip, BOOL clipped, LONG size)
+{
+  LONG left, right;
+  UBYTE *pixel;
+
+  for (;nbline > 0;nbline--, buffer += offset) {
+    left = *leftcrd++;
+    right = *rightcrd++;
+    if (clipped) {
+      if (left > rclip || right < lclip) {
+        continue;
+      }
+      left = (left < lclip) ? lclip : left;
+      right = (right > rclip) ? rclip : right;
+    }
+    for (pixel = buffer + (left * size);left <= right;left++, pixel += size) {
+      SAGE_PutDrawPixel(pixel, size, color);
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Draw a flat quad on a 8, 16 or 32 bits bitmap, with or without clipping
+ */
+BOOL SAGE_DrawFlatQuad8Bits(UBYTE *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color)
+{
+  return SAGE_FillFlatQuad(buffer, leftcrd, rightcrd, nbline, offset, color, 0, 0, FALSE, sizeof(UBYTE));
+}
+
+BOOL SAGE_DrawFlatQuad16Bits(UWORD *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color)
+{
+  return SAGE_FillFlatQuad((UBYTE *)buffer, leftcrd, rightcrd, nbline, offset, color, 0, 0, FALSE, sizeof(UWORD));
+}
+
+BOOL SAGE_DrawFlatQuad32Bits(ULONG *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color)
+{
+  return SAGE_FillFlatQuad((UBYTE *)buffer, leftcrd, rightcrd, nbline, offset, color, 0, 0, FALSE, sizeof(ULONG));
+}
+
+BOOL SAGE_DrawClippedFlatQuad8Bits(UBYTE *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color, LONG lclip, LONG rclip)
+{
+  return SAGE_FillFlatQuad(buffer, leftcrd, rightcrd, nbline, offset, color, lclip, rclip, TRUE, sizeof(UBYTE));
+}
+
+BOOL SAGE_DrawClippedFlatQuad16Bits(UWORD *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color, LONG lclip, LONG rclip)
+{
+  return SAGE_FillFlatQuad((UBYTE *)buffer, leftcrd, rightcrd, nbline, offset, color, lclip, rclip, TRUE, sizeof(UWORD));
+}
+
+BOOL SAGE_DrawClippedFlatQuad32Bits(ULONG *buffer, LONG *leftcrd, LONG *rightcrd, LONG nbline, LONG offset, LONG color, LONG lclip, LONG rclip)
+{
+  return SAGE_FillFlatQuad((UBYTE *)buffer, leftcrd, rightcrd, nbline, offset, color, lclip, rclip, TRUE, sizeof(ULONG));
+}
+
+#endif
+
 VOID SAGE_DumpEdgeCoords(LONG starty, LONG *left_crd, LONG *right_crd, ULONG nb)
 {
   LONG index;
@@ -133,168 +323,284 @@ BOOL SAGE_DrawPixel(LONG x, LONG y, LONG color)
 }
 
 /**
- * Draw an array of pixels without clipping
+ * Get the bitmap of the batched primitives with its draw buffers
+ */
+SAGE_Bitmap *SAGE_GetDrawBitmap(VOID)
+{
+  SAGE_Bitmap *bitmap;
+
+  bitmap = SAGE_GetBackBitmap();
+  SAFE(if (bitmap == NULL) {
+    SAGE_SetError(SERR_NO_BITMAP);
+    return NULL;
+  })
+  SAFE(if (bitmap->first_buffer == NULL || bitmap->second_buffer == NULL || bitmap->row_offsets == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return NULL;
+  })
+  return bitmap;
+}
+
+/**
+ * Draw a batch of pixels, the depth is checked once for the batch
  *
  * @param pixels   Array of SAGE_Pixel
  * @param nbpixels Number of pixels to draw
+ * @param clipping Clipping zone or NULL to draw without clipping
  *
  * @return Operation success
  */
-BOOL SAGE_DrawPixelArray(SAGE_Pixel *pixels, ULONG nbpixels)
+BOOL SAGE_DrawPixelBatch(SAGE_Pixel *pixels, ULONG nbpixels, SAGE_Clipping *clipping)
 {
   SAGE_Bitmap *bitmap;
+  SAGE_Pixel *pixel;
   UBYTE *buffer8;
   UWORD *buffer16;
-  ULONG *buffer32, index;
+  ULONG *buffer32, *rows;
+  LONG left = 0, top = 0, right = 0, bottom = 0;
+  BOOL clipped;
 
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
+  if ((bitmap = SAGE_GetDrawBitmap()) == NULL) {
     return FALSE;
-  })
-  index = 0;
+  }
+  rows = bitmap->row_offsets;
+  clipped = (BOOL)(clipping != NULL);
+  if (clipped) {
+    left = clipping->left;
+    top = clipping->top;
+    right = clipping->right;
+    bottom = clipping->bottom;
+  }
+  pixel = pixels;
   if (bitmap->depth == SBMP_DEPTH8) {
-    while (nbpixels--) {
-      buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-      buffer8 += (pixels[index].y * bitmap->width) + pixels[index].x;
-      *buffer8 = (UBYTE)pixels[index++].color;
+    buffer8 = (UBYTE *)bitmap->bitmap_buffer;
+    for (;nbpixels > 0;nbpixels--, pixel++) {
+      if (!clipped || (pixel->x >= left && pixel->x <= right && pixel->y >= top && pixel->y <= bottom)) {
+        buffer8[rows[pixel->y] + pixel->x] = (UBYTE)pixel->color;
+      }
     }
   } else if (bitmap->depth == SBMP_DEPTH16) {
-    while (nbpixels--) {
-      buffer16 = (UWORD *)bitmap->bitmap_buffer;
-      buffer16 += (pixels[index].y * bitmap->width) + pixels[index].x;
-      *buffer16 = (UWORD)pixels[index++].color;
+    buffer16 = (UWORD *)bitmap->bitmap_buffer;
+    for (;nbpixels > 0;nbpixels--, pixel++) {
+      if (!clipped || (pixel->x >= left && pixel->x <= right && pixel->y >= top && pixel->y <= bottom)) {
+        buffer16[rows[pixel->y] + pixel->x] = (UWORD)pixel->color;
+      }
     }
   } else if (bitmap->depth == SBMP_DEPTH24) {
-    while (nbpixels--) {
-      buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-      buffer8 += (pixels[index].y * (bitmap->width * 3)) + (pixels[index].x * 3);
-      *buffer8++ = (UBYTE)(pixels[index].color>>16) & 0xFF;
-      *buffer8++ = (UBYTE)(pixels[index].color>>8) & 0xFF;
-      *buffer8 = (UBYTE)pixels[index++].color & 0xFF;
+    for (;nbpixels > 0;nbpixels--, pixel++) {
+      if (!clipped || (pixel->x >= left && pixel->x <= right && pixel->y >= top && pixel->y <= bottom)) {
+        buffer8 = (UBYTE *)bitmap->bitmap_buffer + ((rows[pixel->y] + pixel->x) * 3);
+        *buffer8++ = (UBYTE)(pixel->color>>16) & 0xFF;
+        *buffer8++ = (UBYTE)(pixel->color>>8) & 0xFF;
+        *buffer8 = (UBYTE)pixel->color & 0xFF;
+      }
     }
   } else if (bitmap->depth == SBMP_DEPTH32) {
-    while (nbpixels--) {
-      buffer32 = (ULONG *)bitmap->bitmap_buffer;
-      buffer32 += (pixels[index].y * bitmap->width) + pixels[index].x;
-      *buffer32 = (ULONG)pixels[index++].color;
+    buffer32 = (ULONG *)bitmap->bitmap_buffer;
+    for (;nbpixels > 0;nbpixels--, pixel++) {
+      if (!clipped || (pixel->x >= left && pixel->x <= right && pixel->y >= top && pixel->y <= bottom)) {
+        buffer32[rows[pixel->y] + pixel->x] = (ULONG)pixel->color;
+      }
     }
   }
   return TRUE;
 }
 
 /**
- * Draw a line with clipping
+ * Draw an array of pixels without clipping
  *
- * @param x1    Start line X coord
- * @param y1    Start line Y coord
- * @param x2    End line X coord
- * @param y2    End line Y coord
- * @param color Line color in ARGB/CLUT format
+ * @param pixels   Array of SAGE_Pixel
+ * @param nbpixels Number of pixels to draw
  *
  * @return Operation success
  */
-BOOL SAGE_DrawClippedLine(LONG x1, LONG y1, LONG x2, LONG y2, LONG color)
+BOOL SAGE_DrawPixelArray(SAGE_Pixel *pixels, ULONG nbpixels)
+{
+  return SAGE_DrawPixelBatch(pixels, nbpixels, NULL);
+}
+
+/**
+ * Draw an array of pixels with clipping
+ *
+ * @param pixels   Array of SAGE_Pixel
+ * @param nbpixels Number of pixels to draw
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawClippedPixelArray(SAGE_Pixel *pixels, ULONG nbpixels)
 {
   SAGE_Screen *screen;
-  SAGE_Bitmap *bitmap;
-  UBYTE *buffer8;
-  UWORD *buffer16;
-  ULONG *buffer32;
-  LONG dx, dy;
 
   screen = SAGE_GetScreen();
   SAFE(if (screen == NULL) {
     SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
-    return FALSE;
-  })
+  return SAGE_DrawPixelBatch(pixels, nbpixels, &(screen->clipping));
+}
+
+/**
+ * Sort a line from top to bottom and clip it
+ *
+ * @param clipping Clipping zone
+ * @param line     Line to clip
+ *
+ * @return FALSE when the line is outside of the clipping zone
+ */
+BOOL SAGE_ClipLine(SAGE_Clipping *clipping, SAGE_Line *line)
+{
+  LONG x1, y1, x2, y2;
+
   // Always draw from top to bottom
-  if (y1 > y2) {
-    dx = x2;
-    dy = y2;
-    x2 = x1;
-    y2 = y1;
-    x1 = dx;
-    y1 = dy;
-  }
-  // Vertical rejection
-  if (y1 >= screen->clipping.bottom || y2 < screen->clipping.top) {
-    return TRUE;
+  if (line->y1 > line->y2) {
+    x1 = line->x2;
+    y1 = line->y2;
+    x2 = line->x1;
+    y2 = line->y1;
+  } else {
+    x1 = line->x1;
+    y1 = line->y1;
+    x2 = line->x2;
+    y2 = line->y2;
+  }
+  // Vertical rejection, the bottom line is inside like for the pixels
+  if (y1 > clipping->bottom || y2 < clipping->top) {
+    return FALSE;
   }
   // Clipping top
-  if (y1 < screen->clipping.top) {
+  if (y1 < clipping->top) {
     // X1' = X1 + ((CLIP_TOP - Y1) * (X2 - X1)) / (Y2 - Y1)
-    x1 = x1 + ((screen->clipping.top - y1) * (x2 - x1) / (y2 - y1));
-    y1 = screen->clipping.top;
+    x1 = x1 + ((clipping->top - y1) * (x2 - x1) / (y2 - y1));
+    y1 = clipping->top;
   }
   // Clipping bottom
-  if (y2 >= screen->clipping.bottom) {
+  if (y2 > clipping->bottom) {
     // X2' = X2 + ((Y2 - CLIP_BOTTOM) * (X1 - X2)) / (Y2 - Y1)
-    x2 = x2 + ((y2 - screen->clipping.bottom) * (x1 - x2)) / (y2 - y1);
-    y2 = screen->clipping.bottom;
+    x2 = x2 + ((y2 - clipping->bottom) * (x1 - x2)) / (y2 - y1);
+    y2 = clipping->bottom;
   }
   // Horizontal rejection
-  if (x1 < screen->clipping.left && x2 < screen->clipping.left) {
-    return TRUE;
+  if (x1 < clipping->left && x2 < clipping->left) {
+    return FALSE;
   }
-  if (x1 >= screen->clipping.right && x2 >= screen->clipping.right) {
-    return TRUE;
+  if (x1 > clipping->right && x2 > clipping->right) {
+    return FALSE;
   }
   // Horizontal clipping
   if (x1 < x2) {
-    if (x1 < screen->clipping.left) {
+    if (x1 < clipping->left) {
       // Y1' = Y1 + ((CLIP_LEFT - X1) * (Y2 - Y1)) / (X2 - X1)
-      y1 = y1 + ((screen->clipping.left - x1) * (y2 - y1)) / (x2 - x1);
-      x1 = screen->clipping.left;
+      y1 = y1 + ((clipping->left - x1) * (y2 - y1)) / (x2 - x1);
+      x1 = clipping->left;
     }
-    if (x2 >= screen->clipping.right) {
+    if (x2 > clipping->right) {
       // Y2' = Y2 - ((X2 - CLIP_RIGHT) * (Y2 - Y1)) / (X2 - X1)
-      y2 = y2 - ((x2 - screen->clipping.right) * (y2 - y1)) / (x2 - x1);
-      x2 = screen->clipping.right;
+      y2 = y2 - ((x2 - clipping->right) * (y2 - y1)) / (x2 - x1);
+      x2 = clipping->right;
     }
   } else {
-    if (x1 >= screen->clipping.right) {
+    if (x1 > clipping->right) {
       // Y1' = Y1 + ((X1 - CLIP_RIGHT) * (Y2 - Y1)) / (X1 - X2)
-      y1 = y1 + ((x1 - screen->clipping.right) * (y2 -y1)) / (x1 - x2);
-      x1 = screen->clipping.right;
+      y1 = y1 + ((x1 - clipping->right) * (y2 -y1)) / (x1 - x2);
+      x1 = clipping->right;
     }
-    if (x2 < screen->clipping.left) {
+    if (x2 < clipping->left) {
       // Y2' = Y2 + ((CLIP_LEFT - X2) * (Y1 - Y2)) / (X1 - X2)
-      y2 = y2 + ((screen->clipping.left - x2) * (y1 -y2)) / (x1 - x2);
-      x2 = screen->clipping.left;
+      y2 = y2 + ((clipping->left - x2) * (y1 -y2)) / (x1 - x2);
+      x2 = clipping->left;
+    }
+  }
+  line->x1 = x1;
+  line->y1 = y1;
+  line->x2 = x2;
+  line->y2 = y2;
+  return TRUE;
+}
+
+/**
+ * Get a line of a batch from an array of lines or from a line strip, the line
+ * is sorted from top to bottom, clipped and its color is remapped
+ *
+ * @return FALSE when the line is outside of the clipping zone
+ */
+BOOL SAGE_GetBatchLine(SAGE_Line *lines, SAGE_Pixel *points, ULONG index, SAGE_Clipping *clipping, ULONG pixformat, SAGE_Line *line)
+{
+  LONG swap;
+
+  if (lines != NULL) {
+    *line = lines[index];
+  } else {
+    line->x1 = points[index].x;
+    line->y1 = points[index].y;
+    line->x2 = points[index + 1].x;
+    line->y2 = points[index + 1].y;
+    line->color = points[index].color;
+  }
+  if (clipping != NULL) {
+    if (!SAGE_ClipLine(clipping, line)) {
+      return FALSE;
     }
+  } else if (line->y1 > line->y2) {
+    swap = line->x1; line->x1 = line->x2; line->x2 = swap;
+    swap = line->y1; line->y1 = line->y2; line->y2 = swap;
   }
-  // Calculate delta
-  dx = x2 - x1;
-  dy = y2 - y1;
-  // Let's draw
-  color = SAGE_RemapColorToPixFormat(color, bitmap->pixformat);
+  line->color = SAGE_RemapColorToPixFormat(line->color, pixformat);
+  return TRUE;
+}
+
+/**
+ * Draw a batch of lines with the fast line functions, the depth is checked
+ * once for the batch and the lines start from the row offsets
+ *
+ * @param lines    Array of SAGE_Line or NULL for a line strip
+ * @param points   Points of the line strip
+ * @param nblines  Number of lines to draw
+ * @param clipping Clipping zone or NULL to draw without clipping
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawLineBatch(SAGE_Line *lines, SAGE_Pixel *points, ULONG nblines, SAGE_Clipping *clipping)
+{
+  SAGE_Bitmap *bitmap;
+  SAGE_Line line;
+  UBYTE *buffer8;
+  UWORD *buffer16;
+  ULONG *buffer32, *rows, index;
+
+  if ((bitmap = SAGE_GetDrawBitmap()) == NULL) {
+    return FALSE;
+  }
+  rows = bitmap->row_offsets;
   if (bitmap->depth == SBMP_DEPTH8) {
     buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-    buffer8 += (y1 * bitmap->width) + x1;
-    SAGE_FastLine8Bits(buffer8, dx, dy, bitmap->bpr, color);
+    for (index = 0;index < nblines;index++) {
+      if (SAGE_GetBatchLine(lines, points, index, clipping, bitmap->pixformat, &line)) {
+        SAGE_FastLine8Bits(buffer8 + rows[line.y1] + line.x1, line.x2 - line.x1, line.y2 - line.y1, bitmap->bpr, line.color);
+      }
+    }
   } else if (bitmap->depth == SBMP_DEPTH16) {
     buffer16 = (UWORD *)bitmap->bitmap_buffer;
-    buffer16 += (y1 * bitmap->width) + x1;
-    SAGE_FastLine16Bits(buffer16, dx, dy, bitmap->bpr, color);
+    for (index = 0;index < nblines;index++) {
+      if (SAGE_GetBatchLine(lines, points, index, clipping, bitmap->pixformat, &line)) {
+        SAGE_FastLine16Bits(buffer16 + rows[line.y1] + line.x1, line.x2 - line.x1, line.y2 - line.y1, bitmap->bpr, line.color);
+      }
+    }
   } else if (bitmap->depth == SBMP_DEPTH24) {
     SAGE_SetError(SERR_NOT_AVAILABLE);
     return FALSE;
   } else if (bitmap->depth == SBMP_DEPTH32) {
     buffer32 = (ULONG *)bitmap->bitmap_buffer;
-    buffer32 += (y1 * bitmap->width) + x1;
-    SAGE_FastLine32Bits(buffer32, dx, dy, bitmap->bpr, color);
+    for (index = 0;index < nblines;index++) {
+      if (SAGE_GetBatchLine(lines, points, index, clipping, bitmap->pixformat, &line)) {
+        SAGE_FastLine32Bits(buffer32 + rows[line.y1] + line.x1, line.x2 - line.x1, line.y2 - line.y1, bitmap->bpr, line.color);
+      }
+    }
   }
   return TRUE;
 }
 
 /**
- * Draw a line without clipping
+ * Draw a line with clipping
  *
  * @param x1    Start line X coord
  * @param y1    Start line Y coord
@@ -304,64 +610,81 @@ BOOL SAGE_DrawClippedLine(LONG x1, LONG y1, LONG x2, LONG y2, LONG color)
  *
  * @return Operation success
  */
-BOOL SAGE_DrawLine(LONG x1, LONG y1, LONG x2, LONG y2, LONG color)
+BOOL SAGE_DrawClippedLine(LONG x1, LONG y1, LONG x2, LONG y2, LONG color)
 {
-  SAGE_Bitmap *bitmap;
-  UBYTE *buffer8;
-  UWORD *buffer16;
-  ULONG *buffer32;
-  LONG dx, dy;
+  SAGE_Screen *screen;
+  SAGE_Line line;
 
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
-  // Always draw from top to bottom
-  if (y1 > y2) {
-    dx = x2;
-    dy = y2;
-    x2 = x1;
-    y2 = y1;
-    x1 = dx;
-    y1 = dy;
-  }
-  // Calculate delta
-  dx = x2 - x1;
-  dy = y2 - y1;
-  // Let's draw
-  color = SAGE_RemapColorToPixFormat(color, bitmap->pixformat);
-  if (bitmap->depth == SBMP_DEPTH8) {
-    buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-    buffer8 += (y1 * bitmap->width) + x1;
-    SAGE_FastLine8Bits(buffer8, dx, dy, bitmap->bpr, color);
-  } else if (bitmap->depth == SBMP_DEPTH16) {
-    buffer16 = (UWORD *)bitmap->bitmap_buffer;
-    buffer16 += (y1 * bitmap->width) + x1;
-    SAGE_FastLine16Bits(buffer16, dx, dy, bitmap->bpr, color);
-  } else if (bitmap->depth == SBMP_DEPTH24) {
-    SAGE_SetError(SERR_NOT_AVAILABLE);
-    return FALSE;
-  } else if (bitmap->depth == SBMP_DEPTH32) {
-    buffer32 = (ULONG *)bitmap->bitmap_buffer;
-    buffer32 += (y1 * bitmap->width) + x1;
-    SAGE_FastLine32Bits(buffer32, dx, dy, bitmap->bpr, color);
-  }
-  return TRUE;
+  line.x1 = x1;
+  line.y1 = y1;
+  line.x2 = x2;
+  line.y2 = y2;
+  line.color = color;
+  return SAGE_DrawLineBatch(&line, NULL, 1, &(screen->clipping));
+}
+
+/**
+ * Draw a line without clipping
+ *
+ * @param x1    Start line X coord
+ * @param y1    Start line Y coord
+ * @param x2    End line X coord
+ * @param y2    End line Y coord
+ * @param color Line color in ARGB/CLUT format
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawLine(LONG x1, LONG y1, LONG x2, LONG y2, LONG color)
+{
+  SAGE_Line line;
+
+  line.x1 = x1;
+  line.y1 = y1;
+  line.x2 = x2;
+  line.y2 = y2;
+  line.color = color;
+  return SAGE_DrawLineBatch(&line, NULL, 1, NULL);
 }
 
 /**
  * Draw a line strip without clipping
  * (second pixel of previous line is first pixel of next line)
  *
- * @param lines   Array of start line coords
+ * @param lines   Array of nblines + 1 points, each line has the color of its
+ *                first point in ARGB/CLUT format
  * @param nblines Number of lines to draw
  *
  * @return Operation success
  */
 BOOL SAGE_DrawLineStrip(SAGE_Pixel *lines, ULONG nblines)
 {
-  return TRUE;
+  return SAGE_DrawLineBatch(NULL, lines, nblines, NULL);
+}
+
+/**
+ * Draw a line strip with clipping
+ *
+ * @param lines   Array of nblines + 1 points, each line has the color of its
+ *                first point in ARGB/CLUT format
+ * @param nblines Number of lines to draw
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawClippedLineStrip(SAGE_Pixel *lines, ULONG nblines)
+{
+  SAGE_Screen *screen;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
+    return FALSE;
+  })
+  return SAGE_DrawLineBatch(NULL, lines, nblines, &(screen->clipping));
 }
 
 /**
@@ -374,41 +697,42 @@ BOOL SAGE_DrawLineStrip(SAGE_Pixel *lines, ULONG nblines)
  */
 BOOL SAGE_DrawLineArray(SAGE_Line *lines, ULONG nblines)
 {
-  return TRUE;
+  return SAGE_DrawLineBatch(lines, NULL, nblines, NULL);
 }
 
 /**
- * Draw a triangle
+ * Draw an array of lines with clipping
  *
- * @param x1    First point X
- * @param y1    First point Y
- * @param x2    Second point X
- * @param y2    Second point Y
- * @param x3    Third point X
- * @param y3    Third point Y
- * @param color Triangle color in CLUT/ARGB format
+ * @param lines   Array of SAGE_Line
+ * @param nblines Number of lines to draw
  *
  * @return Operation success
  */
-BOOL SAGE_DrawTriangle(LONG x1, LONG y1, LONG x2, LONG y2, LONG x3, LONG y3, LONG color)
+BOOL SAGE_DrawClippedLineArray(SAGE_Line *lines, ULONG nblines)
 {
-  SAGE_Bitmap *bitmap;
-  UBYTE *buffer8;
-  UWORD *buffer16;
-  ULONG *buffer32;
-  LONG swap, *leftcoord, *rightcoord, nb_lines;
+  SAGE_Screen *screen;
 
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
-    return FALSE;
-  })
-  leftcoord = bitmap->first_buffer;
-  rightcoord = bitmap->second_buffer;
-  SAFE(if (leftcoord == NULL || rightcoord == NULL) {
-    SAGE_SetError(SERR_NULL_POINTER);
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
+  return SAGE_DrawLineBatch(lines, NULL, nblines, &(screen->clipping));
+}
+
+/**
+ * Sort the points of a triangle from top to bottom and calculate its left and
+ * right edges
+ *
+ * @return Number of lines to fill from the first line
+ */
+LONG SAGE_TriangleEdges(LONG *leftcoord, LONG *rightcoord, SAGE_Triangle *triangle, SAGE_Clipping *clipping, LONG *first_line)
+{
+  LONG x1, y1, x2, y2, x3, y3, swap, long_points, short_points, tclip, bclip;
+
+  x1 = triangle->x1; y1 = triangle->y1;
+  x2 = triangle->x2; y2 = triangle->y2;
+  x3 = triangle->x3; y3 = triangle->y3;
   // Always draw from top to bottom
   if (y1 > y2) {
     swap = x1; x1 = x2; x2 = swap;
@@ -422,51 +746,211 @@ BOOL SAGE_DrawTriangle(LONG x1, LONG y1, LONG x2, LONG y2, LONG x3, LONG y3, LON
     swap = x1; x1 = x2; x2 = swap;
     swap = y1; y1 = y2; y2 = swap;
   }
+  *first_line = y1;
+  if (clipping == NULL) {
+    // Calculate the triangle's edge
+    if (y1 == y2) {
+      if (x1 > x2) {
+        swap = x1; x1 = x2; x2 = swap;
+      }
+      SAGE_EdgeCalc(leftcoord, x1, y1, x3, y3);
+      SAGE_EdgeCalc(rightcoord, x2, y2, x3, y3);
+    } else if (y2 == y3) {
+      if (x2 > x3) {
+        swap = x2; x2 = x3; x3 = swap;
+      }
+      SAGE_EdgeCalc(leftcoord, x1, y1, x2, y2);
+      SAGE_EdgeCalc(rightcoord, x1, y1, x3, y3);
+    } else {
+      if (((x1 - x2) * (y1 - y3)) > ((x1 - x3) * (y1 - y2))) {
+        SAGE_EdgeCalc(leftcoord, x1, y1, x3, y3);
+        SAGE_EdgeCalc(rightcoord, x1, y1, x2, y2);
+        SAGE_EdgeCalc(rightcoord + (y2 - y1), x2, y2, x3, y3);
+      } else {
+        SAGE_EdgeCalc(rightcoord, x1, y1, x3, y3);
+        SAGE_EdgeCalc(leftcoord, x1, y1, x2, y2);
+        SAGE_EdgeCalc(leftcoord + (y2 - y1), x2, y2, x3, y3);
+      }
+    }
+    return y3 - y1;
+  }
+  SD(SAGE_TraceLog("SAGE_TriangleEdges %d, %d, %d, %d, %d, %d", x1, y1, x2, y2, x3, y3);)
+  tclip = clipping->top;
+  bclip = clipping->bottom;
   // Calculate the triangle's edge
   if (y1 == y2) {
     if (x1 > x2) {
       swap = x1; x1 = x2; x2 = swap;
     }
-    SAGE_EdgeCalc(leftcoord, x1, y1, x3, y3);
-    SAGE_EdgeCalc(rightcoord, x2, y2, x3, y3);
+    long_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x3, y3, tclip, bclip);
+    SAGE_ClippedEdgeCalc(rightcoord, x2, y2, x3, y3, tclip, bclip);
   } else if (y2 == y3) {
     if (x2 > x3) {
       swap = x2; x2 = x3; x3 = swap;
     }
-    SAGE_EdgeCalc(leftcoord, x1, y1, x2, y2);
-    SAGE_EdgeCalc(rightcoord, x1, y1, x3, y3);
+    long_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x2, y2, tclip, bclip);
+    SAGE_ClippedEdgeCalc(rightcoord, x1, y1, x3, y3, tclip, bclip);
   } else {
     if (((x1 - x2) * (y1 - y3)) > ((x1 - x3) * (y1 - y2))) {
-      SAGE_EdgeCalc(leftcoord, x1, y1, x3, y3);
-      SAGE_EdgeCalc(rightcoord, x1, y1, x2, y2);
-      SAGE_EdgeCalc(rightcoord + (y2 - y1), x2, y2, x3, y3);
+      long_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x3, y3, tclip, bclip);
+      short_points = SAGE_ClippedEdgeCalc(rightcoord, x1, y1, x2, y2, tclip, bclip);
+      SAGE_ClippedEdgeCalc((rightcoord + short_points), x2, y2, x3, y3, tclip, bclip);
     } else {
-      SAGE_EdgeCalc(rightcoord, x1, y1, x3, y3);
-      SAGE_EdgeCalc(leftcoord, x1, y1, x2, y2);
-      SAGE_EdgeCalc(leftcoord + (y2 - y1), x2, y2, x3, y3);
+      long_points = SAGE_ClippedEdgeCalc(rightcoord, x1, y1, x3, y3, tclip, bclip);
+      short_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x2, y2, tclip, bclip);
+      SAGE_ClippedEdgeCalc((leftcoord + short_points), x2, y2, x3, y3, tclip, bclip);
     }
   }
-  // Let's draw
-  nb_lines = y3 - y1;
+  // Get first line y coord
+  if (y1 < tclip) {
+    *first_line = tclip;
+  }
+  SD(if (long_points > 0) SAGE_DumpEdgeCoords(*first_line, leftcoord, rightcoord, long_points);)
+  return long_points;
+}
+
+/**
+ * Calculate the left and right edges of a quad with flat top and flat bottom
+ *
+ * @return Number of lines to fill from the first line
+ */
+LONG SAGE_FlatQuadEdges(LONG *leftcoord, LONG *rightcoord, SAGE_FlatQuad *quad, SAGE_Clipping *clipping, LONG *first_line)
+{
+  LONG nb_lines;
+
+  *first_line = quad->yt;
+  if (clipping == NULL) {
+    SAGE_EdgeCalc(leftcoord, quad->x1, quad->yt, quad->x3, quad->yb);
+    SAGE_EdgeCalc(rightcoord, quad->x2, quad->yt, quad->x4, quad->yb);
+    return quad->yb - quad->yt;
+  }
+  nb_lines = SAGE_ClippedEdgeCalc(leftcoord, quad->x1, quad->yt, quad->x3, quad->yb, clipping->top, clipping->bottom);
+  SAGE_ClippedEdgeCalc(rightcoord, quad->x2, quad->yt, quad->x4, quad->yb, clipping->top, clipping->bottom);
+  // Get first line y coord
+  if (quad->yt < clipping->top) {
+    *first_line = clipping->top;
+  }
+  return nb_lines;
+}
+
+/**
+ * Get the edges of a triangle or a quad of a batch and its remapped color
+ *
+ * @return Number of lines to fill from the first line
+ */
+LONG SAGE_GetBatchEdges(SAGE_Bitmap *bitmap, SAGE_Triangle *triangles, SAGE_FlatQuad *quads, ULONG index, SAGE_Clipping *clipping, LONG *first_line, LONG *color)
+{
+  LONG nb_lines;
+
+  if (triangles != NULL) {
+    nb_lines = SAGE_TriangleEdges(bitmap->first_buffer, bitmap->second_buffer, &(triangles[index]), clipping, first_line);
+    *color = triangles[index].color;
+  } else {
+    nb_lines = SAGE_FlatQuadEdges(bitmap->first_buffer, bitmap->second_buffer, &(quads[index]), clipping, first_line);
+    *color = quads[index].color;
+  }
   if (nb_lines > 0) {
-    color = SAGE_RemapColorToPixFormat(color, bitmap->pixformat);
-    if (bitmap->depth == SBMP_DEPTH8) {
-      buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-      buffer8 += y1 * bitmap->width;
-      SAGE_DrawFlatQuad8Bits(buffer8, leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      buffer16 = (UWORD *)bitmap->bitmap_buffer;
-      buffer16 += y1 * bitmap->width;
-      SAGE_DrawFlatQuad16Bits(buffer16, leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
-    } else if (bitmap->depth == SBMP_DEPTH32) {
-      buffer32 = (ULONG *)bitmap->bitmap_buffer;
-      buffer32 += y1 * bitmap->width;
-      SAGE_DrawFlatQuad32Bits(buffer32, leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
+    *color = SAGE_RemapColorToPixFormat(*color, bitmap->pixformat);
+  }
+  return nb_lines;
+}
+
+/**
+ * Fill a batch of triangles or flat quads with the fast quad functions, the
+ * depth is checked once for the batch and the polygons start from the row
+ * offsets
+ *
+ * @param triangles Array of SAGE_Triangle or NULL for flat quads
+ * @param quads     Array of SAGE_FlatQuad
+ * @param count     Number of polygons to draw
+ * @param clipping  Clipping zone or NULL to draw without clipping
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawPolygonBatch(SAGE_Triangle *triangles, SAGE_FlatQuad *quads, ULONG count, SAGE_Clipping *clipping)
+{
+  SAGE_Bitmap *bitmap;
+  UBYTE *buffer8;
+  UWORD *buffer16;
+  ULONG *buffer32, *rows, index;
+  LONG *leftcoord, *rightcoord, nb_lines, first_line, color;
+
+  if ((bitmap = SAGE_GetDrawBitmap()) == NULL) {
+    return FALSE;
+  }
+  rows = bitmap->row_offsets;
+  leftcoord = bitmap->first_buffer;
+  rightcoord = bitmap->second_buffer;
+  if (bitmap->depth == SBMP_DEPTH8) {
+    buffer8 = (UBYTE *)bitmap->bitmap_buffer;
+    for (index = 0;index < count;index++) {
+      if ((nb_lines = SAGE_GetBatchEdges(bitmap, triangles, quads, index, clipping, &first_line, &color)) > 0) {
+        if (clipping != NULL) {
+          SAGE_DrawClippedFlatQuad8Bits(
+              buffer8 + rows[first_line], leftcoord, rightcoord, nb_lines, bitmap->bpr, color, clipping->left, clipping->right
+          );
+        } else {
+          SAGE_DrawFlatQuad8Bits(buffer8 + rows[first_line], leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
+        }
+      }
+    }
+  } else if (bitmap->depth == SBMP_DEPTH16) {
+    buffer16 = (UWORD *)bitmap->bitmap_buffer;
+    for (index = 0;index < count;index++) {
+      if ((nb_lines = SAGE_GetBatchEdges(bitmap, triangles, quads, index, clipping, &first_line, &color)) > 0) {
+        if (clipping != NULL) {
+          SAGE_DrawClippedFlatQuad16Bits(
+              buffer16 + rows[first_line], leftcoord, rightcoord, nb_lines, bitmap->bpr, color, clipping->left, clipping->right
+          );
+        } else {
+          SAGE_DrawFlatQuad16Bits(buffer16 + rows[first_line], leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
+        }
+      }
+    }
+  } else if (bitmap->depth == SBMP_DEPTH32) {
+    buffer32 = (ULONG *)bitmap->bitmap_buffer;
+    for (index = 0;index < count;index++) {
+      if ((nb_lines = SAGE_GetBatchEdges(bitmap, triangles, quads, index, clipping, &first_line, &color)) > 0) {
+        if (clipping != NULL) {
+          SAGE_DrawClippedFlatQuad32Bits(
+              buffer32 + rows[first_line], leftcoord, rightcoord, nb_lines, bitmap->bpr, color, clipping->left, clipping->right
+          );
+        } else {
+          SAGE_DrawFlatQuad32Bits(buffer32 + rows[first_line], leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
+        }
+      }
     }
   }
   return TRUE;
 }
 
+/**
+ * Draw a triangle
+ *
+ * @param x1    First point X
+ * @param y1    First point Y
+ * @param x2    Second point X
+ * @param y2    Second point Y
+ * @param x3    Third point X
+ * @param y3    Third point Y
+ * @param color Triangle color in CLUT/ARGB format
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawTriangle(LONG x1, LONG y1, LONG x2, LONG y2, LONG x3, LONG y3, LONG color)
+{
+  SAGE_Triangle triangle;
+
+  triangle.x1 = x1;
+  triangle.y1 = y1;
+  triangle.x2 = x2;
+  triangle.y2 = y2;
+  triangle.x3 = x3;
+  triangle.y3 = y3;
+  triangle.color = color;
+  return SAGE_DrawPolygonBatch(&triangle, NULL, 1, NULL);
+}
+
 /**
  * Draw a clipped triangle
  *
@@ -483,97 +967,54 @@ BOOL SAGE_DrawTriangle(LONG x1, LONG y1, LONG x2, LONG y2, LONG x3, LONG y3, LON
 BOOL SAGE_DrawClippedTriangle(LONG x1, LONG y1, LONG x2, LONG y2, LONG x3, LONG y3, LONG color)
 {
   SAGE_Screen *screen;
-  SAGE_Bitmap *bitmap;
-  UBYTE *buffer8;
-  UWORD *buffer16;
-  ULONG *buffer32;
-  LONG swap, *leftcoord, *rightcoord, long_points, short_points, tclip, bclip;
+  SAGE_Triangle triangle;
 
   screen = SAGE_GetScreen();
   SAFE(if (screen == NULL) {
     SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
-    return FALSE;
-  })
-  leftcoord = bitmap->first_buffer;
-  rightcoord = bitmap->second_buffer;
-  SAFE(if (leftcoord == NULL || rightcoord == NULL) {
-    SAGE_SetError(SERR_NULL_POINTER);
+  triangle.x1 = x1;
+  triangle.y1 = y1;
+  triangle.x2 = x2;
+  triangle.y2 = y2;
+  triangle.x3 = x3;
+  triangle.y3 = y3;
+  triangle.color = color;
+  return SAGE_DrawPolygonBatch(&triangle, NULL, 1, &(screen->clipping));
+}
+
+/**
+ * Draw an array of triangles without clipping
+ *
+ * @param triangles   Array of SAGE_Triangle
+ * @param nbtriangles Number of triangles to draw
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawTriangleArray(SAGE_Triangle *triangles, ULONG nbtriangles)
+{
+  return SAGE_DrawPolygonBatch(triangles, NULL, nbtriangles, NULL);
+}
+
+/**
+ * Draw an array of triangles with clipping
+ *
+ * @param triangles   Array of SAGE_Triangle
+ * @param nbtriangles Number of triangles to draw
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawClippedTriangleArray(SAGE_Triangle *triangles, ULONG nbtriangles)
+{
+  SAGE_Screen *screen;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
-  // Always draw from top to bottom
-  if (y1 > y2) {
-    swap = x1; x1 = x2; x2 = swap;
-    swap = y1; y1 = y2; y2 = swap;
-  }
-  if (y2 > y3) {
-    swap = x2; x2 = x3; x3 = swap;
-    swap = y2; y2 = y3; y3 = swap;
-  }
-  if (y1 > y2) {
-    swap = x1; x1 = x2; x2 = swap;
-    swap = y1; y1 = y2; y2 = swap;
-  }
-  SD(SAGE_TraceLog("SAGE_DrawClippedTriangle %d, %d, %d, %d, %d, %d", x1, y1, x2, y2, x3, y3);)
-  tclip = screen->clipping.top;
-  bclip = screen->clipping.bottom;
-  // Calculate the triangle's edge
-  if (y1 == y2) {
-    if (x1 > x2) {
-      swap = x1; x1 = x2; x2 = swap;
-    }
-    long_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x3, y3, tclip, bclip);
-    SAGE_ClippedEdgeCalc(rightcoord, x2, y2, x3, y3, tclip, bclip);
-  } else if (y2 == y3) {
-    if (x2 > x3) {
-      swap = x2; x2 = x3; x3 = swap;
-    }
-    long_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x2, y2, tclip, bclip);
-    SAGE_ClippedEdgeCalc(rightcoord, x1, y1, x3, y3, tclip, bclip);
-  } else {
-    if (((x1 - x2) * (y1 - y3)) > ((x1 - x3) * (y1 - y2))) {
-      long_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x3, y3, tclip, bclip);
-      short_points = SAGE_ClippedEdgeCalc(rightcoord, x1, y1, x2, y2, tclip, bclip);
-      SAGE_ClippedEdgeCalc((rightcoord + short_points), x2, y2, x3, y3, tclip, bclip);
-    } else {
-      long_points = SAGE_ClippedEdgeCalc(rightcoord, x1, y1, x3, y3, tclip, bclip);
-      short_points = SAGE_ClippedEdgeCalc(leftcoord, x1, y1, x2, y2, tclip, bclip);
-      SAGE_ClippedEdgeCalc((leftcoord + short_points), x2, y2, x3, y3, tclip, bclip);
-    }
-  }
-  if (long_points > 0) {
-    color = SAGE_RemapColorToPixFormat(color, bitmap->pixformat);
-    // Get first line y coord
-    if (y1 < tclip) {
-      y1 = tclip;
-    }
-    SD(SAGE_DumpEdgeCoords(y1, leftcoord, rightcoord, long_points);)
-    // Draw and fill the polygon
-    if (bitmap->depth == SBMP_DEPTH8) {
-      buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-      buffer8 += y1 * bitmap->width;
-      SAGE_DrawClippedFlatQuad8Bits(
-          buffer8, leftcoord, rightcoord, long_points, bitmap->bpr, color, screen->clipping.left, screen->clipping.right
-      );
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      buffer16 = (UWORD *)bitmap->bitmap_buffer;
-      buffer16 += y1 * bitmap->width;
-      SAGE_DrawClippedFlatQuad16Bits(
-          buffer16, leftcoord, rightcoord, long_points, bitmap->bpr, color, screen->clipping.left, screen->clipping.right
-      );
-    } else if (bitmap->depth == SBMP_DEPTH32) {
-      buffer32 = (ULONG *)bitmap->bitmap_buffer;
-      buffer32 += y1 * bitmap->width;
-      SAGE_DrawClippedFlatQuad32Bits(
-          buffer32, leftcoord, rightcoord, long_points, bitmap->bpr, color, screen->clipping.left, screen->clipping.right
-      );
-    }
-  }
-  return TRUE;
+  return SAGE_DrawPolygonBatch(triangles, NULL, nbtriangles, &(screen->clipping));
 }
 
 /**
@@ -591,50 +1032,16 @@ BOOL SAGE_DrawClippedTriangle(LONG x1, LONG y1, LONG x2, LONG y2, LONG x3, LONG
  */
 BOOL SAGE_DrawFlatQuad(LONG x1, LONG x2, LONG yt, LONG x3, LONG x4, LONG yb, LONG color)
 {
-  SAGE_Screen *screen;
-  SAGE_Bitmap *bitmap;
-  UBYTE *buffer8;
-  UWORD *buffer16;
-  ULONG *buffer32;
-  LONG *leftcoord, *rightcoord, nb_lines;
+  SAGE_FlatQuad quad;
 
-  screen = SAGE_GetScreen();
-  SAFE(if (screen == NULL) {
-    SAGE_SetError(SERR_NO_SCREEN);
-    return FALSE;
-  })
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
-    return FALSE;
-  })
-  leftcoord = bitmap->first_buffer;
-  rightcoord = bitmap->second_buffer;
-  SAFE(if (leftcoord == NULL || rightcoord == NULL) {
-    SAGE_SetError(SERR_NULL_POINTER);
-    return FALSE;
-  })
-  SAGE_EdgeCalc(leftcoord, x1, yt, x3, yb);
-  SAGE_EdgeCalc(rightcoord, x2, yt, x4, yb);
-  // Let's draw
-  nb_lines = yb - yt;
-  if (nb_lines > 0) {
-    color = SAGE_RemapColorToPixFormat(color, bitmap->pixformat);
-    if (bitmap->depth == SBMP_DEPTH8) {
-      buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-      buffer8 += yt * bitmap->width;
-      SAGE_DrawFlatQuad8Bits(buffer8, leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      buffer16 = (UWORD *)bitmap->bitmap_buffer;
-      buffer16 += yt * bitmap->width;
-      SAGE_DrawFlatQuad16Bits(buffer16, leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
-    } else if (bitmap->depth == SBMP_DEPTH32) {
-      buffer32 = (ULONG *)bitmap->bitmap_buffer;
-      buffer32 += yt * bitmap->width;
-      SAGE_DrawFlatQuad32Bits(buffer32, leftcoord, rightcoord, nb_lines, bitmap->bpr, color);
-    }
-  }
-  return TRUE;
+  quad.x1 = x1;
+  quad.x2 = x2;
+  quad.yt = yt;
+  quad.x3 = x3;
+  quad.x4 = x4;
+  quad.yb = yb;
+  quad.color = color;
+  return SAGE_DrawPolygonBatch(NULL, &quad, 1, NULL);
 }
 
 /**
@@ -653,58 +1060,52 @@ BOOL SAGE_DrawFlatQuad(LONG x1, LONG x2, LONG yt, LONG x3, LONG x4, LONG yb, LON
 BOOL SAGE_DrawClippedFlatQuad(LONG x1, LONG x2, LONG yt, LONG x3, LONG x4, LONG yb, LONG color)
 {
   SAGE_Screen *screen;
-  SAGE_Bitmap *bitmap;
-  UBYTE *buffer8;
-  UWORD *buffer16;
-  ULONG *buffer32;
-  LONG *leftcoord, *rightcoord, nb_lines, tclip, bclip;
+  SAGE_FlatQuad quad;
 
   screen = SAGE_GetScreen();
   SAFE(if (screen == NULL) {
     SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
-  bitmap = SAGE_GetBackBitmap();
-  SAFE(if (bitmap == NULL) {
-    SAGE_SetError(SERR_NO_BITMAP);
-    return FALSE;
-  })
-  leftcoord = bitmap->first_buffer;
-  rightcoord = bitmap->second_buffer;
-  SAFE(if (leftcoord == NULL || rightcoord == NULL) {
-    SAGE_SetError(SERR_NULL_POINTER);
+  quad.x1 = x1;
+  quad.x2 = x2;
+  quad.yt = yt;
+  quad.x3 = x3;
+  quad.x4 = x4;
+  quad.yb = yb;
+  quad.color = color;
+  return SAGE_DrawPolygonBatch(NULL, &quad, 1, &(screen->clipping));
+}
+
+/**
+ * Draw an array of quads with flat top and flat bottom without clipping
+ *
+ * @param quads   Array of SAGE_FlatQuad
+ * @param nbquads Number of quads to draw
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawFlatQuadArray(SAGE_FlatQuad *quads, ULONG nbquads)
+{
+  return SAGE_DrawPolygonBatch(NULL, quads, nbquads, NULL);
+}
+
+/**
+ * Draw an array of quads with flat top and flat bottom with clipping
+ *
+ * @param quads   Array of SAGE_FlatQuad
+ * @param nbquads Number of quads to draw
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DrawClippedFlatQuadArray(SAGE_FlatQuad *quads, ULONG nbquads)
+{
+  SAGE_Screen *screen;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
-  tclip = screen->clipping.top;
-  bclip = screen->clipping.bottom;
-  nb_lines = SAGE_ClippedEdgeCalc(leftcoord, x1, yt, x3, yb, tclip, bclip);
-  SAGE_ClippedEdgeCalc(rightcoord, x2, yt, x4, yb, tclip, bclip);
-  // Let's draw
-  if (nb_lines > 0) {
-    color = SAGE_RemapColorToPixFormat(color, bitmap->pixformat);
-    // Get first line y coord
-    if (yt < tclip) {
-      yt = tclip;
-    }
-    if (bitmap->depth == SBMP_DEPTH8) {
-      buffer8 = (UBYTE *)bitmap->bitmap_buffer;
-      buffer8 += yt * bitmap->width;
-      SAGE_DrawClippedFlatQuad8Bits(
-          buffer8, leftcoord, rightcoord, nb_lines, bitmap->bpr, color, screen->clipping.left, screen->clipping.right
-      );
-    } else if (bitmap->depth == SBMP_DEPTH16) {
-      buffer16 = (UWORD *)bitmap->bitmap_buffer;
-      buffer16 += yt * bitmap->width;
-      SAGE_DrawClippedFlatQuad16Bits(
-          buffer16, leftcoord, rightcoord, nb_lines, bitmap->bpr, color, screen->clipping.left, screen->clipping.right
-      );
-    } else if (bitmap->depth == SBMP_DEPTH32) {
-      buffer32 = (ULONG *)bitmap->bitmap_buffer;
-      buffer32 += yt * bitmap->width;
-      SAGE_DrawClippedFlatQuad32Bits(
-          buffer32, leftcoord, rightcoord, nb_lines, bitmap->bpr, color, screen->clipping.left, screen->clipping.right
-      );
-    }
-  }
-  return TRUE;
+  return SAGE_DrawPolygonBatch(NULL, quads, nbquads, &(screen->clipping));
 }
@@ -5,7 +5,7 @@
  * Graphics primitive drawing
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_DRAW_H_
@@ -30,6 +30,17 @@ typedef struct {
   LONG x1, y1, x2, y2, x3, y3, color;   // color should be in ARGB format
 } SAGE_Triangle;
 
+/** Flat top and flat bottom quad structure */
+typedef struct {
+  LONG x1, x2, yt, x3, x4, yb, color;   // color should be in ARGB format
+} SAGE_FlatQuad;
+
+#ifndef SAGE_DRAW_ASM
+#define SAGE_DRAW_ASM         1                     // 0 to draw with the portable C functions
+#endif
+
+#if SAGE_DRAW_ASM == 1
+
 /** External function for 8bits line draw */
 extern BOOL ASM SAGE_FastLine8Bits(
   REG(a0, UBYTE *buffer),
@@ -143,6 +154,43 @@ extern BOOL ASM SAGE_DrawClippedFlatQuad32Bits(
   REG(d4, LONG rclip)
 );
 
+#else
+
+/** Portable 8bits line draw */
+BOOL SAGE_FastLine8Bits(UBYTE *, LONG, LONG, ULONG, LONG);
+
+/** Portable 16bits line draw */
+BOOL SAGE_FastLine16Bits(UWORD *, LONG, LONG, ULONG, LONG);
+
+/** Portable 32bits line draw */
+BOOL SAGE_FastLine32Bits(ULONG *, LONG, LONG, ULONG, LONG);
+
+/** Portable calculation of edge coordinates */
+LONG SAGE_EdgeCalc(LONG *, LONG, LONG, LONG, LONG);
+
+/** Portable 8bits flat quad draw */
+BOOL SAGE_DrawFlatQuad8Bits(UBYTE *, LONG *, LONG *, LONG, LONG, LONG);
+
+/** Portable 16bits flat quad draw */
+BOOL SAGE_DrawFlatQuad16Bits(UWORD *, LONG *, LONG *, LONG, LONG, LONG);
+
+/** Portable 32bits flat quad draw */
+BOOL SAGE_DrawFlatQuad32Bits(ULONG *, LONG *, LONG *, LONG, LONG, LONG);
+
+/** Portable calculation of clipped edge coordinates */
+LONG SAGE_ClippedEdgeCalc(LONG *, LONG, LONG, LONG, LONG, LONG, LONG);
+
+/** Portable 8bits flat quad clipped draw */
+BOOL SAGE_DrawClippedFlatQuad8Bits(UBYTE *, LONG *, LONG *, LONG, LONG, LONG, LONG, LONG);
+
+/** Portable 16bits flat quad clipped draw */
+BOOL SAGE_DrawClippedFlatQuad16Bits(UWORD *, LONG *, LONG *, LONG, LONG, LONG, LONG, LONG);
+
+/** Portable 32bits flat quad clipped draw */
+BOOL SAGE_DrawClippedFlatQuad32Bits(ULONG *, LONG *, LONG *, LONG, LONG, LONG, LONG, LONG);
+
+#endif
+
 /** Draw a pixel with clipping */
 BOOL SAGE_DrawClippedPixel(LONG, LONG, LONG);
 
@@ -152,6 +200,9 @@ BOOL SAGE_DrawPixel(LONG, LONG, LONG);
 /** Draw an array of pixels */
 BOOL SAGE_DrawPixelArray(SAGE_Pixel *, ULONG);
 
+/** Draw an array of pixels with clipping */
+BOOL SAGE_DrawClippedPixelArray(SAGE_Pixel *, ULONG);
+
 /** Draw a line with clipping */
 BOOL SAGE_DrawClippedLine(LONG, LONG, LONG, LONG, LONG);
 
@@ -161,19 +212,37 @@ BOOL SAGE_DrawLine(LONG, LONG, LONG, LONG, LONG);
 /** Draw a line strip */
 BOOL SAGE_DrawLineStrip(SAGE_Pixel *, ULONG);
 
+/** Draw a line strip with clipping */
+BOOL SAGE_DrawClippedLineStrip(SAGE_Pixel *, ULONG);
+
 /** Draw an array of lines */
 BOOL SAGE_DrawLineArray(SAGE_Line *, ULONG);
 
+/** Draw an array of lines with clipping */
+BOOL SAGE_DrawClippedLineArray(SAGE_Line *, ULONG);
+
 /** Draw a triangle */
 BOOL SAGE_DrawTriangle(LONG, LONG, LONG, LONG, LONG, LONG, LONG);
 
 /** Draw a clipped triangle */
 BOOL SAGE_DrawClippedTriangle(LONG, LONG, LONG, LONG, LONG, LONG, LONG);
 
+/** Draw an array of triangles */
+BOOL SAGE_DrawTriangleArray(SAGE_Triangle *, ULONG);
+
+/** Draw an array of clipped triangles */
+BOOL SAGE_DrawClippedTriangleArray(SAGE_Triangle *, ULONG);
+
 /** Draw a quad with flat top and flat bottom */
 BOOL SAGE_DrawFlatQuad(LONG, LONG, LONG, LONG, LONG, LONG, LONG);
 
 /** Draw a clipped quad with flat top and flat bottom */
 BOOL SAGE_DrawClippedFlatQuad(LONG, LONG, LONG, LONG, LONG, LONG, LONG);
 
+/** Draw an array of quads with flat top and flat bottom */
+BOOL SAGE_DrawFlatQuadArray(SAGE_FlatQuad *, ULONG);
+
+/** Draw an array of clipped quads with flat top and flat bottom */
+BOOL SAGE_DrawClippedFlatQuadArray(SAGE_FlatQuad *, ULONG);
+
 #endif
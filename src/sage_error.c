@@ -5,7 +5,7 @@
  * Errors management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <stdio.h>
@@ -66,7 +66,11 @@ SAGE_Error SAGE_errors[] = {
   {SERR_TILE_POS, "Tile position out of bounds"},
   {SERR_TILEMAP_INDEX, "Tilemap index out of bounds"},
   {SERR_TILEMAP_FILE, "Tilemap file not found"},
+  {SERR_TILEANIM_FULL, "Too many tile animations"},
+  {SERR_SPRBATCH_FULL, "Sprite batch is full"},
   {SERR_PICTURE_SIZE, "Picture size too big"},
+  {SERR_COLLISION_FULL, "Collision world is full"},
+  {SERR_ARENA_FULL, "Frame arena is full"},
   {SERR_LOWLEVEL_LIB, "Can't open lowlevel library"},
   {SERR_AHI_LIB, "Can't open AHI library"},
   {SERR_AUDIOALLOC, "Can't allocate audio"},
@@ -108,6 +112,8 @@ SAGE_Error SAGE_errors[] = {
   {SERR_TERRAIN_SIZE, "Terrain size not supported"},
   {SERR_TEXTURE_SIZE, "Texture size not supported"},
   {SERR_ENTITY_SIZE, "Entity has to much vertices"},
+  {SERR_SORT_HISTORY, "Sort history index out of bounds"},
+  {SERR_ENTITY_VERSION, "Entity file version not supported"},
   {SERR_NO_SOCKET, "Failed to create socket"},
   {SERR_BIND_SOCKET, "Failed to bind socket"},
   {SERR_RESOLVE_HOST, "Failed to resolve hostname"},
@@ -124,6 +130,7 @@ SAGE_Error SAGE_errors[] = {
   {SERR_NOSECTION, "Section not found"},
   {SERR_NOPARAMETER, "Parameter not found"},
   {SERR_BUFFERSIZE, "Buffer is too small"},
+  {SERR_BADVALUE, "Bad parameter value"},
   {SERR_ENDOF_ERROR, "End mark"}
 };
 
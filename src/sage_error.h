@@ -5,7 +5,7 @@
  * Errors management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_ERROR_H_
@@ -60,6 +60,10 @@
 #define SERR_NO_FONT          44L
 #define SERR_NO_SCREENTIMER   45L
 #define SERR_NO_MODE          46L
+// Tile animation errors
+#define SERR_TILEANIM_FULL    47L
+// Memory errors
+#define SERR_ARENA_FULL       48L
 // Picture errors
 #define SERR_OPENFILE         50L
 #define SERR_READFILE         51L
@@ -68,6 +72,8 @@
 #define SERR_PIXELFORMAT      54L
 #define SERR_PICMAPPING       55L
 #define SERR_PICTURE_SIZE     56L
+// Collision errors
+#define SERR_COLLISION_FULL   57L
 // Layer errors
 #define SERR_LAYER_SIZE       58L
 #define SERR_LAYER_INDEX      59L
@@ -82,6 +88,7 @@
 #define SERR_TILE_POS         66L
 #define SERR_TILEMAP_INDEX    67L
 #define SERR_TILEMAP_FILE     68L
+#define SERR_SPRBATCH_FULL    69L
 // Audio errors
 #define SERR_AUDIOALLOC       70L
 #define SERR_SOUNDLOAD        71L
@@ -122,6 +129,8 @@
 #define SERR_TERRAIN_SIZE     114L
 #define SERR_TEXTURE_SIZE     115L
 #define SERR_ENTITY_SIZE      116L
+#define SERR_SORT_HISTORY     117L
+#define SERR_ENTITY_VERSION   118L
 // Network errors
 #define SERR_NO_SOCKET        150L
 #define SERR_BIND_SOCKET      151L
@@ -140,6 +149,7 @@
 #define SERR_NOSECTION        171L
 #define SERR_NOPARAMETER      172L
 #define SERR_BUFFERSIZE       173L
+#define SERR_BADVALUE         174L
 
 /** SAGE error */
 typedef struct {
@@ -5,7 +5,7 @@
  * Event container management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <stdlib.h>
@@ -24,7 +24,7 @@
  */
 SAGE_Event *SAGE_AllocEvent()
 {
-  return (SAGE_Event *)SAGE_AllocMem(sizeof(SAGE_Event));
+  return (SAGE_Event *)SAGE_PoolAlloc(sizeof(SAGE_Event));
 }
 
 /**
@@ -35,6 +35,6 @@ SAGE_Event *SAGE_AllocEvent()
 VOID SAGE_ReleaseEvent(SAGE_Event *event)
 {
   if (event != NULL) {
-    SAGE_FreeMem(event);
+    SAGE_PoolFree(event);
   }
 }
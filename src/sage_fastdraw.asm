@@ -579,6 +579,7 @@ _SAGE_ClippedEdgeCalc:
   addq.l  #1,d3                       ; trick to have the last line when clipped
 .NoBottomClip:
   sub.l   d1,d3
+  ble.s   .EndCalculate               ; nothing left after the top clip
   move.l  d3,d7
   subq.l  #1,d3                       ; real height
 .NextEdge:
@@ -612,9 +613,9 @@ _SAGE_DrawClippedFlatQuad8Bits:
   subq.l  #1,d0
 .NextLine:
   move.l  (a1)+,d5                      ; left coord
+  move.l  (a2)+,d6                      ; right coord
   cmp.l   d4,d5
   bgt     .SkipLine                     ; x1 > rclip
-  move.l  (a2)+,d6                      ; right coord
   cmp.l   d3,d6
   blt     .SkipLine                     ; x2 < lclip
   cmp.l   d3,d5
@@ -675,9 +676,9 @@ _SAGE_DrawClippedFlatQuad16Bits:
   subq.l  #1,d0
 .NextLine:
   move.l  (a1)+,d5                      ; left coord
+  move.l  (a2)+,d6                      ; right coord
   cmp.l   d4,d5
   bgt     .SkipLine                     ; x1 > rclip
-  move.l  (a2)+,d6                      ; right coord
   cmp.l   d3,d6
   blt     .SkipLine                     ; x2 < lclip
   cmp.l   d3,d5
@@ -739,9 +740,9 @@ _SAGE_DrawClippedFlatQuad32Bits:
   subq.l  #1,d0
 .NextLine:
   move.l  (a1)+,d5                      ; left coord
+  move.l  (a2)+,d6                      ; right coord
   cmp.l   d4,d5
   bgt     .SkipLine                     ; x1 > rclip
-  move.l  (a2)+,d6                      ; right coord
   cmp.l   d3,d6
   blt     .SkipLine                     ; x2 < lclip
   cmp.l   d3,d5
@@ -5,9 +5,11 @@
  * Layer management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
+#include <string.h>
+
 #include <sage/sage_debug.h>
 #include <sage/sage_error.h>
 #include <sage/sage_logger.h>
@@ -32,6 +34,7 @@ BOOL SAGE_CreateLayer(UWORD index, ULONG width, ULONG height)
 {
   SAGE_Screen *screen;
   SAGE_Layer *layer;
+  UWORD tag;
 
   SD(SAGE_DebugLog("Create layer #%d %dx%d", index, width, height);)
   // Check for video device
@@ -52,6 +55,7 @@ BOOL SAGE_CreateLayer(UWORD index, ULONG width, ULONG height)
     SAGE_ReleaseLayer(index);
   }
   // Allocate and init layer
+  tag = SAGE_SetMemoryTag(SMEM_TAG_LAYER);
   layer = (SAGE_Layer *)SAGE_AllocMem(sizeof(SAGE_Layer));
   if (layer != NULL) {
     layer->view[SLAY_OVERNONE].left = 0;
@@ -59,7 +63,11 @@ BOOL SAGE_CreateLayer(UWORD index, ULONG width, ULONG height)
     layer->view[SLAY_OVERNONE].width = width;
     layer->view[SLAY_OVERNONE].height = height;
     layer->overflow = SLAY_OVERNONE;
-    if ((layer->bitmap = SAGE_AllocBitmap(width, height, screen->depth, 0, screen->pixformat, NULL)) != NULL) {
+    layer->bitmap = SAGE_AllocBitmap(width, height, screen->depth, 0, screen->pixformat, NULL);
+  }
+  SAGE_SetMemoryTag(tag);
+  if (layer != NULL) {
+    if (layer->bitmap != NULL) {
       SageContext.SageVideo->layers[index] = layer;
       return TRUE;
     }
@@ -111,6 +119,20 @@ SAGE_Layer *SAGE_GetLayer(UWORD index)
   return SageContext.SageVideo->layers[index];
 }
 
+/**
+ * Tell the screen that a layer content has changed, the dirty rectangles
+ * can't be used to restore it anymore
+ */
+VOID SAGE_LayerChanged(VOID)
+{
+  SAGE_Screen *screen;
+
+  screen = SAGE_GetScreen();
+  if (screen != NULL && screen->dirty_rects.enable) {
+    SAGE_InvalidateDirtyRects();
+  }
+}
+
 /**
  * Release SAGE Layer resource
  * 
@@ -148,6 +170,7 @@ BOOL SAGE_ClearLayer(UWORD index)
   SAFE(if (layer == NULL) {
     return FALSE;
   })
+  SAGE_LayerChanged();
   return SAGE_ClearBitmap(layer->bitmap, 0, 0, layer->bitmap->width, layer->bitmap->height);
 }
 
@@ -167,6 +190,7 @@ BOOL SAGE_FillLayer(UWORD index, ULONG color)
   SAFE(if (layer == NULL) {
     return FALSE;
   })
+  SAGE_LayerChanged();
   return SAGE_FillBitmap(layer->bitmap, 0, 0, layer->bitmap->width, layer->bitmap->height, SAGE_RemapColor(color)); 
 }
 
@@ -316,6 +340,7 @@ BOOL SAGE_BlitPictureToLayer(SAGE_Picture *picture, ULONG left, ULONG top, ULONG
   })
   if ((left + width) <= picture->bitmap->width && (top + height) <= picture->bitmap->height) {
     if (layer->bitmap->width >= (width + x_pos) && layer->bitmap->height >= (height + y_pos)) {
+      SAGE_LayerChanged();
       return SAGE_BlitBitmap(picture->bitmap, left, top, width, height, layer->bitmap, x_pos, y_pos);
     }
   }
@@ -323,6 +348,35 @@ BOOL SAGE_BlitPictureToLayer(SAGE_Picture *picture, ULONG left, ULONG top, ULONG
   return FALSE;
 }
 
+/**
+ * Copy the part of the layer view inside a dirty rectangle into the screen
+ */
+VOID SAGE_BlitLayerArea(SAGE_Layer *layer, ULONG x_pos, ULONG y_pos, SAGE_DirtyRect *rect, SAGE_Bitmap *destination)
+{
+  SAGE_DirtyRect area;
+  LONG x_part, y_part;
+  UWORD part;
+
+  for (part = SLAY_OVERNONE;part <= SLAY_OVERBOTH;part++) {
+    if ((layer->overflow & part) == part) {
+      x_part = x_pos + ((part & SLAY_OVERWIDTH) ? layer->view[SLAY_OVERNONE].width : 0);
+      y_part = y_pos + ((part & SLAY_OVERHEIGHT) ? layer->view[SLAY_OVERNONE].height : 0);
+      if (SAGE_IntersectDirtyRect(rect, x_part, y_part, layer->view[part].width, layer->view[part].height, &area)) {
+        SAGE_BlitBitmap(
+          layer->bitmap,
+          layer->view[part].left + area.left - x_part,
+          layer->view[part].top + area.top - y_part,
+          area.right - area.left + 1,
+          area.bottom - area.top + 1,
+          destination,
+          area.left,
+          area.top
+        );
+      }
+    }
+  }
+}
+
 /**
  * Blit a layer on the screen at a given position
  * 
@@ -334,8 +388,11 @@ BOOL SAGE_BlitPictureToLayer(SAGE_Picture *picture, ULONG left, ULONG top, ULONG
  */
 BOOL SAGE_BlitLayerToScreen(UWORD index, ULONG x_pos, ULONG y_pos)
 {
+  SAGE_DirtyBackground background;
+  SAGE_DirtyList *restore;
   SAGE_Screen *screen;
   SAGE_Layer *layer;
+  UWORD idx;
 
   screen = SAGE_GetScreen();
   SAFE(if (screen == NULL) {
@@ -349,6 +406,22 @@ BOOL SAGE_BlitLayerToScreen(UWORD index, ULONG x_pos, ULONG y_pos)
   })
   // Check if the layer fit in the screen
   if (screen->back_bitmap->width >= (layer->view[SLAY_OVERNONE].width + x_pos) && screen->back_bitmap->height >= (layer->view[SLAY_OVERNONE].height + y_pos)) {
+    // Copy only the damaged parts of the buffer
+    memset(&background, 0, sizeof(SAGE_DirtyBackground));
+    background.type = SDRT_BACKLAYER;
+    background.source = layer;
+    background.left = layer->view[SLAY_OVERNONE].left;
+    background.top = layer->view[SLAY_OVERNONE].top;
+    background.width = layer->view[SLAY_OVERNONE].width;
+    background.height = layer->view[SLAY_OVERNONE].height;
+    background.x_pos = x_pos;
+    background.y_pos = y_pos;
+    if ((restore = SAGE_GetDirtyRestore(&background)) != NULL && !restore->full) {
+      for (idx = 0;idx < restore->count;idx++) {
+        SAGE_BlitLayerArea(layer, x_pos, y_pos, &(restore->rects[idx]), screen->back_bitmap);
+      }
+      return TRUE;
+    }
     // Copy the main layer bitmap into screen bitmap
     SAGE_BlitBitmap(
       layer->bitmap,
@@ -5,7 +5,7 @@
  * Layer management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_LAYER_H_
@@ -48,6 +48,9 @@ BOOL SAGE_CreateLayerFromPicture(UWORD, SAGE_Picture *);
 /** Get a layer by his index */
 SAGE_Layer *SAGE_GetLayer(UWORD);
 
+/** Tell the screen that a layer has changed */
+VOID SAGE_LayerChanged(VOID);
+
 /** Release a layer resources */
 BOOL SAGE_ReleaseLayer(UWORD);
 
@@ -5,7 +5,7 @@
  * 8SVX sound loading
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <stdlib.h>
@@ -39,7 +39,7 @@ SAGE_Sound *SAGE_Load8SVXSound(BPTR file_handle)
   // Skip unused data
   bytes_read = Seek(file_handle, 12, OFFSET_BEGINING);
   // Allocate structure
-  if ((sound = (SAGE_Sound *)SAGE_AllocMem(sizeof(SAGE_Sound))) == NULL) {
+  if ((sound = (SAGE_Sound *)SAGE_PoolAlloc(sizeof(SAGE_Sound))) == NULL) {
     return NULL;
   }
   sound->sample_buffer = NULL;
@@ -47,12 +47,12 @@ SAGE_Sound *SAGE_Load8SVXSound(BPTR file_handle)
   bytes_read = Read(file_handle, &chunk_id, sizeof(chunk_id));
   if (bytes_read != sizeof(chunk_id)) {
     SAGE_SetError(SERR_READFILE);
-    SAGE_FreeMem(sound);
+    SAGE_PoolFree(sound);
     return NULL;
   }
   if (chunk_id != SSND_VHDRTAG) {
     SAGE_SetError(SERR_FILEFORMAT);
-    SAGE_FreeMem(sound);
+    SAGE_PoolFree(sound);
     return NULL;
   }
   // Skip unused data
@@ -61,7 +61,7 @@ SAGE_Sound *SAGE_Load8SVXSound(BPTR file_handle)
   bytes_read = Read(file_handle, &file_header, sizeof(file_header));
   if (bytes_read != sizeof(file_header)) {
     SAGE_SetError(SERR_READFILE);
-    SAGE_FreeMem(sound);
+    SAGE_PoolFree(sound);
     return NULL;
   }
   sound->type = 1;
@@ -83,13 +83,13 @@ SAGE_Sound *SAGE_Load8SVXSound(BPTR file_handle)
     bytes_read = Read(file_handle, &chunk_id, sizeof(chunk_id));
     if (bytes_read != sizeof(chunk_id)) {
       SAGE_SetError(SERR_READFILE);
-      SAGE_FreeMem(sound);
+      SAGE_PoolFree(sound);
       return NULL;
     }
     bytes_read = Read(file_handle, &data_size, sizeof(data_size));
     if (bytes_read != sizeof(data_size)) {
       SAGE_SetError(SERR_READFILE);
-      SAGE_FreeMem(sound);
+      SAGE_PoolFree(sound);
       return NULL;
     }
     if (chunk_id == SSND_BODYTAG) {
@@ -99,14 +99,14 @@ SAGE_Sound *SAGE_Load8SVXSound(BPTR file_handle)
     }
   }
   if ((sound->sample_buffer = SAGE_AllocMem(sound->size)) == NULL) {
-    SAGE_FreeMem(sound);
+    SAGE_PoolFree(sound);
     return NULL;
   }
   bytes_read = Read(file_handle, sound->sample_buffer, sound->size);
   if (bytes_read != sound->size) {
     SAGE_SetError(SERR_READFILE);
     SAGE_FreeMem(sound->sample_buffer);
-    SAGE_FreeMem(sound);
+    SAGE_PoolFree(sound);
     return NULL;
   }
   sound->sample_info.ahisi_Type = SSND_SAMPLE8M;
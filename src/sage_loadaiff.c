@@ -5,7 +5,7 @@
  * AIFF music loading
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <stdlib.h>
@@ -211,13 +211,13 @@ SAGE_Sound *SAGE_LoadAIFFSound(BPTR file_handle)
 
   SD(SAGE_DebugLog("Loading AIFF sound");)
   // Allocate structure
-  if ((sound = (SAGE_Sound *)SAGE_AllocMem(sizeof(SAGE_Sound))) == NULL) {
+  if ((sound = (SAGE_Sound *)SAGE_PoolAlloc(sizeof(SAGE_Sound))) == NULL) {
     return NULL;
   }
   if (SAGE_LoadAIFFInfo(file_handle, &info)) {
     // Play only mono or stereo and 8 or 16bits sample
     if (info.channel > 2 || info.size > 16) {
-      SAGE_FreeMem(sound);
+      SAGE_PoolFree(sound);
       SAGE_SetError(SERR_FILEFORMAT);
       return NULL;
     }
@@ -255,6 +255,6 @@ SAGE_Sound *SAGE_LoadAIFFSound(BPTR file_handle)
       return sound;
     }
   }
-  SAGE_FreeMem(sound);
+  SAGE_PoolFree(sound);
   return NULL;
 }
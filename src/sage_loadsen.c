@@ -0,0 +1,199 @@
+/**
+ * sage_loadsen.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * SAGE binary entity loading
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <dos/dos.h>
+
+#include <sage/sage_debug.h>
+#include <sage/sage_error.h>
+#include <sage/sage_logger.h>
+#include <sage/sage_memory.h>
+#include <sage/sage_screen.h>
+#include <sage/sage_3dtexture.h>
+#include <sage/sage_loadsen.h>
+
+#include <proto/dos.h>
+
+/**
+ * Read a block of the file
+ */
+BOOL SAGE_ReadSENBlock(BPTR fd, APTR buffer, LONG size)
+{
+  if (size > 0 && Read(fd, buffer, size) != size) {
+    SAGE_SetError(SERR_READFILE);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * Release the textures of the entity materials
+ */
+VOID SAGE_ReleaseSENMaterial(SAGE_SENMaterial *materials, UWORD nb_materials)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < nb_materials;idx++) {
+    if (materials[idx].texture != STEX_USECOLOR) {
+      SAGE_ReleaseTexture(materials[idx].texture);
+      materials[idx].texture = STEX_USECOLOR;
+    }
+  }
+}
+
+/**
+ * Load the textures of the entity materials
+ */
+BOOL SAGE_LoadSENMaterial(SAGE_SENMaterial *materials, UWORD nb_materials, STRPTR file_path)
+{
+  UBYTE file[256];
+  STRPTR dirname;
+  WORD idx_texture;
+  UWORD idx;
+
+  SD(SAGE_DebugLog("* SAGE_LoadSENMaterial");)
+  for (idx = 0;idx < nb_materials;idx++) {
+    materials[idx].texture = STEX_USECOLOR;
+  }
+  for (idx = 0;idx < nb_materials;idx++) {
+    materials[idx].file[S3DE_SENFILESIZE - 1] = '\0';
+    if (strlen(materials[idx].file) > 0) {
+      strcpy(file, file_path);
+      dirname = FilePart(file);
+      *dirname = '\0';
+      strcat(file, materials[idx].file);
+      SD(SAGE_DebugLog(" => mat %d : loading %s", idx, file);)
+      idx_texture = SAGE_GetFreeTextureIndex();
+      if (idx_texture == STEX_NOFREEINDEX) {
+        SAGE_SetError(SERR_TEX_INDEX);
+        return FALSE;
+      }
+      if (!SAGE_CreateTextureFromFile(idx_texture, file)) {
+        return FALSE;
+      }
+      if (materials[idx].transparent) {
+        SAGE_SetTextureTransparency(idx_texture, materials[idx].tcolor);
+      }
+      if (!SAGE_AddTexture(idx_texture)) {
+        SAGE_ReleaseTexture(idx_texture);
+        return FALSE;
+      }
+      materials[idx].texture = idx_texture;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Bind the faces to the loaded materials, only pass done on the faces
+ */
+BOOL SAGE_BindSENFaces(SAGE_Entity *entity, SAGE_SENMaterial *materials, UWORD nb_materials)
+{
+  SAGE_Face *face;
+  FLOAT size;
+  WORD material;
+  UWORD idx;
+
+  for (idx = 0;idx < entity->nb_faces;idx++) {
+    face = &(entity->faces[idx]);
+    material = face->texture;
+    if (face->p1 >= entity->nb_vertices || face->p2 >= entity->nb_vertices || face->p3 >= entity->nb_vertices
+        || (face->is_quad && face->p4 >= entity->nb_vertices) || material < S3DE_SENNOMATERIAL || material >= (WORD)nb_materials) {
+      SAGE_SetError(SERR_FILEFORMAT);
+      return FALSE;
+    }
+    size = 0.0;
+    if (material != S3DE_SENNOMATERIAL) {
+      face->color = SAGE_RemapColor(materials[material].color);
+      face->texture = materials[material].texture;
+      if (face->texture != STEX_USECOLOR) {
+        size = (FLOAT)(SAGE_GetTextureSize(face->texture) - 1);
+      }
+    } else {
+      face->color = SAGE_RemapColor(0xffffff);
+      face->texture = STEX_USECOLOR;
+    }
+    face->u1 *= size;
+    face->v1 *= size;
+    face->u2 *= size;
+    face->v2 *= size;
+    face->u3 *= size;
+    face->v3 *= size;
+    face->u4 *= size;
+    face->v4 *= size;
+  }
+  return TRUE;
+}
+
+/**
+ * Load a SAGE binary entity, the arrays are read straight into the entity
+ * because the converter has already removed the duplicate vertices and
+ * computed the normals and the radius
+ * 
+ * @param file_handle Entity file handle
+ * @param file_path   Entity file path
+ * 
+ * @return SAGE entity structure
+ */
+SAGE_Entity *SAGE_LoadSEN(BPTR file_handle, STRPTR file_path)
+{
+  SAGE_SENHeader header;
+  SAGE_SENMaterial *materials;
+  SAGE_Entity *entity;
+  BOOL loaded;
+
+  SD(SAGE_DebugLog("Load SEN %s", file_path);)
+  if (!SAGE_ReadSENBlock(file_handle, &header, sizeof(SAGE_SENHeader))) {
+    return NULL;
+  }
+  if (header.tag != S3DE_SENTAG) {
+    SAGE_SetError(SERR_FILEFORMAT);
+    return NULL;
+  }
+  if (header.version != S3DE_SENVERSION) {
+    SAGE_SetError(SERR_ENTITY_VERSION);
+    return NULL;
+  }
+  materials = NULL;
+  if (header.nb_materials > 0) {
+    materials = (SAGE_SENMaterial *)SAGE_AllocMem(sizeof(SAGE_SENMaterial) * header.nb_materials);
+    if (materials == NULL) {
+      return NULL;
+    }
+    if (!SAGE_ReadSENBlock(file_handle, materials, sizeof(SAGE_SENMaterial) * header.nb_materials)) {
+      SAGE_FreeMem(materials);
+      return NULL;
+    }
+  }
+  loaded = FALSE;
+  entity = SAGE_CreateEntity(header.nb_vertices, header.nb_faces);
+  if (entity != NULL) {
+    if (SAGE_ReadSENBlock(file_handle, entity->vertices, sizeof(SAGE_Vertex) * header.nb_vertices)
+        && SAGE_ReadSENBlock(file_handle, entity->faces, sizeof(SAGE_Face) * header.nb_faces)
+        && SAGE_ReadSENBlock(file_handle, entity->normals, sizeof(SAGE_Vector) * header.nb_faces)) {
+      entity->radius = header.radius;
+      if (SAGE_LoadSENMaterial(materials, header.nb_materials, file_path)) {
+        loaded = SAGE_BindSENFaces(entity, materials, header.nb_materials);
+      }
+      if (!loaded) {
+        SAGE_ReleaseSENMaterial(materials, header.nb_materials);
+      }
+    }
+    if (!loaded) {
+      SAGE_ReleaseEntity(entity);
+      entity = NULL;
+    }
+  }
+  if (materials != NULL) {
+    SAGE_FreeMem(materials);
+  }
+  return entity;
+}
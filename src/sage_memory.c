@@ -5,7 +5,7 @@
  * Memory allocation management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <sage/sage_debug.h>
@@ -13,42 +13,94 @@
 #include <sage/sage_error.h>
 #include <sage/sage_memory.h>
 
+#include <stdio.h>
+#include <string.h>
+
+#include <dos/dos.h>
 #include <proto/exec.h>
+#include <proto/dos.h>
+
+SAGE_MemoryManager SAGE_Memory = { 0 };
 
-SAGE_MemoryManager SAGE_Memory = { NULL, NULL };
+#if _SAGE_MEMORY_TAGS_ == 1
+/** Names of the engine tags */
+char *SAGE_MemoryTagNames[SMEM_TAG_USER] = {
+  "default", "pool", "arena", "layer", "sprite", "tilemap", "texture", "entity", "sound", "music"
+};
+#endif
 
 /**
- * Add a memory entry to the memory list
+ * Add a memory node to the memory list
  *
- * @param address Bloc address
- * @param size    Bloc size
+ * @param node Memory node
+ */
+VOID SAGE_AddMemoryNode(SAGE_MemoryNode *node)
+{
+  node->magic = SMEM_NODEMAGIC;
+  node->previous = SAGE_Memory.tail;
+  node->next = NULL;
+  if (SAGE_Memory.head == NULL) {
+    SAGE_Memory.head = node;
+  } else {
+    SAGE_Memory.tail->next = node;
+  }
+  SAGE_Memory.tail = node;
+}
+
+/**
+ * Remove a memory node from the memory list
  *
- * @return Operation success
+ * @param node Memory node
+ */
+VOID SAGE_RemoveMemoryNode(SAGE_MemoryNode *node)
+{
+  if (SAGE_Memory.head == node) {
+    SAGE_Memory.head = node->next;
+  }
+  if (SAGE_Memory.tail == node) {
+    SAGE_Memory.tail = node->previous;
+  }
+  if (node->previous != NULL) {
+    node->previous->next = node->next;
+  }
+  if (node->next != NULL) {
+    node->next->previous = node->previous;
+  }
+  node->magic = SMEM_FREEMAGIC;
+}
+
+#if _SAGE_MEMORY_TAGS_ == 1
+/**
+ * Add or remove a memory bloc from the accounting of its tag
+ *
+ * @param node       Memory node
+ * @param allocation Bloc allocation or release
  */
-BOOL SAGE_AddMemoryEntry(APTR base, APTR address, ULONG size)
-{
-  SAGE_MemoryNode *new_node;
-
-  new_node = (SAGE_MemoryNode *)AllocMem(sizeof(SAGE_MemoryNode), MEMF_PUBLIC);
-  if (new_node) {
-    new_node->base_address = base;
-    new_node->memory_bloc = address;
-    new_node->bloc_size = size;
-    if (SAGE_Memory.head == NULL) {
-      new_node->previous = NULL;
-      new_node->next = NULL;
-      SAGE_Memory.head = new_node;
-      SAGE_Memory.tail = new_node;
-    } else {
-      new_node->previous = SAGE_Memory.tail;
-      new_node->next = NULL;
-      SAGE_Memory.tail->next = new_node;
-      SAGE_Memory.tail = new_node;
+VOID SAGE_AccountMemory(SAGE_MemoryNode *node, BOOL allocation)
+{
+  SAGE_MemorySnapshot *accounting;
+  SAGE_MemoryTag *tag;
+
+  accounting = &(SAGE_Memory.accounting);
+  tag = &(accounting->tags[node->tag]);
+  if (allocation) {
+    tag->live_bytes[node->location] += node->bloc_size;
+    if (tag->live_bytes[node->location] > tag->peak_bytes[node->location]) {
+      tag->peak_bytes[node->location] = tag->live_bytes[node->location];
     }
-    return TRUE;
+    tag->live_blocs++;
+    tag->allocations++;
+    accounting->live_bytes[node->location] += node->bloc_size;
+    if (accounting->live_bytes[node->location] > accounting->peak_bytes[node->location]) {
+      accounting->peak_bytes[node->location] = accounting->live_bytes[node->location];
+    }
+  } else {
+    tag->live_bytes[node->location] -= node->bloc_size;
+    tag->live_blocs--;
+    accounting->live_bytes[node->location] -= node->bloc_size;
   }
-  return FALSE;
 }
+#endif
 
 /**
  * Check if alignment is on a power 2 boundary
@@ -73,7 +125,8 @@ ULONG SAGE_CheckAlignment(ULONG align)
 }
 
 /**
- * Allocate a memory bloc and register it to the memory manager
+ * Allocate a memory bloc and register it to the memory manager, the memory
+ * node is stored just before the bloc
  *
  * @param size       Bloc size
  * @param attributes Bloc attributes
@@ -83,30 +136,34 @@ ULONG SAGE_CheckAlignment(ULONG align)
  */
 APTR SAGE_AllocMemoryBloc(ULONG size, ULONG attributes, ULONG align)
 {
+  SAGE_MemoryNode *node;
   APTR base;
   APTR memory;
 
   // Make sure that align is a multiple of 2
   align = SAGE_CheckAlignment(align);
-  // Reserve enough space for alignment
-  size += align;
+  // Reserve enough space for the node and the alignment
+  size += sizeof(SAGE_MemoryNode) + align;
   // Allocate the required bloc
   base = AllocMem(size, attributes);
   if (base == NULL) {
     SAGE_SetError(SERR_NO_MEMORY);
     return NULL;
   }
-  // Align the bloc if necessary
+  // Align the bloc after the node if necessary
   if (align) {
-    memory = (APTR)(((ULONG)base + align) & (-align));
+    memory = (APTR)(((ULONG)base + sizeof(SAGE_MemoryNode) + align - 1) & (-align));
   } else {
-    memory = base;
-  }
-  if (!SAGE_AddMemoryEntry(base, memory, size)) {
-    FreeMem(base, size);
-    SAGE_SetError(SERR_NO_MEMORY);
-    return NULL;
+    memory = (APTR)((UBYTE *)base + sizeof(SAGE_MemoryNode));
   }
+  node = (SAGE_MemoryNode *)memory - 1;
+  node->base_address = base;
+  node->bloc_size = size;
+  node->flags = attributes;
+  SAGE_AddMemoryNode(node);
+  SMT(node->tag = SAGE_Memory.tag;)
+  SMT(node->location = (TypeOfMem(base) & MEMF_CHIP) ? SMEM_LOC_CHIP : SMEM_LOC_FAST;)
+  SMT(SAGE_AccountMemory(node, TRUE);)
   SD(SAGE_TraceLog("Memory allocation 0x%X (0x%X) of %d bytes (align %d)", base, memory, size, align);)
   return memory;
 }
@@ -187,66 +244,464 @@ APTR SAGE_AllocAlignFastMem(ULONG size, ULONG align)
 }
 
 /**
- * Release a memory bloc and unregister it from the memory manager
+ * Give back a bloc to its pool
+ *
+ * @param bloc Pool bloc
+ */
+VOID SAGE_ReleasePoolBloc(SAGE_PoolBloc *bloc)
+{
+  SAGE_MemoryPool *pool;
+
+  pool = &(SAGE_Memory.pools[bloc->magic & ~SMEM_POOLMASK]);
+  bloc->magic = SMEM_FREEMAGIC;
+  bloc->next = pool->free_list;
+  pool->free_list = bloc;
+  pool->used--;
+}
+
+/**
+ * Release a memory bloc and unregister it from the memory manager, blocs of
+ * the pools are given back to their pool
  *
  * @param address Bloc address
  */
 VOID SAGE_FreeMem(APTR address)
 {
   SAGE_MemoryNode *node;
+  ULONG magic;
 
   if (address == NULL) {
     return;
   }
-  node = SAGE_Memory.head;
-  while (node != NULL && node->memory_bloc != address) {
-    node = node->next;
+  // Both headers end with their guard
+  magic = *((ULONG *)address - 1);
+  if ((magic & SMEM_POOLMASK) == SMEM_POOLMAGIC && (magic & ~SMEM_POOLMASK) < SMEM_POOLCLASSES) {
+    SAGE_ReleasePoolBloc((SAGE_PoolBloc *)address - 1);
+    return;
   }
-  // Memory bloc found
-  if (node != NULL) {
-    SD(SAGE_TraceLog("Memory release 0x%X of %d bytes", node->base_address, node->bloc_size);)
-    FreeMem(node->base_address, node->bloc_size);
-    if (SAGE_Memory.head == node) {
-      SAGE_Memory.head = node->next;
+  node = (SAGE_MemoryNode *)address - 1;
+  // Not a bloc of the memory manager or already released
+  if (node->magic != SMEM_NODEMAGIC) {
+    SD(SAGE_ErrorLog("Memory release of an unknown bloc 0x%X", address);)
+    return;
+  }
+  SD(SAGE_TraceLog("Memory release 0x%X of %d bytes", node->base_address, node->bloc_size);)
+  SMT(SAGE_AccountMemory(node, FALSE);)
+  SAGE_RemoveMemoryNode(node);
+  FreeMem(node->base_address, node->bloc_size);
+}
+
+/**
+ * Carve a new memory chunk in blocs for a pool, the chunks are taken from
+ * FAST memory when there is some
+ *
+ * @param pool Memory pool
+ *
+ * @return Operation success
+ */
+BOOL SAGE_GrowPool(SAGE_MemoryPool *pool)
+{
+  SAGE_PoolBloc *bloc;
+  UBYTE *chunk;
+  ULONG slot_size, nb_blocs;
+  UWORD tag;
+
+  tag = SAGE_SetMemoryTag(SMEM_TAG_POOL);
+  if ((chunk = (UBYTE *)SAGE_AllocMemoryBloc(SMEM_POOLCHUNK, MEMF_FAST, 0)) == NULL) {
+    chunk = (UBYTE *)SAGE_AllocMemoryBloc(SMEM_POOLCHUNK, MEMF_PUBLIC, 0);
+  }
+  SAGE_SetMemoryTag(tag);
+  if (chunk == NULL) {
+    return FALSE;
+  }
+  SD(SAGE_TraceLog("Pool of %d bytes grows with chunk 0x%X", pool->bloc_size, chunk);)
+  slot_size = sizeof(SAGE_PoolBloc) + pool->bloc_size;
+  for (nb_blocs = SMEM_POOLCHUNK / slot_size;nb_blocs > 0;nb_blocs--, chunk += slot_size) {
+    bloc = (SAGE_PoolBloc *)chunk;
+    bloc->magic = SMEM_FREEMAGIC;
+    bloc->next = pool->free_list;
+    pool->free_list = bloc;
+  }
+  pool->chunks++;
+  return TRUE;
+}
+
+/**
+ * Allocate a small object from the pool of its size class, the bloc is
+ * cleared like with SAGE_AllocMem, larger objects are allocated with
+ * SAGE_AllocMem
+ *
+ * @param size Object size
+ *
+ * @return Memory bloc address or NULL on error
+ */
+APTR SAGE_PoolAlloc(ULONG size)
+{
+  SAGE_MemoryPool *pool;
+  SAGE_PoolBloc *bloc;
+  ULONG size_class;
+
+  size_class = 0;
+  while (size > (ULONG)(1L << (size_class + SMEM_POOLMINSHIFT))) {
+    if (++size_class >= SMEM_POOLCLASSES) {
+      return SAGE_AllocMem(size);
     }
-    if (SAGE_Memory.tail == node) {
-      SAGE_Memory.tail = node->previous;
+  }
+  pool = &(SAGE_Memory.pools[size_class]);
+  pool->bloc_size = 1L << (size_class + SMEM_POOLMINSHIFT);
+  if (pool->free_list == NULL && !SAGE_GrowPool(pool)) {
+    return NULL;
+  }
+  bloc = pool->free_list;
+  pool->free_list = bloc->next;
+  bloc->next = NULL;
+  bloc->magic = SMEM_POOLMAGIC | size_class;
+  pool->allocations++;
+  if (++pool->used > pool->peak) {
+    pool->peak = pool->used;
+  }
+  memset(bloc + 1, 0, pool->bloc_size);
+  return (APTR)(bloc + 1);
+}
+
+/**
+ * Free a small object of the pools, other blocs are released with
+ * SAGE_FreeMem
+ *
+ * @param address Bloc address
+ */
+VOID SAGE_PoolFree(APTR address)
+{
+  SAGE_FreeMem(address);
+}
+
+/**
+ * Create the frame arenas, transient data allocated with SAGE_FrameAlloc is
+ * released all at once by SAGE_ResetFrameArena on each screen refresh. There
+ * are two arenas so the data of the previous frame stays valid while the wait
+ * buffer is still being processed
+ *
+ * @param size Size of each arena
+ *
+ * @return Operation success
+ */
+BOOL SAGE_CreateFrameArenas(ULONG size)
+{
+  SAGE_FrameArena *arena;
+  UWORD index, tag;
+
+  SD(SAGE_DebugLog("Create frame arenas of %d bytes", size);)
+  SAGE_ReleaseFrameArenas();
+  size = (size + SMEM_ARENAALIGN - 1) & -SMEM_ARENAALIGN;
+  tag = SAGE_SetMemoryTag(SMEM_TAG_ARENA);
+  for (index = 0;index < SMEM_ARENAS;index++) {
+    arena = &(SAGE_Memory.arenas[index]);
+    // Fast memory first, a machine without fast memory gets chip memory
+    if ((arena->buffer = (UBYTE *)SAGE_AllocMemoryBloc(size, MEMF_FAST, SMEM_ARENAALIGN)) == NULL) {
+      if ((arena->buffer = (UBYTE *)SAGE_AllocMemoryBloc(size, MEMF_PUBLIC, SMEM_ARENAALIGN)) == NULL) {
+        SAGE_SetMemoryTag(tag);
+        SAGE_ReleaseFrameArenas();
+        return FALSE;
+      }
     }
-    if (node->previous != NULL) {
-      node->previous->next = node->next;
+    arena->size = size;
+  }
+  SAGE_SetMemoryTag(tag);
+  return TRUE;
+}
+
+/**
+ * Release the frame arenas
+ */
+VOID SAGE_ReleaseFrameArenas()
+{
+  SAGE_FrameArena *arena;
+  UWORD index;
+
+  for (index = 0;index < SMEM_ARENAS;index++) {
+    arena = &(SAGE_Memory.arenas[index]);
+    SAGE_FreeMem(arena->buffer);
+    arena->buffer = NULL;
+    arena->size = 0;
+    arena->used = 0;
+  }
+  SAGE_Memory.arena = 0;
+  // The blocs of the released arenas must not be seen as blocs of this frame
+  SAGE_Memory.arena_frame++;
+}
+
+/**
+ * Check for the frame arenas
+ *
+ * @return TRUE if the frame arenas have been created
+ */
+BOOL SAGE_HasFrameArenas()
+{
+  return (BOOL)(SAGE_Memory.arenas[0].buffer != NULL);
+}
+
+/**
+ * Allocate transient memory from the current frame arena, the bloc is not
+ * cleared and stays valid until the second next screen refresh, it must not
+ * be released with SAGE_FreeMem
+ *
+ * @param size Bloc size
+ *
+ * @return Memory bloc address or NULL on error
+ */
+APTR SAGE_FrameAlloc(ULONG size)
+{
+  SAGE_FrameArena *arena;
+  APTR memory;
+
+  arena = &(SAGE_Memory.arenas[SAGE_Memory.arena]);
+  SAFE(if (arena->buffer == NULL) {
+    SAGE_SetError(SERR_NOT_AVAILABLE);
+    return NULL;
+  })
+  size = (size + SMEM_ARENAALIGN - 1) & -SMEM_ARENAALIGN;
+  if (size > (arena->size - arena->used)) {
+    SD(SAGE_ErrorLog("Frame arena can't allocate %d bytes (%d used of %d)", size, arena->used, arena->size);)
+    SAGE_SetError(SERR_ARENA_FULL);
+    return NULL;
+  }
+  memory = (APTR)(arena->buffer + arena->used);
+  arena->used += size;
+  arena->allocations++;
+  if (arena->used > arena->peak) {
+    arena->peak = arena->used;
+  }
+  return memory;
+}
+
+/**
+ * Get the free bytes of the current frame arena
+ *
+ * @return Free bytes, 0 when there is no frame arena
+ */
+ULONG SAGE_GetFrameArenaFree()
+{
+  SAGE_FrameArena *arena;
+
+  arena = &(SAGE_Memory.arenas[SAGE_Memory.arena]);
+  return arena->size - arena->used;
+}
+
+/**
+ * Get the number of frame arena resets, a bloc allocated from the arena is
+ * stale when the number has changed twice
+ *
+ * @return Number of resets
+ */
+ULONG SAGE_GetFrameArenaFrame()
+{
+  return SAGE_Memory.arena_frame;
+}
+
+/**
+ * Switch to the other frame arena and release all its blocs, called by
+ * SAGE_RefreshScreen
+ */
+VOID SAGE_ResetFrameArena()
+{
+  SAGE_Memory.arena = (SAGE_Memory.arena + 1) % SMEM_ARENAS;
+  SAGE_Memory.arenas[SAGE_Memory.arena].used = 0;
+  SAGE_Memory.arena_frame++;
+}
+
+/**
+ * Set the accounting tag of the new memory blocs, engine modules tag their
+ * own blocs and the tags from SMEM_TAG_USER are free for the application (a
+ * tag by level for example). The bookkeeping is not done in the fast build.
+ *
+ * @param tag Accounting tag
+ *
+ * @return Previous tag, to be restored by the caller
+ */
+UWORD SAGE_SetMemoryTag(UWORD tag)
+{
+#if _SAGE_MEMORY_TAGS_ == 1
+  UWORD previous;
+
+  previous = SAGE_Memory.tag;
+  SAGE_Memory.tag = (tag < SMEM_MAXTAGS) ? tag : SMEM_TAG_DEFAULT;
+  return previous;
+#else
+  return SMEM_TAG_DEFAULT;
+#endif
+}
+
+/**
+ * Set the name of an accounting tag, used by the CSV dump
+ *
+ * @param tag  Accounting tag
+ * @param name Tag name
+ *
+ * @return Operation success
+ */
+BOOL SAGE_SetMemoryTagName(UWORD tag, STRPTR name)
+{
+  SAFE(if (tag >= SMEM_MAXTAGS || name == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  SMT(strncpy(SAGE_Memory.accounting.tags[tag].name, (char *)name, SMEM_TAGNAME - 1);)
+  return TRUE;
+}
+
+/**
+ * Reset the highest bytes of all the tags to their live bytes, to measure the
+ * peak of a new level for example
+ */
+VOID SAGE_ResetMemoryPeaks()
+{
+#if _SAGE_MEMORY_TAGS_ == 1
+  SAGE_MemorySnapshot *accounting;
+  UWORD tag, location;
+
+  accounting = &(SAGE_Memory.accounting);
+  for (location = 0;location < SMEM_LOCATIONS;location++) {
+    for (tag = 0;tag < SMEM_MAXTAGS;tag++) {
+      accounting->tags[tag].peak_bytes[location] = accounting->tags[tag].live_bytes[location];
     }
-    if (node->next != NULL) {
-      node->next->previous = node->previous;
+    accounting->peak_bytes[location] = accounting->live_bytes[location];
+  }
+#endif
+}
+
+/**
+ * Get a snapshot of the memory accounting, the bytes include the memory
+ * nodes and the alignment, the pool objects are counted with the pool chunks
+ *
+ * @param snapshot Snapshot to fill
+ *
+ * @return Operation success, FALSE in the fast build
+ */
+BOOL SAGE_GetMemorySnapshot(SAGE_MemorySnapshot *snapshot)
+{
+#if _SAGE_MEMORY_TAGS_ == 1
+  UWORD tag;
+#endif
+
+  SAFE(if (snapshot == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+#if _SAGE_MEMORY_TAGS_ == 1
+  memcpy(snapshot, &(SAGE_Memory.accounting), sizeof(SAGE_MemorySnapshot));
+  for (tag = 0;tag < SMEM_MAXTAGS;tag++) {
+    if (snapshot->tags[tag].name[0] == '\0') {
+      if (tag < SMEM_TAG_USER) {
+        strcpy(snapshot->tags[tag].name, SAGE_MemoryTagNames[tag]);
+      } else {
+        sprintf(snapshot->tags[tag].name, "user%d", tag - SMEM_TAG_USER);
+      }
     }
-    FreeMem(node, sizeof(SAGE_MemoryNode));
   }
+  return TRUE;
+#else
+  SAGE_SetError(SERR_NOT_AVAILABLE);
+  return FALSE;
+#endif
 }
 
 /**
- * Release all memory bloc and unregister them from the memory manager
+ * Write a CSV line to the file or to the console
+ */
+VOID SAGE_WriteMemoryLine(BPTR file_handle, char *line)
+{
+  if (file_handle != 0) {
+    FPuts(file_handle, line);
+    FPuts(file_handle, "\n");
+  } else {
+    SAGE_DebugLog("%s", line);
+  }
+}
+
+/**
+ * Dump a memory accounting snapshot as CSV, one line by used tag and a line
+ * for the totals
+ *
+ * @param snapshot  Memory snapshot
+ * @param file_name CSV file name or NULL to dump in console
+ *
+ * @return Operation success
+ */
+BOOL SAGE_DumpMemorySnapshot(SAGE_MemorySnapshot *snapshot, STRPTR file_name)
+{
+  SAGE_MemoryTag *tag;
+  char line[128];
+  BPTR file_handle = 0;
+  UWORD index;
+
+  SAFE(if (snapshot == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if (file_name != NULL) {
+    if ((file_handle = Open(file_name, MODE_NEWFILE)) == 0) {
+      SAGE_SetError(SERR_OPENFILE);
+      return FALSE;
+    }
+  }
+  SAGE_WriteMemoryLine(file_handle, "tag,name,chip_live,chip_peak,fast_live,fast_peak,live_blocs,allocations");
+  for (index = 0;index < SMEM_MAXTAGS;index++) {
+    tag = &(snapshot->tags[index]);
+    if (tag->allocations > 0) {
+      sprintf(
+        line, "%d,%s,%lu,%lu,%lu,%lu,%lu,%lu", index, tag->name,
+        tag->live_bytes[SMEM_LOC_CHIP], tag->peak_bytes[SMEM_LOC_CHIP], tag->live_bytes[SMEM_LOC_FAST], tag->peak_bytes[SMEM_LOC_FAST],
+        tag->live_blocs, tag->allocations
+      );
+      SAGE_WriteMemoryLine(file_handle, line);
+    }
+  }
+  sprintf(
+    line, "-1,total,%lu,%lu,%lu,%lu,,",
+    snapshot->live_bytes[SMEM_LOC_CHIP], snapshot->peak_bytes[SMEM_LOC_CHIP], snapshot->live_bytes[SMEM_LOC_FAST], snapshot->peak_bytes[SMEM_LOC_FAST]
+  );
+  SAGE_WriteMemoryLine(file_handle, line);
+  if (file_handle != 0) {
+    Close(file_handle);
+  }
+  return TRUE;
+}
+
+/**
+ * Release all memory bloc and unregister them from the memory manager, the
+ * pools are emptied with their chunks and the frame arenas are dropped
  */
 VOID SAGE_ReleaseMem()
 {
   SAGE_MemoryNode *node;
+  UWORD size_class;
 
-  node = SAGE_Memory.head;
-  while (node != NULL) {
+  while ((node = SAGE_Memory.head) != NULL) {
     SD(SAGE_TraceLog("Releasing memory bloc 0x%X of %d bytes", node->base_address, node->bloc_size);)
+    SMT(SAGE_AccountMemory(node, FALSE);)
+    SAGE_RemoveMemoryNode(node);
     FreeMem(node->base_address, node->bloc_size);
-    SAGE_Memory.head = node->next;
-    FreeMem(node, sizeof(SAGE_MemoryNode));
-    node = SAGE_Memory.head;
   }
-  SAGE_Memory.head = NULL;
-  SAGE_Memory.tail = NULL;
+  for (size_class = 0;size_class < SMEM_POOLCLASSES;size_class++) {
+    SAGE_Memory.pools[size_class].free_list = NULL;
+    SAGE_Memory.pools[size_class].chunks = 0;
+    SAGE_Memory.pools[size_class].used = 0;
+  }
+  for (size_class = 0;size_class < SMEM_ARENAS;size_class++) {
+    SAGE_Memory.arenas[size_class].buffer = NULL;
+    SAGE_Memory.arenas[size_class].size = 0;
+    SAGE_Memory.arenas[size_class].used = 0;
+  }
+  SAGE_Memory.arena = 0;
 }
 
 /**
- * Dump the memory list
+ * Dump the memory list, the pool and the arena statistics
  */
 VOID SAGE_DumpMemory()
 {
   SAGE_MemoryNode *node;
+  SAGE_MemoryPool *pool;
   WORD count = 0;
 
   SAGE_DebugLog("** Dumping memory list **");
@@ -258,12 +713,31 @@ VOID SAGE_DumpMemory()
       count++;
       SAGE_DebugLog("* Node %d :", count);
       SAGE_DebugLog(" - Base address 0x%X", node->base_address);
-      SAGE_DebugLog(" - Aligned address 0x%X", node->memory_bloc);
+      SAGE_DebugLog(" - Aligned address 0x%X", node + 1);
       SAGE_DebugLog(" - Size %d", node->bloc_size);
+      SAGE_DebugLog(" - Flags 0x%X", node->flags);
+      SMT(SAGE_DebugLog(" - Tag %d", node->tag);)
       node = node->next;
     }
   }
   SAGE_DebugLog("** End of list **");
+  SAGE_DebugLog("** Dumping memory pools **");
+  for (count = 0;count < SMEM_POOLCLASSES;count++) {
+    pool = &(SAGE_Memory.pools[count]);
+    SAGE_DebugLog(
+      "* Pool of %d bytes : %d chunks, %d used, %d peak, %d allocations",
+      1L << (count + SMEM_POOLMINSHIFT), pool->chunks, pool->used, pool->peak, pool->allocations
+    );
+  }
+  SAGE_DebugLog("** End of pools **");
+  SAGE_DebugLog("** Dumping frame arenas (frame %d) **", SAGE_Memory.arena_frame);
+  for (count = 0;count < SMEM_ARENAS;count++) {
+    SAGE_DebugLog(
+      "* Arena %d : %d bytes, %d used, %d peak, %d allocations",
+      count, SAGE_Memory.arenas[count].size, SAGE_Memory.arenas[count].used, SAGE_Memory.arenas[count].peak, SAGE_Memory.arenas[count].allocations
+    );
+  }
+  SAGE_DebugLog("** End of arenas **");
 }
 
 /**
@@ -5,7 +5,7 @@
  * Music management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <datatypes/datatypes.h>
@@ -60,7 +60,7 @@ SAGE_Music *SAGE_AllocMusic()
   SAGE_Music *music;
 
   SD(SAGE_DebugLog("Allocate music");)
-  music = (SAGE_Music *)SAGE_AllocMem(sizeof(SAGE_Music));
+  music = (SAGE_Music *)SAGE_PoolAlloc(sizeof(SAGE_Music));
   if (music != NULL) {
     music->buffer = NULL;
     music->size = 0;
@@ -88,7 +88,7 @@ VOID SAGE_ReleaseMusic(SAGE_Music *music)
     if (music->buffer != NULL) {
       SAGE_FreeMem(music->buffer);
     }
-    SAGE_FreeMem(music);
+    SAGE_PoolFree(music);
   }
 }
 
@@ -141,10 +141,11 @@ SAGE_Music *SAGE_LoadMusic(STRPTR file_name)
 {
   SAGE_Music *music;
   BPTR file_handle;
-  UWORD type;
+  UWORD type, tag;
 
   SD(SAGE_DebugLog("Load music %s", file_name);)
   music = NULL;
+  tag = SAGE_SetMemoryTag(SMEM_TAG_MUSIC);
   file_handle = Open(file_name, MODE_OLDFILE);
   if (file_handle != 0) {
     type = SAGE_GetMusicFileType(file_handle);
@@ -159,6 +160,7 @@ SAGE_Music *SAGE_LoadMusic(STRPTR file_name)
   } else {
     SAGE_SetError(SERR_OPENFILE);
   }
+  SAGE_SetMemoryTag(tag);
   SD(SAGE_DumpMusic(music);)
   return music;
 }
@@ -5,7 +5,7 @@
  * Input devices management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 // @todo : check if socket_id < MAX_SOCKETS
@@ -257,7 +257,7 @@ BOOL SAGE_CloseSocket(SAGE_BsdSocket *bsdsocket)
     if (bsdsocket->socket_id != SNET_INVALID_SOCKET) {
       SD(SAGE_DebugLog("Close socket #%d", bsdsocket->socket_id);)
       CloseSocket(bsdsocket->socket_id);
-      SAGE_FreeMem(network->handlers[bsdsocket->socket_id]);
+      SAGE_PoolFree(network->handlers[bsdsocket->socket_id]);
       network->handlers[bsdsocket->socket_id] = NULL;
       network->sockets[bsdsocket->socket_id] = NULL;
       network->nb_sockets--;
@@ -468,7 +468,7 @@ BOOL SAGE_AddSocketListenHandler(SAGE_BsdSocket *bsdsocket, VOID (*handler)(SAGE
   if (bsdsocket != NULL) {
     if (bsdsocket->type == SNET_SERVER_SOCKET) {
       if (network->handlers[bsdsocket->socket_id] == NULL) {
-        if ((sockhand = SAGE_AllocMem(sizeof(SAGE_SocketHandler))) == NULL) {
+        if ((sockhand = SAGE_PoolAlloc(sizeof(SAGE_SocketHandler))) == NULL) {
           return FALSE;
         }
         network->handlers[bsdsocket->socket_id] = sockhand;
@@ -509,7 +509,7 @@ BOOL SAGE_AddSocketReadHandler(SAGE_BsdSocket *bsdsocket, VOID (*handler)(SAGE_B
   })
   if (bsdsocket != NULL) {
     if (network->handlers[bsdsocket->socket_id] == NULL) {
-      if ((sockhand = SAGE_AllocMem(sizeof(SAGE_SocketHandler))) == NULL) {
+      if ((sockhand = SAGE_PoolAlloc(sizeof(SAGE_SocketHandler))) == NULL) {
         return FALSE;
       }
       network->handlers[bsdsocket->socket_id] = sockhand;
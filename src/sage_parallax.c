@@ -0,0 +1,368 @@
+/**
+ * sage_parallax.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Parallax layers compositor
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <sage/sage_debug.h>
+#include <sage/sage_error.h>
+#include <sage/sage_logger.h>
+#include <sage/sage_memory.h>
+#include <sage/sage_bitmap.h>
+#include <sage/sage_screen.h>
+#include <sage/sage_layer.h>
+#include <sage/sage_dirtyrect.h>
+#include <sage/sage_parallax.h>
+
+/**
+ * Create a parallax, the layers are composited band by band and only from
+ * the nearest layer fully hiding the ones behind it
+ * 
+ * @param max_planes Maximum number of layers
+ * 
+ * @return Parallax or NULL on error
+ */
+SAGE_Parallax *SAGE_CreateParallax(UWORD max_planes)
+{
+  SAGE_Parallax *parallax;
+
+  SD(SAGE_DebugLog("Create parallax (%d planes)", max_planes);)
+  if (max_planes == 0 || max_planes > SPLX_MAXPLANES) {
+    SAGE_SetError(SERR_LAYER_INDEX);
+    return NULL;
+  }
+  if ((parallax = (SAGE_Parallax *)SAGE_AllocMem(sizeof(SAGE_Parallax))) != NULL) {
+    parallax->max_planes = max_planes;
+    parallax->nb_planes = 0;
+    if ((parallax->planes = (SAGE_ParallaxPlane *)SAGE_AllocMem(sizeof(SAGE_ParallaxPlane) * max_planes)) != NULL) {
+      return parallax;
+    }
+    SAGE_FreeMem(parallax);
+  }
+  SAGE_SetError(SERR_NO_MEMORY);
+  return NULL;
+}
+
+/**
+ * Release a parallax, the layers are not released
+ * 
+ * @param parallax Parallax
+ */
+VOID SAGE_ReleaseParallax(SAGE_Parallax *parallax)
+{
+  UWORD plane;
+
+  SD(SAGE_DebugLog("Release parallax");)
+  if (parallax != NULL) {
+    if (parallax->planes != NULL) {
+      for (plane = 0;plane < parallax->nb_planes;plane++) {
+        if (parallax->planes[plane].opaque_rows != NULL) {
+          SAGE_FreeMem(parallax->planes[plane].opaque_rows);
+        }
+      }
+      SAGE_FreeMem(parallax->planes);
+    }
+    SAGE_FreeMem(parallax);
+  }
+}
+
+/**
+ * Check if a row of a transparent bitmap has no transparent pixel
+ */
+BOOL SAGE_IsOpaqueRow(SAGE_Bitmap *bitmap, ULONG row)
+{
+  UBYTE *line;
+  ULONG x_pos;
+
+  line = (UBYTE *)bitmap->bitmap_buffer + (row * bitmap->bpr);
+  for (x_pos = 0;x_pos < bitmap->width;x_pos++) {
+    if (bitmap->depth == SBMP_DEPTH8) {
+      if (line[x_pos] == (UBYTE)bitmap->transparency) {
+        return FALSE;
+      }
+    } else if (bitmap->depth == SBMP_DEPTH16) {
+      if (((UWORD *)line)[x_pos] == (UWORD)bitmap->transparency) {
+        return FALSE;
+      }
+    } else if (bitmap->depth == SBMP_DEPTH24) {
+      if (((line[x_pos * 3] << 16) | (line[(x_pos * 3) + 1] << 8) | line[(x_pos * 3) + 2]) == (bitmap->transparency & 0xFFFFFF)) {
+        return FALSE;
+      }
+    } else if (((ULONG *)line)[x_pos] == bitmap->transparency) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Find the opaque rows of a plane layer
+ */
+BOOL SAGE_FindOpaqueRows(SAGE_ParallaxPlane *plane)
+{
+  SAGE_Layer *layer;
+  ULONG row;
+
+  if (plane->opaque_rows != NULL) {
+    SAGE_FreeMem(plane->opaque_rows);
+    plane->opaque_rows = NULL;
+  }
+  if ((layer = SAGE_GetLayer(plane->index)) == NULL) {
+    return FALSE;
+  }
+  if (layer->bitmap->properties & SBMP_TRANSPARENT) {
+    if ((plane->opaque_rows = (UBYTE *)SAGE_AllocMem(layer->bitmap->height)) == NULL) {
+      SAGE_SetError(SERR_NO_MEMORY);
+      return FALSE;
+    }
+    for (row = 0;row < layer->bitmap->height;row++) {
+      plane->opaque_rows[row] = (UBYTE)SAGE_IsOpaqueRow(layer->bitmap, row);
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Add a layer in front of the parallax planes, the layer is scrolled with
+ * SAGE_SetLayerView and its transparency should be set before adding it
+ * 
+ * @param parallax Parallax
+ * @param index    Layer index
+ * @param x_pos    Horizontal position of the layer view on the screen
+ * @param y_pos    Vertical position of the layer view on the screen
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_AddParallaxLayer(SAGE_Parallax *parallax, UWORD index, LONG x_pos, LONG y_pos)
+{
+  SAGE_ParallaxPlane *plane;
+
+  SAFE(if (parallax == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if (parallax->nb_planes >= parallax->max_planes) {
+    SAGE_SetError(SERR_LAYER_INDEX);
+    return FALSE;
+  }
+  plane = &(parallax->planes[parallax->nb_planes]);
+  plane->index = index;
+  plane->x_pos = x_pos;
+  plane->y_pos = y_pos;
+  if (!SAGE_FindOpaqueRows(plane)) {
+    return FALSE;
+  }
+  parallax->nb_planes++;
+  return TRUE;
+}
+
+/**
+ * Update the opaque rows of a parallax layer, to call after drawing in the
+ * layer or changing its transparency
+ * 
+ * @param parallax Parallax
+ * @param index    Layer index
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_UpdateParallaxLayer(SAGE_Parallax *parallax, UWORD index)
+{
+  UWORD plane;
+
+  SAFE(if (parallax == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  for (plane = 0;plane < parallax->nb_planes;plane++) {
+    if (parallax->planes[plane].index == index && !SAGE_FindOpaqueRows(&(parallax->planes[plane]))) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Get the layer bitmap row shown on a screen line
+ */
+ULONG SAGE_GetParallaxRow(SAGE_ParallaxPlane *plane, LONG line)
+{
+  return (plane->layer->view[SLAY_OVERNONE].top + (line - plane->y_pos)) % plane->layer->bitmap->height;
+}
+
+/**
+ * Draw the lines of a plane, rows without transparent pixel are copied
+ * without cookie cut
+ */
+ULONG SAGE_DrawParallaxPlane(SAGE_ParallaxPlane *plane, SAGE_BitmapBlitter blitter, SAGE_Bitmap *destination, LONG top, LONG bottom, BOOL opaque)
+{
+  SAGE_Bitmap *source;
+  LONGBITS properties;
+  ULONG src_x, src_y, width, remain;
+  LONG x_pos;
+
+  source = plane->layer->bitmap;
+  properties = source->properties;
+  if (opaque) {
+    source->properties &= ~SBMP_TRANSPARENT;
+  }
+  src_y = SAGE_GetParallaxRow(plane, top);
+  src_x = (plane->layer->view[SLAY_OVERNONE].left + (plane->left - plane->x_pos)) % source->width;
+  x_pos = plane->left;
+  remain = plane->right - plane->left;
+  // A scrolled view wraps around the layer bitmap
+  while (remain > 0) {
+    width = source->width - src_x;
+    width = (width > remain) ? remain : width;
+    (*blitter)(source, src_x, src_y, width, bottom - top, destination, x_pos, top);
+    x_pos += width;
+    remain -= width;
+    src_x = 0;
+  }
+  source->properties = properties;
+  return (plane->right - plane->left) * (bottom - top);
+}
+
+/**
+ * Draw a band of lines sharing the same planes
+ */
+VOID SAGE_DrawParallaxBand(SAGE_Parallax *parallax, SAGE_BitmapBlitter blitter, SAGE_Bitmap *destination, LONG top, LONG bottom, WORD first, ULONG cover, ULONG opaque)
+{
+  WORD plane;
+
+  for (plane = first;plane < (WORD)parallax->nb_planes;plane++) {
+    if (cover & (1UL << plane)) {
+      parallax->drawn_pixels += SAGE_DrawParallaxPlane(&(parallax->planes[plane]), blitter, destination, top, bottom, (BOOL)((opaque & (1UL << plane)) != 0));
+    }
+  }
+}
+
+/**
+ * Blit all the parallax layers to the screen. Each screen line is checked
+ * from the front layer to the back one until a layer fully covers the line
+ * with a row without transparent pixel, the layers behind it are skipped.
+ * The lines with the same layers are drawn as one band per layer.
+ * 
+ * @param parallax Parallax
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_BlitParallaxToScreen(SAGE_Parallax *parallax)
+{
+  SAGE_ParallaxPlane *plane;
+  SAGE_Screen *screen;
+  SAGE_Bitmap *destination;
+  SAGE_BitmapBlitter blitter;
+  LONG left, top, right, bottom, line, band_top;
+  ULONG cover, opaque, band_cover = 0, band_opaque = 0, row;
+  WORD idx, first, band_first = 0;
+  BOOL wrap;
+
+  SAFE(if (parallax == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
+    return FALSE;
+  })
+  destination = screen->back_bitmap;
+  if ((blitter = SAGE_GetBitmapBlitter(destination->depth)) == NULL) {
+    return FALSE;
+  }
+  parallax->drawn_pixels = 0;
+  // Clip the views on the screen
+  left = destination->width;
+  top = destination->height;
+  right = 0;
+  bottom = 0;
+  for (idx = 0;idx < (WORD)parallax->nb_planes;idx++) {
+    plane = &(parallax->planes[idx]);
+    if ((plane->layer = SAGE_GetLayer(plane->index)) == NULL) {
+      return FALSE;
+    }
+    if (plane->layer->bitmap->depth != destination->depth) {
+      SAGE_SetError(SERR_BM_BLITFMT);
+      return FALSE;
+    }
+    plane->left = (plane->x_pos > 0) ? plane->x_pos : 0;
+    plane->top = (plane->y_pos > 0) ? plane->y_pos : 0;
+    plane->right = plane->x_pos + plane->layer->view[SLAY_OVERNONE].width;
+    if (plane->layer->overflow & SLAY_OVERWIDTH) {
+      plane->right += plane->layer->view[SLAY_OVERWIDTH].width;
+    }
+    plane->bottom = plane->y_pos + plane->layer->view[SLAY_OVERNONE].height;
+    if (plane->layer->overflow & SLAY_OVERHEIGHT) {
+      plane->bottom += plane->layer->view[SLAY_OVERHEIGHT].height;
+    }
+    plane->right = (plane->right < (LONG)destination->width) ? plane->right : (LONG)destination->width;
+    plane->bottom = (plane->bottom < (LONG)destination->height) ? plane->bottom : (LONG)destination->height;
+    if (plane->left < plane->right && plane->top < plane->bottom) {
+      left = (plane->left < left) ? plane->left : left;
+      top = (plane->top < top) ? plane->top : top;
+      right = (plane->right > right) ? plane->right : right;
+      bottom = (plane->bottom > bottom) ? plane->bottom : bottom;
+    } else {
+      plane->bottom = plane->top;
+    }
+  }
+  if (left >= right || top >= bottom) {
+    return TRUE;
+  }
+  band_top = top;
+  for (line = top;line < bottom;line++) {
+    // Find the layers of the line from the front one
+    cover = 0;
+    opaque = 0;
+    first = 0;
+    wrap = FALSE;
+    for (idx = (WORD)parallax->nb_planes - 1;idx >= 0;idx--) {
+      plane = &(parallax->planes[idx]);
+      if (line >= plane->top && line < plane->bottom) {
+        cover |= (1UL << idx);
+        row = SAGE_GetParallaxRow(plane, line);
+        // A band can't cross the bottom of a layer bitmap
+        if (row == 0) {
+          wrap = TRUE;
+        }
+        if (plane->opaque_rows == NULL || plane->opaque_rows[row]) {
+          opaque |= (1UL << idx);
+          if (plane->left <= left && plane->right >= right) {
+            first = idx;
+            break;
+          }
+        }
+      }
+    }
+    if (line > band_top && (wrap || first != band_first || cover != band_cover || opaque != band_opaque)) {
+      SAGE_DrawParallaxBand(parallax, blitter, destination, band_top, line, band_first, band_cover, band_opaque);
+      band_top = line;
+    }
+    band_first = first;
+    band_cover = cover;
+    band_opaque = opaque;
+  }
+  SAGE_DrawParallaxBand(parallax, blitter, destination, band_top, bottom, band_first, band_cover, band_opaque);
+  SAGE_AddDirtyRect(left, top, right - left, bottom - top);
+  return TRUE;
+}
+
+/**
+ * Get the number of pixels written by the last composition
+ * 
+ * @param parallax Parallax
+ * 
+ * @return Number of pixels
+ */
+ULONG SAGE_GetParallaxPixels(SAGE_Parallax *parallax)
+{
+  SAFE(if (parallax == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return 0;
+  })
+  return parallax->drawn_pixels;
+}
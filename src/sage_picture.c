@@ -5,9 +5,11 @@
  * Picture management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
+#include <string.h>
+
 #include <dos/dos.h>
 #include <datatypes/datatypes.h>
 #include <datatypes/pictureclass.h>
@@ -407,7 +409,11 @@ BOOL SAGE_BlitPictureToBitmap(SAGE_Picture *picture, ULONG left, ULONG top, ULON
  */
 BOOL SAGE_BlitPictureToScreen(SAGE_Picture *picture, ULONG left, ULONG top, ULONG width, ULONG height, ULONG x_pos, ULONG y_pos)
 {
+  SAGE_DirtyBackground background;
+  SAGE_DirtyList *restore;
+  SAGE_DirtyRect part;
   SAGE_Screen *screen;
+  UWORD idx;
 
   screen = SAGE_GetScreen();
   if (screen == NULL) {
@@ -420,6 +426,26 @@ BOOL SAGE_BlitPictureToScreen(SAGE_Picture *picture, ULONG left, ULONG top, ULON
   }
   if ((left + width) <= picture->bitmap->width && (top + height) <= picture->bitmap->height) {
     if (screen->width >= (width + x_pos) && screen->height >= (height + y_pos)) {
+      // Copy only the damaged parts of the buffer
+      memset(&background, 0, sizeof(SAGE_DirtyBackground));
+      background.type = SDRT_BACKPICTURE;
+      background.source = picture->bitmap;
+      background.left = left;
+      background.top = top;
+      background.width = width;
+      background.height = height;
+      background.x_pos = x_pos;
+      background.y_pos = y_pos;
+      if ((restore = SAGE_GetDirtyRestore(&background)) != NULL && !restore->full) {
+        for (idx = 0;idx < restore->count;idx++) {
+          if (SAGE_IntersectDirtyRect(&(restore->rects[idx]), x_pos, y_pos, width, height, &part)) {
+            if (!SAGE_BlitBitmap(picture->bitmap, left + part.left - x_pos, top + part.top - y_pos, part.right - part.left + 1, part.bottom - part.top + 1, SAGE_GetBackBitmap(), part.left, part.top)) {
+              return FALSE;
+            }
+          }
+        }
+        return TRUE;
+      }
       // Copy picture bitmap into screen backbuffer
       return SAGE_BlitBitmap(picture->bitmap, left, top, width, height, SAGE_GetBackBitmap(), x_pos, y_pos);
     }
@@ -5,7 +5,7 @@
  * Screen management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <string.h>
@@ -643,13 +643,29 @@ BOOL SAGE_CloseScreen()
  */
 BOOL SAGE_ClearScreen()
 {
+  SAGE_DirtyBackground background;
+  SAGE_DirtyList *restore;
+  SAGE_DirtyRect *rect;
   SAGE_Screen *screen;
+  UWORD idx;
   
   screen = SAGE_GetScreen();
   SAFE(if (screen == NULL) {
     SAGE_SetError(SERR_NO_SCREEN);
     return FALSE;
   })
+  // Clear only the damaged parts of the buffer
+  memset(&background, 0, sizeof(SAGE_DirtyBackground));
+  background.type = SDRT_BACKCLEAR;
+  if ((restore = SAGE_GetDirtyRestore(&background)) != NULL && !restore->full) {
+    for (idx = 0;idx < restore->count;idx++) {
+      rect = &(restore->rects[idx]);
+      if (!SAGE_ClearBitmap(screen->back_bitmap, rect->left, rect->top, rect->right - rect->left + 1, rect->bottom - rect->top + 1)) {
+        return FALSE;
+      }
+    }
+    return TRUE;
+  }
   if (screen->back_bitmap->depth == SBMP_DEPTH8) {
     SAGE_FastClearScreen(
       (ULONG)screen->back_bitmap->bitmap_buffer,
@@ -915,7 +931,9 @@ BOOL SAGE_RefreshScreen()
     if (GetCyberMapAttr(bitmap, CYBRMATTR_ISCYBERGFX)) {
       cgx_handle = LockBitMapTags(bitmap, LBMI_BASEADDRESS, &bmp_adr, TAG_DONE);
       if (cgx_handle != NULL) {
-        SAGE_FastCopyScreen((ULONG)screen->back_bitmap->bitmap_buffer, bmp_adr, screen->back_bitmap->height, screen->back_bitmap->bpr, 0);
+        if (!SAGE_CopyDirtyRects(screen->screen_buffer.back_buffer, (UBYTE *)bmp_adr)) {
+          SAGE_FastCopyScreen((ULONG)screen->back_bitmap->bitmap_buffer, bmp_adr, screen->back_bitmap->height, screen->back_bitmap->bpr, 0);
+        }
         UnLockBitMap(cgx_handle);
       } else {
         SAGE_WarningLog("System failed to lock the screen bitmap !");
@@ -955,6 +973,10 @@ BOOL SAGE_RefreshScreen()
   }
   // Increment the frame counter
   screen->frame_rate.frame_count++;
+  // Start a new frame of background restores
+  screen->dirty_rects.nb_backgrounds = 0;
+  // Release the transient data of the frame before the previous one
+  SAGE_ResetFrameArena();
   // Wait for the VBL if synchro is active, else use the max fps limit
   if (screen->vertical_synchro) {
     SAGE_WaitVbl();
@@ -1631,6 +1653,7 @@ BOOL SAGE_PrintText(STRPTR text, UWORD posx, UWORD posy)
   SetDrMd(&(screen->screen_buffer.work_rastport), screen->drawing_mode);
   Move(&(screen->screen_buffer.work_rastport), posx, posy);
   Text(&(screen->screen_buffer.work_rastport), text, strlen(text));
+  SAGE_AddDirtyRect(posx, posy - screen->screen_buffer.work_rastport.TxBaseline, TextLength(&(screen->screen_buffer.work_rastport), text, strlen(text)), screen->screen_buffer.work_rastport.TxHeight);
   return TRUE;
 }
 
@@ -1660,6 +1683,7 @@ BOOL SAGE_PrintFText(UWORD posx, UWORD posy, char *format, ...)
   vsprintf(TextBuffer, format, args);
   va_end(args);
   Text(&(screen->screen_buffer.work_rastport), TextBuffer, strlen(TextBuffer));
+  SAGE_AddDirtyRect(posx, posy - screen->screen_buffer.work_rastport.TxBaseline, TextLength(&(screen->screen_buffer.work_rastport), TextBuffer, strlen(TextBuffer)), screen->screen_buffer.work_rastport.TxHeight);
   return TRUE;
 }
 
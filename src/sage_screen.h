@@ -5,7 +5,7 @@
  * Screen management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_SCREEN_H_
@@ -19,6 +19,7 @@
 #include <sage/sage_bitmap.h>
 #include <sage/sage_timer.h>
 #include <sage/sage_vblint.h>
+#include <sage/sage_dirtyrect.h>
 
 // Colors constants
 #define SSCR_MAXCOLORS        256
@@ -106,6 +107,8 @@ typedef struct {
   ULONG max_fps, frame_time;
   /** Framerate counter */
   SAGE_FpsCounter frame_rate;
+  /** Dirty rectangles */
+  SAGE_DirtyRects dirty_rects;
 } SAGE_Screen;
 
 /** Check supported pixel format */
@@ -5,7 +5,7 @@
  * Sound management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
 */
 
 #include <datatypes/datatypes.h>
@@ -110,10 +110,11 @@ SAGE_Sound *SAGE_LoadSound(STRPTR file_name)
 {
   SAGE_Sound *sound = NULL;
   BPTR file_handle;
-  UWORD type;
+  UWORD type, tag;
 
   SD(SAGE_DebugLog("Load sound %s", file_name);)
   sound = NULL;
+  tag = SAGE_SetMemoryTag(SMEM_TAG_SOUND);
   file_handle = Open(file_name, MODE_OLDFILE);
   if (file_handle != 0) {
     type = SAGE_GetSoundFileType(file_handle);
@@ -130,6 +131,7 @@ SAGE_Sound *SAGE_LoadSound(STRPTR file_name)
   } else {
     SAGE_SetError(SERR_OPENFILE);
   }
+  SAGE_SetMemoryTag(tag);
   SD(SAGE_DumpSound(sound));
   return sound;
 }
@@ -152,7 +154,7 @@ SAGE_Sound *SAGE_DTLoadSound(STRPTR file_name)
   SD(SAGE_DebugLog("Load sound %s using datatypes", file_name);)
   if (object = NewDTObject(file_name, DTA_GroupID, GID_SOUND, TAG_END)) {
     // Allocate sound structure
-    sound = (SAGE_Sound *)SAGE_AllocMem(sizeof(SAGE_Sound));
+    sound = (SAGE_Sound *)SAGE_PoolAlloc(sizeof(SAGE_Sound));
     if (sound == NULL) {
       DisposeDTObject(object);
       SAGE_SetError(SERR_NO_MEMORY);
@@ -181,7 +183,7 @@ VOID SAGE_ReleaseSound(SAGE_Sound *sound)
     if (sound->sample_buffer) {
       SAGE_FreeMem(sound->sample_buffer);
     }
-    SAGE_FreeMem(sound);
+    SAGE_PoolFree(sound);
   }
 }
 
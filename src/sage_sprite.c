@@ -5,13 +5,16 @@
  * Sprite management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
+#include <string.h>
+
 #include <sage/sage_debug.h>
 #include <sage/sage_error.h>
 #include <sage/sage_logger.h>
 #include <sage/sage_memory.h>
+#include <sage/sage_maths.h>
 #include <sage/sage_context.h>
 #include <sage/sage_sprite.h>
 
@@ -30,7 +33,7 @@ extern SAGE_Context SageContext;
 BOOL SAGE_CreateSpriteBank(UWORD index, UWORD size, SAGE_Picture *picture)
 {
   SAGE_SpriteBank *bank;
-  UWORD sprite;
+  UWORD sprite, tag;
 
   SD(SAGE_DebugLog("Create sprite bank #%d (%d)", index, size);)
   // Check for video device
@@ -50,10 +53,17 @@ BOOL SAGE_CreateSpriteBank(UWORD index, UWORD size, SAGE_Picture *picture)
     SAGE_ReleaseSpriteBank(index);
   }
   // Allocate and init the sprite bank
+  tag = SAGE_SetMemoryTag(SMEM_TAG_SPRITE);
   bank = (SAGE_SpriteBank *)SAGE_AllocMem(sizeof(SAGE_SpriteBank));
   if (bank != NULL) {
     bank->bank_size = size;
     bank->sprites = (SAGE_Sprite *)SAGE_AllocMem(sizeof(SAGE_Sprite) * size);
+    if (bank->sprites != NULL) {
+      bank->bitmap = SAGE_AllocBitmap(picture->bitmap->width, picture->bitmap->height, picture->bitmap->depth, 0, picture->bitmap->pixformat, NULL);
+    }
+  }
+  SAGE_SetMemoryTag(tag);
+  if (bank != NULL) {
     if (bank->sprites != NULL) {
       for (sprite = 0;sprite < size;sprite++) {
         bank->sprites[sprite].left = 0;
@@ -61,7 +71,7 @@ BOOL SAGE_CreateSpriteBank(UWORD index, UWORD size, SAGE_Picture *picture)
         bank->sprites[sprite].width = 0;
         bank->sprites[sprite].height = 0;
       }
-      if ((bank->bitmap = SAGE_AllocBitmap(picture->bitmap->width, picture->bitmap->height, picture->bitmap->depth, 0, picture->bitmap->pixformat, NULL)) != NULL) {
+      if (bank->bitmap != NULL) {
         SAGE_BlitBitmap(picture->bitmap, 0, 0, picture->bitmap->width, picture->bitmap->height, bank->bitmap, 0, 0);
         SageContext.SageVideo->sprites[index] = bank;
         return TRUE;
@@ -95,6 +105,168 @@ SAGE_SpriteBank *SAGE_GetSpriteBank(UWORD index)
   return SageContext.SageVideo->sprites[index];
 }
 
+/**
+ * Release the collision masks of a sprite
+ * 
+ * @param sprite Sprite structure
+ */
+VOID SAGE_ReleaseSpriteMasks(SAGE_Sprite *sprite)
+{
+  UWORD mask;
+
+  if (sprite->masks[0] != NULL) {
+    SAGE_FreeMem(sprite->masks[0]);
+  }
+  for (mask = 0;mask < SSPR_MASKS;mask++) {
+    sprite->masks[mask] = NULL;
+  }
+  sprite->mask_words = 0;
+}
+
+/**
+ * Release the transparent spans of a sprite
+ * 
+ * @param sprite Sprite structure
+ */
+VOID SAGE_ReleaseSpriteSpans(SAGE_Sprite *sprite)
+{
+  if (sprite->span_rows != NULL) {
+    SAGE_FreeMem(sprite->span_rows);
+  }
+  sprite->span_rows = NULL;
+  sprite->spans = NULL;
+}
+
+/**
+ * Release the rotated frames cache of a sprite
+ * 
+ * @param sprite Sprite structure
+ * @param frames Number of frames in the cache
+ */
+VOID SAGE_ReleaseRotatedFrames(SAGE_Sprite *sprite, UWORD frames)
+{
+  UWORD frame;
+
+  if (sprite->rotated_frames != NULL) {
+    for (frame = 0;frame < frames;frame++) {
+      if (sprite->rotated_frames[frame].bitmap != NULL) {
+        SAGE_ReleaseBitmap(sprite->rotated_frames[frame].bitmap);
+      }
+    }
+    SAGE_FreeMem(sprite->rotated_frames);
+    sprite->rotated_frames = NULL;
+  }
+}
+
+/**
+ * Check if a pixel of the bank bitmap is not transparent
+ */
+BOOL SAGE_IsSolidPixel(SAGE_Bitmap *bitmap, ULONG x_pos, ULONG y_pos)
+{
+  UBYTE *pixel;
+
+  if (!(bitmap->properties & SBMP_TRANSPARENT)) {
+    return TRUE;
+  }
+  pixel = (UBYTE *)bitmap->bitmap_buffer + (y_pos * bitmap->bpr) + (x_pos * (bitmap->depth / 8));
+  if (bitmap->depth == SBMP_DEPTH8) {
+    return (BOOL)(*pixel != (UBYTE)bitmap->transparency);
+  } else if (bitmap->depth == SBMP_DEPTH16) {
+    return (BOOL)(*((UWORD *)pixel) != (UWORD)bitmap->transparency);
+  } else if (bitmap->depth == SBMP_DEPTH24) {
+    return (BOOL)((((ULONG)pixel[0] << 16) | ((ULONG)pixel[1] << 8) | (ULONG)pixel[2]) != (bitmap->transparency & 0xFFFFFF));
+  }
+  return (BOOL)(*((ULONG *)pixel) != bitmap->transparency);
+}
+
+/**
+ * Encode the solid pixels of a sprite as spans, each row starts with its
+ * number of spans then each span has a skip word (transparent pixels since
+ * the end of the previous span), a length word and the pixels padded to a
+ * word. Without buffer only the size of the spans is computed.
+ */
+ULONG SAGE_EncodeSpriteSpans(SAGE_Bitmap *bitmap, SAGE_Sprite *spr, UBYTE *spans)
+{
+  UBYTE *pixels;
+  ULONG x_pos, y_pos, start, last, size, bpp, count;
+  UWORD nb_spans;
+
+  bpp = bitmap->depth / 8;
+  size = 0;
+  for (y_pos = 0;y_pos < spr->height;y_pos++) {
+    count = size;
+    size += sizeof(UWORD);
+    nb_spans = 0;
+    last = 0;
+    x_pos = 0;
+    while (x_pos < spr->width) {
+      while (x_pos < spr->width && !SAGE_IsSolidPixel(bitmap, spr->left + x_pos, spr->top + y_pos)) {
+        x_pos++;
+      }
+      if (x_pos >= spr->width) {
+        break;
+      }
+      start = x_pos;
+      while (x_pos < spr->width && SAGE_IsSolidPixel(bitmap, spr->left + x_pos, spr->top + y_pos)) {
+        x_pos++;
+      }
+      if (spans != NULL) {
+        pixels = (UBYTE *)bitmap->bitmap_buffer + ((spr->top + y_pos) * bitmap->bpr) + ((spr->left + start) * bpp);
+        ((UWORD *)(spans + size))[0] = (UWORD)(start - last);
+        ((UWORD *)(spans + size))[1] = (UWORD)(x_pos - start);
+        memcpy(spans + size + SSPR_SPANHEADER, pixels, (x_pos - start) * bpp);
+      }
+      size += SSPR_SPANHEADER + ((((x_pos - start) * bpp) + 1) & ~1);
+      last = x_pos;
+      nb_spans++;
+    }
+    if (spans != NULL) {
+      spr->span_rows[y_pos] = count;
+      *((UWORD *)(spans + count)) = nb_spans;
+    }
+  }
+  return size;
+}
+
+/**
+ * Build the transparent spans of a sprite, the row offsets and the spans are
+ * in the same block. Sprites of an opaque bank have no spans.
+ */
+BOOL SAGE_BuildSpriteSpans(SAGE_SpriteBank *bank, UWORD sprite)
+{
+  SAGE_Sprite *spr;
+  ULONG size;
+
+  spr = &(bank->sprites[sprite]);
+  SAGE_ReleaseSpriteSpans(spr);
+  if (!(bank->bitmap->properties & SBMP_TRANSPARENT) || spr->width == 0 || spr->height == 0) {
+    return TRUE;
+  }
+  size = SAGE_EncodeSpriteSpans(bank->bitmap, spr, NULL);
+  if ((spr->span_rows = (ULONG *)SAGE_AllocMem((sizeof(ULONG) * spr->height) + size)) == NULL) {
+    SAGE_SetError(SERR_NO_MEMORY);
+    return FALSE;
+  }
+  spr->spans = (UBYTE *)(spr->span_rows + spr->height);
+  SAGE_EncodeSpriteSpans(bank->bitmap, spr, spr->spans);
+  return TRUE;
+}
+
+/**
+ * Build the transparent spans of all the sprites of a bank
+ */
+BOOL SAGE_BuildBankSpans(SAGE_SpriteBank *bank)
+{
+  UWORD sprite;
+
+  for (sprite = 0;sprite < bank->bank_size;sprite++) {
+    if (!SAGE_BuildSpriteSpans(bank, sprite)) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
 /**
  * Release a sprite bank
  *
@@ -105,6 +277,7 @@ SAGE_SpriteBank *SAGE_GetSpriteBank(UWORD index)
 BOOL SAGE_ReleaseSpriteBank(UWORD index)
 {
   SAGE_SpriteBank *bank;
+  UWORD sprite;
   
   SD(SAGE_DebugLog("Release sprite bank #%d", index);)
   bank = SAGE_GetSpriteBank(index);
@@ -113,6 +286,11 @@ BOOL SAGE_ReleaseSpriteBank(UWORD index)
       SAGE_ReleaseBitmap(bank->bitmap);
     }
     if (bank->sprites != NULL) {
+      for (sprite = 0;sprite < bank->bank_size;sprite++) {
+        SAGE_ReleaseSpriteMasks(&(bank->sprites[sprite]));
+        SAGE_ReleaseSpriteSpans(&(bank->sprites[sprite]));
+        SAGE_ReleaseRotatedFrames(&(bank->sprites[sprite]), bank->rotation_frames);
+      }
       SAGE_FreeMem(bank->sprites);
     }
     SAGE_FreeMem(bank);
@@ -123,7 +301,9 @@ BOOL SAGE_ReleaseSpriteBank(UWORD index)
 }
 
 /**
- * Define the sprite bank transparency color
+ * Define the sprite bank transparency color, the transparent spans of the
+ * sprites are built again with the new color and the rotated frames are
+ * dropped
  *
  * @param index Sprite bank index
  * @param color Transparent color in ARGB/CLUT format
@@ -131,6 +311,68 @@ BOOL SAGE_ReleaseSpriteBank(UWORD index)
  * @return Operation success
  */
 BOOL SAGE_SetSpriteBankTransparency(UWORD index, ULONG color)
+{
+  SAGE_SpriteBank *bank;
+  UWORD sprite;
+  
+  bank = SAGE_GetSpriteBank(index);
+  SAFE(if (bank == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if (!SAGE_SetBitmapTransparency(bank->bitmap, SAGE_RemapColor(color))) {
+    return FALSE;
+  }
+  for (sprite = 0;sprite < bank->bank_size;sprite++) {
+    SAGE_ReleaseRotatedFrames(&(bank->sprites[sprite]), bank->rotation_frames);
+  }
+  if (bank->sprite_spans) {
+    return SAGE_BuildBankSpans(bank);
+  }
+  return TRUE;
+}
+
+/**
+ * Build the transparent spans of the sprites, a standard sprite with spans is
+ * drawn by copying only its solid pixels instead of testing all the pixels
+ * against the transparent color. Zoomed sprites still use the transparent
+ * blit, flipped and rotated sprites test each pixel of the rotation map.
+ * 
+ * @param index  Sprite bank index
+ * @param enable Enable/disable the transparent spans
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_SetSpriteBankSpans(UWORD index, BOOL enable)
+{
+  SAGE_SpriteBank *bank;
+  UWORD sprite;
+  
+  bank = SAGE_GetSpriteBank(index);
+  SAFE(if (bank == NULL || bank->sprites == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  bank->sprite_spans = enable;
+  if (enable) {
+    return SAGE_BuildBankSpans(bank);
+  }
+  for (sprite = 0;sprite < bank->bank_size;sprite++) {
+    SAGE_ReleaseSpriteSpans(&(bank->sprites[sprite]));
+  }
+  return TRUE;
+}
+
+/**
+ * Build the collision masks of the sprites added to the bank, the masks use
+ * the bank transparency so it should be set before adding the sprites
+ * 
+ * @param index  Sprite bank index
+ * @param enable Enable/disable the collision masks
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_SetSpriteBankMasks(UWORD index, BOOL enable)
 {
   SAGE_SpriteBank *bank;
   
@@ -139,7 +381,122 @@ BOOL SAGE_SetSpriteBankTransparency(UWORD index, ULONG color)
     SAGE_SetError(SERR_NULL_POINTER);
     return FALSE;
   })
-  return SAGE_SetBitmapTransparency(bank->bitmap, SAGE_RemapColor(color));
+  bank->collision_masks = enable;
+  return TRUE;
+}
+
+/**
+ * Keep the last rotated frames of each sprite, a rotated sprite is drawn
+ * again only when its angle, zoom or flipping is not in the cache. The cache
+ * is used only by the sprites of a transparent bank.
+ * 
+ * @param index  Sprite bank index
+ * @param frames Number of frames cached by sprite (0 to disable the cache)
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_SetSpriteBankRotationCache(UWORD index, UWORD frames)
+{
+  SAGE_SpriteBank *bank;
+  UWORD sprite;
+  
+  bank = SAGE_GetSpriteBank(index);
+  SAFE(if (bank == NULL || bank->sprites == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  for (sprite = 0;sprite < bank->bank_size;sprite++) {
+    SAGE_ReleaseRotatedFrames(&(bank->sprites[sprite]), bank->rotation_frames);
+  }
+  bank->rotation_frames = frames;
+  bank->rotation_clock = 0;
+  return TRUE;
+}
+
+/**
+ * Build the collision masks of a sprite, the normal mask and the flipped ones
+ * are done at once so flipping a sprite costs nothing. Each row ends with an
+ * empty long so the collision test can always read the next long.
+ */
+BOOL SAGE_BuildSpriteMasks(SAGE_SpriteBank *bank, UWORD sprite)
+{
+  SAGE_Sprite *spr;
+  ULONG *masks, bit, x_pos, y_pos, flip_x, flip_y;
+  UWORD mask;
+
+  spr = &(bank->sprites[sprite]);
+  SAGE_ReleaseSpriteMasks(spr);
+  spr->mask_words = ((spr->width + 31) >> 5) + 1;
+  masks = (ULONG *)SAGE_AllocMem(sizeof(ULONG) * spr->mask_words * spr->height * SSPR_MASKS);
+  if (masks == NULL) {
+    spr->mask_words = 0;
+    SAGE_SetError(SERR_NO_MEMORY);
+    return FALSE;
+  }
+  for (mask = 0;mask < SSPR_MASKS;mask++) {
+    spr->masks[mask] = masks + (spr->mask_words * spr->height * mask);
+  }
+  for (y_pos = 0;y_pos < spr->height;y_pos++) {
+    flip_y = spr->height - 1 - y_pos;
+    for (x_pos = 0;x_pos < spr->width;x_pos++) {
+      if (SAGE_IsSolidPixel(bank->bitmap, spr->left + x_pos, spr->top + y_pos)) {
+        flip_x = spr->width - 1 - x_pos;
+        bit = 0x80000000 >> (x_pos & 31);
+        spr->masks[0][(y_pos * spr->mask_words) + (x_pos >> 5)] |= bit;
+        spr->masks[SSPR_MASKVFLIP][(flip_y * spr->mask_words) + (x_pos >> 5)] |= bit;
+        bit = 0x80000000 >> (flip_x & 31);
+        spr->masks[SSPR_MASKHFLIP][(y_pos * spr->mask_words) + (flip_x >> 5)] |= bit;
+        spr->masks[SSPR_MASKHFLIP|SSPR_MASKVFLIP][(flip_y * spr->mask_words) + (flip_x >> 5)] |= bit;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Copy the spans of a sprite inside a clipped area of the sprite, the spans
+ * outside of the area are skipped and the others are cut to the area
+ * 
+ * @param sprite      Sprite with spans
+ * @param left        Left of the area in the sprite
+ * @param top         Top of the area in the sprite
+ * @param width       Area width
+ * @param height      Area height
+ * @param destination Destination bitmap (same depth as the sprite bank)
+ * @param x_pos       Horizontal position in the destination
+ * @param y_pos       Vertical position in the destination
+ */
+VOID SAGE_BlitSpriteSpans(SAGE_Sprite *sprite, LONG left, LONG top, LONG width, LONG height, SAGE_Bitmap *destination, LONG x_pos, LONG y_pos)
+{
+  UBYTE *span, *dst_line;
+  LONG row, start, end, right, first, last, bpp;
+  UWORD nb_spans, length;
+
+  bpp = destination->depth / 8;
+  right = left + width;
+  dst_line = (UBYTE *)destination->bitmap_buffer + (y_pos * destination->bpr) + (x_pos * bpp);
+  for (row = top;row < (top + height);row++) {
+    span = sprite->spans + sprite->span_rows[row];
+    nb_spans = *((UWORD *)span);
+    span += sizeof(UWORD);
+    end = 0;
+    while (nb_spans > 0) {
+      start = end + ((UWORD *)span)[0];
+      length = ((UWORD *)span)[1];
+      end = start + length;
+      if (start >= right) {
+        break;
+      }
+      if (end > left) {
+        first = (start > left) ? start : left;
+        last = (end < right) ? end : right;
+        memcpy(dst_line + ((first - left) * bpp), span + SSPR_SPANHEADER + ((first - start) * bpp), (last - first) * bpp);
+      }
+      span += SSPR_SPANHEADER + (((length * bpp) + 1) & ~1);
+      nb_spans--;
+    }
+    dst_line += destination->bpr;
+  }
 }
 
 /**
@@ -227,9 +584,22 @@ BOOL SAGE_AddSpriteToBank(UWORD index, UWORD sprite, ULONG left, ULONG top, ULON
       bank->sprites[sprite].vertical_flip = FALSE;
       bank->sprites[sprite].horizontal_zoom = 1.0;
       bank->sprites[sprite].vertical_zoom = 1.0;
+      bank->sprites[sprite].rotation_angle = 0.0;
       bank->sprites[sprite].flags = SSPR_STANDARD;
+      SAGE_ReleaseRotatedFrames(&(bank->sprites[sprite]), bank->rotation_frames);
       bank->sprites[sprite].hotspot = hotspot;
       SAGE_CalculSpriteHotspot(bank, sprite);
+      if (bank->sprite_spans) {
+        if (!SAGE_BuildSpriteSpans(bank, sprite)) {
+          return FALSE;
+        }
+      } else {
+        SAGE_ReleaseSpriteSpans(&(bank->sprites[sprite]));
+      }
+      if (bank->collision_masks) {
+        return SAGE_BuildSpriteMasks(bank, sprite);
+      }
+      SAGE_ReleaseSpriteMasks(&(bank->sprites[sprite]));
       return TRUE;
     }
     SAGE_SetError(SERR_SPRITE_SIZE);
@@ -349,6 +719,44 @@ BOOL SAGE_SetSpriteZoom(UWORD index, UWORD sprite, FLOAT horizontal, FLOAT verti
   return FALSE;
 }
 
+/**
+ * Set the sprite rotation angle, the sprite turns clockwise around its hotspot
+ * and keeps its zoom factor and flipping
+ * 
+ * @param index  Sprite bank index
+ * @param sprite Sprite index
+ * @param angle  Rotation angle in degree
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_SetSpriteRotation(UWORD index, UWORD sprite, FLOAT angle)
+{
+  SAGE_SpriteBank *bank;
+  
+  bank = SAGE_GetSpriteBank(index);
+  SAFE(if (bank == NULL || bank->sprites == NULL || bank->bitmap == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if (bank->bank_size > sprite) {
+    while (angle < 0.0) {
+      angle += 360.0;
+    }
+    while (angle >= 360.0) {
+      angle -= 360.0;
+    }
+    bank->sprites[sprite].rotation_angle = angle;
+    if ((WORD)(angle * SMTH_PRECISION) == 0) {
+      bank->sprites[sprite].flags &= ~SSPR_ROTATED;
+    } else {
+      bank->sprites[sprite].flags |= SSPR_ROTATED;
+    }
+    return TRUE;
+  }
+  SAGE_SetError(SERR_SPRITE_INDEX);
+  return FALSE;
+}
+
 /**
  * Set the sprite hotspot
  *
@@ -370,12 +778,97 @@ BOOL SAGE_SetSpriteHotspot(UWORD index, UWORD sprite, UWORD hotspot)
   if (bank->bank_size > sprite) {
     bank->sprites[sprite].hotspot = hotspot;
     SAGE_CalculSpriteHotspot(bank, sprite);
+    // The rotated frames turn around the old hotspot
+    SAGE_ReleaseRotatedFrames(&(bank->sprites[sprite]), bank->rotation_frames);
     return TRUE;
   }
   SAGE_SetError(SERR_SPRITE_INDEX);
   return FALSE;
 }
 
+/**
+ * Check for collision between two boxes
+ * 
+ * @param x1 First box left
+ * @param y1 First box top
+ * @param w1 First box width
+ * @param h1 First box height
+ * @param x2 Second box left
+ * @param y2 Second box top
+ * @param w2 Second box width
+ * @param h2 Second box height
+ *
+ * @return Boxes are colliding
+ */
+BOOL SAGE_BoxCollide(LONG x1, LONG y1, LONG w1, LONG h1, LONG x2, LONG y2, LONG w2, LONG h2)
+{
+  if (x2 > (x1 + w1)) return FALSE;
+  if (x1 > (x2 + w2)) return FALSE;
+  if (y2 > (y1 + h1)) return FALSE;
+  if (y1 > (y2 + h2)) return FALSE;
+  return TRUE;
+}
+
+/**
+ * Get 32 pixels of a mask row starting at any pixel
+ */
+ULONG SAGE_GetMaskBits(ULONG *row, LONG x_pos)
+{
+  ULONG shift;
+
+  row += x_pos >> 5;
+  shift = x_pos & 31;
+  if (shift == 0) {
+    return row[0];
+  }
+  return (row[0] << shift) | (row[1] >> (32 - shift));
+}
+
+/**
+ * Check for collision between two sprite masks, only the overlap of the
+ * sprites is tested 32 pixels at a time. The positions are the sprites top
+ * left corners (hotspot already removed). A sprite without mask or zoomed
+ * is tested as a full box.
+ * 
+ * @param spr1 First sprite
+ * @param x1   First sprite left
+ * @param y1   First sprite top
+ * @param spr2 Second sprite
+ * @param x2   Second sprite left
+ * @param y2   Second sprite top
+ * 
+ * @return Sprites are colliding
+ */
+BOOL SAGE_MaskCollide(SAGE_Sprite *spr1, LONG x1, LONG y1, SAGE_Sprite *spr2, LONG x2, LONG y2)
+{
+  ULONG *row1, *row2;
+  LONG left, top, right, bottom, x_pos, y_pos;
+
+  if (spr1->mask_words == 0 || spr2->mask_words == 0 || (spr1->flags & (SSPR_ZOOMED|SSPR_ROTATED)) || (spr2->flags & (SSPR_ZOOMED|SSPR_ROTATED))) {
+    return SAGE_BoxCollide(x1, y1, spr1->width, spr1->height, x2, y2, spr2->width, spr2->height);
+  }
+  left = (x1 > x2) ? x1 : x2;
+  top = (y1 > y2) ? y1 : y2;
+  right = ((x1 + (LONG)spr1->width) < (x2 + (LONG)spr2->width)) ? (x1 + (LONG)spr1->width) : (x2 + (LONG)spr2->width);
+  bottom = ((y1 + (LONG)spr1->height) < (y2 + (LONG)spr2->height)) ? (y1 + (LONG)spr1->height) : (y2 + (LONG)spr2->height);
+  if (left >= right || top >= bottom) {
+    return FALSE;
+  }
+  // Pixels after the right edge of a sprite are empty, no need to mask the last longs
+  row1 = spr1->masks[(spr1->horizontal_flip ? SSPR_MASKHFLIP : 0) | (spr1->vertical_flip ? SSPR_MASKVFLIP : 0)] + ((top - y1) * spr1->mask_words);
+  row2 = spr2->masks[(spr2->horizontal_flip ? SSPR_MASKHFLIP : 0) | (spr2->vertical_flip ? SSPR_MASKVFLIP : 0)] + ((top - y2) * spr2->mask_words);
+  for (y_pos = top;y_pos < bottom;y_pos++) {
+    for (x_pos = left;x_pos < right;x_pos += 32) {
+      if (SAGE_GetMaskBits(row1, x_pos - x1) & SAGE_GetMaskBits(row2, x_pos - x2)) {
+        return TRUE;
+      }
+    }
+    row1 += spr1->mask_words;
+    row2 += spr2->mask_words;
+  }
+  return FALSE;
+}
+
 /**
  * Check for collision between two sprites
  * 
@@ -408,17 +901,335 @@ BOOL SAGE_SpriteCollide(UWORD idx1, UWORD spr1, LONG x1, LONG y1, UWORD idx2, UW
     y2 -= bank2->sprites[spr2].hs_y;
     SD(SAGE_TraceLog("SpriteCollide x1 %d, y1 %d, w1 %d, h1 %d", x1, y1, bank1->sprites[spr1].width, bank1->sprites[spr1].height);)
     SD(SAGE_TraceLog("              x2 %d, y2 %d, w2 %d, h2 %d\n", x2, y2, bank2->sprites[spr2].width, bank2->sprites[spr2].height);)
-    // Check collision
-    if (x2 > (x1 + bank1->sprites[spr1].width)) return FALSE;
-    if (x1 > (x2 + bank2->sprites[spr2].width)) return FALSE;
-    if (y2 > (y1 + bank1->sprites[spr1].height)) return FALSE;
-    if (y1 > (y2 + bank2->sprites[spr2].height)) return FALSE;
-    return TRUE;
+    // Check collision, then the masks if the sprites have some
+    if (SAGE_BoxCollide(x1, y1, bank1->sprites[spr1].width, bank1->sprites[spr1].height, x2, y2, bank2->sprites[spr2].width, bank2->sprites[spr2].height)) {
+      if (bank1->sprites[spr1].mask_words == 0 || bank2->sprites[spr2].mask_words == 0) {
+        return TRUE;
+      }
+      return SAGE_MaskCollide(&(bank1->sprites[spr1]), x1, y1, &(bank2->sprites[spr2]), x2, y2);
+    }
+    return FALSE;
   }
   SAGE_SetError(SERR_SPRITE_INDEX);
   return FALSE;
 }
 
+/**
+ * Compute the inverse mapping of a rotated sprite, each pixel of the
+ * destination box is mapped back to the sprite with 16.16 fixed point
+ * coordinates. The sprite turns around its hotspot placed at x_pos,y_pos.
+ */
+VOID SAGE_SetupRotationMap(SAGE_Sprite *spr, LONG x_pos, LONG y_pos, SAGE_RotationMap *map)
+{
+  FLOAT cosine, sine, hzoom, vzoom, hs_u, hs_v, p_pos, q_pos, x_dest, y_dest;
+  FLOAT min_x, max_x, min_y, max_y, u_start, v_start;
+  WORD angle;
+  UWORD corner;
+
+  angle = (WORD)(spr->rotation_angle * SMTH_PRECISION);
+  cosine = SAGE_FastCosine(angle);
+  sine = SAGE_FastSine(angle);
+  hzoom = spr->horizontal_zoom;
+  vzoom = spr->vertical_zoom;
+  // Hotspot in the sprite
+  hs_u = (spr->width > 0) ? ((FLOAT)spr->hs_x * (FLOAT)spr->real_width) / (FLOAT)spr->width : 0.0;
+  hs_v = (spr->height > 0) ? ((FLOAT)spr->hs_y * (FLOAT)spr->real_height) / (FLOAT)spr->height : 0.0;
+  // Destination box of the sprite corners
+  min_x = min_y = 1.0e9;
+  max_x = max_y = -1.0e9;
+  for (corner = 0;corner < 4;corner++) {
+    p_pos = (((corner & 1) ? (FLOAT)spr->real_width : 0.0) - hs_u) * hzoom;
+    q_pos = (((corner & 2) ? (FLOAT)spr->real_height : 0.0) - hs_v) * vzoom;
+    x_dest = (cosine * p_pos) - (sine * q_pos);
+    y_dest = (sine * p_pos) + (cosine * q_pos);
+    min_x = (x_dest < min_x) ? x_dest : min_x;
+    max_x = (x_dest > max_x) ? x_dest : max_x;
+    min_y = (y_dest < min_y) ? y_dest : min_y;
+    max_y = (y_dest > max_y) ? y_dest : max_y;
+  }
+  map->left = x_pos + (LONG)floor(min_x);
+  map->top = y_pos + (LONG)floor(min_y);
+  map->right = x_pos + (LONG)ceil(max_x) - 1;
+  map->bottom = y_pos + (LONG)ceil(max_y) - 1;
+  // Sprite coordinates of the center of the box top left pixel
+  x_dest = (FLOAT)(map->left - x_pos) + 0.5;
+  y_dest = (FLOAT)(map->top - y_pos) + 0.5;
+  u_start = hs_u + (((x_dest * cosine) + (y_dest * sine)) / hzoom);
+  v_start = hs_v + (((y_dest * cosine) - (x_dest * sine)) / vzoom);
+  map->du_x = (LONG)floor(((cosine / hzoom) * (1L << SSPR_FIXSHIFT)) + 0.5);
+  map->du_y = (LONG)floor(((sine / hzoom) * (1L << SSPR_FIXSHIFT)) + 0.5);
+  map->dv_x = (LONG)floor(((-sine / vzoom) * (1L << SSPR_FIXSHIFT)) + 0.5);
+  map->dv_y = (LONG)floor(((cosine / vzoom) * (1L << SSPR_FIXSHIFT)) + 0.5);
+  map->u_start = (LONG)floor((u_start * (1L << SSPR_FIXSHIFT)) + 0.5);
+  map->v_start = (LONG)floor((v_start * (1L << SSPR_FIXSHIFT)) + 0.5);
+  map->u_size = (LONG)spr->real_width << SSPR_FIXSHIFT;
+  map->v_size = (LONG)spr->real_height << SSPR_FIXSHIFT;
+  // Flipping mirrors the sprite coordinates
+  if (spr->horizontal_flip) {
+    map->u_start = map->u_size - map->u_start;
+    map->du_x = -map->du_x;
+    map->du_y = -map->du_y;
+  }
+  if (spr->vertical_flip) {
+    map->v_start = map->v_size - map->v_start;
+    map->dv_x = -map->dv_x;
+    map->dv_y = -map->dv_y;
+  }
+}
+
+/**
+ * Cut a row of the destination box (first and last pixel from the box left)
+ * to the pixels where a sprite coordinate is between 0 and size
+ */
+VOID SAGE_CutRotationSpan(LONG value, LONG step, LONG size, LONG *first, LONG *last)
+{
+  FLOAT low, high;
+
+  if (step == 0) {
+    if (value < 0 || value >= size) {
+      *last = *first - 1;
+    }
+    return;
+  }
+  // Estimate the limits then adjust them with the fixed point steps
+  low = (FLOAT)(0 - value) / (FLOAT)step;
+  high = (FLOAT)(size - value) / (FLOAT)step;
+  if (low > high) {
+    high = (FLOAT)(0 - value) / (FLOAT)step;
+    low = (FLOAT)(size - value) / (FLOAT)step;
+  }
+  if ((low - 1.0) > (FLOAT)*first) {
+    *first = (LONG)low - 1;
+  }
+  if ((high + 1.0) < (FLOAT)*last) {
+    *last = (LONG)high + 1;
+  }
+  while (*first <= *last && (ULONG)(value + (step * *first)) >= (ULONG)size) {
+    (*first)++;
+  }
+  while (*last >= *first && (ULONG)(value + (step * *last)) >= (ULONG)size) {
+    (*last)--;
+  }
+}
+
+/**
+ * Copy a span of rotated 8bits pixels
+ */
+VOID SAGE_Rotate8BitsSpan(UBYTE *source, ULONG bpr, UBYTE *destination, LONG count, LONG u_pos, LONG v_pos, LONG du, LONG dv, UBYTE transparency, BOOL transparent)
+{
+  UBYTE pixel;
+
+  while (count-- > 0) {
+    pixel = source[((v_pos >> SSPR_FIXSHIFT) * bpr) + (u_pos >> SSPR_FIXSHIFT)];
+    if (!transparent || pixel != transparency) {
+      *destination = pixel;
+    }
+    destination++;
+    u_pos += du;
+    v_pos += dv;
+  }
+}
+
+/**
+ * Copy a span of rotated 16bits pixels
+ */
+VOID SAGE_Rotate16BitsSpan(UBYTE *source, ULONG bpr, UWORD *destination, LONG count, LONG u_pos, LONG v_pos, LONG du, LONG dv, UWORD transparency, BOOL transparent)
+{
+  UWORD pixel;
+
+  while (count-- > 0) {
+    pixel = *((UWORD *)(source + ((v_pos >> SSPR_FIXSHIFT) * bpr)) + (u_pos >> SSPR_FIXSHIFT));
+    if (!transparent || pixel != transparency) {
+      *destination = pixel;
+    }
+    destination++;
+    u_pos += du;
+    v_pos += dv;
+  }
+}
+
+/**
+ * Copy a span of rotated 32bits pixels
+ */
+VOID SAGE_Rotate32BitsSpan(UBYTE *source, ULONG bpr, ULONG *destination, LONG count, LONG u_pos, LONG v_pos, LONG du, LONG dv, ULONG transparency, BOOL transparent)
+{
+  ULONG pixel;
+
+  while (count-- > 0) {
+    pixel = *((ULONG *)(source + ((v_pos >> SSPR_FIXSHIFT) * bpr)) + (u_pos >> SSPR_FIXSHIFT));
+    if (!transparent || pixel != transparency) {
+      *destination = pixel;
+    }
+    destination++;
+    u_pos += du;
+    v_pos += dv;
+  }
+}
+
+/**
+ * Draw a rotated sprite inside a clipping area, each row of the box is cut to
+ * the pixels mapped inside the sprite so only the transparency is tested
+ */
+VOID SAGE_DrawRotatedSprite(SAGE_Bitmap *source, SAGE_Sprite *spr, SAGE_RotationMap *map, SAGE_Bitmap *destination, LONG clip_left, LONG clip_top, LONG clip_right, LONG clip_bottom)
+{
+  UBYTE *src_buffer, *dst_line;
+  LONG row, first, last, u_row, v_row, bpp;
+  BOOL transparent;
+
+  bpp = destination->depth / 8;
+  transparent = (BOOL)((source->properties & SBMP_TRANSPARENT) != 0);
+  src_buffer = (UBYTE *)source->bitmap_buffer + (spr->top * source->bpr) + (spr->left * bpp);
+  if (clip_top < map->top) {
+    clip_top = map->top;
+  }
+  if (clip_bottom > map->bottom) {
+    clip_bottom = map->bottom;
+  }
+  for (row = clip_top;row <= clip_bottom;row++) {
+    u_row = map->u_start + (map->du_y * (row - map->top));
+    v_row = map->v_start + (map->dv_y * (row - map->top));
+    first = ((clip_left > map->left) ? clip_left : map->left) - map->left;
+    last = ((clip_right < map->right) ? clip_right : map->right) - map->left;
+    SAGE_CutRotationSpan(u_row, map->du_x, map->u_size, &first, &last);
+    SAGE_CutRotationSpan(v_row, map->dv_x, map->v_size, &first, &last);
+    if (first <= last) {
+      dst_line = (UBYTE *)destination->bitmap_buffer + (row * destination->bpr) + ((map->left + first) * bpp);
+      u_row += map->du_x * first;
+      v_row += map->dv_x * first;
+      if (bpp == 1) {
+        SAGE_Rotate8BitsSpan(src_buffer, source->bpr, dst_line, (last - first) + 1, u_row, v_row, map->du_x, map->dv_x, (UBYTE)source->transparency, transparent);
+      } else if (bpp == 2) {
+        SAGE_Rotate16BitsSpan(src_buffer, source->bpr, (UWORD *)dst_line, (last - first) + 1, u_row, v_row, map->du_x, map->dv_x, (UWORD)source->transparency, transparent);
+      } else {
+        SAGE_Rotate32BitsSpan(src_buffer, source->bpr, (ULONG *)dst_line, (last - first) + 1, u_row, v_row, map->du_x, map->dv_x, source->transparency, transparent);
+      }
+    }
+  }
+}
+
+/**
+ * Get the rotated frame of a sprite from the cache, a missing frame is drawn
+ * in place of the least recently used one
+ */
+SAGE_RotatedFrame *SAGE_GetRotatedFrame(SAGE_SpriteBank *bank, SAGE_Sprite *spr)
+{
+  SAGE_RotatedFrame *frame, *oldest;
+  SAGE_RotationMap map;
+  SAGE_Bitmap *bitmap;
+  ULONG pixel, nb_pixels;
+  WORD angle;
+  UWORD idx;
+
+  if (spr->rotated_frames == NULL) {
+    if ((spr->rotated_frames = (SAGE_RotatedFrame *)SAGE_AllocMem(sizeof(SAGE_RotatedFrame) * bank->rotation_frames)) == NULL) {
+      SAGE_SetError(SERR_NO_MEMORY);
+      return NULL;
+    }
+  }
+  angle = (WORD)(spr->rotation_angle * SMTH_PRECISION);
+  bank->rotation_clock++;
+  oldest = &(spr->rotated_frames[0]);
+  for (idx = 0;idx < bank->rotation_frames;idx++) {
+    frame = &(spr->rotated_frames[idx]);
+    if (frame->bitmap != NULL && frame->angle == angle
+        && frame->horizontal_zoom == spr->horizontal_zoom && frame->vertical_zoom == spr->vertical_zoom
+        && frame->horizontal_flip == spr->horizontal_flip && frame->vertical_flip == spr->vertical_flip) {
+      frame->last_use = bank->rotation_clock;
+      return frame;
+    }
+    if (frame->last_use < oldest->last_use) {
+      oldest = frame;
+    }
+  }
+  frame = oldest;
+  if (frame->bitmap != NULL) {
+    SAGE_ReleaseBitmap(frame->bitmap);
+    frame->bitmap = NULL;
+  }
+  // Map the sprite in a box starting at 0,0
+  SAGE_SetupRotationMap(spr, 0, 0, &map);
+  frame->x_offset = map.left;
+  frame->y_offset = map.top;
+  frame->width = (map.right - map.left) + 1;
+  frame->height = (map.bottom - map.top) + 1;
+  map.right -= map.left;
+  map.bottom -= map.top;
+  map.left = 0;
+  map.top = 0;
+  // Bitmap width is rounded for the size constraint of all depths
+  if ((bitmap = SAGE_AllocBitmap((frame->width + 7) & ~7, frame->height, bank->bitmap->depth, 0, bank->bitmap->pixformat, NULL)) == NULL) {
+    return NULL;
+  }
+  SAGE_SetBitmapTransparency(bitmap, bank->bitmap->transparency);
+  nb_pixels = bitmap->width * bitmap->height;
+  if (bitmap->depth == SBMP_DEPTH8) {
+    memset(bitmap->bitmap_buffer, (UBYTE)bitmap->transparency, nb_pixels);
+  } else if (bitmap->depth == SBMP_DEPTH16) {
+    for (pixel = 0;pixel < nb_pixels;pixel++) {
+      ((UWORD *)bitmap->bitmap_buffer)[pixel] = (UWORD)bitmap->transparency;
+    }
+  } else {
+    for (pixel = 0;pixel < nb_pixels;pixel++) {
+      ((ULONG *)bitmap->bitmap_buffer)[pixel] = bitmap->transparency;
+    }
+  }
+  SAGE_DrawRotatedSprite(bank->bitmap, spr, &map, bitmap, 0, 0, frame->width - 1, frame->height - 1);
+  frame->bitmap = bitmap;
+  frame->angle = angle;
+  frame->horizontal_zoom = spr->horizontal_zoom;
+  frame->vertical_zoom = spr->vertical_zoom;
+  frame->horizontal_flip = spr->horizontal_flip;
+  frame->vertical_flip = spr->vertical_flip;
+  frame->last_use = bank->rotation_clock;
+  return frame;
+}
+
+/**
+ * Draw a rotated sprite on the screen, from the cache when the bank has one
+ */
+BOOL SAGE_BlitRotatedSprite(SAGE_SpriteBank *bank, SAGE_Sprite *spr, LONG x_pos, LONG y_pos, SAGE_Screen *screen)
+{
+  SAGE_RotatedFrame *frame;
+  SAGE_RotationMap map;
+  LONG left, top, right, bottom, frame_left, frame_top;
+
+  if (bank->bitmap->depth != screen->back_bitmap->depth) {
+    SAGE_SetError(SERR_BM_BLITFMT);
+    return FALSE;
+  }
+  if (bank->bitmap->depth == SBMP_DEPTH24) {
+    SAGE_SetError(SERR_UNKNOWN_DEPTH);
+    return FALSE;
+  }
+  if (bank->rotation_frames > 0 && (bank->bitmap->properties & SBMP_TRANSPARENT)) {
+    if ((frame = SAGE_GetRotatedFrame(bank, spr)) == NULL) {
+      return FALSE;
+    }
+    frame_left = x_pos + frame->x_offset;
+    frame_top = y_pos + frame->y_offset;
+    left = (frame_left > screen->clipping.left) ? frame_left : screen->clipping.left;
+    top = (frame_top > screen->clipping.top) ? frame_top : screen->clipping.top;
+    right = ((frame_left + frame->width - 1) < screen->clipping.right) ? (frame_left + frame->width - 1) : screen->clipping.right;
+    bottom = ((frame_top + frame->height - 1) < screen->clipping.bottom) ? (frame_top + frame->height - 1) : screen->clipping.bottom;
+    if (left > right || top > bottom) {
+      return TRUE;
+    }
+    SAGE_AddDirtyRect(left, top, (right - left) + 1, (bottom - top) + 1);
+    return SAGE_BlitBitmap(frame->bitmap, left - frame_left, top - frame_top, (right - left) + 1, (bottom - top) + 1, screen->back_bitmap, left, top);
+  }
+  SAGE_SetupRotationMap(spr, x_pos, y_pos, &map);
+  left = (map.left > screen->clipping.left) ? map.left : screen->clipping.left;
+  top = (map.top > screen->clipping.top) ? map.top : screen->clipping.top;
+  right = (map.right < screen->clipping.right) ? map.right : screen->clipping.right;
+  bottom = (map.bottom < screen->clipping.bottom) ? map.bottom : screen->clipping.bottom;
+  if (left > right || top > bottom) {
+    return TRUE;
+  }
+  SAGE_AddDirtyRect(left, top, (right - left) + 1, (bottom - top) + 1);
+  SAGE_DrawRotatedSprite(bank->bitmap, spr, &map, screen->back_bitmap, left, top, right, bottom);
+  return TRUE;
+}
+
 /**
  * Draw the sprite on the screen at a given position inside the clipping zone
  * 
@@ -451,6 +1262,10 @@ BOOL SAGE_BlitSpriteToScreen(UWORD index, UWORD sprite, LONG x_pos, LONG y_pos)
     return FALSE;
   })
   if (bank->bank_size > sprite) {
+    // Rotated sprites turn around their hotspot
+    if (bank->sprites[sprite].flags & SSPR_ROTATED) {
+      return SAGE_BlitRotatedSprite(bank, &(bank->sprites[sprite]), x_pos, y_pos, screen);
+    }
     // Set the real position regarding the sprite hotspot
     x_pos -= bank->sprites[sprite].hs_x;
     y_pos -= bank->sprites[sprite].hs_y;
@@ -486,9 +1301,15 @@ BOOL SAGE_BlitSpriteToScreen(UWORD index, UWORD sprite, LONG x_pos, LONG y_pos)
       if ((y_pos + height) > screen->clipping.bottom) {
         height = (screen->clipping.bottom - y_pos) + 1;
       }
+      SAGE_AddDirtyRect(x_pos, y_pos, width, height);
+      if (bank->sprites[sprite].spans != NULL && bank->bitmap->depth == screen->back_bitmap->depth) {
+        SAGE_BlitSpriteSpans(&(bank->sprites[sprite]), left - (LONG)bank->sprites[sprite].left, top - (LONG)bank->sprites[sprite].top, width, height, screen->back_bitmap, x_pos, y_pos);
+        return TRUE;
+      }
       return SAGE_BlitBitmap(bank->bitmap, left, top, width, height, screen->back_bitmap, x_pos, y_pos);
     } else if ((bank->sprites[sprite].flags & SSPR_HFLIPPED) | (bank->sprites[sprite].flags & SSPR_VFLIPPED)) {
-      // Sprite is flipped
+      // Sprite is flipped, the rotation map without angle mirrors it
+      return SAGE_BlitRotatedSprite(bank, &(bank->sprites[sprite]), x_pos + bank->sprites[sprite].hs_x, y_pos + bank->sprites[sprite].hs_y, screen);
     } else if ((bank->sprites[sprite].flags & SSPR_ZOOMED)) {
       // Sprite is zoomed
       rwidth = (LONG) bank->sprites[sprite].real_width;
@@ -517,9 +1338,258 @@ BOOL SAGE_BlitSpriteToScreen(UWORD index, UWORD sprite, LONG x_pos, LONG y_pos)
         rheight = (FLOAT)((screen->clipping.bottom - y_pos) + 1) * vzoom;
         height = (screen->clipping.bottom - y_pos) + 1;
       }
+      SAGE_AddDirtyRect(x_pos, y_pos, width, height);
       return SAGE_BlitZoomedBitmap(bank->bitmap, left, top, rwidth, rheight, screen->back_bitmap, x_pos, y_pos, width, height);
     }
   }
   SAGE_SetError(SERR_SPRITE_INDEX);
   return FALSE;
 }
+
+/**
+ * Create the sprite batch, the sprites queued in the batch are drawn in one
+ * pass by SAGE_FlushSpriteBatch
+ * 
+ * @param size Maximum number of sprites in the batch
+ *
+ * @return Operation success
+ */
+BOOL SAGE_CreateSpriteBatch(UWORD size)
+{
+  SAGE_SpriteBatch *batch;
+
+  SD(SAGE_DebugLog("Create sprite batch (%d)", size);)
+  // Check for video device
+  if (SageContext.SageVideo == NULL) {
+    SAGE_SetError(SERR_NO_VIDEODEVICE);
+    return FALSE;
+  }
+  if (SageContext.SageVideo->sprite_batch != NULL) {
+    SAGE_ReleaseSpriteBatch();
+  }
+  batch = (SAGE_SpriteBatch *)SAGE_AllocMem(sizeof(SAGE_SpriteBatch));
+  if (batch != NULL) {
+    batch->size = size;
+    batch->count = 0;
+    batch->sprites = (SAGE_BatchedSprite *)SAGE_AllocMem(sizeof(SAGE_BatchedSprite) * size);
+    if (batch->sprites != NULL) {
+      batch->keys = (ULONG *)SAGE_AllocMem(sizeof(ULONG) * size * 2);
+      if (batch->keys != NULL) {
+        batch->sorted = batch->keys + size;
+        SageContext.SageVideo->sprite_batch = batch;
+        return TRUE;
+      }
+      SAGE_FreeMem(batch->sprites);
+    }
+    SAGE_FreeMem(batch);
+  }
+  SAGE_SetError(SERR_NO_MEMORY);
+  return FALSE;
+}
+
+/**
+ * Release the sprite batch
+ *
+ * @return Operation success
+ */
+BOOL SAGE_ReleaseSpriteBatch(VOID)
+{
+  SAGE_SpriteBatch *batch;
+
+  SD(SAGE_DebugLog("Release sprite batch");)
+  SAFE(if (SageContext.SageVideo == NULL) {
+    SAGE_SetError(SERR_NO_VIDEODEVICE);
+    return FALSE;
+  })
+  batch = SageContext.SageVideo->sprite_batch;
+  if (batch != NULL) {
+    SAGE_FreeMem(batch->keys);
+    SAGE_FreeMem(batch->sprites);
+    SAGE_FreeMem(batch);
+    SageContext.SageVideo->sprite_batch = NULL;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+ * Queue a sprite in the batch, nothing is drawn until the batch is flushed
+ * 
+ * @param index    Sprite bank index
+ * @param sprite   Sprite index
+ * @param x_pos    Horizontal position (can be negative)
+ * @param y_pos    Vertical position (can be negative)
+ * @param priority Drawing priority, lowest priorities are drawn first
+ *
+ * @return Operation success
+ */
+BOOL SAGE_AddSpriteToBatch(UWORD index, UWORD sprite, LONG x_pos, LONG y_pos, UBYTE priority)
+{
+  SAGE_SpriteBatch *batch;
+  SAGE_BatchedSprite *entry;
+
+  SAFE(if (SageContext.SageVideo == NULL) {
+    SAGE_SetError(SERR_NO_VIDEODEVICE);
+    return FALSE;
+  })
+  batch = SageContext.SageVideo->sprite_batch;
+  SAFE(if (batch == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if (batch->count >= batch->size) {
+    SAGE_SetError(SERR_SPRBATCH_FULL);
+    return FALSE;
+  }
+  entry = &(batch->sprites[batch->count++]);
+  entry->index = index;
+  entry->sprite = sprite;
+  entry->x_pos = x_pos;
+  entry->y_pos = y_pos;
+  entry->priority = priority;
+  return TRUE;
+}
+
+/**
+ * Stable counting sort of the batch keys on one byte
+ */
+VOID SAGE_SortBatchKeys(ULONG *keys, ULONG *sorted, UWORD count, UWORD shift)
+{
+  UWORD offsets[SSPR_BATCHBUCKETS], bucket, total, size, idx;
+
+  for (bucket = 0;bucket < SSPR_BATCHBUCKETS;bucket++) {
+    offsets[bucket] = 0;
+  }
+  for (idx = 0;idx < count;idx++) {
+    offsets[(keys[idx] >> shift) & 0xFF]++;
+  }
+  total = 0;
+  for (bucket = 0;bucket < SSPR_BATCHBUCKETS;bucket++) {
+    size = offsets[bucket];
+    offsets[bucket] = total;
+    total += size;
+  }
+  for (idx = 0;idx < count;idx++) {
+    sorted[offsets[(keys[idx] >> shift) & 0xFF]++] = keys[idx];
+  }
+}
+
+/**
+ * Draw all the queued sprites and empty the batch
+ * 
+ * The sprites outside of the clipping zone are removed first, the others are
+ * sorted by priority then by bank (the queue order is kept for a same
+ * priority and bank) and the standard sprites are copied back to back with
+ * their transparent spans or the blit function of the screen depth, a sprite
+ * that can't be drawn doesn't stop the next ones
+ *
+ * @return Operation success (FALSE if a sprite was not drawn)
+ */
+BOOL SAGE_FlushSpriteBatch(VOID)
+{
+  SAGE_BitmapBlitter blitter;
+  SAGE_BatchedSprite *entry;
+  SAGE_SpriteBatch *batch;
+  SAGE_SpriteBank *bank = NULL;
+  SAGE_Sprite *sprite;
+  SAGE_Screen *screen;
+  LONG left, top, width, height, x_pos, y_pos;
+  UWORD idx, visible, last_index;
+  BOOL success = TRUE;
+
+  screen = SAGE_GetScreen();
+  SAFE(if (screen == NULL || SageContext.SageVideo == NULL) {
+    SAGE_SetError(SERR_NO_SCREEN);
+    return FALSE;
+  })
+  batch = SageContext.SageVideo->sprite_batch;
+  SAFE(if (batch == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if ((blitter = SAGE_GetBitmapBlitter(screen->back_bitmap->depth)) == NULL) {
+    batch->count = 0;
+    return FALSE;
+  }
+  // Remove the sprites outside of the clipping zone and build the sort keys
+  visible = 0;
+  last_index = SSPR_MAX_SPRBANK;
+  for (idx = 0;idx < batch->count;idx++) {
+    entry = &(batch->sprites[idx]);
+    if (entry->index != last_index) {
+      bank = SAGE_GetSpriteBank(entry->index);
+      if (bank == NULL || bank->sprites == NULL || bank->bitmap == NULL) {
+        batch->count = 0;
+        SAGE_SetError(SERR_NULL_POINTER);
+        return FALSE;
+      }
+      if (bank->bitmap->depth != screen->back_bitmap->depth) {
+        batch->count = 0;
+        SAGE_SetError(SERR_BM_BLITFMT);
+        return FALSE;
+      }
+      last_index = entry->index;
+    }
+    if (entry->sprite >= bank->bank_size) {
+      batch->count = 0;
+      SAGE_SetError(SERR_SPRITE_INDEX);
+      return FALSE;
+    }
+    sprite = &(bank->sprites[entry->sprite]);
+    x_pos = entry->x_pos - sprite->hs_x;
+    y_pos = entry->y_pos - sprite->hs_y;
+    // Rotated sprites are clipped by SAGE_BlitSpriteToScreen
+    if ((sprite->flags & SSPR_ROTATED)
+        || (x_pos <= screen->clipping.right && (x_pos + (LONG)sprite->width) > screen->clipping.left
+        && y_pos <= screen->clipping.bottom && (y_pos + (LONG)sprite->height) > screen->clipping.top)) {
+      batch->keys[visible++] = ((ULONG)entry->priority << 24) | ((ULONG)entry->index << 16) | (ULONG)idx;
+    }
+  }
+  batch->count = 0;
+  // Sort by bank then by priority, the key low word keeps the queue order
+  SAGE_SortBatchKeys(batch->keys, batch->sorted, visible, 16);
+  SAGE_SortBatchKeys(batch->sorted, batch->keys, visible, 24);
+  last_index = SSPR_MAX_SPRBANK;
+  for (idx = 0;idx < visible;idx++) {
+    entry = &(batch->sprites[batch->keys[idx] & 0xFFFF]);
+    if (entry->index != last_index) {
+      bank = SageContext.SageVideo->sprites[entry->index];
+      last_index = entry->index;
+    }
+    sprite = &(bank->sprites[entry->sprite]);
+    if ((sprite->flags & SSPR_STANDARD) && !(sprite->flags & SSPR_ROTATED)) {
+      left = (LONG) sprite->left;
+      top = (LONG) sprite->top;
+      width = (LONG) sprite->width;
+      height = (LONG) sprite->height;
+      x_pos = entry->x_pos - sprite->hs_x;
+      y_pos = entry->y_pos - sprite->hs_y;
+      if (x_pos < screen->clipping.left) {
+        left += screen->clipping.left - x_pos;
+        width -= screen->clipping.left - x_pos;
+        x_pos = screen->clipping.left;
+      }
+      if (y_pos < screen->clipping.top) {
+        top += screen->clipping.top - y_pos;
+        height -= screen->clipping.top - y_pos;
+        y_pos = screen->clipping.top;
+      }
+      if ((x_pos + width) > screen->clipping.right) {
+        width = (screen->clipping.right - x_pos) + 1;
+      }
+      if ((y_pos + height) > screen->clipping.bottom) {
+        height = (screen->clipping.bottom - y_pos) + 1;
+      }
+      SAGE_AddDirtyRect(x_pos, y_pos, width, height);
+      if (sprite->spans != NULL) {
+        SAGE_BlitSpriteSpans(sprite, left - (LONG)sprite->left, top - (LONG)sprite->top, width, height, screen->back_bitmap, x_pos, y_pos);
+      } else {
+        (*blitter)(bank->bitmap, left, top, width, height, screen->back_bitmap, x_pos, y_pos);
+      }
+    } else if (!SAGE_BlitSpriteToScreen(entry->index, entry->sprite, entry->x_pos, entry->y_pos)) {
+      // Keep drawing the next sprites
+      success = FALSE;
+    }
+  }
+  return success;
+}
@@ -5,7 +5,7 @@
  * Thread management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 /**
@@ -100,19 +100,19 @@ SAGE_Thread *SAGE_CreateThread(LONG (*user_func)(APTR), APTR user_data)
   SAGE_Thread *thread;
   BYTE thread_address[20];
   
-  thread = (SAGE_Thread *)SAGE_AllocMem(sizeof(SAGE_Thread));
+  thread = (SAGE_Thread *)SAGE_PoolAlloc(sizeof(SAGE_Thread));
   if (thread != NULL) {
     // Add the thread to the thread pool
     if (!SAGE_AddThread(thread)) {
       SAGE_SetError(SERR_NO_THREAD);
-      SAGE_FreeMem(thread);
+      SAGE_PoolFree(thread);
       return NULL;
     }
     thread->running = FALSE;
     thread->parent = FindTask(NULL);
     if (thread->parent == NULL) {
       SAGE_SetError(SERR_FINDTASK);
-      SAGE_FreeMem(thread);
+      SAGE_PoolFree(thread);
       return NULL;
     }
     thread->user_func = user_func;
@@ -199,7 +199,7 @@ BOOL SAGE_RemoveThread(SAGE_Thread *thread)
     return FALSE;
   }
   SageContext.Threads[thread->ident] = NULL;
-  SAGE_FreeMem(thread);
+  SAGE_PoolFree(thread);
   return TRUE;
 }
 
@@ -5,7 +5,7 @@
  * Tile management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <proto/dos.h>
@@ -325,6 +325,98 @@ APTR SAGE_GetTileUserData(UWORD index, UWORD tile)
   return NULL;
 }
 
+/**
+ * Add a tile animation, the tiles from first to first + frames - 1 cycle
+ * through the same frames so a map cell only has to hold one of them
+ *
+ * @param index  Tile bank index
+ * @param first  First tile of the cycle
+ * @param frames Number of tiles of the cycle
+ * @param delay  Number of SAGE_AnimateTiles calls between two frames
+ *
+ * @return Operation success
+ */
+BOOL SAGE_AddTileAnimation(UWORD index, UWORD first, UWORD frames, UWORD delay)
+{
+  SAGE_TileBank *bank;
+  SAGE_TileAnimation *animation;
+  UWORD tile;
+
+  bank = SAGE_GetTileBank(index);
+  SAFE(if (bank == NULL || bank->tiles == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  if (frames == 0 || ((ULONG)first + frames) > bank->bank_size) {
+    SAGE_SetError(SERR_TILE_INDEX);
+    return FALSE;
+  }
+  if (bank->nb_animations >= STIL_MAX_TILEANIM) {
+    SAGE_SetError(SERR_TILEANIM_FULL);
+    return FALSE;
+  }
+  animation = &(bank->animations[bank->nb_animations++]);
+  animation->first = first;
+  animation->frames = frames;
+  animation->delay = delay;
+  animation->counter = 0;
+  animation->frame = 0;
+  for (tile = first;tile < (first + frames);tile++) {
+    bank->tiles[tile].animation = bank->nb_animations;
+    bank->tiles[tile].display = tile;
+  }
+  return TRUE;
+}
+
+/**
+ * Animate the tiles of a bank, should be called once per frame. Only the
+ * display tile of the animated tiles is updated, the maps are unchanged.
+ *
+ * @param index Tile bank index
+ *
+ * @return Operation success
+ */
+BOOL SAGE_AnimateTiles(UWORD index)
+{
+  SAGE_TileBank *bank;
+  SAGE_TileAnimation *animation;
+  UWORD anim, tile;
+
+  bank = SAGE_GetTileBank(index);
+  SAFE(if (bank == NULL || bank->tiles == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  for (anim = 0;anim < bank->nb_animations;anim++) {
+    animation = &(bank->animations[anim]);
+    if (++animation->counter > animation->delay) {
+      animation->counter = 0;
+      animation->frame = (animation->frame + 1) % animation->frames;
+      for (tile = 0;tile < animation->frames;tile++) {
+        bank->tiles[animation->first + tile].display = animation->first + ((tile + animation->frame) % animation->frames);
+      }
+      bank->anim_step++;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Get the tile to draw for a tile, the current frame for an animated tile
+ *
+ * @param bank Tile bank
+ * @param tile Tile id
+ *
+ * @return Tile to draw
+ */
+UWORD SAGE_GetTileDisplay(SAGE_TileBank *bank, UWORD tile)
+{
+  if (bank->tiles[tile].animation != STIL_NOANIM) {
+    return bank->tiles[tile].display;
+  }
+  return tile;
+}
+
 /**
  * Blit a tile to a layer
  *
@@ -348,8 +440,10 @@ BOOL SAGE_BlitTileToLayer(UWORD index, UWORD tile, UWORD l_idx, ULONG x_pos, ULO
     return NULL;
   })
   if (bank->bank_size > tile) {
+    tile = SAGE_GetTileDisplay(bank, tile);
     x_pos %= layer->bitmap->width;
     y_pos %= layer->bitmap->height;
+    SAGE_LayerChanged();
     return SAGE_BlitBitmap(
       bank->bitmap,
       bank->tiles[tile].left,
@@ -387,7 +481,9 @@ BOOL SAGE_BlitTileToScreen(UWORD index, UWORD tile, ULONG x_pos, ULONG y_pos)
     return FALSE;
   })
   if (bank->bank_size > tile) {
+    tile = SAGE_GetTileDisplay(bank, tile);
     if (x_pos <= (screen->back_bitmap->width - bank->tile_width) && y_pos <= (screen->back_bitmap->height - bank->tile_height)) {
+      SAGE_AddDirtyRect(x_pos, y_pos, bank->tile_width, bank->tile_height);
       return SAGE_BlitBitmap(
         bank->bitmap,
         bank->tiles[tile].left,
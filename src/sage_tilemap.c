@@ -5,9 +5,11 @@
  * Tilemap management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
+#include <string.h>
+
 #include <proto/dos.h>
 
 #include <sage/sage_debug.h>
@@ -15,6 +17,8 @@
 #include <sage/sage_logger.h>
 #include <sage/sage_memory.h>
 #include <sage/sage_context.h>
+#include <sage/sage_bitmap.h>
+#include <sage/sage_layer.h>
 #include <sage/sage_tile.h>
 #include <sage/sage_tilemap.h>
 
@@ -34,6 +38,7 @@ extern SAGE_Context SageContext;
 BOOL SAGE_CreateTileMap(UWORD index, UWORD cols, UWORD rows, UBYTE bpt)
 {
   SAGE_TileMap *tilemap;
+  UWORD tag;
 
   SD(SAGE_DebugLog("Create tilemap #%d %dx%d (%d)", index, cols, rows, bpt);)
   // Check for video device
@@ -49,12 +54,16 @@ BOOL SAGE_CreateTileMap(UWORD index, UWORD cols, UWORD rows, UBYTE bpt)
     SAGE_ReleaseLayer(index);
   }
   // Allocate and init tilemap
+  tag = SAGE_SetMemoryTag(SMEM_TAG_TILEMAP);
   tilemap = (SAGE_TileMap *)SAGE_AllocMem(sizeof(SAGE_TileMap));
+  if (tilemap != NULL) {
+    tilemap->map = SAGE_AllocMem(cols * rows * bpt);
+  }
+  SAGE_SetMemoryTag(tag);
   if (tilemap != NULL) {
     tilemap->cols = cols;
     tilemap->rows = rows;
     tilemap->bytespertile = bpt;
-    tilemap->map = SAGE_AllocMem(cols * rows * bpt);
     if (tilemap->map != NULL) {
       SageContext.SageVideo->tilemaps[index] = tilemap;
       return TRUE;
@@ -111,7 +120,53 @@ BOOL SAGE_ReleaseTileMap(UWORD index)
 }
 
 /**
- * Load a tile map file
+ * Unpack the RLE tiles of a tilemap file, each packet starts with a control
+ * byte : a run of (control & 0x7F) + 2 copies of the next tile or
+ * control + 1 literal tiles
+ */
+BOOL SAGE_UnpackTileMap(SAGE_TileMap *tilemap, UBYTE *packed, LONG packed_size)
+{
+  UBYTE *map, *end, control;
+  ULONG map_size, done, count, idx, bpt;
+
+  map = (UBYTE *)tilemap->map;
+  bpt = tilemap->bytespertile;
+  map_size = (ULONG)tilemap->cols * tilemap->rows * bpt;
+  end = packed + packed_size;
+  done = 0;
+  while (done < map_size && packed < end) {
+    control = *packed++;
+    if (control & STIL_RLERUN) {
+      count = ((control & ~STIL_RLERUN) + 2) * bpt;
+      if ((packed + bpt) > end || (done + count) > map_size) {
+        return FALSE;
+      }
+      if (bpt == STIL_MAPBPT_BYTE) {
+        memset(map + done, *packed, count);
+      } else {
+        for (idx = 0;idx < count;idx += bpt) {
+          map[done + idx] = packed[0];
+          map[done + idx + 1] = packed[1];
+        }
+      }
+      packed += bpt;
+    } else {
+      count = (control + 1) * bpt;
+      if ((packed + count) > end || (done + count) > map_size) {
+        return FALSE;
+      }
+      memcpy(map + done, packed, count);
+      packed += count;
+    }
+    done += count;
+  }
+  return (BOOL)(done == map_size);
+}
+
+/**
+ * Load a tile map file, a raw array of tiles or a RLE packed file starting
+ * with a SAGE_TileMapHeader (see tools/map2stm.c), a packed file of another
+ * size or version is rejected
  *
  * @param index   Tilemap index
  * @param mapfile Map file name
@@ -121,8 +176,11 @@ BOOL SAGE_ReleaseTileMap(UWORD index)
 BOOL SAGE_LoadTileMap(UWORD index, STRPTR mapfile)
 {
   SAGE_TileMap *tilemap;
+  SAGE_TileMapHeader header;
   BPTR file_handle;
   LONG bytes_read, file_size, map_size;
+  UBYTE *packed;
+  BOOL success;
 
   tilemap = SAGE_GetTileMap(index);
   SAFE(if (tilemap == NULL) {
@@ -134,6 +192,27 @@ BOOL SAGE_LoadTileMap(UWORD index, STRPTR mapfile)
   if (file_handle != 0) {
     bytes_read = Seek(file_handle, 0, OFFSET_END);
     file_size = Seek(file_handle, 0, OFFSET_BEGINNING);
+    // Packed file, read all the packets at once and unpack them
+    if (file_size > STIL_RLEHEADER && Read(file_handle, &header, STIL_RLEHEADER) == STIL_RLEHEADER && header.tag == STIL_RLETAG) {
+      success = FALSE;
+      // An unknown version may not use the same packets
+      if (header.version == STIL_RLEVERSION && header.cols == tilemap->cols && header.rows == tilemap->rows
+          && header.bytespertile == tilemap->bytespertile) {
+        file_size -= STIL_RLEHEADER;
+        if ((packed = (UBYTE *)SAGE_AllocMem(file_size)) != NULL) {
+          if (Read(file_handle, packed, file_size) == file_size) {
+            success = SAGE_UnpackTileMap(tilemap, packed, file_size);
+          }
+          SAGE_FreeMem(packed);
+        }
+      }
+      Close(file_handle);
+      if (!success) {
+        SAGE_SetError(SERR_FILEFORMAT);
+      }
+      return success;
+    }
+    Seek(file_handle, 0, OFFSET_BEGINNING);
     // Be sure that map file fits into our map buffer
     if (file_size > map_size) {
       file_size = map_size;
@@ -187,6 +266,238 @@ UWORD *SAGE_GetTileMapW(UWORD index)
   return (UWORD *)tilemap->map;
 }
 
+/**
+ * Link a tilemap to a tile bank and a layer used as a scrolling ring buffer,
+ * the layer should hold at least one more tile than the view in each
+ * direction and its size should be a multiple of the tile size
+ *
+ * @param index  Tilemap index
+ * @param bank   Tile bank index
+ * @param layer  Layer index
+ * @param width  View width
+ * @param height View height
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_SetTileMapScroll(UWORD index, UWORD bank, UWORD layer, ULONG width, ULONG height)
+{
+  SAGE_TileMap *tilemap;
+  SAGE_TileBank *tilebank;
+  SAGE_Layer *tilelayer;
+  SAGE_TileMapScroll *scroll;
+
+  SD(SAGE_DebugLog("Set tilemap #%d scroll with tilebank #%d and layer #%d (%dx%d)", index, bank, layer, width, height);)
+  tilemap = SAGE_GetTileMap(index);
+  tilebank = SAGE_GetTileBank(bank);
+  tilelayer = SAGE_GetLayer(layer);
+  SAFE(if (tilemap == NULL || tilebank == NULL || tilelayer == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  scroll = &(tilemap->scroll);
+  scroll->active = FALSE;
+  // A view not aligned on the tiles shows one more column and row
+  scroll->view_cols = ((width + tilebank->tile_width - 1) / tilebank->tile_width) + 1;
+  scroll->view_rows = ((height + tilebank->tile_height - 1) / tilebank->tile_height) + 1;
+  scroll->layer_cols = tilelayer->bitmap->width / tilebank->tile_width;
+  scroll->layer_rows = tilelayer->bitmap->height / tilebank->tile_height;
+  if ((tilelayer->bitmap->width % tilebank->tile_width) != 0 || (tilelayer->bitmap->height % tilebank->tile_height) != 0
+      || scroll->layer_cols < scroll->view_cols || scroll->layer_rows < scroll->view_rows) {
+    SAGE_SetError(SERR_LAYER_SIZE);
+    return FALSE;
+  }
+  scroll->bank = bank;
+  scroll->layer = layer;
+  scroll->view_width = width;
+  scroll->view_height = height;
+  scroll->camera_x = 0;
+  scroll->camera_y = 0;
+  scroll->first_col = 0;
+  scroll->first_row = 0;
+  scroll->redraw = TRUE;
+  scroll->active = TRUE;
+  return TRUE;
+}
+
+/**
+ * Draw a block of map tiles at their place in the layer ring buffer, the
+ * tiles outside of the map or of the bank are skipped
+ */
+VOID SAGE_DrawTileMapArea(SAGE_TileMap *tilemap, SAGE_TileBank *bank, SAGE_Layer *layer, LONG left, LONG top, LONG right, LONG bottom)
+{
+  SAGE_TileMapScroll *scroll;
+  UBYTE *map_byte = NULL;
+  UWORD *map_word = NULL, tile;
+  LONG col, row, layer_row;
+  ULONG x_pos, y_pos;
+
+  scroll = &(tilemap->scroll);
+  if (left < 0) {
+    left = 0;
+  }
+  if (top < 0) {
+    top = 0;
+  }
+  if (right > tilemap->cols) {
+    right = tilemap->cols;
+  }
+  if (bottom > tilemap->rows) {
+    bottom = tilemap->rows;
+  }
+  for (row = top;row < bottom;row++) {
+    if (tilemap->bytespertile == STIL_MAPBPT_WORD) {
+      map_word = (UWORD *)tilemap->map + (row * tilemap->cols);
+    } else {
+      map_byte = (UBYTE *)tilemap->map + (row * tilemap->cols);
+    }
+    layer_row = row % scroll->layer_rows;
+    y_pos = layer_row * bank->tile_height;
+    for (col = left;col < right;col++) {
+      tile = (map_word != NULL) ? map_word[col] : (UWORD)map_byte[col];
+      if (tile < bank->bank_size) {
+        tile = SAGE_GetTileDisplay(bank, tile);
+        x_pos = (col % scroll->layer_cols) * bank->tile_width;
+        SAGE_BlitBitmap(
+          bank->bitmap,
+          bank->tiles[tile].left,
+          bank->tiles[tile].top,
+          bank->tile_width,
+          bank->tile_height,
+          layer->bitmap,
+          x_pos,
+          y_pos
+        );
+      }
+    }
+  }
+}
+
+/**
+ * Draw again the animated tiles of the view
+ */
+VOID SAGE_DrawTileMapAnims(SAGE_TileMap *tilemap, SAGE_TileBank *bank, SAGE_Layer *layer)
+{
+  SAGE_TileMapScroll *scroll;
+  UWORD tile;
+  LONG col, row, right, bottom;
+
+  scroll = &(tilemap->scroll);
+  right = scroll->first_col + scroll->view_cols;
+  right = (right > tilemap->cols) ? tilemap->cols : right;
+  bottom = scroll->first_row + scroll->view_rows;
+  bottom = (bottom > tilemap->rows) ? tilemap->rows : bottom;
+  for (row = scroll->first_row;row < bottom;row++) {
+    for (col = scroll->first_col;col < right;col++) {
+      if (tilemap->bytespertile == STIL_MAPBPT_WORD) {
+        tile = ((UWORD *)tilemap->map)[(row * tilemap->cols) + col];
+      } else {
+        tile = ((UBYTE *)tilemap->map)[(row * tilemap->cols) + col];
+      }
+      if (tile < bank->bank_size && bank->tiles[tile].animation != STIL_NOANIM) {
+        SAGE_DrawTileMapArea(tilemap, bank, layer, col, row, col + 1, row + 1);
+      }
+    }
+  }
+}
+
+/**
+ * Move the tilemap camera, only the tile columns and rows coming into the
+ * view are drawn in the layer (and the animated tiles when their frame has
+ * changed) then the layer view is set on the camera with the sub tile offset,
+ * the camera is kept inside the map
+ *
+ * @param index Tilemap index
+ * @param x_pos Camera horizontal position in the map
+ * @param y_pos Camera vertical position in the map
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_ScrollTileMap(UWORD index, LONG x_pos, LONG y_pos)
+{
+  SAGE_TileMap *tilemap;
+  SAGE_TileMapScroll *scroll;
+  SAGE_TileBank *bank;
+  SAGE_Layer *layer;
+  LONG max_x, max_y, first_col, first_row, left, right;
+
+  tilemap = SAGE_GetTileMap(index);
+  SAFE(if (tilemap == NULL || !tilemap->scroll.active) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  scroll = &(tilemap->scroll);
+  bank = SAGE_GetTileBank(scroll->bank);
+  layer = SAGE_GetLayer(scroll->layer);
+  if (bank == NULL || layer == NULL) {
+    return FALSE;
+  }
+  // Keep the camera inside the map
+  max_x = ((LONG)tilemap->cols * bank->tile_width) - (LONG)scroll->view_width;
+  max_y = ((LONG)tilemap->rows * bank->tile_height) - (LONG)scroll->view_height;
+  x_pos = (x_pos > max_x) ? max_x : x_pos;
+  y_pos = (y_pos > max_y) ? max_y : y_pos;
+  x_pos = (x_pos < 0) ? 0 : x_pos;
+  y_pos = (y_pos < 0) ? 0 : y_pos;
+  first_col = x_pos / bank->tile_width;
+  first_row = y_pos / bank->tile_height;
+  if (scroll->redraw || (first_col - scroll->first_col) >= scroll->view_cols || (scroll->first_col - first_col) >= scroll->view_cols
+      || (first_row - scroll->first_row) >= scroll->view_rows || (scroll->first_row - first_row) >= scroll->view_rows) {
+    SAGE_DrawTileMapArea(tilemap, bank, layer, first_col, first_row, first_col + scroll->view_cols, first_row + scroll->view_rows);
+    SAGE_LayerChanged();
+    scroll->redraw = FALSE;
+    scroll->anim_step = bank->anim_step;
+  } else if (first_col != scroll->first_col || first_row != scroll->first_row) {
+    // New columns on the whole view height
+    if (first_col > scroll->first_col) {
+      SAGE_DrawTileMapArea(tilemap, bank, layer, scroll->first_col + scroll->view_cols, first_row, first_col + scroll->view_cols, first_row + scroll->view_rows);
+    } else if (first_col < scroll->first_col) {
+      SAGE_DrawTileMapArea(tilemap, bank, layer, first_col, first_row, scroll->first_col, first_row + scroll->view_rows);
+    }
+    // New rows only on the columns that were already in view
+    left = (first_col > scroll->first_col) ? first_col : scroll->first_col;
+    right = ((first_col < scroll->first_col) ? first_col : scroll->first_col) + scroll->view_cols;
+    if (first_row > scroll->first_row) {
+      SAGE_DrawTileMapArea(tilemap, bank, layer, left, scroll->first_row + scroll->view_rows, right, first_row + scroll->view_rows);
+    } else if (first_row < scroll->first_row) {
+      SAGE_DrawTileMapArea(tilemap, bank, layer, left, first_row, right, scroll->first_row);
+    }
+    SAGE_LayerChanged();
+  }
+  scroll->first_col = first_col;
+  scroll->first_row = first_row;
+  // Only the animated tiles change with the animation frames
+  if (scroll->anim_step != bank->anim_step) {
+    SAGE_DrawTileMapAnims(tilemap, bank, layer);
+    SAGE_LayerChanged();
+    scroll->anim_step = bank->anim_step;
+  }
+  scroll->camera_x = x_pos;
+  scroll->camera_y = y_pos;
+  // The view offset inside the first tile gives the pixel scrolling
+  return SAGE_SetLayerView(scroll->layer, x_pos, y_pos, scroll->view_width, scroll->view_height);
+}
+
+/**
+ * Redraw the whole tilemap view at the next scroll, to call after changing
+ * some tiles of the map
+ *
+ * @param index Tilemap index
+ * 
+ * @return Operation success
+ */
+BOOL SAGE_RedrawTileMap(UWORD index)
+{
+  SAGE_TileMap *tilemap;
+
+  tilemap = SAGE_GetTileMap(index);
+  SAFE(if (tilemap == NULL) {
+    SAGE_SetError(SERR_NULL_POINTER);
+    return FALSE;
+  })
+  tilemap->scroll.redraw = TRUE;
+  return TRUE;
+}
+
 /** WORK IN PROGRESS !!! */
 
 /** Get tile UBYTE value at map position */
@@ -5,7 +5,7 @@
  * Tilemap management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 25/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_TILEMAP_H_
@@ -16,6 +16,40 @@
 #define STIL_MAPBPT_BYTE      1
 #define STIL_MAPBPT_WORD      2
 
+#define STIL_RLETAG           0x53544D52            // "STMR"
+#define STIL_RLEVERSION       1
+#define STIL_RLEHEADER        12
+#define STIL_RLERUN           0x80                  // Run of 2 to 129 tiles, else 1 to 128 literal tiles
+
+/** SAGE tilemap scrolling structure */
+typedef struct {
+  /** Scrolling is set */
+  BOOL active;
+  /** Tile bank and layer indexes */
+  UWORD bank, layer;
+  /** View size in pixels and in tiles */
+  ULONG view_width, view_height;
+  LONG view_cols, view_rows;
+  /** Layer size in tiles */
+  LONG layer_cols, layer_rows;
+  /** Camera position */
+  LONG camera_x, camera_y;
+  /** First map column and row drawn in the layer */
+  LONG first_col, first_row;
+  /** Layer should be fully redrawn */
+  BOOL redraw;
+  /** Tile bank animation step of the drawn tiles */
+  ULONG anim_step;
+} SAGE_TileMapScroll;
+
+/** SAGE RLE tilemap file header (followed by the packed tiles) */
+typedef struct {
+  ULONG tag;
+  UWORD cols, rows;
+  UBYTE bytespertile, version;
+  UWORD reserved;
+} SAGE_TileMapHeader;
+
 /** SAGE tilemap structure */
 typedef struct {
   /** Size of the tilemap */
@@ -24,6 +58,8 @@ typedef struct {
   APTR map;
   /** Bytes per tile index */
   UBYTE bytespertile;
+  /** Layer scrolling */
+  SAGE_TileMapScroll scroll;
 } SAGE_TileMap;
 
 /** Create a tilemap */
@@ -44,6 +80,15 @@ UBYTE *SAGE_GetTileMapB(UWORD);
 /** Get tile map as UWORD array */
 UWORD *SAGE_GetTileMapW(UWORD);
 
+/** Link a tilemap to a tile bank and a scrolling layer */
+BOOL SAGE_SetTileMapScroll(UWORD, UWORD, UWORD, ULONG, ULONG);
+
+/** Move the tilemap camera and draw the exposed tiles */
+BOOL SAGE_ScrollTileMap(UWORD, LONG, LONG);
+
+/** Redraw the whole tilemap view at the next scroll */
+BOOL SAGE_RedrawTileMap(UWORD);
+
 /** WORK IN PROGRESS !!! */
 
 /** Get tile UBYTE value at map position */
@@ -5,7 +5,7 @@
  * Timers management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #include <sage/sage_debug.h>
@@ -122,6 +122,18 @@ ULONG SAGE_ElapsedTime(SAGE_Timer *timer)
   return (tv.tv_secs << STIM_SECONDS_SHIFT | tv.tv_micro);
 }
 
+/**
+ * Convert an elapsed time to microseconds
+ * 
+ * @param elapsed_time Elapsed time (12 bits seconds, 20 bits micro)
+ * 
+ * @return Elapsed time in microseconds
+ */
+ULONG SAGE_TimeToMicroseconds(ULONG elapsed_time)
+{
+  return (((elapsed_time >> STIM_SECONDS_SHIFT) & STIM_SECONDS_MASK) * STIM_TICKS) + (elapsed_time & STIM_MICRO_MASK);
+}
+
 /**
  * Wait a certain amount of time
  * 
@@ -5,7 +5,7 @@
  * Timers management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_TIMER_H_
@@ -45,6 +45,9 @@ BOOL SAGE_GetSysTime(SAGE_Timer *);
 /** Get the elapsed time between two calls */
 ULONG SAGE_ElapsedTime(SAGE_Timer *);
 
+/** Convert an elapsed time to microseconds */
+ULONG SAGE_TimeToMicroseconds(ULONG);
+
 /** Wait for a certain amount of time */
 BOOL SAGE_Delay(SAGE_Timer *, ULONG);
 
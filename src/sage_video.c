@@ -5,7 +5,7 @@
  * Video module management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 /** @todo : add methods for queying video card and modes */
@@ -229,6 +229,10 @@ BOOL SAGE_FreeVideoDevice()
       video->sprites[index] = NULL;
     }
   }
+  // Release the sprite batch
+  if (video->sprite_batch != NULL) {
+    SAGE_ReleaseSpriteBatch();
+  }
   // Release all tile banks
   for (index = 0;index < STIL_MAX_TILEBANK;index++) {
     if (video->tiles[index] != NULL) {
@@ -5,7 +5,7 @@
  * Video module management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
 #ifndef _SAGE_VIDEO_H_
@@ -42,6 +42,8 @@ typedef struct {
   SAGE_Layer *layers[SLAY_MAX_LAYERS];
   /** Sprite bank */
   SAGE_SpriteBank *sprites[SSPR_MAX_SPRBANK];
+  /** Sprite batch */
+  SAGE_SpriteBatch *sprite_batch;
   /** Tile bank */
   SAGE_TileBank *tiles[STIL_MAX_TILEBANK];
   /** Tile map */
@@ -5,12 +5,144 @@
  * Config file functions
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
+#include <stdio.h>
+
 #include <sage/sage.h>
 
+#define NB_TUNABLES           2000
+#define TUNABLES_PER_SECTION  50
+
 UBYTE my_buffer[256];
+UBYTE section_name[32], tunable_name[32], tunable_value[32];
+
+/**
+ * Make the section and the name of a tunable
+ */
+VOID TunableName(ULONG tunable)
+{
+  sprintf(section_name, "SECTION%d", tunable / TUNABLES_PER_SECTION);
+  sprintf(tunable_name, "tunable_%d", tunable);
+}
+
+/**
+ * Write a small config file with one value
+ */
+BOOL WriteReloadFile(STRPTR value)
+{
+  FILE *file;
+
+  if ((file = fopen("conf_reload.cfg", "w")) == NULL) {
+    return FALSE;
+  }
+  fprintf(file, "[TEST]\nvalue=%s\n", value);
+  fclose(file);
+  return TRUE;
+}
+
+/**
+ * Change a config file read by SAGE_GetParameterFromFile, the kept value is
+ * returned until the cache is refreshed
+ */
+VOID CheckReload(VOID)
+{
+  SAGE_Timer *timer;
+
+  if ((timer = SAGE_AllocTimer()) == NULL) {
+    SAGE_DisplayError();
+    return;
+  }
+  if (WriteReloadFile("1") && SAGE_GetParameterFromFile("conf_reload.cfg", "TEST", "value", NULL, my_buffer, 256)) {
+    SAGE_AppliLog("Test 7 : [TEST] value=%s (1 expected)", my_buffer);
+    // Wait a few ticks so the new file date is different
+    SAGE_Delay(timer, 100000);
+    if (WriteReloadFile("2") && SAGE_GetParameterFromFile("conf_reload.cfg", "TEST", "value", NULL, my_buffer, 256)) {
+      SAGE_AppliLog("Test 8 : kept file [TEST] value=%s (1 expected)", my_buffer);
+    } else {
+      SAGE_DisplayError();
+    }
+    SAGE_AppliLog("Test 9 : file changed=%d (1 expected)", SAGE_RefreshConfigurationCache());
+    if (SAGE_GetParameterFromFile("conf_reload.cfg", "TEST", "value", NULL, my_buffer, 256)) {
+      SAGE_AppliLog("Test 10 : refreshed file [TEST] value=%s (2 expected)", my_buffer);
+    } else {
+      SAGE_DisplayError();
+    }
+  } else {
+    SAGE_DisplayError();
+  }
+  SAGE_ReleaseTimer(timer);
+}
+
+/**
+ * Save a file of NB_TUNABLES integers then time the load and the lookups
+ */
+VOID BenchTunables(VOID)
+{
+  SAGE_Configuration *conf;
+  SAGE_Timer *timer;
+  ULONG tunable, load_time, first_time, cached_time, file_time, errors = 0;
+
+  if ((timer = SAGE_AllocTimer()) == NULL) {
+    SAGE_DisplayError();
+    return;
+  }
+  if ((conf = SAGE_LoadConfigurationFile("data/test.ini")) == NULL) {
+    SAGE_DisplayError();
+    SAGE_ReleaseTimer(timer);
+    return;
+  }
+  SAGE_AppliLog("Saving %d tunables", NB_TUNABLES);
+  for (tunable = 0;tunable < NB_TUNABLES;tunable++) {
+    TunableName(tunable);
+    sprintf(tunable_value, "%d", tunable * 7);
+    SAGE_SetParameterValue(conf, section_name, tunable_name, tunable_value);
+  }
+  if (!SAGE_SaveConfigurationFile(conf, "RAM:tunables.cfg", "Tunables")) {
+    SAGE_DisplayError();
+  }
+  SAGE_ReleaseConfigurationFile(conf);
+  SAGE_ElapsedTime(timer);
+  if ((conf = SAGE_LoadConfigurationFile("RAM:tunables.cfg")) != NULL) {
+    load_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+    for (tunable = 0;tunable < NB_TUNABLES;tunable++) {
+      TunableName(tunable);
+      if (SAGE_GetParameterInteger(conf, section_name, tunable_name, -1) != (LONG)(tunable * 7)) {
+        errors++;
+      }
+    }
+    first_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+    for (tunable = 0;tunable < NB_TUNABLES;tunable++) {
+      TunableName(tunable);
+      if (SAGE_GetParameterInteger(conf, section_name, tunable_name, -1) != (LONG)(tunable * 7)) {
+        errors++;
+      }
+    }
+    cached_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+    for (tunable = 0;tunable < NB_TUNABLES;tunable++) {
+      TunableName(tunable);
+      if (!SAGE_GetParameterFromFile("RAM:tunables.cfg", section_name, tunable_name, NULL, my_buffer, 256)) {
+        errors++;
+      }
+    }
+    file_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+    if (errors == 0) {
+      SAGE_AppliLog("All tunables found !");
+    } else {
+      SAGE_ErrorLog("%d tunables are wrong", errors);
+    }
+    SAGE_AppliLog("  Load file            : %d us", load_time);
+    SAGE_AppliLog("  Integers (parsed)    : %d us", first_time);
+    SAGE_AppliLog("  Integers (cached)    : %d us", cached_time);
+    SAGE_AppliLog("  Parameters from file : %d us", file_time);
+    SAGE_ReleaseConfigurationFile(conf);
+  } else {
+    SAGE_DisplayError();
+  }
+  SAGE_ReleaseConfigurationCache();
+  SAGE_ReleaseTimer(timer);
+}
 
 void main(void)
 {
@@ -45,6 +177,7 @@ void main(void)
       SAGE_DisplayError();
     }
     SAGE_AppliLog("Test 6 : debug=%s", my_buffer);
+    CheckReload();
     SAGE_AppliLog("*** Load config file ***");
     if ((my_conf = SAGE_LoadConfigurationFile("data/test.ini")) == NULL) {
       SAGE_DisplayError();
@@ -55,27 +188,30 @@ void main(void)
       SAGE_AppliLog("Test 2 : [NETWORK] server=%s", my_buffer);
       strcpy(my_buffer, SAGE_GetParameterValue(my_conf, NULL, "debug", "FALSE"));
       SAGE_AppliLog("Test 3 : debug=%s", my_buffer);
-      SAGE_AppliLog("Test 4 : Update [VIDEO] depth=8");
+      SAGE_AppliLog("Test 4 : [VIDEO] depth=%d", SAGE_GetParameterInteger(my_conf, "VIDEO", "depth", 8));
+      SAGE_AppliLog("Test 5 : [VIDEO] resolution=%d (not an integer)", SAGE_GetParameterInteger(my_conf, "VIDEO", "resolution", -1));
+      SAGE_AppliLog("Test 6 : debug=%d", SAGE_GetParameterBoolean(my_conf, NULL, "debug", FALSE));
+      SAGE_AppliLog("Test 7 : Update [VIDEO] depth=8");
       if (!SAGE_SetParameterValue(my_conf, "VIDEO", "depth", "8")) {
         SAGE_DisplayError();
       }
-      SAGE_AppliLog("Test 5 : Create [NETWORK] port=6200");
+      SAGE_AppliLog("Test 8 : Create [NETWORK] port=6200");
       if (!SAGE_SetParameterValue(my_conf, "NETWORK", "port", "6200")) {
         SAGE_DisplayError();
       }
-      SAGE_AppliLog("Test 6 : Create [AUDIO] stereo=TRUE");
+      SAGE_AppliLog("Test 9 : Create [AUDIO] stereo=TRUE");
       if (!SAGE_SetParameterValue(my_conf, "AUDIO", "stereo", "TRUE")) {
         SAGE_DisplayError();
       }
-      SAGE_AppliLog("Test 7 : Create name=Lexo");
+      SAGE_AppliLog("Test 10 : Create name=Lexo");
       if (!SAGE_SetParameterValue(my_conf, NULL, "name", "Lexo")) {
         SAGE_DisplayError();
       }
-      SAGE_AppliLog("Test 8 : Remove [AUDIO] sounds");
+      SAGE_AppliLog("Test 11 : Remove [AUDIO] sounds");
       if (!SAGE_SetParameterValue(my_conf, "AUDIO", "sounds", NULL)) {
         SAGE_DisplayError();
       }
-      SAGE_AppliLog("Test 9 : Remove [NETWORK] server");
+      SAGE_AppliLog("Test 12 : Remove [NETWORK] server");
       if (!SAGE_SetParameterValue(my_conf, "NETWORK", "server", NULL)) {
         SAGE_DisplayError();
       }
@@ -85,6 +221,8 @@ void main(void)
       }
     }
     SAGE_ReleaseConfigurationFile(my_conf);
+    SAGE_AppliLog("*** Benchmark ***");
+    BenchTunables();
   }
   SAGE_Exit();
   SAGE_AppliLog("End of test");
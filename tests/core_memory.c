@@ -5,11 +5,189 @@
  * Test memory management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 24/02/2025)
+ * @version 25.1 February 2025 (updated: 26/06/2025)
  */
 
+#include <stdlib.h>
+
 #include <sage/sage.h>
 
+#define LIVE_BLOCS            2000
+#define BENCH_PAIRS           100000
+#define ARENA_SIZE            65536
+#define ARENA_FRAMES          500
+#define FRAME_BLOCS           100
+#define TAG_LEVEL             SMEM_TAG_USER
+
+APTR Blocs[LIVE_BLOCS];
+ULONG *FrameBlocs[2][FRAME_BLOCS];
+
+/**
+ * Free and allocate random blocs while LIVE_BLOCS blocs are kept allocated,
+ * from the memory list or from the pools
+ */
+VOID BenchMemory(BOOL pools)
+{
+  SAGE_Timer *timer;
+  ULONG pair, bloc, elapsed;
+
+  if ((timer = SAGE_AllocTimer()) != NULL) {
+    for (bloc = 0;bloc < LIVE_BLOCS;bloc++) {
+      Blocs[bloc] = pools ? SAGE_PoolAlloc(16 + (bloc % 200)) : SAGE_AllocMem(16 + (bloc % 200));
+    }
+    SAGE_AppliLog("Freeing and allocating %d %s blocs with %d live blocs", BENCH_PAIRS, pools ? "pool" : "list", LIVE_BLOCS);
+    SAGE_ElapsedTime(timer);
+    for (pair = 0;pair < BENCH_PAIRS;pair++) {
+      bloc = rand() % LIVE_BLOCS;
+      if (pools) {
+        SAGE_PoolFree(Blocs[bloc]);
+        Blocs[bloc] = SAGE_PoolAlloc(16 + (rand() % 240));
+      } else {
+        SAGE_FreeMem(Blocs[bloc]);
+        Blocs[bloc] = SAGE_AllocMem(16 + (rand() % 240));
+      }
+      if (Blocs[bloc] == NULL) {
+        SAGE_DisplayError();
+        break;
+      }
+    }
+    elapsed = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+    SAGE_AppliLog("  %d pairs in %d us", pair, elapsed);
+    for (bloc = 0;bloc < LIVE_BLOCS;bloc++) {
+      SAGE_FreeMem(Blocs[bloc]);
+    }
+    SAGE_ReleaseTimer(timer);
+  }
+}
+
+/**
+ * Allocate the transient blocs of a frame, each bloc is filled with the frame
+ * number
+ */
+BOOL AllocFrameBlocs(ULONG frame, BOOL arena)
+{
+  ULONG **blocs, bloc, idx, size;
+
+  blocs = FrameBlocs[frame & 1];
+  for (bloc = 0;bloc < FRAME_BLOCS;bloc++) {
+    size = 4 + (rand() % 60);
+    if ((blocs[bloc] = arena ? SAGE_FrameAlloc(size * 4) : SAGE_AllocMem(size * 4)) == NULL) {
+      return FALSE;
+    }
+    blocs[bloc][0] = size;
+    for (idx = 1;idx < size;idx++) {
+      blocs[bloc][idx] = frame;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Check that the blocs of a frame are still intact
+ */
+BOOL CheckFrameBlocs(ULONG frame)
+{
+  ULONG **blocs, bloc, idx;
+
+  blocs = FrameBlocs[frame & 1];
+  for (bloc = 0;bloc < FRAME_BLOCS;bloc++) {
+    for (idx = 1;idx < blocs[bloc][0];idx++) {
+      if (blocs[bloc][idx] != frame) {
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Allocate FRAME_BLOCS transient blocs each frame from the frame arenas and
+ * with SAGE_AllocMem/SAGE_FreeMem, the blocs of the previous frame must
+ * survive one arena reset
+ */
+VOID BenchArena(VOID)
+{
+  SAGE_Timer *timer;
+  ULONG frame, bloc, list_time, arena_time, errors = 0;
+
+  if ((timer = SAGE_AllocTimer()) != NULL) {
+    SAGE_AppliLog("Allocating %d blocs by frame during %d frames", FRAME_BLOCS, ARENA_FRAMES);
+    SAGE_ElapsedTime(timer);
+    for (frame = 0;frame < ARENA_FRAMES;frame++) {
+      if (!AllocFrameBlocs(frame, FALSE)) {
+        SAGE_DisplayError();
+        break;
+      }
+      for (bloc = 0;bloc < FRAME_BLOCS;bloc++) {
+        SAGE_FreeMem(FrameBlocs[frame & 1][bloc]);
+      }
+    }
+    list_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+    if (SAGE_CreateFrameArenas(ARENA_SIZE)) {
+      SAGE_ElapsedTime(timer);
+      for (frame = 0;frame < ARENA_FRAMES;frame++) {
+        if (!AllocFrameBlocs(frame, TRUE)) {
+          SAGE_DisplayError();
+          break;
+        }
+        if (frame > 0 && !CheckFrameBlocs(frame - 1)) {
+          errors++;
+        }
+        SAGE_ResetFrameArena();
+      }
+      arena_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+      if (errors == 0) {
+        SAGE_AppliLog("Previous frame blocs are intact !");
+      } else {
+        SAGE_ErrorLog("%d frames lost their blocs", errors);
+      }
+      SAGE_AppliLog("  Memory list  : %d us", list_time);
+      SAGE_AppliLog("  Frame arenas : %d us", arena_time);
+      SAGE_AppliLog("Allocating more than the arena size");
+      if (SAGE_FrameAlloc(ARENA_SIZE + 1) == NULL) {
+        SAGE_DisplayError();
+      }
+      SAGE_DumpMemory();
+      SAGE_ReleaseFrameArenas();
+    } else {
+      SAGE_DisplayError();
+    }
+    SAGE_ReleaseTimer(timer);
+  }
+}
+
+/**
+ * Allocate blocs for a level tag and dump the memory accounting as CSV
+ */
+VOID TagMemory(VOID)
+{
+  SAGE_MemorySnapshot snapshot;
+  APTR bloc1, bloc2, bloc3;
+  UWORD tag;
+
+  SAGE_SetMemoryTagName(TAG_LEVEL, "level1");
+  tag = SAGE_SetMemoryTag(TAG_LEVEL);
+  bloc1 = SAGE_AllocMem(20000);
+  bloc2 = SAGE_AllocChipMem(10000);
+  SAGE_SetMemoryTag(tag);
+  bloc3 = SAGE_AllocMem(5000);
+  SAGE_FreeMem(bloc1);
+  if (SAGE_GetMemorySnapshot(&snapshot)) {
+    SAGE_AppliLog("Level tag uses %d bytes of CHIP (peak %d) and %d bytes of FAST (peak %d)",
+      snapshot.tags[TAG_LEVEL].live_bytes[SMEM_LOC_CHIP], snapshot.tags[TAG_LEVEL].peak_bytes[SMEM_LOC_CHIP],
+      snapshot.tags[TAG_LEVEL].live_bytes[SMEM_LOC_FAST], snapshot.tags[TAG_LEVEL].peak_bytes[SMEM_LOC_FAST]
+    );
+    SAGE_DumpMemorySnapshot(&snapshot, NULL);
+    if (SAGE_DumpMemorySnapshot(&snapshot, "RAM:memory.csv")) {
+      SAGE_AppliLog("Memory accounting saved to RAM:memory.csv");
+    }
+  } else {
+    SAGE_AppliLog("Memory accounting is not available in this build");
+  }
+  SAGE_FreeMem(bloc2);
+  SAGE_FreeMem(bloc3);
+}
+
 void main(void)
 {
   APTR bloc1;
@@ -41,6 +219,11 @@ void main(void)
       SAGE_FreeMem(bloc3);
       SAGE_DumpMemory();
     }
+    BenchMemory(FALSE);
+    BenchMemory(TRUE);
+    SAGE_DumpMemory();
+    BenchArena();
+    TagMemory();
     SAGE_AppliLog("Freeing all blocs");
     SAGE_ReleaseMem();
     SAGE_AppliLog("Available memory %d", SAGE_AvailMem());
@@ -0,0 +1,184 @@
+/**
+ * engine3d_3desen.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test 3D binary entity load
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <math.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define LOAD_LOOPS            100
+#define LOAD_EPSILON          0.001
+
+#define OBJ_FILE              "data/house.obj"
+#define SEN_FILE              "data/house.sen"
+
+/**
+ * Release the textures loaded with an entity
+ */
+VOID ReleaseEntityTextures(SAGE_Entity *entity)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < entity->nb_faces;idx++) {
+    if (entity->faces[idx].texture != STEX_USECOLOR) {
+      SAGE_ReleaseTexture(entity->faces[idx].texture);
+    }
+  }
+}
+
+/**
+ * Load an entity the way a game does it at startup
+ */
+SAGE_Entity *LoadEntity(STRPTR filename, BOOL optimize)
+{
+  SAGE_Entity *entity;
+
+  entity = SAGE_LoadEntity(filename);
+  if (entity != NULL && optimize && !SAGE_OptimizeEntity(entity)) {
+    ReleaseEntityTextures(entity);
+    SAGE_ReleaseEntity(entity);
+    entity = NULL;
+  }
+  return entity;
+}
+
+/**
+ * Check if two floats are equal
+ */
+BOOL SameFloat(FLOAT a, FLOAT b)
+{
+  return (BOOL)(fabs(a - b) < LOAD_EPSILON);
+}
+
+/**
+ * Count the differences between the OBJ and the SEN entities
+ */
+ULONG CompareEntities(SAGE_Entity *obj, SAGE_Entity *sen)
+{
+  ULONG errors;
+  UWORD idx;
+  SAGE_Face *fo, *fs;
+
+  if (obj->nb_vertices != sen->nb_vertices || obj->nb_faces != sen->nb_faces) {
+    SAGE_ErrorLog("OBJ has %d vertices/%d faces, SEN has %d vertices/%d faces", obj->nb_vertices, obj->nb_faces, sen->nb_vertices, sen->nb_faces);
+    return 1;
+  }
+  errors = 0;
+  if (!SameFloat(obj->radius, sen->radius)) {
+    SAGE_ErrorLog("Radius %f is not %f", sen->radius, obj->radius);
+    errors++;
+  }
+  for (idx = 0;idx < obj->nb_vertices;idx++) {
+    if (!SameFloat(obj->vertices[idx].x, sen->vertices[idx].x) || !SameFloat(obj->vertices[idx].y, sen->vertices[idx].y) || !SameFloat(obj->vertices[idx].z, sen->vertices[idx].z)) {
+      SAGE_ErrorLog("Vertex %d is different", idx);
+      errors++;
+    }
+  }
+  for (idx = 0;idx < obj->nb_faces;idx++) {
+    fo = &(obj->faces[idx]);
+    fs = &(sen->faces[idx]);
+    if (fo->is_quad != fs->is_quad || fo->p1 != fs->p1 || fo->p2 != fs->p2 || fo->p3 != fs->p3 || (fo->is_quad && fo->p4 != fs->p4)
+        || fo->color != fs->color || (fo->texture == STEX_USECOLOR) != (fs->texture == STEX_USECOLOR)
+        || !SameFloat(fo->u1, fs->u1) || !SameFloat(fo->v1, fs->v1) || !SameFloat(fo->u2, fs->u2) || !SameFloat(fo->v2, fs->v2)
+        || !SameFloat(fo->u3, fs->u3) || !SameFloat(fo->v3, fs->v3)) {
+      SAGE_ErrorLog("Face %d is different", idx);
+      errors++;
+    }
+    if (!SameFloat(obj->normals[idx].x, sen->normals[idx].x) || !SameFloat(obj->normals[idx].y, sen->normals[idx].y) || !SameFloat(obj->normals[idx].z, sen->normals[idx].z)) {
+      SAGE_ErrorLog("Normal %d is different", idx);
+      errors++;
+    }
+  }
+  return errors;
+}
+
+/**
+ * Load an entity LOAD_LOOPS times and return the elapsed time in microseconds
+ */
+ULONG BenchLoad(SAGE_Timer *timer, STRPTR filename, BOOL optimize)
+{
+  SAGE_Entity *entity;
+  ULONG elapsed_time, total_time;
+  UWORD loop;
+
+  total_time = 0;
+  for (loop = 0;loop < LOAD_LOOPS;loop++) {
+    SAGE_ElapsedTime(timer);
+    entity = LoadEntity(filename, optimize);
+    elapsed_time = SAGE_ElapsedTime(timer);
+    total_time += SAGE_TimeToMicroseconds(elapsed_time);
+    if (entity == NULL) {
+      SAGE_ErrorLog("Can't load %s !", filename);
+      return 0;
+    }
+    ReleaseEntityTextures(entity);
+    SAGE_ReleaseEntity(entity);
+  }
+  return total_time;
+}
+
+/**
+ * Check the SEN entity against the OBJ entity then compare the load times
+ * (data/house.sen is made with : obj2sen house.obj house.sen)
+ */
+void main(void)
+{
+  SAGE_Entity *obj_entity = NULL, *sen_entity = NULL;
+  SAGE_Timer *timer;
+  ULONG errors, obj_time, sen_time;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("    SAGE library 3D test (3DESEN) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO|SMOD_3D)) {
+    SAGE_AppliLog("Initialization successfull");
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_Init3DEngine();
+      if ((obj_entity = LoadEntity(OBJ_FILE, TRUE)) != NULL && (sen_entity = LoadEntity(SEN_FILE, FALSE)) != NULL) {
+        SAGE_AppliLog("Compare %s with %s", SEN_FILE, OBJ_FILE);
+        errors = CompareEntities(obj_entity, sen_entity);
+        if (errors == 0) {
+          SAGE_AppliLog("Entities match !");
+        } else {
+          SAGE_ErrorLog("%d differences !", errors);
+        }
+        if ((timer = SAGE_AllocTimer()) != NULL) {
+          SAGE_AppliLog("Loading each entity %d times", LOAD_LOOPS);
+          obj_time = BenchLoad(timer, OBJ_FILE, TRUE);
+          sen_time = BenchLoad(timer, SEN_FILE, FALSE);
+          SAGE_AppliLog("  OBJ (parse + optimize) : %d ms, %d us per entity", obj_time / 1000, obj_time / LOAD_LOOPS);
+          SAGE_AppliLog("  SEN (binary read)      : %d ms, %d us per entity", sen_time / 1000, sen_time / LOAD_LOOPS);
+          if (sen_time > 0) {
+            SAGE_AppliLog("  SEN is %d.%02d times faster", obj_time / sen_time, ((obj_time % sen_time) * 100) / sen_time);
+          }
+          SAGE_ReleaseTimer(timer);
+        }
+      } else {
+        SAGE_DisplayError();
+      }
+      if (obj_entity != NULL) {
+        ReleaseEntityTextures(obj_entity);
+        SAGE_ReleaseEntity(obj_entity);
+      }
+      if (sen_entity != NULL) {
+        ReleaseEntityTextures(sen_entity);
+        SAGE_ReleaseEntity(sen_entity);
+      }
+      SAGE_Release3DEngine();
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -0,0 +1,154 @@
+/**
+ * engine3d_3dstream.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Benchmark the vertex streams pipeline against the standard vertex pipeline
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 12/06/2025)
+ */
+
+#include <math.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define MAIN_CAMERA           1
+#define SPHERE_ENTITY         1
+
+#define SPHERE_RINGS          140
+#define SPHERE_SEGMENTS       144
+#define SPHERE_RADIUS         100.0
+#define SPHERE_DISTANCE       400.0
+
+#define BENCH_FRAMES          100
+
+// Set the stack size
+extern long int __stack = 16384;
+
+/**
+ * Build a sphere of SPHERE_RINGS*SPHERE_SEGMENTS vertices (poles are left open)
+ */
+SAGE_Entity *BuildSphere(VOID)
+{
+  SAGE_Entity *sphere;
+  UWORD ring, segment, index;
+  DOUBLE theta, phi;
+
+  sphere = SAGE_CreateEntity(SPHERE_RINGS * SPHERE_SEGMENTS, (SPHERE_RINGS - 1) * SPHERE_SEGMENTS);
+  if (sphere != NULL) {
+    for (ring = 0;ring < SPHERE_RINGS;ring++) {
+      theta = PI * (DOUBLE)(ring + 1) / (DOUBLE)(SPHERE_RINGS + 1);
+      for (segment = 0;segment < SPHERE_SEGMENTS;segment++) {
+        phi = 2.0 * PI * (DOUBLE)segment / (DOUBLE)SPHERE_SEGMENTS;
+        index = ring * SPHERE_SEGMENTS + segment;
+        sphere->vertices[index].x = (FLOAT)(SPHERE_RADIUS * sin(theta) * cos(phi));
+        sphere->vertices[index].y = (FLOAT)(SPHERE_RADIUS * cos(theta));
+        sphere->vertices[index].z = (FLOAT)(SPHERE_RADIUS * sin(theta) * sin(phi));
+      }
+    }
+    index = 0;
+    for (ring = 0;ring < (SPHERE_RINGS - 1);ring++) {
+      for (segment = 0;segment < SPHERE_SEGMENTS;segment++) {
+        sphere->faces[index].is_quad = TRUE;
+        sphere->faces[index].texture = STEX_USECOLOR;
+        sphere->faces[index].color = ((ring + segment) & 1) ? 0xff0000 : 0xffffff;
+        sphere->faces[index].p1 = ring * SPHERE_SEGMENTS + segment;
+        sphere->faces[index].p2 = ring * SPHERE_SEGMENTS + ((segment + 1) % SPHERE_SEGMENTS);
+        sphere->faces[index].p3 = (ring + 1) * SPHERE_SEGMENTS + ((segment + 1) % SPHERE_SEGMENTS);
+        sphere->faces[index].p4 = (ring + 1) * SPHERE_SEGMENTS + segment;
+        index++;
+      }
+    }
+    SAGE_InitEntity(sphere);
+  }
+  return sphere;
+}
+
+/**
+ * Render some frames and return the elapsed time in milliseconds
+ */
+ULONG RenderFrames(SAGE_Timer *timer)
+{
+  UWORD frame;
+  ULONG elapsed_time;
+
+  SAGE_ElapsedTime(timer);
+  for (frame = 0;frame < BENCH_FRAMES;frame++) {
+    SAGE_ClearScreen();
+    SAGE_RotateEntity(SPHERE_ENTITY, S3DE_ONEDEGREE, S3DE_ONEDEGREE, 0);
+    SAGE_RenderWorld();
+    SAGE_RefreshScreen();
+  }
+  elapsed_time = SAGE_ElapsedTime(timer);
+  return SAGE_TimeToMicroseconds(elapsed_time) / 1000;
+}
+
+void main(void)
+{
+  SAGE_Entity *sphere;
+  SAGE_Timer *timer;
+  SAGE_EngineMetrics *metrics;
+  ULONG aos_time, soa_time;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("    SAGE library 3D test (3DSTREAM) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO|SMOD_3D)) {
+    SAGE_AppliLog("Initialization successfull");
+    if ((timer = SAGE_AllocTimer()) != NULL) {
+      if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+        SAGE_HideMouse();
+        SAGE_Set3DRenderSystem(S3DD_S3DRENDER);
+        if (SAGE_Init3DEngine()) {
+          SAGE_AddCamera(MAIN_CAMERA, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+          SAGE_SetActiveCamera(MAIN_CAMERA);
+          SAGE_SetCameraPlane(MAIN_CAMERA, (FLOAT)10.0, (FLOAT)1000.0);
+          SAGE_Set3DRenderMode(S3DR_RENDER_WIRE);
+          SAGE_AppliLog("Building sphere of %d vertices", SPHERE_RINGS * SPHERE_SEGMENTS);
+          if ((sphere = BuildSphere()) != NULL && SAGE_AddEntity(SPHERE_ENTITY, sphere)) {
+            SAGE_SetEntityPosition(SPHERE_ENTITY, (FLOAT)0.0, (FLOAT)0.0, (FLOAT)SPHERE_DISTANCE);
+
+            SAGE_AppliLog("Rendering %d frames with the standard vertex pipeline", BENCH_FRAMES);
+            SAGE_EnableVertexStreams(FALSE);
+            aos_time = RenderFrames(timer);
+            metrics = SAGE_GetEngineMetrics();
+            SAGE_AppliLog("AoS : %d ms (%d ms/frame)  V=%d/%d/%d  F=%d/%d  E=%d", aos_time, aos_time / BENCH_FRAMES,
+              metrics->rendered_vertices, metrics->calculated_vertices, metrics->total_vertices,
+              metrics->rendered_faces, metrics->total_faces, metrics->rendered_elements
+            );
+
+            SAGE_AppliLog("Rendering %d frames with the vertex streams pipeline", BENCH_FRAMES);
+            if (SAGE_EnableVertexStreams(TRUE)) {
+              soa_time = RenderFrames(timer);
+              metrics = SAGE_GetEngineMetrics();
+              SAGE_AppliLog("SoA : %d ms (%d ms/frame)  V=%d/%d/%d  F=%d/%d  E=%d", soa_time, soa_time / BENCH_FRAMES,
+                metrics->rendered_vertices, metrics->calculated_vertices, metrics->total_vertices,
+                metrics->rendered_faces, metrics->total_faces, metrics->rendered_elements
+              );
+              if (soa_time > 0) {
+                SAGE_AppliLog("Speed ratio AoS/SoA : %d%%", (aos_time * 100) / soa_time);
+              }
+            } else {
+              SAGE_DisplayError();
+            }
+
+            SAGE_RemoveEntity(SPHERE_ENTITY);
+            SAGE_AppliLog("All done !");
+          } else {
+            SAGE_DisplayError();
+          }
+        }
+        SAGE_Release3DEngine();
+        SAGE_ShowMouse();
+        SAGE_CloseScreen();
+      }
+      SAGE_ReleaseTimer(timer);
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -5,7 +5,7 @@
  * Test 3D terrain management
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 March 2025 (updated: 20/03/2025)
+ * @version 25.1 March 2025 (updated: 20/06/2025)
  */
 
 #include <sage/sage.h>
@@ -23,6 +23,7 @@
 // Test data
 FLOAT cpx = (CELL_SIZE * TERRAIN_SIZE / 2), cpz = (CELL_SIZE * TERRAIN_SIZE / 2), min = CELL_SIZE, max = (CELL_SIZE * TERRAIN_SIZE);
 WORD cax = 0, cay = 0;
+BOOL lod = TRUE;
 
 // Metrics buffer
 UBYTE string_buffer[256];
@@ -159,6 +160,10 @@ void main(void)
               if (event->code == SKEY_FR_T) {
                 SAGE_Set3DRenderMode(S3DR_RENDER_TEXT);
               }
+              if (event->code == SKEY_FR_L) {
+                lod = !lod;
+                SAGE_SetTerrainLevelOfDetail((lod ? S3DT_LOD_ERROR : 0.0), S3DT_LOD_LEVELS - 1);
+              }
             } else if (event->type == SEVT_MOUSEMV) {
               cay += event->mousex;
               cax += event->mousey;
@@ -168,7 +173,7 @@ void main(void)
           SAGE_SetCameraPosition(MAIN_CAMERA, cpx, (FLOAT)100.0, cpz);
           SAGE_ClearScreen();
           SAGE_RenderWorld();
-          SAGE_PrintFText(10, 15, "CAM AX=%d  AY=%d  PX=%f  PZ=%f", cax, cay, cpx, cpz);
+          SAGE_PrintFText(10, 15, "CAM AX=%d  AY=%d  PX=%f  PZ=%f  LOD=%s", cax, cay, cpx, cpz, (lod ? "on" : "off"));
           metrics = SAGE_GetEngineMetrics();
           SAGE_PrintFText(10, 47,
             "P=%d/%d  Z=%d/%d  E=%d/%d  V=%d/%d/%d  F=%d/%d  E=%d",
@@ -0,0 +1,168 @@
+/**
+ * engine3d_3dtree.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Check the bounding tree culling against the culling of each entity
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdlib.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define MAIN_CAMERA           1
+
+#define NB_CUBES              500
+#define CUBE_SIZE             20.0
+#define WORLD_SIZE            2000
+#define MOVE_SIZE             40
+
+#define TEST_FRAMES           50
+
+BOOL CubeCulled[NB_CUBES], CubeClipped[NB_CUBES];
+
+/**
+ * Build a cube entity
+ */
+SAGE_Entity *BuildCube(FLOAT size)
+{
+  SAGE_Entity *cube;
+  UWORD index;
+  static UWORD faces[6][4] = {
+    { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 },
+    { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 }
+  };
+
+  if ((cube = SAGE_CreateEntity(8, 6)) != NULL) {
+    for (index = 0;index < 8;index++) {
+      cube->vertices[index].x = (index & 1) ? size : -size;
+      cube->vertices[index].y = (index & 2) ? size : -size;
+      cube->vertices[index].z = (index & 4) ? size : -size;
+    }
+    for (index = 0;index < 6;index++) {
+      cube->faces[index].is_quad = TRUE;
+      cube->faces[index].texture = STEX_USECOLOR;
+      cube->faces[index].color = 0xffffff;
+      cube->faces[index].p1 = faces[index][0];
+      cube->faces[index].p2 = faces[index][1];
+      cube->faces[index].p3 = faces[index][2];
+      cube->faces[index].p4 = faces[index][3];
+    }
+    SAGE_InitEntity(cube);
+  }
+  return cube;
+}
+
+/**
+ * Random coordinate between -size/2 and size/2
+ */
+FLOAT RandomCoordinate(LONG size)
+{
+  return (FLOAT)((rand() % size) - (size / 2));
+}
+
+/**
+ * Render the world with and without the bounding trees and count the
+ * entities which do not get the same visibility
+ */
+ULONG CompareCulling(VOID)
+{
+  SAGE_Entity *cube;
+  UWORD index;
+  ULONG errors;
+
+  SAGE_EnableBoundingTrees(FALSE);
+  SAGE_RenderWorld();
+  for (index = 0;index < NB_CUBES;index++) {
+    cube = SAGE_GetEntity(index);
+    CubeCulled[index] = cube->culled;
+    CubeClipped[index] = cube->clipped;
+  }
+  SAGE_EnableBoundingTrees(TRUE);
+  SAGE_RenderWorld();
+  errors = 0;
+  for (index = 0;index < NB_CUBES;index++) {
+    cube = SAGE_GetEntity(index);
+    if (cube->culled != CubeCulled[index] || (!cube->culled && cube->clipped != CubeClipped[index])) {
+      errors++;
+    }
+  }
+  return errors;
+}
+
+void main(void)
+{
+  SAGE_Entity *cube;
+  SAGE_EngineMetrics *metrics;
+  UWORD index, frame;
+  ULONG errors, visible;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("    SAGE library 3D test (3DTREE) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO|SMOD_3D)) {
+    SAGE_AppliLog("Initialization successfull");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_Set3DRenderSystem(S3DD_S3DRENDER);
+      if (SAGE_Init3DEngine()) {
+        SAGE_AddCamera(MAIN_CAMERA, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+        SAGE_SetActiveCamera(MAIN_CAMERA);
+        SAGE_SetCameraPlane(MAIN_CAMERA, (FLOAT)10.0, (FLOAT)1000.0);
+        SAGE_Set3DRenderMode(S3DR_RENDER_WIRE);
+        SAGE_AppliLog("Adding %d cubes", NB_CUBES);
+        srand(1);
+        for (index = 0;index < NB_CUBES;index++) {
+          if ((cube = BuildCube((FLOAT)CUBE_SIZE)) == NULL || !SAGE_AddEntity(index, cube)) {
+            SAGE_DisplayError();
+            break;
+          }
+          SAGE_SetEntityPosition(index, RandomCoordinate(WORLD_SIZE), RandomCoordinate(WORLD_SIZE / 4), RandomCoordinate(WORLD_SIZE));
+        }
+        if (index == NB_CUBES) {
+          SAGE_AppliLog("Comparing the culling of %d frames", TEST_FRAMES);
+          errors = 0;
+          for (frame = 0;frame < TEST_FRAMES;frame++) {
+            // Move the cubes and the camera
+            for (index = 0;index < NB_CUBES;index++) {
+              SAGE_MoveEntity(index, RandomCoordinate(MOVE_SIZE), RandomCoordinate(MOVE_SIZE), RandomCoordinate(MOVE_SIZE));
+            }
+            SAGE_SetCameraAngle(MAIN_CAMERA, (WORD)((frame % 10) * S3DE_ONEDEGREE), (WORD)(frame * 7 * S3DE_ONEDEGREE), 0);
+            // Grow some cubes, the tree must see their new radius
+            if (frame == (TEST_FRAMES / 2)) {
+              for (index = 0;index < NB_CUBES;index += 5) {
+                cube = SAGE_GetEntity(index);
+                cube->vertices[0].x *= 4.0;
+                cube->vertices[0].y *= 4.0;
+                cube->vertices[0].z *= 4.0;
+                SAGE_SetEntityRadius(cube);
+              }
+            }
+            errors += CompareCulling();
+          }
+          metrics = SAGE_GetEngineMetrics();
+          visible = metrics->rendered_entities;
+          if (errors == 0) {
+            SAGE_AppliLog("Tree culling matches the culling of each entity !");
+          } else {
+            SAGE_ErrorLog("%d entities do not get the same visibility with the tree", errors);
+          }
+          SAGE_AppliLog("Last frame : %d visible entities, %d tested nodes for %d entities", visible, metrics->tested_nodes, NB_CUBES);
+        }
+        SAGE_FlushEntities();
+        SAGE_AppliLog("All done !");
+      }
+      SAGE_Release3DEngine();
+      SAGE_ShowMouse();
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
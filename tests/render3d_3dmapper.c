@@ -0,0 +1,433 @@
+/**
+ * render3d_3dmapper.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Check the fast mappers against the C reference mappers and golden images
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <proto/dos.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          320L
+#define SCREEN_HEIGHT         240L
+
+#define TEX_VAMPIRE           1
+#define TEX_WIDTH             255.0
+
+#define MODE_CHECK            0
+#define MODE_SAVE             1
+#define MODE_BENCH            2
+
+#define SET_BASIC             0
+#define SET_CLIPPED           1
+#define SET_DEPTH             2
+#define SET_SLIVERS           3
+#define SET_MESH              4
+#define SET_COUNT             5
+#define SET_MAX_ELEMENTS      512
+
+#define MESH_COLUMNS          16
+#define MESH_ROWS             12
+
+#define BENCH_LOOPS           20
+
+STRPTR SetNames[SET_COUNT] = { "basic", "clipped", "depth", "slivers", "mesh" };
+
+SAGE_3DElement MapperSets[SET_COUNT][SET_MAX_ELEMENTS];
+UWORD SetSize[SET_COUNT];
+ULONG SetPixels[SET_COUNT];
+
+/**
+ * Add a triangle to a set
+ */
+VOID AddTriangle(UWORD set, FLOAT x1, FLOAT y1, FLOAT z1, FLOAT x2, FLOAT y2, FLOAT z2, FLOAT x3, FLOAT y3, FLOAT z3, WORD texture, ULONG color)
+{
+  SAGE_3DElement *element;
+
+  element = &(MapperSets[set][SetSize[set]++]);
+  element->type = S3DR_ELEM_TRIANGLE;
+  element->x1 = x1; element->y1 = y1; element->z1 = z1; element->u1 = 0.0; element->v1 = 0.0;
+  element->x2 = x2; element->y2 = y2; element->z2 = z2; element->u2 = TEX_WIDTH; element->v2 = 0.0;
+  element->x3 = x3; element->y3 = y3; element->z3 = z3; element->u3 = 0.0; element->v3 = TEX_WIDTH;
+  element->texture = texture;
+  element->color = color;
+}
+
+/**
+ * Build the scripted triangle sets
+ *   basic   : flat top, flat bottom and generic triangles
+ *   clipped : triangles crossing each screen border
+ *   depth   : interpenetrating triangles
+ *   slivers : thin, tiny and nearly flat triangles
+ *   mesh    : grid of small textured quads with a wavy depth
+ */
+VOID BuildSets(VOID)
+{
+  SAGE_3DElement *element;
+  UWORD column, row;
+  FLOAT x, y, size_x, size_y;
+
+  memset(SetSize, 0, sizeof(SetSize));
+  // Basic
+  AddTriangle(SET_BASIC, 20.0, 10.0, 50.0, 150.0, 10.0, 20.0, 120.0, 110.0, 100.0, TEX_VAMPIRE, 0xff0000);
+  AddTriangle(SET_BASIC, 230.0, 15.0, 10.0, 170.0, 120.0, 10.0, 300.0, 120.0, 30.0, TEX_VAMPIRE, 0x00ff00);
+  AddTriangle(SET_BASIC, 80.0, 125.0, 10.0, 20.0, 235.0, 40.0, 150.0, 190.0, 30.0, TEX_VAMPIRE, 0x0000ff);
+  AddTriangle(SET_BASIC, 240.0, 128.0, 10.0, 170.0, 170.0, 20.0, 310.0, 233.0, 60.0, STEX_USECOLOR, 0xff00ff);
+  // Clipped
+  AddTriangle(SET_CLIPPED, -60.0, 20.0, 20.0, 90.0, 60.0, 40.0, -20.0, 200.0, 30.0, TEX_VAMPIRE, 0xff0000);
+  AddTriangle(SET_CLIPPED, 260.0, 30.0, 20.0, 390.0, 120.0, 40.0, 250.0, 210.0, 30.0, TEX_VAMPIRE, 0x00ff00);
+  AddTriangle(SET_CLIPPED, 100.0, -80.0, 20.0, 220.0, -30.0, 40.0, 160.0, 70.0, 30.0, STEX_USECOLOR, 0x0000ff);
+  AddTriangle(SET_CLIPPED, 110.0, 170.0, 20.0, 230.0, 200.0, 40.0, 140.0, 330.0, 30.0, TEX_VAMPIRE, 0xffff00);
+  AddTriangle(SET_CLIPPED, -200.0, -200.0, 900.0, 600.0, -100.0, 900.0, 100.0, 500.0, 900.0, STEX_USECOLOR, 0x808080);
+  // Depth
+  AddTriangle(SET_DEPTH, 20.0, 20.0, 10.0, 300.0, 60.0, 200.0, 40.0, 220.0, 10.0, TEX_VAMPIRE, 0xff0000);
+  AddTriangle(SET_DEPTH, 300.0, 20.0, 10.0, 20.0, 120.0, 200.0, 280.0, 220.0, 10.0, TEX_VAMPIRE, 0x00ff00);
+  AddTriangle(SET_DEPTH, 160.0, 5.0, 100.0, 60.0, 235.0, 100.0, 260.0, 235.0, 100.0, STEX_USECOLOR, 0x0000ff);
+  element = &(MapperSets[SET_DEPTH][SetSize[SET_DEPTH]++]);
+  element->type = S3DR_ELEM_QUAD;
+  element->x1 = 100.0; element->y1 = 80.0; element->z1 = 50.0; element->u1 = 0.0; element->v1 = 0.0;
+  element->x2 = 220.0; element->y2 = 80.0; element->z2 = 150.0; element->u2 = TEX_WIDTH; element->v2 = 0.0;
+  element->x3 = 220.0; element->y3 = 160.0; element->z3 = 150.0; element->u3 = TEX_WIDTH; element->v3 = TEX_WIDTH;
+  element->x4 = 100.0; element->y4 = 160.0; element->z4 = 50.0; element->u4 = 0.0; element->v4 = TEX_WIDTH;
+  element->texture = TEX_VAMPIRE;
+  element->color = 0xffffff;
+  // Slivers
+  AddTriangle(SET_SLIVERS, 10.0, 10.0, 10.0, 12.0, 10.0, 10.0, 300.0, 230.0, 10.0, TEX_VAMPIRE, 0xff0000);
+  AddTriangle(SET_SLIVERS, 10.0, 200.0, 10.0, 310.0, 201.0, 10.0, 10.0, 202.0, 10.0, TEX_VAMPIRE, 0x00ff00);
+  AddTriangle(SET_SLIVERS, 160.0, 5.0, 10.0, 161.0, 230.0, 10.0, 159.0, 120.0, 10.0, STEX_USECOLOR, 0x0000ff);
+  AddTriangle(SET_SLIVERS, 50.0, 50.0, 10.0, 51.0, 51.0, 10.0, 50.0, 52.0, 10.0, STEX_USECOLOR, 0xffff00);
+  AddTriangle(SET_SLIVERS, 200.0, 60.0, 10.0, 300.0, 61.0, 10.0, 250.0, 140.0, 10.0, TEX_VAMPIRE, 0x00ffff);
+  AddTriangle(SET_SLIVERS, 30.0, 100.0, 10.0, 130.0, 99.0, 10.0, 80.0, 101.0, 10.0, STEX_USECOLOR, 0xff00ff);
+  // Mesh
+  size_x = (FLOAT)SCREEN_WIDTH / MESH_COLUMNS;
+  size_y = (FLOAT)SCREEN_HEIGHT / MESH_ROWS;
+  for (row = 0;row < MESH_ROWS;row++) {
+    for (column = 0;column < MESH_COLUMNS;column++) {
+      x = column * size_x;
+      y = row * size_y;
+      element = &(MapperSets[SET_MESH][SetSize[SET_MESH]++]);
+      element->type = S3DR_ELEM_QUAD;
+      element->x1 = x; element->y1 = y; element->z1 = 100.0 + ((column + row) % 4) * 10.0;
+      element->u1 = 0.0; element->v1 = 0.0;
+      element->x2 = x + size_x; element->y2 = y; element->z2 = 100.0 + ((column + row + 1) % 4) * 10.0;
+      element->u2 = TEX_WIDTH; element->v2 = 0.0;
+      element->x3 = x + size_x; element->y3 = y + size_y; element->z3 = 100.0 + ((column + row + 2) % 4) * 10.0;
+      element->u3 = TEX_WIDTH; element->v3 = TEX_WIDTH;
+      element->x4 = x; element->y4 = y + size_y; element->z4 = 100.0 + ((column + row + 1) % 4) * 10.0;
+      element->u4 = 0.0; element->v4 = TEX_WIDTH;
+      element->texture = TEX_VAMPIRE;
+      element->color = 0xffffff;
+    }
+  }
+}
+
+/**
+ * Render a set in the back bitmap
+ */
+VOID RenderSet(UWORD set)
+{
+  UWORD index;
+
+  SAGE_ClearScreen();
+  for (index = 0;index < SetSize[set];index++) {
+    SAGE_Push3DElement(&(MapperSets[set][index]));
+  }
+  SAGE_Render3DElements();
+}
+
+/**
+ * Count the pixels mapped by each set, every element is drawn alone
+ */
+VOID CountPixels(VOID)
+{
+  SAGE_Bitmap *bitmap;
+  SAGE_3DElement element;
+  UBYTE *pixels;
+  ULONG x, y, bpp;
+  UWORD set, index;
+
+  bitmap = SAGE_GetBackBitmap();
+  bpp = bitmap->depth / 8;
+  for (set = 0;set < SET_COUNT;set++) {
+    SetPixels[set] = 0;
+    for (index = 0;index < SetSize[set];index++) {
+      SAGE_ClearScreen();
+      element = MapperSets[set][index];
+      element.texture = STEX_USECOLOR;
+      element.color = 0x0000ff;
+      SAGE_Push3DElement(&element);
+      SAGE_Render3DElements();
+      for (y = 0;y < bitmap->height;y++) {
+        pixels = (UBYTE *)bitmap->bitmap_buffer + (y * bitmap->bpr);
+        for (x = 0;x < bitmap->width * bpp;x += bpp) {
+          if (pixels[x] != 0 || pixels[x + bpp - 1] != 0) {
+            SetPixels[set]++;
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Copy the back bitmap into a frame
+ */
+VOID CopyFrame(SAGE_Bitmap *bitmap, UBYTE *frame)
+{
+  ULONG y, row;
+
+  row = bitmap->width * (bitmap->depth / 8);
+  for (y = 0;y < bitmap->height;y++) {
+    memcpy(frame + (y * row), (UBYTE *)bitmap->bitmap_buffer + (y * bitmap->bpr), row);
+  }
+}
+
+/**
+ * Compare the back bitmap with a frame and return the number of different pixels
+ */
+ULONG CompareFrame(SAGE_Bitmap *bitmap, UBYTE *frame, STRPTR name, UWORD set)
+{
+  ULONG x, y, row, bpp, differences;
+  UBYTE *pixels;
+
+  bpp = bitmap->depth / 8;
+  row = bitmap->width * bpp;
+  differences = 0;
+  for (y = 0;y < bitmap->height;y++) {
+    pixels = (UBYTE *)bitmap->bitmap_buffer + (y * bitmap->bpr);
+    for (x = 0;x < row;x += bpp) {
+      if (memcmp(pixels + x, frame + (y * row) + x, bpp) != 0) {
+        if (differences == 0) {
+          SAGE_AppliLog("  %s : first difference of set %s at %d,%d", name, SetNames[set], x / bpp, y);
+        }
+        differences++;
+      }
+    }
+  }
+  return differences;
+}
+
+/**
+ * Load or save the golden images of all sets
+ */
+BOOL GoldenFile(STRPTR filename, UBYTE *golden, ULONG size, BOOL save)
+{
+  BPTR fdesc;
+  LONG bytes;
+
+  if ((fdesc = Open(filename, (save ? MODE_NEWFILE : MODE_OLDFILE))) == 0) {
+    return FALSE;
+  }
+  if (save) {
+    bytes = Write(fdesc, golden, size);
+  } else {
+    bytes = Read(fdesc, golden, size);
+  }
+  Close(fdesc);
+  return (BOOL)(bytes == size);
+}
+
+/**
+ * Render all sets and return the elapsed time in microseconds
+ */
+ULONG BenchSets(SAGE_Timer *timer)
+{
+  ULONG elapsed_time, total_time;
+  UWORD loop, set;
+
+  total_time = 0;
+  for (loop = 0;loop < BENCH_LOOPS;loop++) {
+    for (set = 0;set < SET_COUNT;set++) {
+      SAGE_ElapsedTime(timer);
+      RenderSet(set);
+      elapsed_time = SAGE_ElapsedTime(timer);
+      total_time += SAGE_TimeToMicroseconds(elapsed_time);
+    }
+  }
+  return total_time;
+}
+
+/**
+ * Log a mapping rate in Mpixels/s
+ */
+VOID LogRate(STRPTR name, ULONG pixels, ULONG micros)
+{
+  ULONG rate;
+
+  rate = 0;
+  if (micros >= 100) {
+    rate = pixels / (micros / 100);
+  }
+  SAGE_AppliLog("  %s : %d pixels in %d ms, %d.%02d Mpixels/s", name, pixels, micros / 1000, rate / 100, rate % 100);
+}
+
+/**
+ * Check the fast mappers against the reference mappers and golden images
+ * Usage : render3d_3dmapper DEPTH MODE
+ *  with DEPTH = 8 or 16
+ *  and MODE = CHECK (compare with golden images), SAVE (save the reference
+ *  mappers output as golden images) or BENCH (Mpixels/s of each mapper,
+ *  perspective mappers included)
+ */
+void main(int argc, char **argv)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Bitmap *bitmap;
+  SAGE_Timer *timer;
+  UBYTE *reference = NULL, *golden = NULL;
+  UBYTE filename[32];
+  ULONG frame_size, differences, errors, pixels, fast_time, reference_time, perspective_time;
+  LONG depth = 16, mode = MODE_CHECK;
+  UWORD set;
+  BOOL zbuffer, has_golden = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library 3D test (3DMAPPER) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("usage : render3d_3dmapper DEPTH MODE");
+  if (SAGE_Init(SMOD_VIDEO|SMOD_3D)) {
+    SAGE_AppliLog("Initialization successfull");
+    if (argc >= 2 && strcmp(argv[1], "8") == 0) {
+      depth = 8;
+    }
+    if (argc >= 3) {
+      if (strcmp(argv[2], "SAVE") == 0) {
+        mode = MODE_SAVE;
+      } else if (strcmp(argv[2], "BENCH") == 0) {
+        mode = MODE_BENCH;
+      }
+    }
+    SAGE_AppliLog("User parameters DEPTH=%d, MODE=%d", depth, mode);
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, depth, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_Set3DRenderSystem(S3DD_S3DRENDER);
+      SAGE_Set3DRenderMode(S3DR_RENDER_TEXT);
+      SAGE_AppliLog("Load and create texture");
+      if (depth == 8) {
+        picture = SAGE_LoadPicture("data/testtex.gif");
+        if (picture != NULL) {
+          SAGE_LoadPictureColorMap(picture);
+          SAGE_RefreshColors(0, 256);
+        }
+      } else {
+        picture = SAGE_LoadPicture("data/testtex.png");
+      }
+      if (picture != NULL && SAGE_CreateTextureFromPicture(TEX_VAMPIRE, 0, 0, STEX_FULLSIZE, picture) && SAGE_AddTexture(TEX_VAMPIRE)) {
+        bitmap = SAGE_GetBackBitmap();
+        frame_size = bitmap->width * bitmap->height * (bitmap->depth / 8);
+        reference = (UBYTE *) SAGE_AllocMem(frame_size);
+        golden = (UBYTE *) SAGE_AllocMem(frame_size * SET_COUNT);
+        timer = SAGE_AllocTimer();
+        if (reference != NULL && golden != NULL && timer != NULL) {
+          BuildSets();
+          sprintf(filename, "data/mapper%d.golden", depth);
+          if (mode == MODE_SAVE) {
+            SAGE_AppliLog("Render the golden images with the reference mappers");
+            SAGE_EnableZBuffer(TRUE);
+            SAGE_EnableReferenceMappers(TRUE);
+            for (set = 0;set < SET_COUNT;set++) {
+              RenderSet(set);
+              CopyFrame(SAGE_GetBackBitmap(), golden + (set * frame_size));
+              SAGE_RefreshScreen();
+            }
+            if (GoldenFile(filename, golden, frame_size * SET_COUNT, TRUE)) {
+              SAGE_AppliLog("Golden images saved to %s", filename);
+            } else {
+              SAGE_ErrorLog("Can't save golden images to %s !", filename);
+            }
+          } else if (mode == MODE_CHECK) {
+            has_golden = GoldenFile(filename, golden, frame_size * SET_COUNT, FALSE);
+            if (!has_golden) {
+              SAGE_ErrorLog("No golden images in %s, run with SAVE first !", filename);
+            }
+            errors = 0;
+            for (zbuffer = 0;zbuffer < 2;zbuffer++) {
+              SAGE_EnableZBuffer(zbuffer);
+              SAGE_AppliLog("Checking mappers with Z buffer %s", (zbuffer ? "on" : "off"));
+              for (set = 0;set < SET_COUNT;set++) {
+                SAGE_EnableReferenceMappers(TRUE);
+                RenderSet(set);
+                CopyFrame(SAGE_GetBackBitmap(), reference);
+                if (has_golden && zbuffer) {
+                  differences = CompareFrame(SAGE_GetBackBitmap(), golden + (set * frame_size), "reference", set);
+                  SAGE_AppliLog(" Set %s : reference mappers %d pixels different from golden image", SetNames[set], differences);
+                  errors += differences;
+                }
+                SAGE_EnableReferenceMappers(FALSE);
+                RenderSet(set);
+                differences = CompareFrame(SAGE_GetBackBitmap(), reference, "fast", set);
+                SAGE_AppliLog(" Set %s : fast mappers %d pixels different from reference mappers", SetNames[set], differences);
+                errors += differences;
+                SAGE_RefreshScreen();
+              }
+            }
+            if (errors > 0) {
+              SAGE_ErrorLog("%d pixels don't match !", errors);
+            } else if (!has_golden) {
+              SAGE_ErrorLog("Mappers match each other but were not checked against golden images !");
+            } else {
+              SAGE_AppliLog("All mappers match !");
+            }
+          } else {
+            SAGE_AppliLog("Count the mapped pixels");
+            SAGE_EnableZBuffer(FALSE);
+            CountPixels();
+            pixels = 0;
+            for (set = 0;set < SET_COUNT;set++) {
+              SAGE_AppliLog(" Set %s : %d elements, %d pixels", SetNames[set], SetSize[set], SetPixels[set]);
+              pixels += SetPixels[set];
+            }
+            pixels *= BENCH_LOOPS;
+            for (zbuffer = 0;zbuffer < 2;zbuffer++) {
+              SAGE_EnableZBuffer(zbuffer);
+              SAGE_AppliLog("Rendering all sets %d times with Z buffer %s", BENCH_LOOPS, (zbuffer ? "on (including clear)" : "off"));
+              SAGE_EnableReferenceMappers(FALSE);
+              fast_time = BenchSets(timer);
+              SAGE_EnableReferenceMappers(TRUE);
+              reference_time = BenchSets(timer);
+              SAGE_EnablePerspective(TRUE);
+              perspective_time = BenchSets(timer);
+              SAGE_EnablePerspective(FALSE);
+              LogRate("fast mappers", pixels, fast_time);
+              LogRate("reference mappers", pixels, reference_time);
+              LogRate("perspective mappers", pixels, perspective_time);
+            }
+          }
+          SAGE_EnableReferenceMappers(FALSE);
+        } else {
+          SAGE_DisplayError();
+        }
+        if (timer != NULL) {
+          SAGE_ReleaseTimer(timer);
+        }
+        if (golden != NULL) {
+          SAGE_FreeMem(golden);
+        }
+        if (reference != NULL) {
+          SAGE_FreeMem(reference);
+        }
+      } else {
+        SAGE_ErrorLog("Can't create the texture !");
+        SAGE_DisplayError();
+      }
+      if (picture != NULL) {
+        SAGE_ReleasePicture(picture);
+      }
+      SAGE_ReleaseTexture(TEX_VAMPIRE);
+      SAGE_ShowMouse();
+      SAGE_CloseScreen();
+    }
+  } else {
+    SAGE_DisplayError();
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
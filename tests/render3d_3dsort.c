@@ -0,0 +1,203 @@
+/**
+ * render3d_3dsort.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Benchmark the rendering queue sort (quick sort, radix sort and coherent sort)
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <sage/sage.h>
+
+#define QUEUE_RANDOM          0
+#define QUEUE_MESH            1
+#define QUEUE_COHERENT        2
+#define QUEUE_TYPES           3
+
+#define QUEUE_SIZE            S3DR_MAX_ELEMENTS
+#define BENCH_LOOPS           20
+
+#define MESH_RINGS            64
+#define MESH_SEGMENTS         128
+#define MESH_RADIUS           100.0
+#define MESH_DISTANCE         400.0
+
+#define CULL_STEP             50
+
+// Quick sort is recursive and may go very deep on nearly sorted queues
+extern long int __stack = 262144;
+
+STRPTR QueueNames[QUEUE_TYPES] = { "random", "mesh", "coherent" };
+
+FLOAT QueueDepth[QUEUE_SIZE];
+
+/**
+ * Fill the depth table with a type of queue
+ *   random   : random depth between near and far plane
+ *   mesh     : quad centers of a rotated sphere, in mesh order (as the engine pushes them)
+ *   coherent : previous frame order with a small jitter
+ */
+VOID BuildQueue(UWORD type, UWORD loop)
+{
+  UWORD index, ring, segment;
+  DOUBLE theta, phi, x, z, angle;
+
+  for (index = 0;index < QUEUE_SIZE;index++) {
+    switch (type) {
+      case QUEUE_RANDOM:
+        QueueDepth[index] = (FLOAT)(10.0 + (rand() % 99000) / 100.0);
+        break;
+      case QUEUE_MESH:
+        ring = (index / MESH_SEGMENTS) % MESH_RINGS;
+        segment = index % MESH_SEGMENTS;
+        angle = (DOUBLE)loop * PI / 180.0;
+        theta = PI * ((DOUBLE)ring + 0.5) / (DOUBLE)MESH_RINGS;
+        phi = 2.0 * PI * ((DOUBLE)segment + 0.5) / (DOUBLE)MESH_SEGMENTS;
+        x = MESH_RADIUS * sin(theta) * cos(phi);
+        z = MESH_RADIUS * sin(theta) * sin(phi);
+        QueueDepth[index] = (FLOAT)(MESH_DISTANCE + x * sin(angle) + z * cos(angle));
+        break;
+      default:
+        QueueDepth[index] = (FLOAT)(1000.0 - index * 0.1 + (rand() % 100) / 200.0);
+        break;
+    }
+  }
+}
+
+/**
+ * Push the depth table as points in the rendering queue
+ */
+VOID PushQueue(VOID)
+{
+  SAGE_3DElement element;
+  UWORD index;
+
+  SAGE_Flush3DElements();
+  element.type = S3DR_ELEM_POINT;
+  element.texture = STEX_USECOLOR;
+  element.color = 0xffffff;
+  element.x1 = 0.0;
+  element.y1 = 0.0;
+  for (index = 0;index < QUEUE_SIZE;index++) {
+    element.z1 = QueueDepth[index];
+    SAGE_Push3DElement(&element);
+  }
+}
+
+/**
+ * Push the depth table with a key for each element, skip one element out of
+ * step to simulate culled faces (no culling when step is 0)
+ */
+VOID PushKeyedQueue(UWORD step)
+{
+  SAGE_3DElement element;
+  UWORD index;
+
+  SAGE_Flush3DElements();
+  element.type = S3DR_ELEM_POINT;
+  element.texture = STEX_USECOLOR;
+  element.color = 0xffffff;
+  element.x1 = 0.0;
+  element.y1 = 0.0;
+  for (index = 0;index < QUEUE_SIZE;index++) {
+    if (step == 0 || (index % step) != 0) {
+      element.z1 = QueueDepth[index];
+      SAGE_Set3DElementKey(index);
+      SAGE_Push3DElement(&element);
+    }
+  }
+}
+
+/**
+ * Check that the coherent sort keeps its history when faces are culled
+ */
+VOID CheckCulledFaces(VOID)
+{
+  ULONG culled;
+
+  culled = (QUEUE_SIZE + CULL_STEP - 1) / CULL_STEP;
+  SAGE_EnableCoherentSort(TRUE);
+  BuildQueue(QUEUE_MESH, 0);
+  PushKeyedQueue(0);
+  SAGE_Sort3DElements(FALSE);
+  PushKeyedQueue(CULL_STEP);
+  SAGE_Sort3DElements(FALSE);
+  SAGE_AppliLog("Coherent sort with %d culled faces : %d moved elements (0 expected)", culled, SAGE_GetMoved3DElements());
+  PushKeyedQueue(0);
+  SAGE_Sort3DElements(FALSE);
+  SAGE_AppliLog("Coherent sort with %d faces back : %d moved elements (%d expected)", culled, SAGE_GetMoved3DElements(), culled);
+  SAGE_Flush3DElements();
+  SAGE_EnableCoherentSort(FALSE);
+}
+
+/**
+ * Sort some queues and return the elapsed time in milliseconds
+ */
+ULONG SortQueues(SAGE_Timer *timer, UWORD type, BOOL ascending)
+{
+  UWORD loop;
+  ULONG elapsed_time, total_time;
+
+  total_time = 0;
+  for (loop = 0;loop < BENCH_LOOPS;loop++) {
+    BuildQueue(type, loop);
+    PushQueue();
+    SAGE_ElapsedTime(timer);
+    SAGE_Sort3DElements(ascending);
+    elapsed_time = SAGE_ElapsedTime(timer);
+    total_time += SAGE_TimeToMicroseconds(elapsed_time);
+  }
+  SAGE_Flush3DElements();
+  return total_time / 1000;
+}
+
+void main(void)
+{
+  SAGE_Timer *timer;
+  ULONG quick_time, radix_time, coherent_time;
+  UWORD type;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library 3D test (3DSORT) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO|SMOD_3D)) {
+    SAGE_AppliLog("Initialization successfull");
+    if ((timer = SAGE_AllocTimer()) != NULL) {
+      SAGE_AppliLog("Sorting %d queues of %d elements for each mode", BENCH_LOOPS, QUEUE_SIZE);
+      for (type = 0;type < QUEUE_TYPES;type++) {
+        srand(1);
+        SAGE_EnableRadixSort(FALSE);
+        quick_time = SortQueues(timer, type, FALSE);
+        srand(1);
+        SAGE_EnableRadixSort(TRUE);
+        radix_time = SortQueues(timer, type, FALSE);
+        SAGE_AppliLog("Queue %s (descending) : quick sort %d ms  radix sort %d ms", QueueNames[type], quick_time, radix_time);
+        srand(1);
+        SAGE_EnableRadixSort(FALSE);
+        quick_time = SortQueues(timer, type, TRUE);
+        srand(1);
+        SAGE_EnableRadixSort(TRUE);
+        radix_time = SortQueues(timer, type, TRUE);
+        SAGE_AppliLog("Queue %s (ascending) : quick sort %d ms  radix sort %d ms", QueueNames[type], quick_time, radix_time);
+        srand(1);
+        SAGE_EnableCoherentSort(TRUE);
+        coherent_time = SortQueues(timer, type, FALSE);
+        SAGE_AppliLog("Queue %s (descending) : coherent sort %d ms  last moved elements %d", QueueNames[type], coherent_time, SAGE_GetMoved3DElements());
+        SAGE_EnableCoherentSort(FALSE);
+      }
+      SAGE_EnableRadixSort(FALSE);
+      CheckCulledFaces();
+      SAGE_ReleaseTimer(timer);
+    } else {
+      SAGE_DisplayError();
+    }
+  } else {
+    SAGE_DisplayError();
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -5,7 +5,7 @@
  * Test SAGE texture mapper
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 26/02/2025)
+ * @version 25.1 February 2025 (updated: 24/06/2025)
  */
 
 #include <sage/sage.h>
@@ -192,7 +192,7 @@ void main(int argc, char **argv)
   SAGE_Event *event = NULL;
   SAGE_Picture *picture = NULL;
   LONG depth = 16, render = S3DD_S3DRENDER;
-  BOOL finish = FALSE;
+  BOOL finish = FALSE, perspective = FALSE;
 
   SAGE_AppliLog("--------------------------------------------------------------------------------");
   SAGE_AppliLog("    SAGE library 3D test (3DTRIANGLE) / %s", SAGE_GetVersion());
@@ -303,6 +303,10 @@ void main(int argc, char **argv)
                 case SKEY_FR_F7:
                   SAGE_Set3DRenderMode(S3DR_RENDER_TEXT);
                   break;
+                case SKEY_FR_P:
+                  SAGE_AppliLog("Change perspective correction mode");
+                  perspective = SAGE_EnablePerspective(!perspective);
+                  break;
               }
             }
           }
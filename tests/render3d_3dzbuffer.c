@@ -5,7 +5,7 @@
  * Test 3D Z buffer
  * 
  * @author Fabrice Labrador <fabrice.labrador@gmail.com>
- * @version 25.1 February 2025 (updated: 26/02/2025)
+ * @version 25.1 February 2025 (updated: 22/06/2025)
  */
 
 #include <sage/sage.h>
@@ -86,7 +86,7 @@ void main(int argc, char **argv)
   SAGE_Event *event = NULL;
   SAGE_Picture *picture = NULL;
   LONG depth = 16, render = S3DD_S3DRENDER;
-  BOOL finish = FALSE, zbuffer = TRUE;
+  BOOL finish = FALSE, zbuffer = TRUE, hizbuffer = FALSE, lazyzbuffer = FALSE;
 
   SAGE_AppliLog("--------------------------------------------------------------------------------");
   SAGE_AppliLog("    SAGE library 3D test (3DTRIANGLE) / %s", SAGE_GetVersion());
@@ -139,6 +139,14 @@ void main(int argc, char **argv)
                       if (zbuffer) zbuffer = FALSE; else zbuffer = TRUE;
                       SAGE_EnableZBuffer(zbuffer);
                       break;
+                    case SKEY_FR_H:
+                      SAGE_AppliLog("Change Hi-Z buffer mode (last frame rejected %d triangles and %d tiles)", SAGE_GetRejected3DTriangles(), SAGE_GetRejected3DTiles());
+                      hizbuffer = SAGE_EnableHiZBuffer(!hizbuffer);
+                      break;
+                    case SKEY_FR_L:
+                      SAGE_AppliLog("Change lazy Z buffer mode (last frame cleared %d tiles)", SAGE_GetCleared3DTiles());
+                      lazyzbuffer = SAGE_EnableLazyZBuffer(!lazyzbuffer);
+                      break;
                     case SKEY_FR_D:
                       SAGE_SetTraceDebug(TRUE);
                       break;
@@ -0,0 +1,224 @@
+/**
+ * video_batch.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test sprite batch
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define SPR_TRANSP            0xFF00FF
+#define SPR_BANK              0
+#define SPR_BULLET            0
+#define SPR_TROLL             1
+#define SPR_FLIPPED           2
+#define NB_SPRITES            3
+
+#define NB_BULLETS            320
+#define BENCH_FRAMES          200
+
+/** Moving bullet */
+typedef struct {
+  LONG x, y, dx, dy;
+} Bullet;
+
+Bullet bullets[NB_BULLETS];
+
+/**
+ * Spread the bullets over and around the screen
+ */
+VOID InitBullets(VOID)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < NB_BULLETS;idx++) {
+    bullets[idx].x = ((idx * 97) % (SCREEN_WIDTH + 64)) - 32;
+    bullets[idx].y = ((idx * 61) % (SCREEN_HEIGHT + 64)) - 32;
+    bullets[idx].dx = (idx % 7) - 3;
+    bullets[idx].dy = (idx % 5) - 2;
+  }
+}
+
+/**
+ * Move the bullets and wrap them around the screen
+ */
+VOID MoveBullets(VOID)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < NB_BULLETS;idx++) {
+    bullets[idx].x += bullets[idx].dx;
+    if (bullets[idx].x < -32) {
+      bullets[idx].x = SCREEN_WIDTH + 31;
+    } else if (bullets[idx].x >= (SCREEN_WIDTH + 32)) {
+      bullets[idx].x = -32;
+    }
+    bullets[idx].y += bullets[idx].dy;
+    if (bullets[idx].y < -32) {
+      bullets[idx].y = SCREEN_HEIGHT + 31;
+    } else if (bullets[idx].y >= (SCREEN_HEIGHT + 32)) {
+      bullets[idx].y = -32;
+    }
+  }
+}
+
+/**
+ * Draw a frame with one call per sprite or with the batch and return the
+ * drawing time in microseconds
+ */
+ULONG DrawFrame(SAGE_Timer *timer, BOOL batched)
+{
+  ULONG elapsed_time;
+  UWORD idx;
+
+  SAGE_ClearScreen();
+  SAGE_ElapsedTime(timer);
+  if (batched) {
+    // The troll is queued first but drawn over the bullets
+    SAGE_AddSpriteToBatch(SPR_BANK, SPR_TROLL, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 1);
+    for (idx = 0;idx < NB_BULLETS;idx++) {
+      SAGE_AddSpriteToBatch(SPR_BANK, SPR_BULLET, bullets[idx].x, bullets[idx].y, 0);
+    }
+    SAGE_FlushSpriteBatch();
+  } else {
+    for (idx = 0;idx < NB_BULLETS;idx++) {
+      SAGE_BlitSpriteToScreen(SPR_BANK, SPR_BULLET, bullets[idx].x, bullets[idx].y);
+    }
+    SAGE_BlitSpriteToScreen(SPR_BANK, SPR_TROLL, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+  }
+  elapsed_time = SAGE_ElapsedTime(timer);
+  return SAGE_TimeToMicroseconds(elapsed_time);
+}
+
+/**
+ * Queue a flipped troll between two bullets and compare the batch with the
+ * same sprites drawn one by one, the bullet queued after the flipped sprite
+ * must be drawn too
+ */
+BOOL CheckFlippedSprite(VOID)
+{
+  SAGE_Bitmap *back_bitmap;
+  UBYTE *copy;
+  ULONG size;
+  BOOL success = FALSE;
+
+  back_bitmap = SAGE_GetBackBitmap();
+  size = back_bitmap->bpr * back_bitmap->height;
+  if ((copy = (UBYTE *)SAGE_AllocMem(size)) == NULL) {
+    SAGE_DisplayError();
+    return FALSE;
+  }
+  SAGE_ClearScreen();
+  SAGE_AddSpriteToBatch(SPR_BANK, SPR_BULLET, 100, 100, 0);
+  SAGE_AddSpriteToBatch(SPR_BANK, SPR_FLIPPED, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 0);
+  SAGE_AddSpriteToBatch(SPR_BANK, SPR_BULLET, SCREEN_WIDTH - 100, SCREEN_HEIGHT - 100, 0);
+  if (SAGE_FlushSpriteBatch()) {
+    memcpy(copy, back_bitmap->bitmap_buffer, size);
+    SAGE_ClearScreen();
+    SAGE_BlitSpriteToScreen(SPR_BANK, SPR_BULLET, 100, 100);
+    SAGE_BlitSpriteToScreen(SPR_BANK, SPR_FLIPPED, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    SAGE_BlitSpriteToScreen(SPR_BANK, SPR_BULLET, SCREEN_WIDTH - 100, SCREEN_HEIGHT - 100);
+    success = (BOOL)(memcmp(copy, back_bitmap->bitmap_buffer, size) == 0);
+  } else {
+    SAGE_DisplayError();
+  }
+  SAGE_FreeMem(copy);
+  SAGE_AppliLog("Flipped sprite in the middle of the batch : %s", success ? "OK" : "FAILED");
+  return success;
+}
+
+/**
+ * Draw the same bullets with SAGE_BlitSpriteToScreen then with the sprite
+ * batch and compare the drawing times
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Event *event = NULL;
+  SAGE_Timer *timer = NULL;
+  ULONG times[2];
+  UWORD frame, mode;
+  BOOL finish = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (BATCH) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_AppliLog("Load sprite picture and create sprite bank");
+      if ((picture = SAGE_LoadPicture("data/troll_sprite.gif")) != NULL) {
+        SAGE_LoadPictureColorMap(picture);
+        SAGE_RefreshColors(0, 256);
+        if (SAGE_CreateSpriteBank(SPR_BANK, NB_SPRITES, picture)) {
+          SAGE_SetSpriteBankTransparency(SPR_BANK, SPR_TRANSP);
+          if (!SAGE_AddSpriteToBank(SPR_BANK, SPR_BULLET, 30, 30, 16, 16, SSPR_HS_MIDDLE)
+              || !SAGE_AddSpriteToBank(SPR_BANK, SPR_TROLL, 6, 4, 96, 112, SSPR_HS_MIDDLE)
+              || !SAGE_AddSpriteToBank(SPR_BANK, SPR_FLIPPED, 6, 4, 96, 112, SSPR_HS_MIDDLE)
+              || !SAGE_SetSpriteFlipping(SPR_BANK, SPR_FLIPPED, TRUE, FALSE)) {
+            finish = TRUE;
+            SAGE_DisplayError();
+          }
+        } else {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        SAGE_ReleasePicture(picture);
+      } else {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      if (!SAGE_CreateSpriteBatch(NB_BULLETS + 1) || (timer = SAGE_AllocTimer()) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      if (!finish) {
+        CheckFlippedSprite();
+      }
+      InitBullets();
+      for (mode = 0;mode < 2 && !finish;mode++) {
+        SAGE_AppliLog("Drawing %d sprites %d times %s", NB_BULLETS + 1, BENCH_FRAMES, mode ? "with the batch" : "one by one");
+        times[mode] = 0;
+        for (frame = 0;frame < BENCH_FRAMES && !finish;frame++) {
+          while ((event = SAGE_GetEvent()) != NULL) {
+            if (event->type == SEVT_RAWKEY && event->code == SKEY_FR_ESC) {
+              SAGE_AppliLog("Exit loop");
+              finish = TRUE;
+            }
+          }
+          times[mode] += DrawFrame(timer, (BOOL)mode);
+          MoveBullets();
+          if (!SAGE_RefreshScreen()) {
+            finish = TRUE;
+            SAGE_DisplayError();
+          }
+        }
+        SAGE_AppliLog("  %d us per frame", times[mode] / BENCH_FRAMES);
+      }
+      if (!finish && times[1] > 0) {
+        SAGE_AppliLog("Batch is %d.%02d times faster", times[0] / times[1], ((times[0] % times[1]) * 100) / times[1]);
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      SAGE_AppliLog("Release sprites");
+      SAGE_ReleaseSpriteBatch();
+      SAGE_ReleaseSpriteBank(SPR_BANK);
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
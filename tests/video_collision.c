@@ -0,0 +1,173 @@
+/**
+ * video_collision.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test sprite collision world
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdlib.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define SPR_TRANSP            0xFF00FF
+#define SPR_BANK              0
+#define SPR_BULLET            0
+#define SPR_TROLL             1
+#define SPR_BOX               2
+#define NB_SPRITES            3
+
+#define NB_OBJECTS            2000
+#define MAX_PAIRS             8000
+#define CELL_SIZE             32
+#define BENCH_FRAMES          10
+
+#define LAYER_PLAYER          1
+#define LAYER_ENEMY           2
+
+LONG xpos[NB_OBJECTS], ypos[NB_OBJECTS];
+WORD objects[NB_OBJECTS];
+
+/**
+ * Count the colliding pairs with SAGE_SpriteCollide on every pair, odd
+ * objects are players and only collide with enemies
+ */
+ULONG BruteForce(VOID)
+{
+  ULONG count = 0;
+  UWORD obj1, obj2;
+
+  for (obj1 = 0;obj1 < NB_OBJECTS;obj1++) {
+    for (obj2 = obj1 + 1;obj2 < NB_OBJECTS;obj2++) {
+      if (((obj1 & 1) == 0 || (obj2 & 1) == 0)
+          && SAGE_SpriteCollide(SPR_BANK, (obj1 % 7) ? SPR_BULLET : SPR_TROLL, xpos[obj1], ypos[obj1], SPR_BANK, (obj2 % 7) ? SPR_BULLET : SPR_TROLL, xpos[obj2], ypos[obj2])) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * Check that two sprites without mask collide when their boxes touch each
+ * other on a cell border, like SAGE_BoxCollide, and not one pixel further
+ */
+VOID CheckTouchingBoxes(VOID)
+{
+  SAGE_CollisionWorld *boxes;
+  SAGE_Sprite *sprite;
+  WORD box1, box2;
+  ULONG touching, apart;
+
+  if ((boxes = SAGE_CreateCollisionWorld(2, 4, CELL_SIZE)) != NULL) {
+    sprite = SAGE_GetSprite(SPR_BANK, SPR_BOX);
+    box1 = SAGE_AddCollisionObject(boxes, SPR_BANK, SPR_BOX, LAYER_ENEMY, LAYER_ENEMY);
+    box2 = SAGE_AddCollisionObject(boxes, SPR_BANK, SPR_BOX, LAYER_ENEMY, LAYER_ENEMY);
+    // First box ends at the last pixel of a cell, second box starts in the next cell
+    SAGE_MoveCollisionObject(boxes, box1, CELL_SIZE - sprite->width + sprite->hs_x, sprite->hs_y);
+    SAGE_MoveCollisionObject(boxes, box2, CELL_SIZE + sprite->hs_x, sprite->hs_y);
+    SAGE_FindCollisions(boxes);
+    touching = SAGE_GetNbCollisions(boxes);
+    SAGE_MoveCollisionObject(boxes, box2, CELL_SIZE + 1 + sprite->hs_x, sprite->hs_y);
+    SAGE_FindCollisions(boxes);
+    apart = SAGE_GetNbCollisions(boxes);
+    if (touching == 1 && apart == 0) {
+      SAGE_AppliLog("Touching boxes collide !");
+    } else {
+      SAGE_ErrorLog("Touching boxes : %d pairs (1 expected), apart boxes : %d pairs (0 expected)", touching, apart);
+    }
+    SAGE_ReleaseCollisionWorld(boxes);
+  } else {
+    SAGE_DisplayError();
+  }
+}
+
+/**
+ * Find the colliding pairs of NB_OBJECTS sprites with the collision world and
+ * with the brute force loop, then compare the results and the times
+ */
+void main(void)
+{
+  SAGE_CollisionWorld *world = NULL;
+  SAGE_Picture *picture = NULL;
+  SAGE_Timer *timer = NULL;
+  ULONG world_time = 0, brute_time = 0, brute_count, errors = 0;
+  UWORD obj, frame;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (COLLISION) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_AppliLog("Load sprite picture and create sprite bank");
+      if ((picture = SAGE_LoadPicture("data/troll_sprite.gif")) != NULL
+          && SAGE_CreateSpriteBank(SPR_BANK, NB_SPRITES, picture)
+          && SAGE_SetSpriteBankTransparency(SPR_BANK, SPR_TRANSP)
+          && SAGE_SetSpriteBankMasks(SPR_BANK, TRUE)
+          && SAGE_AddSpriteToBank(SPR_BANK, SPR_BULLET, 30, 30, 16, 16, SSPR_HS_MIDDLE)
+          && SAGE_AddSpriteToBank(SPR_BANK, SPR_TROLL, 6, 4, 96, 112, SSPR_HS_MIDDLE)
+          && SAGE_SetSpriteBankMasks(SPR_BANK, FALSE)
+          && SAGE_AddSpriteToBank(SPR_BANK, SPR_BOX, 30, 30, 16, 16, SSPR_HS_MIDDLE)
+          && (world = SAGE_CreateCollisionWorld(NB_OBJECTS, MAX_PAIRS, CELL_SIZE)) != NULL
+          && (timer = SAGE_AllocTimer()) != NULL) {
+        for (obj = 0;obj < NB_OBJECTS;obj++) {
+          if (obj & 1) {
+            objects[obj] = SAGE_AddCollisionObject(world, SPR_BANK, (obj % 7) ? SPR_BULLET : SPR_TROLL, LAYER_PLAYER, LAYER_ENEMY);
+          } else {
+            objects[obj] = SAGE_AddCollisionObject(world, SPR_BANK, (obj % 7) ? SPR_BULLET : SPR_TROLL, LAYER_ENEMY, LAYER_PLAYER|LAYER_ENEMY);
+          }
+        }
+        CheckTouchingBoxes();
+        SAGE_AppliLog("Searching collisions of %d objects %d times", NB_OBJECTS, BENCH_FRAMES);
+        for (frame = 0;frame < BENCH_FRAMES;frame++) {
+          for (obj = 0;obj < NB_OBJECTS;obj++) {
+            xpos[obj] = (rand() % (SCREEN_WIDTH * 2)) - 32;
+            ypos[obj] = (rand() % (SCREEN_HEIGHT * 2)) - 32;
+            SAGE_MoveCollisionObject(world, objects[obj], xpos[obj], ypos[obj]);
+          }
+          SAGE_ElapsedTime(timer);
+          if (!SAGE_FindCollisions(world)) {
+            SAGE_DisplayError();
+            break;
+          }
+          world_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+          brute_count = BruteForce();
+          brute_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+          if (brute_count != SAGE_GetNbCollisions(world)) {
+            SAGE_ErrorLog("Frame %d : world found %d pairs, brute force found %d pairs", frame, SAGE_GetNbCollisions(world), brute_count);
+            errors++;
+          }
+        }
+        if (errors == 0) {
+          SAGE_AppliLog("Pairs match !");
+        }
+        SAGE_AppliLog("  Collision world : %d us per frame", world_time / BENCH_FRAMES);
+        SAGE_AppliLog("  Brute force     : %d us per frame", brute_time / BENCH_FRAMES);
+        if (world_time > 0) {
+          SAGE_AppliLog("  World is %d times faster", brute_time / world_time);
+        }
+      } else {
+        SAGE_DisplayError();
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      SAGE_ReleaseCollisionWorld(world);
+      if (picture != NULL) {
+        SAGE_ReleasePicture(picture);
+      }
+      SAGE_ReleaseSpriteBank(SPR_BANK);
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -0,0 +1,185 @@
+/**
+ * video_dirty.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test dirty rectangles
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define NB_SPRITES            6
+#define NB_MOVERS             8
+#define SPR_TRANSP            0xFF00FF
+#define SPR_DELAY             10
+#define SPR_BANK              0
+#define SPR_WIDTH             100
+#define SPR_HEIGHT            112
+
+ULONG sprites[NB_SPRITES*4] = {
+  6,4,96,112,
+  108,4,80,112,
+  190,4,80,112,
+  278,4,96,112,
+  380,4,80,112,
+  470,4,80,112
+};
+
+/** Moving sprite */
+typedef struct {
+  LONG x, y, dx, dy;
+} Mover;
+
+Mover movers[NB_MOVERS];
+
+/**
+ * Spread the sprites over the screen
+ */
+VOID InitMovers(VOID)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < NB_MOVERS;idx++) {
+    movers[idx].x = (idx * 71) % (SCREEN_WIDTH - SPR_WIDTH);
+    movers[idx].y = (idx * 53) % (SCREEN_HEIGHT - SPR_HEIGHT);
+    movers[idx].dx = (idx & 1) ? 2 : -2;
+    movers[idx].dy = (idx & 2) ? 1 : -1;
+  }
+}
+
+/**
+ * Move the sprites and bounce on the screen borders
+ */
+VOID MoveMovers(VOID)
+{
+  UWORD idx;
+
+  for (idx = 0;idx < NB_MOVERS;idx++) {
+    movers[idx].x += movers[idx].dx;
+    if (movers[idx].x < 0 || movers[idx].x > (SCREEN_WIDTH - SPR_WIDTH)) {
+      movers[idx].dx = -movers[idx].dx;
+      movers[idx].x += movers[idx].dx;
+    }
+    movers[idx].y += movers[idx].dy;
+    if (movers[idx].y < 0 || movers[idx].y > (SCREEN_HEIGHT - SPR_HEIGHT)) {
+      movers[idx].dy = -movers[idx].dy;
+      movers[idx].y += movers[idx].dy;
+    }
+  }
+}
+
+/**
+ * Draw the same static background with moving sprites, press D to switch the
+ * dirty rectangles and compare the frame rates
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Event *event = NULL;
+  UWORD sprite = 0, delay = 0, idx;
+  BOOL finish = FALSE, dirty = TRUE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (DIRTY) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_AppliLog("Load sprite picture and create sprite bank");
+      if ((picture = SAGE_LoadPicture("data/troll_sprite.gif")) != NULL) {
+        SAGE_LoadPictureColorMap(picture);
+        SAGE_RefreshColors(0, 256);
+        if (SAGE_CreateSpriteBank(SPR_BANK, NB_SPRITES, picture)) {
+          SAGE_SetSpriteBankTransparency(SPR_BANK, SPR_TRANSP);
+          for (sprite = 0;sprite < NB_SPRITES;sprite++) {
+            if (!SAGE_AddSpriteToBank(SPR_BANK, sprite, sprites[sprite*4], sprites[sprite*4+1], sprites[sprite*4+2], sprites[sprite*4+3], SSPR_HS_TOPLEFT)) {
+              finish = TRUE;
+              SAGE_DisplayError();
+            }
+          }
+        } else {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        SAGE_ReleasePicture(picture);
+      } else {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      SAGE_AppliLog("Load a picture for the background");
+      if ((picture = SAGE_LoadPicture("data/desert.png")) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      InitMovers();
+      SAGE_EnableDirtyRects(dirty);
+      SAGE_EnableFrameCount(TRUE);
+      SAGE_AppliLog("Dirty rectangles ON, press D to switch");
+      delay = 0;
+      sprite = 0;
+      while (!finish) {
+        if (SAGE_IsFrontMostScreen()) {
+          while ((event = SAGE_GetEvent()) != NULL) {
+            if (event->type == SEVT_RAWKEY) {
+              switch (event->code) {
+                case SKEY_FR_ESC:
+                  SAGE_AppliLog("Exit loop");
+                  finish = TRUE;
+                  break;
+                case SKEY_FR_D:
+                  SAGE_AppliLog("%d fps with dirty rectangles %s", SAGE_GetFps(), dirty ? "ON" : "OFF");
+                  dirty = !dirty;
+                  SAGE_EnableDirtyRects(dirty);
+                  break;
+              }
+            }
+          }
+          // Only the parts damaged by the sprites are restored when the dirty rectangles are on
+          if (!SAGE_BlitPictureToScreen(picture, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, 0)) {
+            SAGE_AppliLog("Error blitting picture !");
+            finish = TRUE;
+            SAGE_DisplayError();
+          }
+          if (++delay >= SPR_DELAY) {
+            delay = 0;
+            if (++sprite >= NB_SPRITES) {
+              sprite = 0;
+            }
+          }
+          for (idx = 0;idx < NB_MOVERS;idx++) {
+            if (!SAGE_BlitSpriteToScreen(SPR_BANK, sprite, movers[idx].x, movers[idx].y)) {
+              SAGE_AppliLog("Error blitting sprite (%d) !", sprite);
+              finish = TRUE;
+              SAGE_DisplayError();
+            }
+          }
+          SAGE_PrintFText(10, 20, "%d fps", SAGE_GetFps());
+          MoveMovers();
+        }
+        if (!SAGE_RefreshScreen()) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+      }
+      SAGE_AppliLog("%d fps with dirty rectangles %s", SAGE_GetFps(), dirty ? "ON" : "OFF");
+      SAGE_EnableFrameCount(FALSE);
+      SAGE_EnableDirtyRects(FALSE);
+      SAGE_AppliLog("Release picture");
+      SAGE_ReleasePicture(picture);
+      SAGE_AppliLog("Release sprites");
+      SAGE_ReleaseSpriteBank(SPR_BANK);
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -0,0 +1,144 @@
+/**
+ * video_mask.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test sprite collision masks
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdlib.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define SPR_TRANSP            0xFF00FF
+#define SPR_BANK              0
+#define SPR_BULLET            0
+#define SPR_TROLL             1
+#define NB_SPRITES            2
+
+#define NB_TESTS              2000
+
+LONG troll_x[NB_TESTS], troll_y[NB_TESTS], bullet_x[NB_TESTS], bullet_y[NB_TESTS];
+
+/**
+ * Check if a pixel of a displayed sprite is not transparent
+ */
+BOOL SolidPixel(SAGE_Bitmap *bitmap, SAGE_Sprite *sprite, LONG x_pos, LONG y_pos)
+{
+  UWORD *pixel;
+
+  if (sprite->horizontal_flip) {
+    x_pos = sprite->width - 1 - x_pos;
+  }
+  if (sprite->vertical_flip) {
+    y_pos = sprite->height - 1 - y_pos;
+  }
+  pixel = (UWORD *)((UBYTE *)bitmap->bitmap_buffer + ((sprite->top + y_pos) * bitmap->bpr)) + sprite->left + x_pos;
+  return (BOOL)(*pixel != (UWORD)bitmap->transparency);
+}
+
+/**
+ * Check the collision of two sprites pixel by pixel
+ */
+BOOL PixelCollide(SAGE_Bitmap *bitmap, SAGE_Sprite *spr1, LONG x1, LONG y1, SAGE_Sprite *spr2, LONG x2, LONG y2)
+{
+  LONG x_pos, y_pos;
+
+  for (y_pos = y1;y_pos < (y1 + (LONG)spr1->height);y_pos++) {
+    for (x_pos = x1;x_pos < (x1 + (LONG)spr1->width);x_pos++) {
+      if (x_pos >= x2 && x_pos < (x2 + (LONG)spr2->width) && y_pos >= y2 && y_pos < (y2 + (LONG)spr2->height)
+          && SolidPixel(bitmap, spr1, x_pos - x1, y_pos - y1) && SolidPixel(bitmap, spr2, x_pos - x2, y_pos - y2)) {
+        return TRUE;
+      }
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * Compare the masks collisions with a pixel by pixel check on random
+ * positions and flippings of the troll and the bullet
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_SpriteBank *bank;
+  SAGE_Sprite *spr1, *spr2;
+  SAGE_Timer *timer = NULL;
+  ULONG mask_time, box_hits = 0, mask_hits = 0, errors = 0;
+  UWORD test;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (MASK) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_AppliLog("Load sprite picture and create sprite bank with masks");
+      if ((picture = SAGE_LoadPicture("data/troll_sprite.gif")) != NULL
+          && SAGE_CreateSpriteBank(SPR_BANK, NB_SPRITES, picture)
+          && SAGE_SetSpriteBankTransparency(SPR_BANK, SPR_TRANSP)
+          && SAGE_SetSpriteBankMasks(SPR_BANK, TRUE)
+          && SAGE_AddSpriteToBank(SPR_BANK, SPR_BULLET, 30, 30, 16, 16, SSPR_HS_TOPLEFT)
+          && SAGE_AddSpriteToBank(SPR_BANK, SPR_TROLL, 6, 4, 96, 112, SSPR_HS_TOPLEFT)
+          && (timer = SAGE_AllocTimer()) != NULL) {
+        bank = SAGE_GetSpriteBank(SPR_BANK);
+        spr1 = SAGE_GetSprite(SPR_BANK, SPR_TROLL);
+        spr2 = SAGE_GetSprite(SPR_BANK, SPR_BULLET);
+        for (test = 0;test < NB_TESTS;test++) {
+          troll_x[test] = rand() % 64;
+          troll_y[test] = rand() % 64;
+          bullet_x[test] = rand() % 160;
+          bullet_y[test] = rand() % 176;
+        }
+        SAGE_AppliLog("Checking %d random positions", NB_TESTS);
+        for (test = 0;test < NB_TESTS;test++) {
+          SAGE_SetSpriteFlipping(SPR_BANK, SPR_TROLL, (BOOL)(test & 1), (BOOL)(test & 2));
+          SAGE_SetSpriteFlipping(SPR_BANK, SPR_BULLET, (BOOL)(test & 4), (BOOL)(test & 8));
+          if (SAGE_MaskCollide(spr1, troll_x[test], troll_y[test], spr2, bullet_x[test], bullet_y[test]) != PixelCollide(bank->bitmap, spr1, troll_x[test], troll_y[test], spr2, bullet_x[test], bullet_y[test])) {
+            SAGE_ErrorLog("Test %d : mask and pixel collisions differ", test);
+            errors++;
+          }
+        }
+        if (errors == 0) {
+          SAGE_AppliLog("Masks match the pixels !");
+        }
+        SAGE_SetSpriteFlipping(SPR_BANK, SPR_TROLL, FALSE, FALSE);
+        SAGE_SetSpriteFlipping(SPR_BANK, SPR_BULLET, FALSE, FALSE);
+        SAGE_ElapsedTime(timer);
+        for (test = 0;test < NB_TESTS;test++) {
+          if (SAGE_MaskCollide(spr1, troll_x[test], troll_y[test], spr2, bullet_x[test], bullet_y[test])) {
+            mask_hits++;
+          }
+        }
+        mask_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (test = 0;test < NB_TESTS;test++) {
+          if (SAGE_BoxCollide(troll_x[test], troll_y[test], spr1->width, spr1->height, bullet_x[test], bullet_y[test], spr2->width, spr2->height)) {
+            box_hits++;
+          }
+        }
+        SAGE_AppliLog("  Box collisions  : %d", box_hits);
+        SAGE_AppliLog("  Mask collisions : %d in %d us", mask_hits, mask_time);
+      } else {
+        SAGE_DisplayError();
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      if (picture != NULL) {
+        SAGE_ReleasePicture(picture);
+      }
+      SAGE_ReleaseSpriteBank(SPR_BANK);
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
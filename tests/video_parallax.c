@@ -0,0 +1,178 @@
+/**
+ * video_parallax.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test parallax compositor
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define LAYER_TRANSP          0xFF00FF
+#define SKY_LAYER             0
+#define NB_BANDS              7
+#define BAND_HEIGHT           96
+#define BAND_STEP             48
+#define NB_LAYERS             (NB_BANDS + 1)
+
+#define BENCH_FRAMES          100
+
+UWORD Reference[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+/**
+ * Draw a sky gradient and hills bands, the top of each band is transparent
+ * with a hill shape and the bottom is opaque
+ */
+BOOL CreateLayers(VOID)
+{
+  SAGE_Bitmap *bitmap;
+  UWORD *pixel, layer, hill;
+  ULONG x_pos, y_pos;
+
+  if (!SAGE_CreateLayer(SKY_LAYER, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+    return FALSE;
+  }
+  bitmap = SAGE_GetLayerBitmap(SKY_LAYER);
+  for (y_pos = 0;y_pos < SCREEN_HEIGHT;y_pos++) {
+    pixel = (UWORD *)((UBYTE *)bitmap->bitmap_buffer + (y_pos * bitmap->bpr));
+    for (x_pos = 0;x_pos < SCREEN_WIDTH;x_pos++) {
+      *pixel++ = (UWORD)(((y_pos * 31) / SCREEN_HEIGHT) | ((x_pos & 32) << 5));
+    }
+  }
+  for (layer = 1;layer <= NB_BANDS;layer++) {
+    if (!SAGE_CreateLayer(layer, SCREEN_WIDTH, BAND_HEIGHT) || !SAGE_SetLayerTransparency(layer, LAYER_TRANSP)) {
+      return FALSE;
+    }
+    bitmap = SAGE_GetLayerBitmap(layer);
+    for (y_pos = 0;y_pos < BAND_HEIGHT;y_pos++) {
+      pixel = (UWORD *)((UBYTE *)bitmap->bitmap_buffer + (y_pos * bitmap->bpr));
+      for (x_pos = 0;x_pos < SCREEN_WIDTH;x_pos++) {
+        // Triangle hills, higher for the front bands
+        hill = (UWORD)((x_pos * (layer + 1)) % 128);
+        hill = (hill > 64) ? 128 - hill : hill;
+        if (y_pos < (BAND_HEIGHT / 2) && y_pos < (BAND_HEIGHT / 2) - (hill / 2)) {
+          *pixel++ = (UWORD)bitmap->transparency;
+        } else {
+          *pixel++ = (UWORD)((layer << 8) | (layer << 2) | (x_pos & 3));
+        }
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Scroll the layers, the front ones faster
+ */
+BOOL ScrollLayers(UWORD frame)
+{
+  UWORD layer;
+
+  if (!SAGE_SetLayerView(SKY_LAYER, frame, 0, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+    return FALSE;
+  }
+  for (layer = 1;layer <= NB_BANDS;layer++) {
+    if (!SAGE_SetLayerView(layer, frame * (layer + 1), 0, SCREEN_WIDTH, BAND_HEIGHT)) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Draw the same parallax with one SAGE_BlitLayerToScreen per layer and with
+ * the compositor, compare the pictures and the times
+ */
+void main(void)
+{
+  SAGE_Parallax *parallax = NULL;
+  SAGE_Event *event = NULL;
+  SAGE_Timer *timer = NULL;
+  SAGE_Bitmap *back;
+  ULONG layers_time = 0, parallax_time = 0, pixels = 0, errors = 0, row;
+  UWORD frame = 0, layer;
+  BOOL finish = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (PARALLAX) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_AppliLog("Create %d layers", NB_LAYERS);
+      if (!CreateLayers() || (parallax = SAGE_CreateParallax(NB_LAYERS)) == NULL || (timer = SAGE_AllocTimer()) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      } else {
+        SAGE_AddParallaxLayer(parallax, SKY_LAYER, 0, 0);
+        for (layer = 1;layer <= NB_BANDS;layer++) {
+          SAGE_AddParallaxLayer(parallax, layer, 0, SCREEN_HEIGHT - BAND_HEIGHT - ((NB_BANDS - layer) * BAND_STEP));
+        }
+      }
+      for (frame = 0;frame < BENCH_FRAMES && !finish;frame++) {
+        while ((event = SAGE_GetEvent()) != NULL) {
+          if (event->type == SEVT_RAWKEY && event->code == SKEY_FR_ESC) {
+            SAGE_AppliLog("Exit loop");
+            finish = TRUE;
+          }
+        }
+        ScrollLayers(frame);
+        back = SAGE_GetScreen()->back_bitmap;
+        SAGE_ElapsedTime(timer);
+        for (layer = 0;layer < NB_LAYERS;layer++) {
+          SAGE_BlitLayerToScreen(layer, 0, parallax->planes[layer].y_pos);
+        }
+        layers_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (row = 0;row < SCREEN_HEIGHT;row++) {
+          memcpy(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2);
+        }
+        SAGE_ElapsedTime(timer);
+        if (!SAGE_BlitParallaxToScreen(parallax)) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        parallax_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        pixels += SAGE_GetParallaxPixels(parallax);
+        for (row = 0;row < SCREEN_HEIGHT;row++) {
+          if (memcmp(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2) != 0) {
+            SAGE_ErrorLog("Frame %d : line %d differs", frame, row);
+            errors++;
+            break;
+          }
+        }
+        if (!SAGE_RefreshScreen()) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+      }
+      if (frame > 0) {
+        if (errors == 0) {
+          SAGE_AppliLog("Pictures match !");
+        }
+        SAGE_AppliLog("  One blit per layer : %d us per frame", layers_time / frame);
+        SAGE_AppliLog("  Compositor         : %d us per frame, %d pixels for %d screen pixels", parallax_time / frame, pixels / frame, SCREEN_WIDTH * SCREEN_HEIGHT);
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      SAGE_ReleaseParallax(parallax);
+      for (layer = 0;layer < NB_LAYERS;layer++) {
+        SAGE_ReleaseLayer(layer);
+      }
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
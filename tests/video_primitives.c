@@ -0,0 +1,192 @@
+/**
+ * video_primitives.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test batched primitive drawing
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define NB_PIXELS             4000
+#define NB_LINES              1000
+#define NB_TRIANGLES          200
+#define NB_QUADS              200
+#define BENCH_FRAMES          20
+
+SAGE_Pixel Pixels[NB_PIXELS];
+SAGE_Line Lines[NB_LINES];
+SAGE_Triangle Triangles[NB_TRIANGLES];
+SAGE_FlatQuad Quads[NB_QUADS];
+UWORD Reference[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+/**
+ * Get a random coordinate, some of them are outside of the screen to check
+ * the clipping
+ */
+LONG RandomCoord(LONG size)
+{
+  return (rand() % (size + 200)) - 100;
+}
+
+/**
+ * Make random primitives for a frame
+ */
+VOID MakePrimitives(VOID)
+{
+  ULONG idx;
+
+  for (idx = 0;idx < NB_PIXELS;idx++) {
+    Pixels[idx].x = RandomCoord(SCREEN_WIDTH);
+    Pixels[idx].y = RandomCoord(SCREEN_HEIGHT);
+    Pixels[idx].color = SAGE_RemapColor(rand() & 0xFFFFFF);
+  }
+  for (idx = 0;idx < NB_LINES;idx++) {
+    Lines[idx].x1 = RandomCoord(SCREEN_WIDTH);
+    Lines[idx].y1 = RandomCoord(SCREEN_HEIGHT);
+    Lines[idx].x2 = RandomCoord(SCREEN_WIDTH);
+    Lines[idx].y2 = RandomCoord(SCREEN_HEIGHT);
+    Lines[idx].color = rand() & 0xFFFFFF;
+  }
+  for (idx = 0;idx < NB_TRIANGLES;idx++) {
+    Triangles[idx].x1 = RandomCoord(SCREEN_WIDTH);
+    Triangles[idx].y1 = RandomCoord(SCREEN_HEIGHT);
+    Triangles[idx].x2 = Triangles[idx].x1 + (rand() % 120) - 60;
+    Triangles[idx].y2 = Triangles[idx].y1 + (rand() % 120) - 60;
+    Triangles[idx].x3 = Triangles[idx].x1 + (rand() % 120) - 60;
+    Triangles[idx].y3 = Triangles[idx].y1 + (rand() % 120) - 60;
+    Triangles[idx].color = rand() & 0xFFFFFF;
+  }
+  for (idx = 0;idx < NB_QUADS;idx++) {
+    Quads[idx].yt = RandomCoord(SCREEN_HEIGHT);
+    Quads[idx].yb = Quads[idx].yt + (rand() % 60);
+    Quads[idx].x1 = RandomCoord(SCREEN_WIDTH);
+    Quads[idx].x2 = Quads[idx].x1 + (rand() % 60);
+    Quads[idx].x3 = Quads[idx].x1 + (rand() % 40) - 20;
+    Quads[idx].x4 = Quads[idx].x3 + (rand() % 60);
+    Quads[idx].color = rand() & 0xFFFFFF;
+  }
+}
+
+/**
+ * Draw the primitives one by one
+ */
+VOID DrawSingle(VOID)
+{
+  SAGE_Screen *screen;
+  ULONG idx;
+
+  screen = SAGE_GetScreen();
+  SAGE_ClearScreen();
+  for (idx = 0;idx < NB_PIXELS;idx++) {
+    if (Pixels[idx].x >= screen->clipping.left && Pixels[idx].x <= screen->clipping.right
+        && Pixels[idx].y >= screen->clipping.top && Pixels[idx].y <= screen->clipping.bottom) {
+      SAGE_DrawPixelArray(&(Pixels[idx]), 1);
+    }
+  }
+  for (idx = 0;idx < NB_TRIANGLES;idx++) {
+    SAGE_DrawClippedTriangle(
+      Triangles[idx].x1, Triangles[idx].y1, Triangles[idx].x2, Triangles[idx].y2, Triangles[idx].x3, Triangles[idx].y3, Triangles[idx].color
+    );
+  }
+  for (idx = 0;idx < NB_QUADS;idx++) {
+    SAGE_DrawClippedFlatQuad(Quads[idx].x1, Quads[idx].x2, Quads[idx].yt, Quads[idx].x3, Quads[idx].x4, Quads[idx].yb, Quads[idx].color);
+  }
+  for (idx = 0;idx < NB_LINES;idx++) {
+    SAGE_DrawClippedLine(Lines[idx].x1, Lines[idx].y1, Lines[idx].x2, Lines[idx].y2, Lines[idx].color);
+  }
+}
+
+/**
+ * Draw the primitives by batch
+ */
+VOID DrawBatched(VOID)
+{
+  SAGE_ClearScreen();
+  SAGE_DrawClippedPixelArray(Pixels, NB_PIXELS);
+  SAGE_DrawClippedTriangleArray(Triangles, NB_TRIANGLES);
+  SAGE_DrawClippedFlatQuadArray(Quads, NB_QUADS);
+  SAGE_DrawClippedLineArray(Lines, NB_LINES);
+}
+
+/**
+ * Draw random primitives one by one and by batch, compare the pictures and
+ * the times
+ */
+void main(void)
+{
+  SAGE_Event *event = NULL;
+  SAGE_Timer *timer = NULL;
+  SAGE_Bitmap *back;
+  ULONG single_time = 0, batch_time = 0, errors = 0, row;
+  UWORD frame = 0;
+  BOOL finish = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (PRIMITIVES) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      if ((timer = SAGE_AllocTimer()) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      for (frame = 0;frame < BENCH_FRAMES && !finish;frame++) {
+        while ((event = SAGE_GetEvent()) != NULL) {
+          if (event->type == SEVT_RAWKEY && event->code == SKEY_FR_ESC) {
+            SAGE_AppliLog("Exit loop");
+            finish = TRUE;
+          }
+        }
+        MakePrimitives();
+        back = SAGE_GetScreen()->back_bitmap;
+        SAGE_ElapsedTime(timer);
+        DrawSingle();
+        single_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (row = 0;row < SCREEN_HEIGHT;row++) {
+          memcpy(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2);
+        }
+        SAGE_ElapsedTime(timer);
+        DrawBatched();
+        batch_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (row = 0;row < SCREEN_HEIGHT;row++) {
+          if (memcmp(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2) != 0) {
+            SAGE_ErrorLog("Frame %d : line %d differs", frame, row);
+            errors++;
+            break;
+          }
+        }
+        if (!SAGE_RefreshScreen()) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+      }
+      if (frame > 0) {
+        if (errors == 0) {
+          SAGE_AppliLog("Pictures match !");
+        }
+        SAGE_AppliLog("  Single primitives  : %d us per frame", single_time / frame);
+        SAGE_AppliLog("  Batched primitives : %d us per frame", batch_time / frame);
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -0,0 +1,153 @@
+/**
+ * video_rotate.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test sprite rotation
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define SPR_TRANSP            0xFF00FF
+#define DIRECT_BANK           0
+#define CACHED_BANK           1
+#define SPR_TROLL             0
+#define NB_SPRITES            1
+
+#define NB_TROLLS             16
+#define NB_ANGLES             8
+#define CACHE_FRAMES          NB_ANGLES
+#define BENCH_FRAMES          100
+
+UWORD Reference[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+/**
+ * Create a sprite bank with or without the rotation cache
+ */
+BOOL CreateBank(UWORD index, SAGE_Picture *picture, UWORD frames)
+{
+  return (BOOL)(SAGE_CreateSpriteBank(index, NB_SPRITES, picture)
+    && SAGE_SetSpriteBankTransparency(index, SPR_TRANSP)
+    && SAGE_SetSpriteBankRotationCache(index, frames)
+    && SAGE_AddSpriteToBank(index, SPR_TROLL, 6, 4, 96, 112, SSPR_HS_MIDDLE));
+}
+
+/**
+ * Draw a circle of rotating trolls, some of them are zoomed and some go
+ * outside of the screen to check the clipping
+ */
+BOOL DrawTrolls(UWORD index, UWORD frame)
+{
+  FLOAT angle;
+  LONG x_pos, y_pos;
+  UWORD troll;
+
+  SAGE_ClearScreen();
+  for (troll = 0;troll < NB_TROLLS;troll++) {
+    angle = (FLOAT)(((frame + troll) % NB_ANGLES) * (360 / NB_ANGLES)) + 15.0;
+    x_pos = (SCREEN_WIDTH / 2) + (LONG)(SAGE_FastCosine(troll * (SMTH_ANGLE_360 / NB_TROLLS)) * 300.0);
+    y_pos = (SCREEN_HEIGHT / 2) + (LONG)(SAGE_FastSine(troll * (SMTH_ANGLE_360 / NB_TROLLS)) * 230.0);
+    if (!SAGE_SetSpriteZoom(index, SPR_TROLL, (troll & 1) ? 1.5 : 1.0, (troll & 1) ? 1.5 : 1.0)
+        || !SAGE_SetSpriteRotation(index, SPR_TROLL, angle)
+        || !SAGE_BlitSpriteToScreen(index, SPR_TROLL, x_pos, y_pos)) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Draw the rotating trolls directly and from the rotation cache, compare the
+ * pictures and the times
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Event *event = NULL;
+  SAGE_Timer *timer = NULL;
+  SAGE_Bitmap *back;
+  ULONG direct_time = 0, cached_time = 0, errors = 0, row;
+  UWORD frame = 0;
+  BOOL finish = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (ROTATE) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_AppliLog("Load sprite picture and create sprite banks");
+      if ((picture = SAGE_LoadPicture("data/troll_sprite.gif")) == NULL
+          || !CreateBank(DIRECT_BANK, picture, 0)
+          || !CreateBank(CACHED_BANK, picture, CACHE_FRAMES)
+          || (timer = SAGE_AllocTimer()) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      for (frame = 0;frame < BENCH_FRAMES && !finish;frame++) {
+        while ((event = SAGE_GetEvent()) != NULL) {
+          if (event->type == SEVT_RAWKEY && event->code == SKEY_FR_ESC) {
+            SAGE_AppliLog("Exit loop");
+            finish = TRUE;
+          }
+        }
+        back = SAGE_GetScreen()->back_bitmap;
+        SAGE_ElapsedTime(timer);
+        if (!DrawTrolls(DIRECT_BANK, frame)) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        direct_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (row = 0;row < SCREEN_HEIGHT;row++) {
+          memcpy(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2);
+        }
+        SAGE_ElapsedTime(timer);
+        if (!DrawTrolls(CACHED_BANK, frame)) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        cached_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (row = 0;row < SCREEN_HEIGHT;row++) {
+          if (memcmp(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2) != 0) {
+            SAGE_ErrorLog("Frame %d : line %d differs", frame, row);
+            errors++;
+            break;
+          }
+        }
+        if (!SAGE_RefreshScreen()) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+      }
+      if (frame > 0) {
+        if (errors == 0) {
+          SAGE_AppliLog("Pictures match !");
+        }
+        SAGE_AppliLog("  Rotation blitter : %d us per frame", direct_time / frame);
+        SAGE_AppliLog("  Rotation cache   : %d us per frame", cached_time / frame);
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      if (picture != NULL) {
+        SAGE_ReleasePicture(picture);
+      }
+      SAGE_ReleaseSpriteBank(DIRECT_BANK);
+      SAGE_ReleaseSpriteBank(CACHED_BANK);
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -0,0 +1,140 @@
+/**
+ * video_spans.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test sprite transparent spans
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          640
+#define SCREEN_HEIGHT         480
+#define SCREEN_DEPTH          16
+
+#define SPR_TRANSP            0xFF00FF
+#define SPANS_BANK            0
+#define BLIT_BANK             1
+#define SPR_TROLL             0
+#define NB_SPRITES            1
+
+#define NB_POSITIONS          200
+#define BENCH_BLITS           2000
+
+UWORD Reference[SCREEN_WIDTH * SCREEN_HEIGHT];
+LONG troll_x[BENCH_BLITS], troll_y[BENCH_BLITS];
+
+/**
+ * Create a sprite bank with or without the transparent spans
+ */
+BOOL CreateBank(UWORD index, SAGE_Picture *picture, BOOL spans)
+{
+  return (BOOL)(SAGE_CreateSpriteBank(index, NB_SPRITES, picture)
+    && SAGE_SetSpriteBankSpans(index, spans)
+    && SAGE_SetSpriteBankTransparency(index, SPR_TRANSP)
+    && SAGE_AddSpriteToBank(index, SPR_TROLL, 6, 4, 96, 112, SSPR_HS_MIDDLE));
+}
+
+/**
+ * Clear the back bitmap with a pattern so the transparent pixels are checked
+ */
+VOID ClearBack(SAGE_Bitmap *back)
+{
+  UWORD *pixel;
+  ULONG x_pos, y_pos;
+
+  for (y_pos = 0;y_pos < SCREEN_HEIGHT;y_pos++) {
+    pixel = (UWORD *)((UBYTE *)back->bitmap_buffer + (y_pos * back->bpr));
+    for (x_pos = 0;x_pos < SCREEN_WIDTH;x_pos++) {
+      *pixel++ = (UWORD)((x_pos ^ y_pos) & 0x3F);
+    }
+  }
+}
+
+/**
+ * Draw the same sprite with its transparent spans and with the transparent
+ * blit, compare the pictures (clipped sprites included) and the times
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Timer *timer = NULL;
+  SAGE_Bitmap *back;
+  ULONG spans_time = 0, blit_time = 0, errors = 0, row;
+  LONG x_pos, y_pos;
+  UWORD idx;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (SPANS) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_AppliLog("Load sprite picture and create sprite banks");
+      if ((picture = SAGE_LoadPicture("data/troll_sprite.gif")) != NULL
+          && CreateBank(SPANS_BANK, picture, TRUE)
+          && CreateBank(BLIT_BANK, picture, FALSE)
+          && (timer = SAGE_AllocTimer()) != NULL) {
+        back = SAGE_GetScreen()->back_bitmap;
+        SAGE_AppliLog("Compare %d positions", NB_POSITIONS);
+        for (idx = 0;idx < NB_POSITIONS;idx++) {
+          x_pos = (rand() % (SCREEN_WIDTH + 128)) - 64;
+          y_pos = (rand() % (SCREEN_HEIGHT + 128)) - 64;
+          ClearBack(back);
+          SAGE_BlitSpriteToScreen(BLIT_BANK, SPR_TROLL, x_pos, y_pos);
+          for (row = 0;row < SCREEN_HEIGHT;row++) {
+            memcpy(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2);
+          }
+          ClearBack(back);
+          SAGE_BlitSpriteToScreen(SPANS_BANK, SPR_TROLL, x_pos, y_pos);
+          for (row = 0;row < SCREEN_HEIGHT;row++) {
+            if (memcmp(&(Reference[row * SCREEN_WIDTH]), (UBYTE *)back->bitmap_buffer + (row * back->bpr), SCREEN_WIDTH * 2) != 0) {
+              SAGE_ErrorLog("Sprite at %d,%d : line %d differs", x_pos, y_pos, row);
+              errors++;
+              break;
+            }
+          }
+        }
+        if (errors == 0) {
+          SAGE_AppliLog("Pictures match !");
+        }
+        SAGE_AppliLog("Blit %d sprites", BENCH_BLITS);
+        for (idx = 0;idx < BENCH_BLITS;idx++) {
+          troll_x[idx] = rand() % SCREEN_WIDTH;
+          troll_y[idx] = rand() % SCREEN_HEIGHT;
+        }
+        SAGE_ElapsedTime(timer);
+        for (idx = 0;idx < BENCH_BLITS;idx++) {
+          SAGE_BlitSpriteToScreen(BLIT_BANK, SPR_TROLL, troll_x[idx], troll_y[idx]);
+        }
+        blit_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        for (idx = 0;idx < BENCH_BLITS;idx++) {
+          SAGE_BlitSpriteToScreen(SPANS_BANK, SPR_TROLL, troll_x[idx], troll_y[idx]);
+        }
+        spans_time = SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+        SAGE_AppliLog("  Transparent blit : %d us", blit_time);
+        SAGE_AppliLog("  Sprite spans     : %d us", spans_time);
+        SAGE_RefreshScreen();
+      } else {
+        SAGE_DisplayError();
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      if (picture != NULL) {
+        SAGE_ReleasePicture(picture);
+      }
+      SAGE_ReleaseSpriteBank(SPANS_BANK);
+      SAGE_ReleaseSpriteBank(BLIT_BANK);
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
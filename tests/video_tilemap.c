@@ -0,0 +1,184 @@
+/**
+ * video_tilemap.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test tilemap scrolling
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          320L
+#define SCREEN_HEIGHT         240L
+#define SCREEN_DEPTH          8L
+
+#define NB_TILES              20
+#define TILE_WIDTH            32
+#define TILE_HEIGHT           20
+#define TILE_BANK             0
+
+#define MAP_COLS              100
+#define MAP_ROWS              60
+#define MAP_BYTE              0
+#define MAP_WORD              1
+
+#define LAYER_WIDTH           (TILE_WIDTH * 12)
+#define LAYER_HEIGHT          (TILE_HEIGHT * 14)
+#define LAYER_STREAM          0
+#define LAYER_REDRAW          1
+
+#define BENCH_FRAMES          500
+
+/**
+ * Fill the byte and the word maps with the same tiles
+ */
+VOID FillMaps(VOID)
+{
+  UBYTE *map_byte;
+  UWORD *map_word, col, row;
+
+  map_byte = SAGE_GetTileMapB(MAP_BYTE);
+  map_word = SAGE_GetTileMapW(MAP_WORD);
+  for (row = 0;row < MAP_ROWS;row++) {
+    for (col = 0;col < MAP_COLS;col++) {
+      *map_byte = (UBYTE)(((col * 7) + (row * 3) + (col * row)) % NB_TILES);
+      *map_word++ = (UWORD)*map_byte++;
+    }
+  }
+}
+
+/**
+ * Compare the views of the streamed and of the redrawn layers
+ */
+BOOL SameViews(VOID)
+{
+  SAGE_Layer *stream, *redraw;
+  UBYTE *line1, *line2;
+  ULONG x_pos, y_pos;
+  UWORD part;
+
+  stream = SAGE_GetLayer(LAYER_STREAM);
+  redraw = SAGE_GetLayer(LAYER_REDRAW);
+  for (part = SLAY_OVERNONE;part <= SLAY_OVERBOTH;part++) {
+    if ((stream->overflow & part) == part) {
+      for (y_pos = stream->view[part].top;y_pos < (stream->view[part].top + stream->view[part].height);y_pos++) {
+        line1 = (UBYTE *)stream->bitmap->bitmap_buffer + (y_pos * stream->bitmap->bpr);
+        line2 = (UBYTE *)redraw->bitmap->bitmap_buffer + (y_pos * redraw->bitmap->bpr);
+        for (x_pos = stream->view[part].left;x_pos < (stream->view[part].left + stream->view[part].width);x_pos++) {
+          if (line1[x_pos] != line2[x_pos]) {
+            return FALSE;
+          }
+        }
+      }
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Scroll a byte map streaming the new tiles and a word map redrawn on each
+ * frame, check that the views are the same and compare the times
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Event *event = NULL;
+  SAGE_Timer *timer = NULL;
+  ULONG elapsed_time, stream_time = 0, redraw_time = 0, errors = 0;
+  LONG x_pos = 0, y_pos = 0, x_speed = 3, y_speed = 2;
+  UWORD frame;
+  BOOL finish = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (TILEMAP) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_AppliLog("Load tile picture and create tile bank");
+      if ((picture = SAGE_LoadPicture("data/Odysseus_Tiles.bmp")) != NULL) {
+        SAGE_LoadPictureColorMap(picture);
+        SAGE_RefreshColors(0, 256);
+        if (!SAGE_CreateTileBank(TILE_BANK, TILE_WIDTH, TILE_HEIGHT, NB_TILES, picture) || !SAGE_AddTilesToBank(TILE_BANK)) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        SAGE_ReleasePicture(picture);
+      } else {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      SAGE_AppliLog("Create tilemaps and layers");
+      if (finish
+          || !SAGE_CreateTileMap(MAP_BYTE, MAP_COLS, MAP_ROWS, STIL_MAPBPT_BYTE)
+          || !SAGE_CreateTileMap(MAP_WORD, MAP_COLS, MAP_ROWS, STIL_MAPBPT_WORD)
+          || !SAGE_CreateLayer(LAYER_STREAM, LAYER_WIDTH, LAYER_HEIGHT)
+          || !SAGE_CreateLayer(LAYER_REDRAW, LAYER_WIDTH, LAYER_HEIGHT)
+          || !SAGE_SetTileMapScroll(MAP_BYTE, TILE_BANK, LAYER_STREAM, SCREEN_WIDTH, SCREEN_HEIGHT)
+          || !SAGE_SetTileMapScroll(MAP_WORD, TILE_BANK, LAYER_REDRAW, SCREEN_WIDTH, SCREEN_HEIGHT)
+          || (timer = SAGE_AllocTimer()) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      } else {
+        FillMaps();
+      }
+      for (frame = 0;frame < BENCH_FRAMES && !finish;frame++) {
+        while ((event = SAGE_GetEvent()) != NULL) {
+          if (event->type == SEVT_RAWKEY && event->code == SKEY_FR_ESC) {
+            SAGE_AppliLog("Exit loop");
+            finish = TRUE;
+          }
+        }
+        // Bounce the camera on the map borders
+        x_pos += x_speed;
+        y_pos += y_speed;
+        if (x_pos <= 0 || x_pos >= ((MAP_COLS * TILE_WIDTH) - SCREEN_WIDTH)) {
+          x_speed = -x_speed;
+        }
+        if (y_pos <= 0 || y_pos >= ((MAP_ROWS * TILE_HEIGHT) - SCREEN_HEIGHT)) {
+          y_speed = -y_speed;
+        }
+        SAGE_ElapsedTime(timer);
+        SAGE_ScrollTileMap(MAP_BYTE, x_pos, y_pos);
+        elapsed_time = SAGE_ElapsedTime(timer);
+        stream_time += SAGE_TimeToMicroseconds(elapsed_time);
+        SAGE_RedrawTileMap(MAP_WORD);
+        SAGE_ScrollTileMap(MAP_WORD, x_pos, y_pos);
+        elapsed_time = SAGE_ElapsedTime(timer);
+        redraw_time += SAGE_TimeToMicroseconds(elapsed_time);
+        if (!SameViews()) {
+          SAGE_ErrorLog("Frame %d : streamed view differs at %d,%d", frame, x_pos, y_pos);
+          errors++;
+        }
+        if (!SAGE_BlitLayerToScreen(LAYER_STREAM, 0, 0) || !SAGE_RefreshScreen()) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+      }
+      if (frame > 0) {
+        if (errors == 0) {
+          SAGE_AppliLog("Views match !");
+        }
+        SAGE_AppliLog("  Streamed tiles : %d us per frame", stream_time / frame);
+        SAGE_AppliLog("  Full redraw    : %d us per frame", redraw_time / frame);
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      SAGE_AppliLog("Release tilemaps, layers and tiles");
+      SAGE_ReleaseTileMap(MAP_BYTE);
+      SAGE_ReleaseTileMap(MAP_WORD);
+      SAGE_ReleaseLayer(LAYER_STREAM);
+      SAGE_ReleaseLayer(LAYER_REDRAW);
+      SAGE_ReleaseTileBank(TILE_BANK);
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
@@ -0,0 +1,172 @@
+/**
+ * video_tilepack.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Test packed tilemaps and animated tiles
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#include <string.h>
+
+#include <sage/sage.h>
+
+#define SCREEN_WIDTH          320L
+#define SCREEN_HEIGHT         240L
+#define SCREEN_DEPTH          8L
+
+#define NB_TILES              20
+#define TILE_WIDTH            32
+#define TILE_HEIGHT           20
+#define TILE_BANK             0
+
+#define WATER_TILE            16
+#define WATER_FRAMES          4
+#define WATER_DELAY           5
+
+#define MAP_COLS              512
+#define MAP_ROWS              32
+#define MAP_RAW               0
+#define MAP_PACKED            1
+
+#define LAYER_WIDTH           (TILE_WIDTH * 12)
+#define LAYER_HEIGHT          (TILE_HEIGHT * 14)
+#define LAYER_MAP             0
+
+#define LOAD_COUNT            10
+#define SCROLL_FRAMES         600
+
+/**
+ * Load a map file several times and return the mean time
+ */
+ULONG LoadMap(SAGE_Timer *timer, UWORD index, STRPTR file)
+{
+  ULONG load_time = 0;
+  UWORD count;
+
+  for (count = 0;count < LOAD_COUNT;count++) {
+    SAGE_ElapsedTime(timer);
+    if (!SAGE_LoadTileMap(index, file)) {
+      SAGE_DisplayError();
+      return 0;
+    }
+    load_time += SAGE_TimeToMicroseconds(SAGE_ElapsedTime(timer));
+  }
+  return load_time / LOAD_COUNT;
+}
+
+/**
+ * Check that the water tiles show the right frame
+ */
+BOOL CheckWater(UWORD steps)
+{
+  SAGE_TileBank *bank;
+  UWORD tile, frame;
+
+  bank = SAGE_GetTileBank(TILE_BANK);
+  frame = (steps / (WATER_DELAY + 1)) % WATER_FRAMES;
+  for (tile = 0;tile < WATER_FRAMES;tile++) {
+    if (SAGE_GetTileDisplay(bank, WATER_TILE + tile) != (WATER_TILE + ((tile + frame) % WATER_FRAMES))) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Load the same level from a raw and from a packed map, compare them and the
+ * loading times then scroll the level with animated water
+ */
+void main(void)
+{
+  SAGE_Picture *picture = NULL;
+  SAGE_Event *event = NULL;
+  SAGE_Timer *timer = NULL;
+  ULONG raw_time, packed_time;
+  LONG x_pos = 0, x_speed = 2;
+  UWORD frame;
+  BOOL finish = FALSE;
+
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  SAGE_AppliLog("* SAGE library VIDEO test (TILEPACK) / %s", SAGE_GetVersion());
+  SAGE_AppliLog("--------------------------------------------------------------------------------");
+  if (SAGE_Init(SMOD_VIDEO)) {
+    SAGE_AppliLog("Opening screen");
+    if (SAGE_OpenScreen(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SSCR_STRICTRES)) {
+      SAGE_HideMouse();
+      SAGE_AppliLog("Load tile picture and create tile bank");
+      if ((picture = SAGE_LoadPicture("data/Odysseus_Tiles.bmp")) != NULL) {
+        SAGE_LoadPictureColorMap(picture);
+        SAGE_RefreshColors(0, 256);
+        if (!SAGE_CreateTileBank(TILE_BANK, TILE_WIDTH, TILE_HEIGHT, NB_TILES, picture)
+            || !SAGE_AddTilesToBank(TILE_BANK)
+            || !SAGE_AddTileAnimation(TILE_BANK, WATER_TILE, WATER_FRAMES, WATER_DELAY)) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+        SAGE_ReleasePicture(picture);
+      } else {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      if (finish
+          || !SAGE_CreateTileMap(MAP_RAW, MAP_COLS, MAP_ROWS, STIL_MAPBPT_WORD)
+          || !SAGE_CreateTileMap(MAP_PACKED, MAP_COLS, MAP_ROWS, STIL_MAPBPT_WORD)
+          || !SAGE_CreateLayer(LAYER_MAP, LAYER_WIDTH, LAYER_HEIGHT)
+          || !SAGE_SetTileMapScroll(MAP_PACKED, TILE_BANK, LAYER_MAP, SCREEN_WIDTH, SCREEN_HEIGHT)
+          || (timer = SAGE_AllocTimer()) == NULL) {
+        finish = TRUE;
+        SAGE_DisplayError();
+      }
+      if (!finish) {
+        SAGE_AppliLog("Load the raw and the packed maps %d times", LOAD_COUNT);
+        raw_time = LoadMap(timer, MAP_RAW, "data/level.map");
+        packed_time = LoadMap(timer, MAP_PACKED, "data/level.stm");
+        if (memcmp(SAGE_GetTileMapW(MAP_RAW), SAGE_GetTileMapW(MAP_PACKED), MAP_COLS * MAP_ROWS * STIL_MAPBPT_WORD) == 0) {
+          SAGE_AppliLog("Maps match !");
+        } else {
+          SAGE_ErrorLog("Packed map differs from the raw map");
+        }
+        SAGE_AppliLog("  Raw map    : %d us", raw_time);
+        SAGE_AppliLog("  Packed map : %d us", packed_time);
+      }
+      SAGE_AppliLog("Scroll the level");
+      for (frame = 0;frame < SCROLL_FRAMES && !finish;frame++) {
+        while ((event = SAGE_GetEvent()) != NULL) {
+          if (event->type == SEVT_RAWKEY && event->code == SKEY_FR_ESC) {
+            SAGE_AppliLog("Exit loop");
+            finish = TRUE;
+          }
+        }
+        x_pos += x_speed;
+        if (x_pos <= 0 || x_pos >= ((MAP_COLS * TILE_WIDTH) - SCREEN_WIDTH)) {
+          x_speed = -x_speed;
+        }
+        SAGE_AnimateTiles(TILE_BANK);
+        if (!CheckWater(frame + 1)) {
+          SAGE_ErrorLog("Frame %d : bad water frame", frame);
+        }
+        if (!SAGE_ScrollTileMap(MAP_PACKED, x_pos, (MAP_ROWS * TILE_HEIGHT) - SCREEN_HEIGHT)
+            || !SAGE_BlitLayerToScreen(LAYER_MAP, 0, 0)
+            || !SAGE_RefreshScreen()) {
+          finish = TRUE;
+          SAGE_DisplayError();
+        }
+      }
+      if (timer != NULL) {
+        SAGE_ReleaseTimer(timer);
+      }
+      SAGE_AppliLog("Release tilemaps, layer and tiles");
+      SAGE_ReleaseTileMap(MAP_RAW);
+      SAGE_ReleaseTileMap(MAP_PACKED);
+      SAGE_ReleaseLayer(LAYER_MAP);
+      SAGE_ReleaseTileBank(TILE_BANK);
+      SAGE_ShowMouse();
+      SAGE_AppliLog("Closing screen");
+      SAGE_CloseScreen();
+    }
+  }
+  SAGE_Exit();
+  SAGE_AppliLog("End of test");
+}
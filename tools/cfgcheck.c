@@ -0,0 +1,427 @@
+/**
+ * cfgcheck.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, check and benchmark the configuration file parser
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -o cfgcheck cfgcheck.c host/amiga.c
+ *           ../src/sage_configfile.c ../src/sage_memory.c ../src/sage_error.c ../src/sage_logger.c
+ * Usage : cfgcheck file.ini          (parse the file and show the hash tables)
+ *         cfgcheck -b [parameters]   (benchmark the lookups)
+ *         cfgcheck -f [iterations]   (fuzz the parser)
+ * 
+ * The tool links sage_configfile.c with the host shims, so the parser, the
+ * hash tables and the typed getters that are checked are the ones of the
+ * engine. The benchmark compares the lookups to the linked lists and the file
+ * rescan of the previous SAGE versions. The fuzzer parses random buffers and
+ * checks every parameter against a simple line by line parser, then sets,
+ * adds and removes parameters and checks the tables and the lists again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sage/sage_error.h>
+#include <sage/sage_memory.h>
+#include <sage/sage_configfile.h>
+
+#define FUZZ_SIZE           2048
+#define FUZZ_PARAMS         1024
+#define FUZZ_ADDS           300                   // New parameters, enough to grow the smallest table
+
+/** Reference parser result */
+typedef struct {
+  char *section, *name, *value;
+  BOOL removed;
+} RefParam;
+
+/** Internal functions of sage_configfile.c */
+SAGE_Configuration *SAGE_CreateConfiguration(ULONG);
+BOOL SAGE_ParseConfiguration(SAGE_Configuration *, UBYTE *, ULONG);
+SAGE_ConfParameter *SAGE_GetParameter(SAGE_Configuration *, STRPTR, STRPTR);
+
+/**
+ * Parse a buffer like SAGE_LoadConfigurationFile does with the file
+ */
+static SAGE_Configuration *Parse(char *text, long size)
+{
+  SAGE_Configuration *config;
+  UBYTE *buffer;
+
+  if ((buffer = (UBYTE *)SAGE_AllocMem(size + 1)) == NULL) {
+    return NULL;
+  }
+  memcpy(buffer, text, size);
+  if ((config = SAGE_CreateConfiguration(size / SCFG_BYTES_PER_PARAM)) == NULL) {
+    SAGE_FreeMem(buffer);
+    return NULL;
+  }
+  config->file_buffer = buffer;
+  if (!SAGE_ParseConfiguration(config, buffer, size)) {
+    SAGE_ReleaseConfigurationFile(config);
+    return NULL;
+  }
+  return config;
+}
+
+static SAGE_ConfParameter *Lookup(SAGE_Configuration *config, char *section, char *name)
+{
+  return SAGE_GetParameter(config, (STRPTR)section, (STRPTR)name);
+}
+
+/**
+ * Count the parameters of the file order lists and check the last links
+ */
+static long CountListed(SAGE_Configuration *config)
+{
+  SAGE_ConfSection *section;
+  SAGE_ConfParameter *param, *last = NULL;
+  long count = 0;
+
+  for (param = config->parameters;param != NULL;param = (SAGE_ConfParameter *)param->next_param) {
+    last = param;
+    count++;
+  }
+  if (last != config->last_param) {
+    return -1;
+  }
+  for (section = config->sections;section != NULL;section = (SAGE_ConfSection *)section->next_section) {
+    last = NULL;
+    for (param = section->parameters;param != NULL;param = (SAGE_ConfParameter *)param->next_param) {
+      last = param;
+      count++;
+    }
+    if (last != section->last_param) {
+      return -1;
+    }
+  }
+  return count;
+}
+
+/**
+ * Line by line parser, linear search of the parameters
+ */
+static long RefParse(char *buffer, long size, RefParam *params, long max_params)
+{
+  char *line, *end, *eol, *mark, *section = NULL;
+  long count = 0, idx;
+
+  end = buffer + size;
+  *end = '\0';
+  for (line = buffer;line < end;line = eol + 1) {
+    if ((eol = (char *)memchr(line, '\n', end - line)) == NULL) {
+      eol = end;
+    }
+    *eol = '\0';
+    if (eol > line && *(eol - 1) == '\r') {
+      *(eol - 1) = '\0';
+    }
+    if (line[0] == '[') {
+      if ((mark = strchr(line, ']')) != NULL) {
+        *mark = '\0';
+        section = line + 1;
+      }
+    } else if (line[0] != ';' && line[0] != ' ' && line[0] != '\t' && line[0] != '\0' && (mark = strchr(line, '=')) != NULL) {
+      *mark = '\0';
+      for (idx = 0;idx < count;idx++) {
+        if (((params[idx].section == NULL && section == NULL)
+             || (params[idx].section != NULL && section != NULL && strcmp(params[idx].section, section) == 0))
+            && strcmp(params[idx].name, line) == 0) {
+          break;
+        }
+      }
+      if (idx == count && count < max_params) {
+        params[count].section = section;
+        params[count].name = line;
+        params[count].removed = FALSE;
+        params[count++].value = mark + 1;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * Check the typed getters of a parameter, a value read twice must be the same
+ * and a new value clears the cached one
+ */
+static long CheckGetters(SAGE_Configuration *config, RefParam *param, long number)
+{
+  char value[32];
+  long errors = 0;
+
+  if (SAGE_GetParameterInteger(config, (STRPTR)param->section, (STRPTR)param->name, -1) != SAGE_GetParameterInteger(config, (STRPTR)param->section, (STRPTR)param->name, -1)) {
+    errors++;
+  }
+  if (SAGE_GetParameterBoolean(config, (STRPTR)param->section, (STRPTR)param->name, 2) != SAGE_GetParameterBoolean(config, (STRPTR)param->section, (STRPTR)param->name, 2)) {
+    errors++;
+  }
+  SAGE_GetParameterFloat(config, (STRPTR)param->section, (STRPTR)param->name, -1.0);
+  sprintf(value, " 0x%lX ", number);
+  SAGE_SetParameterValue(config, (STRPTR)param->section, (STRPTR)param->name, (STRPTR)value);
+  if (SAGE_GetParameterInteger(config, (STRPTR)param->section, (STRPTR)param->name, -1) != number) {
+    errors++;
+  }
+  if (SAGE_GetParameterBoolean(config, (STRPTR)param->section, (STRPTR)param->name, 2) != 2 || SAGE_GetErrorCode() != SERR_BADVALUE) {
+    errors++;
+  }
+  sprintf(value, "%ld.5", number);
+  SAGE_SetParameterValue(config, (STRPTR)param->section, (STRPTR)param->name, (STRPTR)value);
+  if (SAGE_GetParameterFloat(config, (STRPTR)param->section, (STRPTR)param->name, -1.0) != (FLOAT)number + 0.5f) {
+    errors++;
+  }
+  SAGE_SetParameterValue(config, (STRPTR)param->section, (STRPTR)param->name, (STRPTR)((number & 1) ? "  yes" : "Off\t"));
+  if (SAGE_GetParameterBoolean(config, (STRPTR)param->section, (STRPTR)param->name, 2) != ((number & 1) ? TRUE : FALSE)) {
+    errors++;
+  }
+  param->value = (number & 1) ? "  yes" : "Off\t";
+  return errors;
+}
+
+/**
+ * Check every parameter of the reference against the configuration
+ */
+static long CheckParams(SAGE_Configuration *config, RefParam *params, long count)
+{
+  SAGE_ConfParameter *param;
+  long idx, errors = 0;
+
+  for (idx = 0;idx < count;idx++) {
+    param = Lookup(config, params[idx].section, params[idx].name);
+    if (params[idx].removed) {
+      errors += (param != NULL);
+    } else if (param == NULL || strcmp((char *)param->param_value, params[idx].value) != 0) {
+      errors++;
+    }
+  }
+  return errors;
+}
+
+/**
+ * Fuzz the parser with random buffers made of the config file characters
+ */
+static BOOL Fuzz(long iterations)
+{
+  static const char alphabet[] = "ab[]=;\n\r \t0x1-.eTRUE";
+  static char buffer[FUZZ_SIZE + 1], copy[FUZZ_SIZE + 1];
+  static char names[FUZZ_ADDS][2][16];
+  static RefParam params[FUZZ_PARAMS + FUZZ_ADDS];
+  SAGE_Configuration *config;
+  long iter, size, idx, count, live, errors = 0;
+
+  srand(1);
+  for (iter = 0;iter < iterations;iter++) {
+    size = rand() % FUZZ_SIZE;
+    for (idx = 0;idx < size;idx++) {
+      buffer[idx] = (rand() % 4) ? alphabet[rand() % (sizeof(alphabet) - 1)] : (char)(rand() & 0xff);
+    }
+    memcpy(copy, buffer, size);
+    count = RefParse(copy, size, params, FUZZ_PARAMS);
+    if ((config = Parse(buffer, size)) == NULL) {
+      fprintf(stderr, "Iteration %ld : parse failed\n", iter);
+      return FALSE;
+    }
+    if (count < FUZZ_PARAMS && config->nb_params != (ULONG)count) {
+      fprintf(stderr, "Iteration %ld : %lu parameters, %ld expected\n", iter, config->nb_params, count);
+      errors++;
+    }
+    if (CheckParams(config, params, count) > 0) {
+      fprintf(stderr, "Iteration %ld : parsed parameters differ\n", iter);
+      errors++;
+    }
+    if (count < FUZZ_PARAMS) {
+      // Typed getters on a few parameters
+      for (idx = 0;idx < count && idx < 8;idx++) {
+        if (CheckGetters(config, &(params[idx]), iter + idx) > 0) {
+          fprintf(stderr, "Iteration %ld : typed getters of %s differ\n", iter, params[idx].name);
+          errors++;
+        }
+      }
+      // New parameters grow the table, in a new section or in a parsed one
+      for (idx = 0;idx < FUZZ_ADDS;idx++) {
+        sprintf(names[idx][0], "added%ld", idx);
+        sprintf(names[idx][1], "fuzz%ld", idx % 5);
+        params[count + idx].section = (idx % 3 == 0) ? NULL : ((idx % 3 == 1 || count == 0) ? names[idx][1] : params[idx % count].section);
+        params[count + idx].name = names[idx][0];
+        params[count + idx].value = names[idx][1];
+        params[count + idx].removed = FALSE;
+        SAGE_SetParameterValue(config, (STRPTR)params[count + idx].section, (STRPTR)names[idx][0], (STRPTR)names[idx][1]);
+      }
+      // Remove every other parameter
+      live = count + FUZZ_ADDS;
+      for (idx = rand() % 2;idx < count + FUZZ_ADDS;idx += 2) {
+        params[idx].removed = TRUE;
+        live--;
+        if (!SAGE_SetParameterValue(config, (STRPTR)params[idx].section, (STRPTR)params[idx].name, NULL)) {
+          errors++;
+        }
+      }
+      if (CheckParams(config, params, count + FUZZ_ADDS) > 0 || config->nb_params != (ULONG)live || CountListed(config) != live) {
+        fprintf(stderr, "Iteration %ld : tables or lists differ after the updates\n", iter);
+        errors++;
+      }
+    }
+    SAGE_ReleaseConfigurationFile(config);
+  }
+  printf("%ld buffers parsed, %ld errors\n", iterations, errors);
+  return (BOOL)(errors == 0);
+}
+
+/**
+ * Make a config file of nb_params tunables, 50 per section
+ */
+static char *MakeFile(long nb_params, long *size)
+{
+  char *buffer;
+  long idx, used = 0;
+
+  buffer = (char *)malloc(nb_params * 48 + 1);
+  buffer[0] = '\0';
+  for (idx = 0;idx < nb_params;idx++) {
+    if ((idx % 50) == 0) {
+      used += sprintf(buffer + used, "\n[SECTION%ld]\n", idx / 50);
+    }
+    used += sprintf(buffer + used, "tunable_%ld=%ld\n", idx, idx * 7);
+  }
+  *size = used;
+  return buffer;
+}
+
+/**
+ * Scan the file from the start like the previous SAGE_GetParameterFromFile
+ */
+static int Rescan(const char *file, const char *section, const char *name)
+{
+  const char *line = file;
+  size_t length = strlen(name), section_length = strlen(section);
+
+  while (*line != '\0') {
+    if (line[0] == '[' && strncmp(line + 1, section, section_length) == 0 && line[section_length + 1] == ']') {
+      for (line = strchr(line, '\n') + 1;*line != '\0' && *line != '[';line = strchr(line, '\n') + 1) {
+        if (strncmp(line, name, length) == 0 && line[length] == '=') {
+          return 1;
+        }
+      }
+      return 0;
+    }
+    line = strchr(line, '\n') + 1;
+  }
+  return 0;
+}
+
+/**
+ * Benchmark the lookups of all the parameters
+ */
+static BOOL Bench(long nb_params)
+{
+  SAGE_Configuration *config;
+  SAGE_ConfSection *section;
+  SAGE_ConfParameter *param;
+  char *file, section_name[32], name[32];
+  long size, idx, found = 0;
+  clock_t start;
+  double parse_time, hash_time, list_time, rescan_time;
+
+  file = MakeFile(nb_params, &size);
+  start = clock();
+  config = Parse(file, size);
+  parse_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+  if (config == NULL) {
+    free(file);
+    return FALSE;
+  }
+  // Hash tables
+  start = clock();
+  for (idx = 0;idx < nb_params;idx++) {
+    sprintf(section_name, "SECTION%ld", idx / 50);
+    sprintf(name, "tunable_%ld", idx);
+    found += (Lookup(config, section_name, name) != NULL);
+  }
+  hash_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+  // Linked lists in file order, strcmp on each node
+  start = clock();
+  for (idx = 0;idx < nb_params;idx++) {
+    sprintf(section_name, "SECTION%ld", idx / 50);
+    sprintf(name, "tunable_%ld", idx);
+    for (section = config->sections;section != NULL && strcmp(section_name, (char *)section->section_name) != 0;section = (SAGE_ConfSection *)section->next_section);
+    if (section != NULL) {
+      for (param = section->parameters;param != NULL;param = (SAGE_ConfParameter *)param->next_param) {
+        if (strcmp(name, (char *)param->param_name) == 0) {
+          found++;
+          break;
+        }
+      }
+    }
+  }
+  list_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+  // File rescan on each lookup
+  start = clock();
+  for (idx = 0;idx < nb_params;idx++) {
+    sprintf(section_name, "SECTION%ld", idx / 50);
+    sprintf(name, "tunable_%ld", idx);
+    found += Rescan(file, section_name, name);
+  }
+  rescan_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("%ld parameters, %ld bytes, %lu buckets, %ld found\n", nb_params, size, config->param_mask + 1, found);
+  printf("  Parse       : %.3f ms\n", parse_time * 1000.0);
+  printf("  Hash tables : %.3f ms\n", hash_time * 1000.0);
+  printf("  Lists       : %.3f ms\n", list_time * 1000.0);
+  printf("  File rescan : %.3f ms\n", rescan_time * 1000.0);
+  SAGE_ReleaseConfigurationFile(config);
+  free(file);
+  return (BOOL)(found == nb_params * 3);
+}
+
+/**
+ * Load a file and show the hash tables
+ */
+static BOOL Check(char *filename)
+{
+  SAGE_Configuration *config;
+  SAGE_ConfSection *section;
+  SAGE_ConfParameter *param;
+  ULONG idx, chain, longest = 0, used = 0, nb_sections = 0;
+
+  if ((config = SAGE_LoadConfigurationFile((STRPTR)filename)) == NULL) {
+    fprintf(stderr, "Can't load %s (error %ld)\n", filename, (long)SAGE_GetErrorCode());
+    return FALSE;
+  }
+  for (idx = 0;idx <= config->param_mask;idx++) {
+    chain = 0;
+    for (param = config->param_buckets[idx];param != NULL;param = (SAGE_ConfParameter *)param->next_hash) {
+      chain++;
+    }
+    used += (chain > 0);
+    longest = (chain > longest) ? chain : longest;
+  }
+  for (section = config->sections;section != NULL;section = (SAGE_ConfSection *)section->next_section) {
+    nb_sections++;
+  }
+  printf("%s : %lu sections, %lu parameters, %lu/%lu buckets used, longest chain %lu\n",
+         filename, nb_sections, config->nb_params, used, config->param_mask + 1, longest);
+  SAGE_ReleaseConfigurationFile(config);
+  return TRUE;
+}
+
+int main(int argc, char **argv)
+{
+  BOOL success;
+
+  if (argc >= 2 && strcmp(argv[1], "-b") == 0) {
+    success = Bench((argc > 2) ? atol(argv[2]) : 2000);
+  } else if (argc >= 2 && strcmp(argv[1], "-f") == 0) {
+    success = Fuzz((argc > 2) ? atol(argv[2]) : 10000);
+  } else if (argc == 2) {
+    success = Check(argv[1]);
+  } else {
+    fprintf(stderr, "usage : cfgcheck file.ini | -b [parameters] | -f [iterations]\n");
+    return EXIT_FAILURE;
+  }
+  SAGE_ReleaseMem();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+/**
+ * collbench.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, benchmark the collision world
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -o collbench collbench.c host/amiga.c
+ *           ../src/sage_collision.c ../src/sage_memory.c ../src/sage_error.c
+ *           ../src/sage_logger.c
+ * Usage : collbench [frames] [objects]
+ * 
+ * The tool links the engine collision world with the host shims and runs the
+ * loop of the video_collision test : 2000 objects (one troll for seven
+ * bullets) are moved at random on twice the screen size, the world finds the
+ * colliding pairs and a brute force loop tests every pair. Both counts must
+ * match and the times are compared. The sprite module needs the video device
+ * so the tool gives its own sprites, without collision masks, to the world :
+ * the pairs are found with the boxes only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <sage/sage_sprite.h>
+#include <sage/sage_error.h>
+#include <sage/sage_collision.h>
+
+#define SCREEN_WIDTH        640
+#define SCREEN_HEIGHT       480
+
+#define SPR_BULLET          0
+#define SPR_TROLL           1
+#define NB_SPRITES          2
+
+#define BENCH_FRAMES        100
+#define NB_OBJECTS          2000
+#define CELL_SIZE           32
+
+#define LAYER_PLAYER        1
+#define LAYER_ENEMY         2
+
+SAGE_Sprite Sprites[NB_SPRITES];
+
+/**
+ * Sprites of the bank, as SAGE_AddSpriteToBank with SSPR_HS_MIDDLE
+ */
+SAGE_Sprite *SAGE_GetSprite(UWORD index, UWORD sprite)
+{
+  return (sprite < NB_SPRITES) ? &(Sprites[sprite]) : NULL;
+}
+
+/**
+ * Box collision of sage_sprite.c, boxes which touch each other collide
+ */
+BOOL SAGE_BoxCollide(LONG x1, LONG y1, LONG w1, LONG h1, LONG x2, LONG y2, LONG w2, LONG h2)
+{
+  if (x2 > (x1 + w1)) return FALSE;
+  if (x1 > (x2 + w2)) return FALSE;
+  if (y2 > (y1 + h1)) return FALSE;
+  if (y1 > (y2 + h2)) return FALSE;
+  return TRUE;
+}
+
+/**
+ * The sprites have no mask, the world never refines its pairs
+ */
+BOOL SAGE_MaskCollide(SAGE_Sprite *sprite1, LONG x1, LONG y1, SAGE_Sprite *sprite2, LONG x2, LONG y2)
+{
+  return SAGE_BoxCollide(x1, y1, sprite1->width, sprite1->height, x2, y2, sprite2->width, sprite2->height);
+}
+
+/**
+ * Set a sprite size and its middle hotspot
+ */
+void SetSprite(UWORD sprite, ULONG width, ULONG height)
+{
+  Sprites[sprite].width = width;
+  Sprites[sprite].height = height;
+  Sprites[sprite].hs_x = width / 2;
+  Sprites[sprite].hs_y = height / 2;
+}
+
+/**
+ * Sprite of an object, one troll for seven objects
+ */
+UWORD ObjectSprite(long obj)
+{
+  return (obj % 7) ? SPR_BULLET : SPR_TROLL;
+}
+
+/**
+ * Count the colliding pairs by testing every pair, odd objects are players
+ * and only collide with enemies
+ */
+unsigned long BruteForce(long *xpos, long *ypos, long nb_objects)
+{
+  SAGE_Sprite *spr1, *spr2;
+  unsigned long count = 0;
+  long obj1, obj2;
+
+  for (obj1 = 0;obj1 < nb_objects;obj1++) {
+    spr1 = &(Sprites[ObjectSprite(obj1)]);
+    for (obj2 = obj1 + 1;obj2 < nb_objects;obj2++) {
+      spr2 = &(Sprites[ObjectSprite(obj2)]);
+      if (((obj1 & 1) == 0 || (obj2 & 1) == 0)
+          && SAGE_BoxCollide(xpos[obj1] - spr1->hs_x, ypos[obj1] - spr1->hs_y, spr1->width, spr1->height, xpos[obj2] - spr2->hs_x, ypos[obj2] - spr2->hs_y, spr2->width, spr2->height)) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+int main(int argc, char **argv)
+{
+  SAGE_CollisionWorld *world;
+  WORD *objects;
+  long *xpos, *ypos, frames, nb_objects, frame, obj, errors;
+  unsigned long brute_count, pairs;
+  clock_t start, world_time, brute_time;
+
+  frames = argc > 1 ? atol(argv[1]) : BENCH_FRAMES;
+  nb_objects = argc > 2 ? atol(argv[2]) : NB_OBJECTS;
+  if (frames < 1 || nb_objects < 1 || nb_objects > 32767) {
+    fprintf(stderr, "Usage : collbench [frames] [objects]\n");
+    return 1;
+  }
+  objects = calloc(nb_objects, sizeof(WORD));
+  xpos = calloc(nb_objects, sizeof(long));
+  ypos = calloc(nb_objects, sizeof(long));
+  world = SAGE_CreateCollisionWorld((UWORD)nb_objects, nb_objects * 4, CELL_SIZE);
+  if (objects == NULL || xpos == NULL || ypos == NULL || world == NULL) {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+  SetSprite(SPR_BULLET, 16, 16);
+  SetSprite(SPR_TROLL, 96, 112);
+  for (obj = 0;obj < nb_objects;obj++) {
+    if (obj & 1) {
+      objects[obj] = SAGE_AddCollisionObject(world, 0, ObjectSprite(obj), LAYER_PLAYER, LAYER_ENEMY);
+    } else {
+      objects[obj] = SAGE_AddCollisionObject(world, 0, ObjectSprite(obj), LAYER_ENEMY, LAYER_PLAYER|LAYER_ENEMY);
+    }
+  }
+  srand(1);
+  errors = 0;
+  pairs = 0;
+  world_time = 0;
+  brute_time = 0;
+  for (frame = 0;frame < frames;frame++) {
+    for (obj = 0;obj < nb_objects;obj++) {
+      xpos[obj] = (rand() % (SCREEN_WIDTH * 2)) - 32;
+      ypos[obj] = (rand() % (SCREEN_HEIGHT * 2)) - 32;
+      SAGE_MoveCollisionObject(world, objects[obj], xpos[obj], ypos[obj]);
+    }
+    start = clock();
+    if (!SAGE_FindCollisions(world)) {
+      fprintf(stderr, "Frame %ld : collision search failed (error %d)\n", frame, (int)SAGE_GetErrorCode());
+      return 1;
+    }
+    world_time += clock() - start;
+    start = clock();
+    brute_count = BruteForce(xpos, ypos, nb_objects);
+    brute_time += clock() - start;
+    pairs += brute_count;
+    if (brute_count != SAGE_GetNbCollisions(world)) {
+      printf("Frame %ld : world found %lu pairs, brute force found %lu pairs\n", frame, (unsigned long)SAGE_GetNbCollisions(world), brute_count);
+      errors++;
+    }
+  }
+  printf("%ld objects, %ld frames, %lu pairs by frame, %ld errors\n", nb_objects, frames, pairs / frames, errors);
+  printf("  Collision world : %.1f us per frame\n", (double)world_time * 1000000.0 / CLOCKS_PER_SEC / frames);
+  printf("  Brute force     : %.1f us per frame\n", (double)brute_time * 1000000.0 / CLOCKS_PER_SEC / frames);
+  SAGE_ReleaseCollisionWorld(world);
+  free(ypos);
+  free(xpos);
+  free(objects);
+  return errors != 0;
+}
@@ -0,0 +1,290 @@
+/**
+ * drawcheck.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, check the batched primitives and their clipping
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -DSAGE_DRAW_ASM=0 -o drawcheck drawcheck.c
+ *           host/amiga.c ../src/sage_draw.c ../src/sage_error.c ../src/sage_logger.c
+ * Usage : drawcheck [iterations]
+ * 
+ * The tool links sage_draw.c built with the portable C functions instead of
+ * the fast draw assembly, so the batch, the clipping and the edge code run on
+ * the host. Random lines, triangles and flat quads are drawn in 8, 16 and 32
+ * bits bitmaps and checked :
+ *   - a clipped primitive never writes out of the clipping zone,
+ *   - the three depths write the same pixels,
+ *   - a clipped polygon writes the pixels of the same polygon drawn without
+ *     clipping on a larger bitmap, inside the clipping zone,
+ *   - a line inside the clipping zone is drawn the same with and without
+ *     clipping, from its first to its last point.
+ * Build it with -fsanitize=address to catch the writes out of the buffers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sage/sage_draw.h>
+
+#define WIDTH               96
+#define HEIGHT              64
+#define MARGIN              (RANGE * 2)
+#define RANGE               48                    // Coordinates out of the bitmap, quads are up to 2 * RANGE wide
+#define BACKGROUND          0
+#define INK                 1
+#define DEPTHS              3
+
+static SAGE_Screen screen;
+static SAGE_Bitmap *back_bitmap;
+
+/**
+ * Engine functions used by sage_draw.c
+ */
+SAGE_Screen *SAGE_GetScreen(VOID)
+{
+  return &screen;
+}
+
+SAGE_Bitmap *SAGE_GetBackBitmap(VOID)
+{
+  return back_bitmap;
+}
+
+ULONG SAGE_RemapColorToPixFormat(ULONG color, ULONG pixformat)
+{
+  return color;
+}
+
+static ULONG PixelSize(ULONG depth)
+{
+  return depth == SBMP_DEPTH8 ? sizeof(UBYTE) : (depth == SBMP_DEPTH16 ? sizeof(UWORD) : sizeof(ULONG));
+}
+
+static SAGE_Bitmap *NewBitmap(ULONG width, ULONG height, ULONG depth)
+{
+  SAGE_Bitmap *bitmap;
+  ULONG row;
+
+  bitmap = calloc(1, sizeof(SAGE_Bitmap));
+  bitmap->width = width;
+  bitmap->height = height;
+  bitmap->depth = depth;
+  bitmap->bpr = width * PixelSize(depth);
+  bitmap->pixformat = depth == SBMP_DEPTH8 ? PIXFMT_CLUT : PIXFMT_ARGB32;
+  bitmap->bitmap_buffer = calloc(height, bitmap->bpr);
+  bitmap->first_buffer = malloc(SBMP_DRAWBUFSIZE);
+  bitmap->second_buffer = malloc(SBMP_DRAWBUFSIZE);
+  bitmap->row_offsets = malloc(sizeof(ULONG) * height);
+  for (row = 0;row < height;row++) {
+    bitmap->row_offsets[row] = row * width;
+  }
+  return bitmap;
+}
+
+static VOID FreeBitmap(SAGE_Bitmap *bitmap)
+{
+  free(bitmap->bitmap_buffer);
+  free(bitmap->first_buffer);
+  free(bitmap->second_buffer);
+  free(bitmap->row_offsets);
+  free(bitmap);
+}
+
+static ULONG GetPixel(SAGE_Bitmap *bitmap, LONG x, LONG y)
+{
+  UBYTE *pixel;
+
+  pixel = (UBYTE *)bitmap->bitmap_buffer + (y * bitmap->bpr) + (x * PixelSize(bitmap->depth));
+  if (bitmap->depth == SBMP_DEPTH8) {
+    return *pixel;
+  } else if (bitmap->depth == SBMP_DEPTH16) {
+    return *((UWORD *)pixel);
+  }
+  return *((ULONG *)pixel);
+}
+
+static LONG Random(LONG low, LONG high)
+{
+  return low + (rand() % (high - low + 1));
+}
+
+static LONG RandomX(VOID)
+{
+  return Random(-RANGE, WIDTH + RANGE - 1);
+}
+
+static LONG RandomY(VOID)
+{
+  return Random(-RANGE, HEIGHT + RANGE - 1);
+}
+
+/**
+ * Draw one primitive on a bitmap, kind 0 is a line, 1 a triangle and 2 a flat
+ * quad, coordinates are moved by offset
+ */
+static BOOL Draw(SAGE_Bitmap *bitmap, UWORD kind, LONG *coords, LONG offset, BOOL clipped)
+{
+  SAGE_Line line;
+  SAGE_Triangle triangle;
+  SAGE_FlatQuad quad;
+
+  back_bitmap = bitmap;
+  if (kind == 0) {
+    line.x1 = coords[0] + offset; line.y1 = coords[1] + offset;
+    line.x2 = coords[2] + offset; line.y2 = coords[3] + offset;
+    line.color = INK;
+    return clipped ? SAGE_DrawClippedLineArray(&line, 1) : SAGE_DrawLineArray(&line, 1);
+  } else if (kind == 1) {
+    triangle.x1 = coords[0] + offset; triangle.y1 = coords[1] + offset;
+    triangle.x2 = coords[2] + offset; triangle.y2 = coords[3] + offset;
+    triangle.x3 = coords[4] + offset; triangle.y3 = coords[5] + offset;
+    triangle.color = INK;
+    return clipped ? SAGE_DrawClippedTriangleArray(&triangle, 1) : SAGE_DrawTriangleArray(&triangle, 1);
+  }
+  quad.x1 = coords[0] + offset; quad.x2 = coords[1] + offset; quad.yt = coords[2] + offset;
+  quad.x3 = coords[3] + offset; quad.x4 = coords[4] + offset; quad.yb = coords[5] + offset;
+  quad.color = INK;
+  return clipped ? SAGE_DrawClippedFlatQuadArray(&quad, 1) : SAGE_DrawFlatQuadArray(&quad, 1);
+}
+
+/**
+ * Make random coordinates for a primitive
+ */
+static VOID MakeCoords(UWORD kind, LONG *coords)
+{
+  if (kind == 2) {
+    coords[0] = RandomX();
+    coords[1] = coords[0] + Random(0, RANGE);
+    coords[2] = RandomY();
+    coords[3] = RandomX();
+    coords[4] = coords[3] + Random(0, RANGE);
+    coords[5] = coords[2] + Random(1, RANGE);
+  } else {
+    coords[0] = RandomX(); coords[1] = RandomY();
+    coords[2] = RandomX(); coords[3] = RandomY();
+    coords[4] = RandomX(); coords[5] = RandomY();
+  }
+}
+
+static BOOL Inside(LONG x, LONG y)
+{
+  return x >= screen.clipping.left && x <= screen.clipping.right && y >= screen.clipping.top && y <= screen.clipping.bottom;
+}
+
+/**
+ * Check a primitive drawn with clipping in each depth
+ */
+static LONG CheckPrimitive(UWORD kind, LONG *coords, SAGE_Bitmap **bitmaps, SAGE_Bitmap *reference)
+{
+  LONG x, y, errors, depth;
+  ULONG pixel;
+
+  errors = 0;
+  for (depth = 0;depth < DEPTHS;depth++) {
+    memset(bitmaps[depth]->bitmap_buffer, BACKGROUND, bitmaps[depth]->height * bitmaps[depth]->bpr);
+    Draw(bitmaps[depth], kind, coords, 0, TRUE);
+  }
+  // Lines are clipped on their end points, only polygons match the larger bitmap
+  memset(reference->bitmap_buffer, BACKGROUND, reference->height * reference->bpr);
+  if (kind != 0) {
+    Draw(reference, kind, coords, MARGIN, FALSE);
+  }
+  for (y = 0;y < HEIGHT;y++) {
+    for (x = 0;x < WIDTH;x++) {
+      pixel = GetPixel(bitmaps[0], x, y);
+      if (pixel != BACKGROUND && !Inside(x, y)) {
+        errors++;
+      }
+      for (depth = 1;depth < DEPTHS;depth++) {
+        if (GetPixel(bitmaps[depth], x, y) != pixel) {
+          errors++;
+        }
+      }
+      if (kind != 0 && Inside(x, y) && GetPixel(reference, x + MARGIN, y + MARGIN) != pixel) {
+        errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+/**
+ * Check a line inside the clipping zone
+ */
+static LONG CheckInsideLine(SAGE_Bitmap *clipped, SAGE_Bitmap *unclipped)
+{
+  LONG coords[6], x, y, errors;
+
+  coords[0] = Random(screen.clipping.left, screen.clipping.right);
+  coords[1] = Random(screen.clipping.top, screen.clipping.bottom);
+  coords[2] = Random(screen.clipping.left, screen.clipping.right);
+  coords[3] = Random(screen.clipping.top, screen.clipping.bottom);
+  memset(clipped->bitmap_buffer, BACKGROUND, clipped->height * clipped->bpr);
+  memset(unclipped->bitmap_buffer, BACKGROUND, unclipped->height * unclipped->bpr);
+  Draw(clipped, 0, coords, 0, TRUE);
+  Draw(unclipped, 0, coords, 0, FALSE);
+  errors = 0;
+  for (y = 0;y < HEIGHT;y++) {
+    for (x = 0;x < WIDTH;x++) {
+      if (GetPixel(clipped, x, y) != GetPixel(unclipped, x, y)) {
+        errors++;
+      }
+    }
+  }
+  if (GetPixel(unclipped, coords[0], coords[1]) != INK || GetPixel(unclipped, coords[2], coords[3]) != INK) {
+    errors++;
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  static char *names[] = { "lines", "triangles", "flat quads" };
+  SAGE_Bitmap *bitmaps[DEPTHS], *reference, *unclipped;
+  LONG iterations, iteration, coords[6], errors, failures, total;
+  UWORD kind;
+
+  iterations = argc > 1 ? atol(argv[1]) : 10000;
+  srand(1);
+  screen.clipping.left = 7;
+  screen.clipping.top = 5;
+  screen.clipping.right = WIDTH - 11;
+  screen.clipping.bottom = HEIGHT - 9;
+  bitmaps[0] = NewBitmap(WIDTH, HEIGHT, SBMP_DEPTH8);
+  bitmaps[1] = NewBitmap(WIDTH, HEIGHT, SBMP_DEPTH16);
+  bitmaps[2] = NewBitmap(WIDTH, HEIGHT, SBMP_DEPTH32);
+  reference = NewBitmap(WIDTH + (MARGIN * 2), HEIGHT + (MARGIN * 2), SBMP_DEPTH8);
+  unclipped = NewBitmap(WIDTH, HEIGHT, SBMP_DEPTH8);
+  total = 0;
+  for (kind = 0;kind < 3;kind++) {
+    failures = 0;
+    for (iteration = 0;iteration < iterations;iteration++) {
+      MakeCoords(kind, coords);
+      if ((errors = CheckPrimitive(kind, coords, bitmaps, reference)) > 0) {
+        if (failures++ < 5) {
+          printf("  %s %ld,%ld %ld,%ld %ld,%ld : %ld bad pixels\n", names[kind], coords[0], coords[1], coords[2], coords[3], coords[4], coords[5], errors);
+        }
+      }
+    }
+    printf("%ld clipped %s, %ld failed\n", iterations, names[kind], failures);
+    total += failures;
+  }
+  failures = 0;
+  for (iteration = 0;iteration < iterations;iteration++) {
+    if (CheckInsideLine(bitmaps[0], unclipped) > 0) {
+      failures++;
+    }
+  }
+  printf("%ld lines inside the clipping zone, %ld failed\n", iterations, failures);
+  total += failures;
+  for (kind = 0;kind < DEPTHS;kind++) {
+    FreeBitmap(bitmaps[kind]);
+  }
+  FreeBitmap(reference);
+  FreeBitmap(unclipped);
+  return total > 0;
+}
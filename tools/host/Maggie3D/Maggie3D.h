@@ -0,0 +1,19 @@
+/**
+ * Maggie3D/Maggie3D.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, Maggie3D types used by the SAGE headers
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_MAGGIE3D_MAGGIE3D_H_
+#define _HOST_MAGGIE3D_MAGGIE3D_H_
+
+#include <exec/types.h>
+
+typedef struct M3D_Context M3D_Context;
+typedef struct M3D_Texture M3D_Texture;
+
+#endif
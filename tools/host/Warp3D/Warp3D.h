@@ -0,0 +1,26 @@
+/**
+ * Warp3D/Warp3D.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, Warp3D types used by the SAGE headers
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_WARP3D_WARP3D_H_
+#define _HOST_WARP3D_WARP3D_H_
+
+#include <exec/types.h>
+
+#define W3D_CHUNKY            1
+#define W3D_A1R5G5B5          2
+#define W3D_R5G6B5            3
+#define W3D_R8G8B8            4
+#define W3D_A8R8G8B8          6
+#define W3D_R8G8B8A8          11
+
+typedef struct W3D_Context W3D_Context;
+typedef struct W3D_Texture W3D_Texture;
+
+#endif
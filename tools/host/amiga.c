@@ -0,0 +1,183 @@
+/**
+ * amiga.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, exec and dos functions over the C library
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * The host tools build the engine sources with -Ihost before -I../include,
+ * the shim headers replace the Amiga includes, the debug macros and the
+ * context, so the modules that only need memory, files and logs (memory,
+ * error, logger, configuration, draw with SAGE_DRAW_ASM 0, 3D mappers with
+ * SAGE_MAPPER_ASM 0) run unchanged on the host.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <exec/exec.h>
+#include <dos/dos.h>
+
+#include <sage/sage_context.h>
+
+/** @var SAGE context, only read by the logger */
+SAGE_Context SageContext;
+
+/**
+ * Allocate memory with malloc
+ */
+APTR AllocMem(ULONG size, ULONG attributes)
+{
+  APTR memory;
+
+  if ((memory = malloc(size)) != NULL && (attributes & MEMF_CLEAR)) {
+    memset(memory, 0, size);
+  }
+  return memory;
+}
+
+/**
+ * Free memory
+ */
+VOID FreeMem(APTR memory, ULONG size)
+{
+  free(memory);
+}
+
+/**
+ * Available memory, the host does not tell
+ */
+ULONG AvailMem(ULONG attributes)
+{
+  return 0;
+}
+
+/**
+ * Type of memory, the host only has fast memory
+ */
+ULONG TypeOfMem(APTR memory)
+{
+  return MEMF_PUBLIC|MEMF_FAST;
+}
+
+/**
+ * Open a file, MODE_NEWFILE creates it
+ */
+BPTR Open(STRPTR name, LONG mode)
+{
+  return (BPTR)fopen((char *)name, mode == MODE_NEWFILE ? "wb" : "rb");
+}
+
+/**
+ * Close a file
+ */
+LONG Close(BPTR file)
+{
+  return fclose((FILE *)file) == 0;
+}
+
+/**
+ * Read from a file
+ */
+LONG Read(BPTR file, APTR buffer, LONG length)
+{
+  return (LONG)fread(buffer, 1, length, (FILE *)file);
+}
+
+/**
+ * Seek in a file and return the previous position
+ */
+LONG Seek(BPTR file, LONG position, LONG mode)
+{
+  LONG previous;
+
+  previous = ftell((FILE *)file);
+  if (fseek((FILE *)file, position, mode == OFFSET_BEGINNING ? SEEK_SET : (mode == OFFSET_END ? SEEK_END : SEEK_CUR)) != 0) {
+    return -1;
+  }
+  return previous;
+}
+
+/**
+ * Write a string to a file
+ */
+LONG FPuts(BPTR file, STRPTR string)
+{
+  return fputs((char *)string, (FILE *)file) < 0 ? -1 : 0;
+}
+
+/**
+ * Lock a file, the lock is a copy of its name
+ */
+BPTR Lock(STRPTR name, LONG mode)
+{
+  struct stat status;
+  char *lock;
+
+  if (stat((char *)name, &status) != 0 || (lock = malloc(strlen((char *)name) + 1)) == NULL) {
+    return 0;
+  }
+  strcpy(lock, (char *)name);
+  return (BPTR)lock;
+}
+
+/**
+ * Unlock a file
+ */
+VOID UnLock(BPTR lock)
+{
+  free((char *)lock);
+}
+
+/**
+ * Examine a locked file, the date is counted from 1/1/1978 like AmigaDOS
+ */
+LONG Examine(BPTR lock, struct FileInfoBlock *fib)
+{
+  struct stat status;
+  LONG seconds;
+
+  if (stat((char *)lock, &status) != 0) {
+    return FALSE;
+  }
+  fib->fib_Size = (LONG)status.st_size;
+  seconds = (LONG)(status.st_mtim.tv_sec - 252460800L);
+  fib->fib_Date.ds_Days = seconds / 86400;
+  fib->fib_Date.ds_Minute = (seconds % 86400) / 60;
+  fib->fib_Date.ds_Tick = (seconds % 60) * TICKS_PER_SECOND + status.st_mtim.tv_nsec / (1000000000L / TICKS_PER_SECOND);
+  return TRUE;
+}
+
+/**
+ * Compare two dates, negative when the first one is later
+ */
+LONG CompareDates(struct DateStamp *date1, struct DateStamp *date2)
+{
+  if (date1->ds_Days != date2->ds_Days) {
+    return date2->ds_Days - date1->ds_Days;
+  }
+  if (date1->ds_Minute != date2->ds_Minute) {
+    return date2->ds_Minute - date1->ds_Minute;
+  }
+  return date2->ds_Tick - date1->ds_Tick;
+}
+
+/**
+ * Allocate a dos object, only the file info block
+ */
+APTR AllocDosObject(ULONG type, APTR tags)
+{
+  return type == DOS_FIB ? calloc(1, sizeof(struct FileInfoBlock)) : NULL;
+}
+
+/**
+ * Free a dos object
+ */
+VOID FreeDosObject(ULONG type, APTR object)
+{
+  free(object);
+}
@@ -0,0 +1,16 @@
+/**
+ * clib/dos_protos.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, see dos/dos.h
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_CLIB_DOS_PROTOS_H_
+#define _HOST_CLIB_DOS_PROTOS_H_
+
+#include <dos/dos.h>
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * cybergraphx/cybergraphics.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, Cybergraphics pixel formats
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_CYBERGRAPHX_CYBERGRAPHICS_H_
+#define _HOST_CYBERGRAPHX_CYBERGRAPHICS_H_
+
+#include <exec/types.h>
+
+#define PIXFMT_LUT8           0UL
+#define PIXFMT_RGB15          1UL
+#define PIXFMT_BGR15          2UL
+#define PIXFMT_RGB15PC        3UL
+#define PIXFMT_BGR15PC        4UL
+#define PIXFMT_RGB16          5UL
+#define PIXFMT_BGR16          6UL
+#define PIXFMT_RGB16PC        7UL
+#define PIXFMT_BGR16PC        8UL
+#define PIXFMT_RGB24          9UL
+#define PIXFMT_BGR24          10UL
+#define PIXFMT_ARGB32         11UL
+#define PIXFMT_BGRA32         12UL
+#define PIXFMT_RGBA32         13UL
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * devices/timer.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, timer structures used by the SAGE headers
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_DEVICES_TIMER_H_
+#define _HOST_DEVICES_TIMER_H_
+
+#include <sys/time.h>
+
+#include <exec/io.h>
+
+struct timerequest;
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * dos/dos.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, dos.library file functions
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_DOS_DOS_H_
+#define _HOST_DOS_DOS_H_
+
+#include <exec/types.h>
+
+#define MODE_OLDFILE          1005
+#define MODE_NEWFILE          1006
+
+#define OFFSET_BEGINNING      -1
+#define OFFSET_CURRENT        0
+#define OFFSET_END            1
+
+#define SHARED_LOCK           -2
+
+#define TICKS_PER_SECOND      50
+#define DOS_FIB               2
+
+struct DateStamp {
+  LONG ds_Days;
+  LONG ds_Minute;
+  LONG ds_Tick;
+};
+
+struct FileInfoBlock {
+  LONG fib_Size;
+  struct DateStamp fib_Date;
+};
+
+/** Open a file with fopen */
+BPTR Open(STRPTR, LONG);
+
+/** Close a file */
+LONG Close(BPTR);
+
+/** Read from a file */
+LONG Read(BPTR, APTR, LONG);
+
+/** Seek in a file and return the previous position */
+LONG Seek(BPTR, LONG, LONG);
+
+/** Write a string to a file */
+LONG FPuts(BPTR, STRPTR);
+
+BPTR Lock(STRPTR, LONG);
+
+VOID UnLock(BPTR);
+
+LONG Examine(BPTR, struct FileInfoBlock *);
+
+LONG CompareDates(struct DateStamp *, struct DateStamp *);
+
+APTR AllocDosObject(ULONG, APTR);
+
+VOID FreeDosObject(ULONG, APTR);
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * exec/exec.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, exec.library memory functions
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_EXEC_EXEC_H_
+#define _HOST_EXEC_EXEC_H_
+
+#include <exec/types.h>
+
+#define MEMF_ANY              0
+#define MEMF_PUBLIC           (1L << 0)
+#define MEMF_CHIP             (1L << 1)
+#define MEMF_FAST             (1L << 2)
+#define MEMF_CLEAR            (1L << 16)
+
+/** Allocate memory with malloc */
+APTR AllocMem(ULONG, ULONG);
+
+/** Free memory */
+VOID FreeMem(APTR, ULONG);
+
+/** Available memory, always 0 */
+ULONG AvailMem(ULONG);
+
+/** Type of memory, the host only has fast memory */
+ULONG TypeOfMem(APTR);
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ * exec/io.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, exec IO structures used by the SAGE headers
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_EXEC_IO_H_
+#define _HOST_EXEC_IO_H_
+
+#include <exec/types.h>
+
+struct MsgPort;
+
+#endif
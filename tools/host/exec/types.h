@@ -0,0 +1,35 @@
+/**
+ * exec/types.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, Amiga base types
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_EXEC_TYPES_H_
+#define _HOST_EXEC_TYPES_H_
+
+#include <stddef.h>
+
+// LONG and ULONG keep the size of a pointer, the engine casts addresses to ULONG
+typedef void VOID;
+typedef void *APTR;
+typedef long LONG;
+typedef unsigned long ULONG;
+typedef short WORD;
+typedef unsigned short UWORD;
+typedef signed char BYTE;
+typedef unsigned char UBYTE;
+typedef short BOOL;
+typedef float FLOAT;
+typedef double DOUBLE;
+typedef unsigned char *STRPTR;
+typedef long BPTR;
+typedef unsigned long LONGBITS;
+
+#define TRUE                  1
+#define FALSE                 0
+
+#endif
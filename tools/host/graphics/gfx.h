@@ -0,0 +1,25 @@
+/**
+ * graphics/gfx.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, graphics structures used by the SAGE headers
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_GRAPHICS_GFX_H_
+#define _HOST_GRAPHICS_GFX_H_
+
+#include <exec/types.h>
+
+#define JAM1                  0
+#define JAM2                  1
+
+struct BitMap;
+
+struct RastPort {
+  struct BitMap *BitMap;
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * intuition/intuitionbase.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, intuition structures used by the SAGE headers
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_INTUITION_INTUITIONBASE_H_
+#define _HOST_INTUITION_INTUITIONBASE_H_
+
+#include <exec/types.h>
+
+#define SELECTDOWN            0x68
+#define SELECTUP              0xE8
+#define MENUDOWN              0x69
+#define MENUUP                0xE9
+
+struct Screen;
+struct Window;
+struct ScreenBuffer;
+struct IntuiMessage;
+struct TextFont;
+
+#endif
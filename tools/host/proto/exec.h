@@ -0,0 +1,16 @@
+/**
+ * proto/exec.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, see exec/exec.h
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_PROTO_EXEC_H_
+#define _HOST_PROTO_EXEC_H_
+
+#include <exec/exec.h>
+
+#endif
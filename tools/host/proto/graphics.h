@@ -0,0 +1,16 @@
+/**
+ * proto/graphics.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, see graphics/gfx.h
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _HOST_PROTO_GRAPHICS_H_
+#define _HOST_PROTO_GRAPHICS_H_
+
+#include <graphics/gfx.h>
+
+#endif
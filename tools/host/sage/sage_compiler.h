@@ -0,0 +1,19 @@
+/**
+ * sage/sage_compiler.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, register arguments are plain arguments
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_COMPILER_H_
+#define _SAGE_COMPILER_H_
+
+#define SAVEDS
+#define ASM
+#define REG(r,a)              a
+#define INTERRUPT
+
+#endif
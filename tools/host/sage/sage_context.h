@@ -0,0 +1,29 @@
+/**
+ * sage/sage_context.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, context without the devices but the 3D renderer
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_CONTEXT_H_
+#define _SAGE_CONTEXT_H_
+
+#include <exec/types.h>
+
+#include <sage/sage_3drender.h>
+
+/** SAGE 3D, the mappers only read the Z buffer */
+typedef struct {
+  SAGE_Render render;
+} SAGE_3DDevice;
+
+/** SAGE context, the logger only reads the trace flag */
+typedef struct {
+  BOOL TraceDebug;
+  SAGE_3DDevice *Sage3D;
+} SAGE_Context;
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * sage/sage_debug.h
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host shim, debug macros without the 3D dump functions
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ */
+
+#ifndef _SAGE_DEBUG_H_
+#define _SAGE_DEBUG_H_
+
+#if _SAGE_DEBUG_MODE_ == 1
+#define SD(x) x
+#else
+#define SD(x)
+#endif
+
+#if _SAGE_SAFE_MODE_ == 1
+#define SAFE(x) x
+#else
+#define SAFE(x)
+#endif
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * map2stm.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, pack a raw tilemap to a SAGE RLE tilemap (STM)
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -o map2stm map2stm.c
+ * Usage : map2stm cols rows bpt file.map file.stm
+ * 
+ * The raw map is the file read by SAGE_LoadTileMap, cols x rows tiles of bpt
+ * bytes (1 or 2, big endian). The STM file starts with a SAGE_TileMapHeader
+ * (see sage_tilemap.h) followed by packets of tiles, each packet starts with
+ * a control byte :
+ *   0x00-0x7F : (control + 1) literal tiles follow
+ *   0x80-0xFF : the next tile is repeated (control & 0x7F) + 2 times
+ * The packed file is unpacked again and compared to the map before exit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define STM_TAG             0x53544D52              // "STMR"
+#define STM_VERSION         1
+#define STM_HEADERSIZE      12
+#define STM_RUN             0x80
+#define STM_MAXRUN          129
+#define STM_MAXLITERAL      128
+
+/**
+ * Compare two tiles of the map
+ */
+static int SameTile(const uint8_t *map, long tile1, long tile2, int bpt)
+{
+  return memcmp(map + tile1 * bpt, map + tile2 * bpt, bpt) == 0;
+}
+
+/**
+ * Pack the map tiles, return the packed size
+ */
+static long PackMap(const uint8_t *map, long nb_tiles, int bpt, uint8_t *packed)
+{
+  long tile, run, literal, size;
+
+  size = 0;
+  tile = 0;
+  while (tile < nb_tiles) {
+    run = 1;
+    while ((tile + run) < nb_tiles && run < STM_MAXRUN && SameTile(map, tile, tile + run, bpt)) {
+      run++;
+    }
+    if (run >= 2) {
+      packed[size++] = (uint8_t)(STM_RUN | (run - 2));
+      memcpy(packed + size, map + tile * bpt, bpt);
+      size += bpt;
+      tile += run;
+    } else {
+      // Literal tiles up to the next run of 2 tiles
+      literal = 1;
+      while ((tile + literal) < nb_tiles && literal < STM_MAXLITERAL
+             && !((tile + literal + 1) < nb_tiles && SameTile(map, tile + literal, tile + literal + 1, bpt))) {
+        literal++;
+      }
+      packed[size++] = (uint8_t)(literal - 1);
+      memcpy(packed + size, map + tile * bpt, literal * bpt);
+      size += literal * bpt;
+      tile += literal;
+    }
+  }
+  return size;
+}
+
+/**
+ * Unpack the tiles with the rules of SAGE_UnpackTileMap
+ */
+static int UnpackMap(const uint8_t *packed, long packed_size, int bpt, uint8_t *map, long map_size)
+{
+  const uint8_t *end = packed + packed_size;
+  long done = 0, count, idx;
+  uint8_t control;
+
+  while (done < map_size && packed < end) {
+    control = *packed++;
+    if (control & STM_RUN) {
+      count = ((control & ~STM_RUN) + 2) * bpt;
+      if ((packed + bpt) > end || (done + count) > map_size) {
+        return 0;
+      }
+      for (idx = 0;idx < count;idx += bpt) {
+        memcpy(map + done + idx, packed, bpt);
+      }
+      packed += bpt;
+    } else {
+      count = (control + 1) * bpt;
+      if ((packed + count) > end || (done + count) > map_size) {
+        return 0;
+      }
+      memcpy(map + done, packed, count);
+      packed += count;
+    }
+    done += count;
+  }
+  return done == map_size;
+}
+
+/** Big endian writers */
+
+static void PutWord(FILE *fd, uint16_t value)
+{
+  fputc((value >> 8) & 0xff, fd);
+  fputc(value & 0xff, fd);
+}
+
+static void PutLong(FILE *fd, uint32_t value)
+{
+  PutWord(fd, (uint16_t)(value >> 16));
+  PutWord(fd, (uint16_t)value);
+}
+
+int main(int argc, char **argv)
+{
+  uint8_t *map, *packed, *check;
+  long cols, rows, map_size, packed_size;
+  int bpt, success;
+  FILE *fd;
+
+  if (argc != 6) {
+    fprintf(stderr, "usage : map2stm cols rows bpt file.map file.stm\n");
+    return EXIT_FAILURE;
+  }
+  cols = atol(argv[1]);
+  rows = atol(argv[2]);
+  bpt = atoi(argv[3]);
+  if (cols <= 0 || cols > 65535 || rows <= 0 || rows > 65535 || (bpt != 1 && bpt != 2)) {
+    fprintf(stderr, "Bad map size\n");
+    return EXIT_FAILURE;
+  }
+  map_size = cols * rows * bpt;
+  map = (uint8_t *)calloc(map_size, 1);
+  check = (uint8_t *)calloc(map_size, 1);
+  packed = (uint8_t *)malloc(map_size + (map_size / STM_MAXLITERAL) + 1);
+  success = 0;
+  if (map != NULL && check != NULL && packed != NULL) {
+    if ((fd = fopen(argv[4], "rb")) != NULL) {
+      // A short map file leaves the last tiles to 0 like SAGE_LoadTileMap
+      if (fread(map, 1, map_size, fd) > 0) {
+        packed_size = PackMap(map, cols * rows, bpt, packed);
+        if (UnpackMap(packed, packed_size, bpt, check, map_size) && memcmp(map, check, map_size) == 0) {
+          if ((fd = freopen(argv[5], "wb", fd)) != NULL) {
+            PutLong(fd, STM_TAG);
+            PutWord(fd, (uint16_t)cols);
+            PutWord(fd, (uint16_t)rows);
+            fputc(bpt, fd);
+            fputc(STM_VERSION, fd);
+            PutWord(fd, 0);
+            success = (fwrite(packed, 1, packed_size, fd) == (size_t)packed_size);
+            printf("%s : %ld bytes packed to %ld bytes\n", argv[5], map_size, packed_size + STM_HEADERSIZE);
+          } else {
+            fprintf(stderr, "Can't write %s\n", argv[5]);
+          }
+        } else {
+          fprintf(stderr, "Packed map check failed\n");
+        }
+      } else {
+        fprintf(stderr, "Can't read %s\n", argv[4]);
+      }
+      if (fd != NULL) {
+        fclose(fd);
+      }
+    } else {
+      fprintf(stderr, "Can't open %s\n", argv[4]);
+    }
+  }
+  free(map);
+  free(check);
+  free(packed);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
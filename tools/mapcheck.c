@@ -0,0 +1,518 @@
+/**
+ * mapcheck.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, check the C texture mappers against golden images
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -DSAGE_MAPPER_ASM=0 -o mapcheck mapcheck.c
+ *           host/amiga.c ../src/sage_3dtexmap.c ../src/sage_error.c ../src/sage_logger.c -lm
+ * Usage : mapcheck [-s|-b|-w]
+ * 
+ * The tool links sage_3dtexmap.c built with the C mappers only and renders the
+ * scripted triangle sets of the render3d_3dmapper test in 8 and 16 bits
+ * bitmaps, with a procedural texture, like SAGE_RenderSage3DElements does.
+ * Each set is rendered without Z buffer, with Z buffer and with perspective
+ * correction, the golden images of data/mapper.golden are the FNV-1a hashes
+ * of these frames.
+ *   mapcheck    : compare the frames with the golden images and check that
+ *                 the Hi-Z test and the lazy clear don't change a frame
+ *   mapcheck -s : save the frames hashes as the golden images
+ *   mapcheck -b : Mpixels/s of each mapper
+ *   mapcheck -w : write the frames as PGM (8 bits) and PPM (16 bits) images
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sage/sage_3dtexmap.h>
+#include <sage/sage_context.h>
+
+#define SCREEN_WIDTH          320
+#define SCREEN_HEIGHT         240
+
+#define TEX_SIZE              256
+#define TEX_WIDTH             255.0
+
+#define SET_BASIC             0
+#define SET_CLIPPED           1
+#define SET_DEPTH             2
+#define SET_SLIVERS           3
+#define SET_MESH              4
+#define SET_COUNT             5
+#define SET_MAX_ELEMENTS      512
+
+#define MESH_COLUMNS          16
+#define MESH_ROWS             12
+
+#define VARIANT_FLAT          0                     // No Z buffer
+#define VARIANT_ZBUFFER       1                     // Z buffer
+#define VARIANT_PERSPECTIVE   2                     // Z buffer and perspective correction
+#define VARIANT_COUNT         3
+
+#define DEPTHS                2
+#define GOLDEN_FILE           "data/mapper.golden"
+#define BENCH_LOOPS           200
+#define STALE_DEPTH           0                     // Z buffer garbage left for the lazy clear
+
+static char *SetNames[SET_COUNT] = { "basic", "clipped", "depth", "slivers", "mesh" };
+static char *VariantNames[VARIANT_COUNT] = { "flat", "zbuffer", "perspective" };
+static LONGBITS VariantOptions[VARIANT_COUNT] = { 0, S3DR_ZBUFFER, S3DR_ZBUFFER|S3DR_PERSPECTIVE };
+
+static SAGE_3DElement MapperSets[SET_COUNT][SET_MAX_ELEMENTS];
+static UWORD SetSize[SET_COUNT];
+
+static SAGE_3DDevice device;
+static SAGE_Clipping clipping;
+static SAGE_3DTexture textures[DEPTHS];
+static SAGE_Bitmap *bitmaps[DEPTHS];
+
+extern SAGE_Context SageContext;
+
+/**
+ * Engine function used by sage_3dtexmap.c
+ */
+BOOL SAGE_Get3DRenderOption(LONGBITS option)
+{
+  return (BOOL)((device.render.options & option) != 0);
+}
+
+static SAGE_Bitmap *NewBitmap(ULONG width, ULONG height, ULONG depth)
+{
+  SAGE_Bitmap *bitmap;
+
+  bitmap = calloc(1, sizeof(SAGE_Bitmap));
+  bitmap->width = width;
+  bitmap->height = height;
+  bitmap->depth = depth;
+  bitmap->bpr = width * (depth / 8);
+  bitmap->bitmap_buffer = calloc(height, bitmap->bpr);
+  return bitmap;
+}
+
+static VOID FreeBitmap(SAGE_Bitmap *bitmap)
+{
+  free(bitmap->bitmap_buffer);
+  free(bitmap);
+}
+
+/**
+ * Make the texture of a depth, every texel of the 16 bits texture is unique
+ */
+static VOID MakeTexture(SAGE_3DTexture *texture, ULONG depth)
+{
+  ULONG u, v;
+
+  memset(texture, 0, sizeof(SAGE_3DTexture));
+  texture->size = TEX_SIZE;
+  texture->bitmap = NewBitmap(TEX_SIZE, TEX_SIZE, depth);
+  for (v = 0;v < TEX_SIZE;v++) {
+    for (u = 0;u < TEX_SIZE;u++) {
+      if (depth == SBMP_DEPTH8) {
+        ((UBYTE *)texture->bitmap->bitmap_buffer)[v * TEX_SIZE + u] = (UBYTE)(((u >> 4) ^ (v >> 4)) * 16 + (u & 15));
+      } else {
+        ((UWORD *)texture->bitmap->bitmap_buffer)[v * TEX_SIZE + u] = (UWORD)((v << 8) | u);
+      }
+    }
+  }
+}
+
+/**
+ * Color of a pixel format, 3-3-2 index in 8 bits and RGB565 in 16 bits
+ */
+static ULONG RemapColor(ULONG color, ULONG depth)
+{
+  if (depth == SBMP_DEPTH8) {
+    return ((color >> 16) & 0xE0) | ((color >> 11) & 0x1C) | ((color >> 6) & 0x03);
+  }
+  return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+}
+
+/**
+ * Add a triangle to a set
+ */
+static VOID AddTriangle(UWORD set, FLOAT x1, FLOAT y1, FLOAT z1, FLOAT x2, FLOAT y2, FLOAT z2, FLOAT x3, FLOAT y3, FLOAT z3, WORD texture, ULONG color)
+{
+  SAGE_3DElement *element;
+
+  element = &(MapperSets[set][SetSize[set]++]);
+  element->type = S3DR_ELEM_TRIANGLE;
+  element->x1 = x1; element->y1 = y1; element->z1 = z1; element->u1 = 0.0; element->v1 = 0.0;
+  element->x2 = x2; element->y2 = y2; element->z2 = z2; element->u2 = TEX_WIDTH; element->v2 = 0.0;
+  element->x3 = x3; element->y3 = y3; element->z3 = z3; element->u3 = 0.0; element->v3 = TEX_WIDTH;
+  element->texture = texture;
+  element->color = color;
+}
+
+/**
+ * Build the scripted triangle sets, the same as the render3d_3dmapper test
+ */
+static VOID BuildSets(VOID)
+{
+  SAGE_3DElement *element;
+  UWORD column, row;
+  FLOAT x, y, size_x, size_y;
+
+  memset(SetSize, 0, sizeof(SetSize));
+  // Basic
+  AddTriangle(SET_BASIC, 20.0, 10.0, 50.0, 150.0, 10.0, 20.0, 120.0, 110.0, 100.0, 0, 0xff0000);
+  AddTriangle(SET_BASIC, 230.0, 15.0, 10.0, 170.0, 120.0, 10.0, 300.0, 120.0, 30.0, 0, 0x00ff00);
+  AddTriangle(SET_BASIC, 80.0, 125.0, 10.0, 20.0, 235.0, 40.0, 150.0, 190.0, 30.0, 0, 0x0000ff);
+  AddTriangle(SET_BASIC, 240.0, 128.0, 10.0, 170.0, 170.0, 20.0, 310.0, 233.0, 60.0, STEX_USECOLOR, 0xff00ff);
+  // Clipped
+  AddTriangle(SET_CLIPPED, -60.0, 20.0, 20.0, 90.0, 60.0, 40.0, -20.0, 200.0, 30.0, 0, 0xff0000);
+  AddTriangle(SET_CLIPPED, 260.0, 30.0, 20.0, 390.0, 120.0, 40.0, 250.0, 210.0, 30.0, 0, 0x00ff00);
+  AddTriangle(SET_CLIPPED, 100.0, -80.0, 20.0, 220.0, -30.0, 40.0, 160.0, 70.0, 30.0, STEX_USECOLOR, 0x0000ff);
+  AddTriangle(SET_CLIPPED, 110.0, 170.0, 20.0, 230.0, 200.0, 40.0, 140.0, 330.0, 30.0, 0, 0xffff00);
+  AddTriangle(SET_CLIPPED, -200.0, -200.0, 900.0, 600.0, -100.0, 900.0, 100.0, 500.0, 900.0, STEX_USECOLOR, 0x808080);
+  // Depth
+  AddTriangle(SET_DEPTH, 20.0, 20.0, 10.0, 300.0, 60.0, 200.0, 40.0, 220.0, 10.0, 0, 0xff0000);
+  AddTriangle(SET_DEPTH, 300.0, 20.0, 10.0, 20.0, 120.0, 200.0, 280.0, 220.0, 10.0, 0, 0x00ff00);
+  AddTriangle(SET_DEPTH, 160.0, 5.0, 100.0, 60.0, 235.0, 100.0, 260.0, 235.0, 100.0, STEX_USECOLOR, 0x0000ff);
+  element = &(MapperSets[SET_DEPTH][SetSize[SET_DEPTH]++]);
+  element->type = S3DR_ELEM_QUAD;
+  element->x1 = 100.0; element->y1 = 80.0; element->z1 = 50.0; element->u1 = 0.0; element->v1 = 0.0;
+  element->x2 = 220.0; element->y2 = 80.0; element->z2 = 150.0; element->u2 = TEX_WIDTH; element->v2 = 0.0;
+  element->x3 = 220.0; element->y3 = 160.0; element->z3 = 150.0; element->u3 = TEX_WIDTH; element->v3 = TEX_WIDTH;
+  element->x4 = 100.0; element->y4 = 160.0; element->z4 = 50.0; element->u4 = 0.0; element->v4 = TEX_WIDTH;
+  element->texture = 0;
+  element->color = 0xffffff;
+  // Slivers
+  AddTriangle(SET_SLIVERS, 10.0, 10.0, 10.0, 12.0, 10.0, 10.0, 300.0, 230.0, 10.0, 0, 0xff0000);
+  AddTriangle(SET_SLIVERS, 10.0, 200.0, 10.0, 310.0, 201.0, 10.0, 10.0, 202.0, 10.0, 0, 0x00ff00);
+  AddTriangle(SET_SLIVERS, 160.0, 5.0, 10.0, 161.0, 230.0, 10.0, 159.0, 120.0, 10.0, STEX_USECOLOR, 0x0000ff);
+  AddTriangle(SET_SLIVERS, 50.0, 50.0, 10.0, 51.0, 51.0, 10.0, 50.0, 52.0, 10.0, STEX_USECOLOR, 0xffff00);
+  AddTriangle(SET_SLIVERS, 200.0, 60.0, 10.0, 300.0, 61.0, 10.0, 250.0, 140.0, 10.0, 0, 0x00ffff);
+  AddTriangle(SET_SLIVERS, 30.0, 100.0, 10.0, 130.0, 99.0, 10.0, 80.0, 101.0, 10.0, STEX_USECOLOR, 0xff00ff);
+  // Mesh
+  size_x = (FLOAT)SCREEN_WIDTH / MESH_COLUMNS;
+  size_y = (FLOAT)SCREEN_HEIGHT / MESH_ROWS;
+  for (row = 0;row < MESH_ROWS;row++) {
+    for (column = 0;column < MESH_COLUMNS;column++) {
+      x = column * size_x;
+      y = row * size_y;
+      element = &(MapperSets[SET_MESH][SetSize[SET_MESH]++]);
+      element->type = S3DR_ELEM_QUAD;
+      element->x1 = x; element->y1 = y; element->z1 = 100.0 + ((column + row) % 4) * 10.0;
+      element->u1 = 0.0; element->v1 = 0.0;
+      element->x2 = x + size_x; element->y2 = y; element->z2 = 100.0 + ((column + row + 1) % 4) * 10.0;
+      element->u2 = TEX_WIDTH; element->v2 = 0.0;
+      element->x3 = x + size_x; element->y3 = y + size_y; element->z3 = 100.0 + ((column + row + 2) % 4) * 10.0;
+      element->u3 = TEX_WIDTH; element->v3 = TEX_WIDTH;
+      element->x4 = x; element->y4 = y + size_y; element->z4 = 100.0 + ((column + row + 1) % 4) * 10.0;
+      element->u4 = 0.0; element->v4 = TEX_WIDTH;
+      element->texture = 0;
+      element->color = 0xffffff;
+    }
+  }
+}
+
+/**
+ * Draw one triangle of an element
+ */
+static VOID DrawTriangle(S3D_Triangle *triangle, SAGE_3DElement *element, UWORD index)
+{
+  if (element->texture == STEX_USECOLOR) {
+    triangle->tex = NULL;
+    SAGE_DrawColoredTriangle(triangle, bitmaps[index], &clipping);
+  } else {
+    triangle->tex = &(textures[index]);
+    SAGE_DrawTexturedTriangle(triangle, bitmaps[index], &clipping);
+  }
+}
+
+/**
+ * Draw an element like SAGE_RenderSage3DElements does
+ */
+static VOID DrawElement(SAGE_3DElement *element, UWORD index)
+{
+  S3D_Triangle triangle;
+
+  triangle.x1 = element->x1; triangle.y1 = element->y1; triangle.z1 = element->z1;
+  triangle.u1 = element->u1; triangle.v1 = element->v1;
+  triangle.x2 = element->x2; triangle.y2 = element->y2; triangle.z2 = element->z2;
+  triangle.u2 = element->u2; triangle.v2 = element->v2;
+  triangle.x3 = element->x3; triangle.y3 = element->y3; triangle.z3 = element->z3;
+  triangle.u3 = element->u3; triangle.v3 = element->v3;
+  triangle.color = RemapColor(element->color, bitmaps[index]->depth);
+  DrawTriangle(&triangle, element, index);
+  if (element->type == S3DR_ELEM_QUAD) {
+    triangle.x1 = element->x1; triangle.y1 = element->y1; triangle.z1 = element->z1;
+    triangle.u1 = element->u1; triangle.v1 = element->v1;
+    triangle.x2 = element->x4; triangle.y2 = element->y4; triangle.z2 = element->z4;
+    triangle.u2 = element->u4; triangle.v2 = element->v4;
+    triangle.x3 = element->x3; triangle.y3 = element->y3; triangle.z3 = element->z3;
+    triangle.u3 = element->u3; triangle.v3 = element->v3;
+    DrawTriangle(&triangle, element, index);
+  }
+}
+
+/**
+ * Clear the frame and the Z buffer, with the lazy clear the Z buffer is
+ * filled with garbage that the mappers have to clear
+ */
+static VOID ClearFrame(UWORD index)
+{
+  SAGE_ZBuffer *zbuffer;
+  UWORD *depth;
+  ULONG pixel, tile;
+
+  zbuffer = &(device.render.zbuffer);
+  memset(bitmaps[index]->bitmap_buffer, 0, bitmaps[index]->height * bitmaps[index]->bpr);
+  depth = (UWORD *)zbuffer->buffer;
+  for (pixel = 0;pixel < (ULONG)(zbuffer->width * zbuffer->height);pixel++) {
+    depth[pixel] = (device.render.options & S3DR_LAZYZBUFFER) ? STALE_DEPTH : S3DR_HIZ_FAR;
+  }
+  for (tile = 0;tile < (ULONG)(zbuffer->tiles_width * zbuffer->tiles_height);tile++) {
+    zbuffer->tiles[tile] = S3DR_HIZ_FAR;
+    zbuffer->epochs[tile] = 0;
+  }
+  zbuffer->epoch = 1;
+}
+
+/**
+ * Render a set in the bitmap of a depth
+ */
+static VOID RenderSet(UWORD set, UWORD index)
+{
+  UWORD element;
+
+  ClearFrame(index);
+  for (element = 0;element < SetSize[set];element++) {
+    DrawElement(&(MapperSets[set][element]), index);
+  }
+}
+
+/**
+ * FNV-1a hash of a frame
+ */
+static ULONG HashFrame(SAGE_Bitmap *bitmap)
+{
+  UBYTE *pixels;
+  ULONG hash, byte, size;
+
+  pixels = (UBYTE *)bitmap->bitmap_buffer;
+  size = bitmap->height * bitmap->bpr;
+  hash = 2166136261UL;
+  for (byte = 0;byte < size;byte++) {
+    hash = ((hash ^ pixels[byte]) * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  return hash;
+}
+
+/**
+ * Write a frame as a PGM (8 bits) or a PPM (16 bits) image
+ */
+static BOOL WriteFrame(SAGE_Bitmap *bitmap, char *filename)
+{
+  FILE *file;
+  UWORD color;
+  ULONG pixel;
+
+  if ((file = fopen(filename, "wb")) == NULL) {
+    return FALSE;
+  }
+  if (bitmap->depth == SBMP_DEPTH8) {
+    fprintf(file, "P5\n%lu %lu\n255\n", bitmap->width, bitmap->height);
+    fwrite(bitmap->bitmap_buffer, 1, bitmap->width * bitmap->height, file);
+  } else {
+    fprintf(file, "P6\n%lu %lu\n255\n", bitmap->width, bitmap->height);
+    for (pixel = 0;pixel < bitmap->width * bitmap->height;pixel++) {
+      color = ((UWORD *)bitmap->bitmap_buffer)[pixel];
+      fputc((color >> 8) & 0xF8, file);
+      fputc((color >> 3) & 0xFC, file);
+      fputc((color << 3) & 0xF8, file);
+    }
+  }
+  fclose(file);
+  return TRUE;
+}
+
+/**
+ * Find the golden hash of a frame, return FALSE if there's none
+ */
+static BOOL GoldenHash(FILE *golden, ULONG depth, UWORD set, UWORD variant, ULONG *hash)
+{
+  char line[128], set_name[32], variant_name[32];
+  unsigned long golden_depth, golden_hash;
+
+  rewind(golden);
+  while (fgets(line, sizeof(line), golden) != NULL) {
+    if (line[0] != '#' && sscanf(line, "%lu %31s %31s %lx", &golden_depth, set_name, variant_name, &golden_hash) == 4) {
+      if (golden_depth == depth && strcmp(set_name, SetNames[set]) == 0 && strcmp(variant_name, VariantNames[variant]) == 0) {
+        *hash = (ULONG)golden_hash;
+        return TRUE;
+      }
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * Render all the frames, save or compare them with the golden images
+ */
+static LONG CheckFrames(BOOL save, BOOL write)
+{
+  FILE *golden;
+  char filename[64];
+  ULONG hash, golden_hash;
+  LONG errors;
+  UWORD index, set, variant;
+
+  if ((golden = fopen(GOLDEN_FILE, save ? "w" : "r")) == NULL) {
+    printf("Can't open %s\n", GOLDEN_FILE);
+    return 1;
+  }
+  if (save) {
+    fprintf(golden, "# SAGE mapper golden images, FNV-1a hash of each frame rendered by mapcheck\n");
+    fprintf(golden, "# depth set variant hash\n");
+  }
+  errors = 0;
+  for (index = 0;index < DEPTHS;index++) {
+    for (set = 0;set < SET_COUNT;set++) {
+      for (variant = 0;variant < VARIANT_COUNT;variant++) {
+        device.render.options = VariantOptions[variant];
+        RenderSet(set, index);
+        hash = HashFrame(bitmaps[index]);
+        if (save) {
+          fprintf(golden, "%lu %s %s 0x%08lX\n", bitmaps[index]->depth, SetNames[set], VariantNames[variant], hash);
+        } else if (!GoldenHash(golden, bitmaps[index]->depth, set, variant, &golden_hash)) {
+          printf("  %lu bits %s %s : no golden image\n", bitmaps[index]->depth, SetNames[set], VariantNames[variant]);
+          errors++;
+        } else if (hash != golden_hash) {
+          printf("  %lu bits %s %s : frame differs from the golden image\n", bitmaps[index]->depth, SetNames[set], VariantNames[variant]);
+          errors++;
+        }
+        if (write) {
+          sprintf(filename, "mapper%lu_%s_%s.%s", bitmaps[index]->depth, SetNames[set], VariantNames[variant], index == 0 ? "pgm" : "ppm");
+          WriteFrame(bitmaps[index], filename);
+        }
+        // The Hi-Z test and the lazy clear should give the same frame
+        if (variant != VARIANT_FLAT) {
+          device.render.options |= S3DR_HIZBUFFER|S3DR_LAZYZBUFFER;
+          RenderSet(set, index);
+          if (HashFrame(bitmaps[index]) != hash) {
+            printf("  %lu bits %s %s : Hi-Z and lazy clear change the frame\n", bitmaps[index]->depth, SetNames[set], VariantNames[variant]);
+            errors++;
+          }
+        }
+      }
+    }
+  }
+  fclose(golden);
+  if (save) {
+    printf("Golden images saved to %s\n", GOLDEN_FILE);
+  } else {
+    printf("%d frames checked, %ld errors\n", DEPTHS * SET_COUNT * VARIANT_COUNT, errors);
+  }
+  return errors;
+}
+
+/**
+ * Count the pixels mapped by all the sets, every element is drawn alone
+ */
+static ULONG CountPixels(UWORD index)
+{
+  SAGE_Bitmap *bitmap;
+  SAGE_3DElement element;
+  ULONG pixels, pixel, bpp;
+  UWORD set, count;
+
+  bitmap = bitmaps[index];
+  bpp = bitmap->depth / 8;
+  pixels = 0;
+  device.render.options = 0;
+  for (set = 0;set < SET_COUNT;set++) {
+    for (count = 0;count < SetSize[set];count++) {
+      ClearFrame(index);
+      element = MapperSets[set][count];
+      element.texture = STEX_USECOLOR;
+      element.color = 0x0000ff;
+      DrawElement(&element, index);
+      for (pixel = 0;pixel < bitmap->width * bitmap->height * bpp;pixel += bpp) {
+        if (((UBYTE *)bitmap->bitmap_buffer)[pixel] != 0 || ((UBYTE *)bitmap->bitmap_buffer)[pixel + bpp - 1] != 0) {
+          pixels++;
+        }
+      }
+    }
+  }
+  return pixels;
+}
+
+/**
+ * Mpixels/s of the mappers for each depth and variant, the time includes the
+ * frame clear
+ */
+static VOID BenchMappers(VOID)
+{
+  clock_t start;
+  DOUBLE seconds;
+  ULONG pixels;
+  UWORD index, set, variant, loop;
+
+  for (index = 0;index < DEPTHS;index++) {
+    pixels = CountPixels(index);
+    printf("%lu bits, %lu pixels by frame set\n", bitmaps[index]->depth, pixels);
+    for (variant = 0;variant < VARIANT_COUNT;variant++) {
+      device.render.options = VariantOptions[variant];
+      start = clock();
+      for (loop = 0;loop < BENCH_LOOPS;loop++) {
+        for (set = 0;set < SET_COUNT;set++) {
+          RenderSet(set, index);
+        }
+      }
+      seconds = (DOUBLE)(clock() - start) / CLOCKS_PER_SEC;
+      if (seconds > 0.0) {
+        printf("  %-12s : %.2f Mpixels/s\n", VariantNames[variant], (DOUBLE)pixels * BENCH_LOOPS / seconds / 1000000.0);
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  SAGE_ZBuffer *zbuffer;
+  LONG errors;
+  UWORD index;
+
+  SageContext.Sage3D = &device;
+  zbuffer = &(device.render.zbuffer);
+  zbuffer->width = SCREEN_WIDTH;
+  zbuffer->height = SCREEN_HEIGHT;
+  zbuffer->bpr = SCREEN_WIDTH * sizeof(UWORD);
+  zbuffer->bpp = sizeof(UWORD);
+  zbuffer->buffer = malloc(zbuffer->bpr * SCREEN_HEIGHT);
+  zbuffer->tiles_width = (SCREEN_WIDTH + S3DR_HIZ_SIZE - 1) >> S3DR_HIZ_SHIFT;
+  zbuffer->tiles_height = (SCREEN_HEIGHT + S3DR_HIZ_SIZE - 1) >> S3DR_HIZ_SHIFT;
+  zbuffer->tiles = malloc(zbuffer->tiles_width * zbuffer->tiles_height * sizeof(UWORD));
+  zbuffer->epochs = malloc(zbuffer->tiles_width * zbuffer->tiles_height);
+  clipping.left = 0;
+  clipping.top = 0;
+  clipping.right = SCREEN_WIDTH - 1;
+  clipping.bottom = SCREEN_HEIGHT - 1;
+  bitmaps[0] = NewBitmap(SCREEN_WIDTH, SCREEN_HEIGHT, SBMP_DEPTH8);
+  bitmaps[1] = NewBitmap(SCREEN_WIDTH, SCREEN_HEIGHT, SBMP_DEPTH16);
+  MakeTexture(&(textures[0]), SBMP_DEPTH8);
+  MakeTexture(&(textures[1]), SBMP_DEPTH16);
+  BuildSets();
+  errors = 0;
+  if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+    BenchMappers();
+  } else if (argc > 1 && strcmp(argv[1], "-s") == 0) {
+    errors = CheckFrames(TRUE, FALSE);
+  } else {
+    errors = CheckFrames(FALSE, argc > 1 && strcmp(argv[1], "-w") == 0);
+  }
+  for (index = 0;index < DEPTHS;index++) {
+    FreeBitmap(textures[index].bitmap);
+    FreeBitmap(bitmaps[index]);
+  }
+  free(zbuffer->buffer);
+  free(zbuffer->tiles);
+  free(zbuffer->epochs);
+  return errors > 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * membench.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, benchmark the memory manager
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -o membench membench.c host/amiga.c
+ *           ../src/sage_memory.c ../src/sage_error.c ../src/sage_logger.c
+ * Usage : membench [pairs] [live blocs]
+ * 
+ * The tool links the engine memory manager with the host shims (AllocMem is
+ * malloc) and runs the loop of the core_memory test : free a random bloc and
+ * allocate a new one, with a number of blocs kept alive. Every other bloc is
+ * aligned on 16 bytes and the others must be aligned on 8 bytes like the
+ * blocs of AllocMem. To compare with another version of the manager, build
+ * the tool against the src and include directories of that version.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sage/sage_memory.h>
+
+#define BENCH_PAIRS         100000
+#define LIVE_BLOCS          2000
+
+int main(int argc, char **argv)
+{
+  APTR *blocs;
+  long pairs, live, pair, bloc, misaligned;
+  clock_t start;
+
+  pairs = argc > 1 ? atol(argv[1]) : BENCH_PAIRS;
+  live = argc > 2 ? atol(argv[2]) : LIVE_BLOCS;
+  if (pairs < 0 || live < 1 || (blocs = calloc(live, sizeof(APTR))) == NULL) {
+    fprintf(stderr, "Usage : membench [pairs] [live blocs]\n");
+    return 1;
+  }
+  srand(1);
+  for (bloc = 0;bloc < live;bloc++) {
+    blocs[bloc] = SAGE_AllocMem(16 + (bloc % 200));
+  }
+  misaligned = 0;
+  start = clock();
+  for (pair = 0;pair < pairs;pair++) {
+    bloc = rand() % live;
+    SAGE_FreeMem(blocs[bloc]);
+    if (pair & 1) {
+      blocs[bloc] = SAGE_AllocAlignMem(16 + (rand() % 240), 16);
+      misaligned += ((ULONG)blocs[bloc] & 15) != 0;
+    } else {
+      blocs[bloc] = SAGE_AllocMem(16 + (rand() % 240));
+      misaligned += ((ULONG)blocs[bloc] & 7) != 0;
+    }
+    if (blocs[bloc] == NULL) {
+      fprintf(stderr, "Allocation failed after %ld pairs\n", pair);
+      return 1;
+    }
+    memset(blocs[bloc], 0, 16);
+  }
+  printf("%ld pairs with %ld live blocs in %.1f ms\n", pairs, live, (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+  if (misaligned > 0) {
+    printf("%ld misaligned blocs\n", misaligned);
+  }
+  SAGE_ReleaseMem();
+  free(blocs);
+  return misaligned > 0;
+}
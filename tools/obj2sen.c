@@ -0,0 +1,612 @@
+/**
+ * obj2sen.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, convert a Wavefront object to a SAGE binary entity (SEN)
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -o obj2sen obj2sen.c -lm
+ * Usage : obj2sen file.obj file.sen  (convert)
+ *         obj2sen -c file.sen        (map the file and check it)
+ * 
+ * The converter does the work done by SAGE_LoadEntity at load time : parse
+ * the OBJ/MTL files, remove the duplicate vertices, compute the faces normal
+ * and the entity radius. The SEN file is written big endian with the layout
+ * of the SAGE structures (see sage_loadsen.h) so the engine reads each array
+ * straight into the entity.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SEN_TAG             0x53454E54              // "SENT"
+#define SEN_VERSION         1
+#define SEN_FILESIZE        64
+#define SEN_NOMATERIAL      -1
+#define SEN_MAXVERTICES     65000                   // S3DE_MAX_VERTICES
+#define SEN_MAXFACES        65535
+
+#define SEN_HEADERSIZE      16
+#define SEN_MATERIALSIZE    (SEN_FILESIZE + 12)
+#define SEN_VERTEXSIZE      12
+#define SEN_FACESIZE        52
+#define SEN_NORMALSIZE      12
+
+#define LINE_SIZE           1024
+#define MAX_TOKENS          16
+#define HASH_SIZE           65536
+
+typedef struct {
+  float x, y, z;
+} Vertex;
+
+typedef struct {
+  float u, v;
+} TexVertex;
+
+typedef struct {
+  int is_quad, material;
+  int p[4], t[4];
+} Face;
+
+typedef struct {
+  char name[256];
+  char file[SEN_FILESIZE];
+  uint32_t color, tcolor;
+  int transparent;
+} Material;
+
+typedef struct {
+  int nb_vertices, nb_vertexts, nb_faces, nb_materials;
+  Vertex *vertices;
+  TexVertex *vertexts;
+  Face *faces;
+  Material *materials;
+  Vertex *normals;
+  float radius;
+} Object;
+
+/** Line tokens */
+static char line_buffer[LINE_SIZE];
+static char *line_token[MAX_TOKENS];
+
+/**
+ * Split a line in tokens, same rules as SAGE_OBJTokenizeLine
+ */
+static int TokenizeLine(char *line)
+{
+  int nb_tokens;
+
+  nb_tokens = 0;
+  if (*line == '#') {
+    return 0;
+  }
+  while (*line != '\0' && *line != '\n' && nb_tokens < MAX_TOKENS) {
+    if (*line == ' ' || *line == '\t' || *line == '\r') {
+      line++;
+    } else {
+      line_token[nb_tokens++] = line;
+      while (*line > 32 && *line < 127) line++;
+      if (*line != '\0') {
+        *line++ = '\0';
+      }
+    }
+  }
+  return nb_tokens;
+}
+
+/**
+ * Grow an array when it is full
+ */
+static void *GrowArray(void *array, int count, int *capacity, size_t size)
+{
+  if (count < *capacity) {
+    return array;
+  }
+  *capacity = (*capacity == 0) ? 256 : *capacity * 2;
+  array = realloc(array, *capacity * size);
+  if (array == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  return array;
+}
+
+/**
+ * Pack a color from 3 float components
+ */
+static uint32_t PackColor(const char *red, const char *green, const char *blue)
+{
+  return ((uint32_t)(atof(red) * 255.0) << 16) + ((uint32_t)(atof(green) * 255.0) << 8) + (uint32_t)(atof(blue) * 255.0);
+}
+
+/**
+ * Parse the material library
+ */
+static int ParseMaterialFile(const char *path, Object *object)
+{
+  Material *material;
+  int tokens, capacity;
+  FILE *fd;
+
+  if ((fd = fopen(path, "r")) == NULL) {
+    fprintf(stderr, "Can't open material file %s\n", path);
+    return 0;
+  }
+  material = NULL;
+  capacity = object->nb_materials;
+  while (fgets(line_buffer, LINE_SIZE, fd) != NULL) {
+    tokens = TokenizeLine(line_buffer);
+    if (tokens > 1 && strcmp(line_token[0], "newmtl") == 0) {
+      object->materials = GrowArray(object->materials, object->nb_materials, &capacity, sizeof(Material));
+      material = &(object->materials[object->nb_materials++]);
+      memset(material, 0, sizeof(Material));
+      strncpy(material->name, line_token[1], sizeof(material->name) - 1);
+    } else if (material == NULL) {
+      continue;
+    } else if (tokens > 1 && strcmp(line_token[0], "Tr") == 0) {
+      material->transparent = (atof(line_token[1]) == 1.0);
+    } else if (tokens > 3 && strcmp(line_token[0], "Tf") == 0) {
+      material->tcolor = PackColor(line_token[1], line_token[2], line_token[3]);
+    } else if (tokens > 3 && strcmp(line_token[0], "Kd") == 0) {
+      material->color = PackColor(line_token[1], line_token[2], line_token[3]);
+    } else if (tokens > 1 && strcmp(line_token[0], "map_Kd") == 0) {
+      if (strlen(line_token[1]) >= SEN_FILESIZE) {
+        fprintf(stderr, "Texture file name too long %s\n", line_token[1]);
+        fclose(fd);
+        return 0;
+      }
+      strcpy(material->file, line_token[1]);
+    }
+  }
+  fclose(fd);
+  return 1;
+}
+
+/**
+ * Set a face corner from a "p/t/n" token
+ */
+static void SetFaceCorner(Face *face, int corner, char *token)
+{
+  char *slash;
+
+  face->p[corner] = atoi(token) - 1;
+  face->t[corner] = -1;
+  slash = strchr(token, '/');
+  if (slash != NULL && slash[1] != '/' && slash[1] != '\0') {
+    face->t[corner] = atoi(slash + 1) - 1;
+  }
+}
+
+/**
+ * Parse the Wavefront file
+ */
+static int ParseWavefrontFile(const char *path, Object *object)
+{
+  int tokens, corner, material, cap_vertices, cap_vertexts, cap_faces;
+  char matlib[512], *dirname;
+  Face *face;
+  FILE *fd;
+
+  if ((fd = fopen(path, "r")) == NULL) {
+    fprintf(stderr, "Can't open object file %s\n", path);
+    return 0;
+  }
+  material = SEN_NOMATERIAL;
+  cap_vertices = cap_vertexts = cap_faces = 0;
+  while (fgets(line_buffer, LINE_SIZE, fd) != NULL) {
+    tokens = TokenizeLine(line_buffer);
+    if (tokens > 1 && strcmp(line_token[0], "mtllib") == 0) {
+      strncpy(matlib, path, sizeof(matlib) - 1);
+      matlib[sizeof(matlib) - 1] = '\0';
+      dirname = strrchr(matlib, '/');
+      dirname = (dirname == NULL) ? matlib : dirname + 1;
+      *dirname = '\0';
+      if (strlen(matlib) + strlen(line_token[1]) >= sizeof(matlib) || !ParseMaterialFile(strcat(matlib, line_token[1]), object)) {
+        fclose(fd);
+        return 0;
+      }
+    } else if (tokens > 3 && strcmp(line_token[0], "v") == 0) {
+      object->vertices = GrowArray(object->vertices, object->nb_vertices, &cap_vertices, sizeof(Vertex));
+      object->vertices[object->nb_vertices].x = (float)atof(line_token[1]);
+      object->vertices[object->nb_vertices].y = (float)atof(line_token[2]);
+      object->vertices[object->nb_vertices].z = (float)atof(line_token[3]);
+      object->nb_vertices++;
+    } else if (tokens > 2 && strcmp(line_token[0], "vt") == 0) {
+      object->vertexts = GrowArray(object->vertexts, object->nb_vertexts, &cap_vertexts, sizeof(TexVertex));
+      object->vertexts[object->nb_vertexts].u = (float)fabs(atof(line_token[1]));
+      object->vertexts[object->nb_vertexts].v = (float)fabs(atof(line_token[2]));
+      object->nb_vertexts++;
+    } else if (tokens > 1 && strcmp(line_token[0], "usemtl") == 0) {
+      for (material = 0;material < object->nb_materials;material++) {
+        if (strcmp(object->materials[material].name, line_token[1]) == 0) {
+          break;
+        }
+      }
+      if (material == object->nb_materials) {
+        material = SEN_NOMATERIAL;
+      }
+    } else if (tokens > 3 && strcmp(line_token[0], "f") == 0) {
+      object->faces = GrowArray(object->faces, object->nb_faces, &cap_faces, sizeof(Face));
+      face = &(object->faces[object->nb_faces++]);
+      face->is_quad = (tokens > 4);
+      face->material = material;
+      for (corner = 0;corner < (face->is_quad ? 4 : 3);corner++) {
+        SetFaceCorner(face, corner, line_token[corner + 1]);
+      }
+    }
+  }
+  fclose(fd);
+  return 1;
+}
+
+/**
+ * Hash a vertex on its bit pattern
+ */
+static unsigned int HashVertex(const Vertex *vertex)
+{
+  uint32_t bits[3];
+
+  memcpy(bits, vertex, sizeof(bits));
+  return ((bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u)) & (HASH_SIZE - 1);
+}
+
+/**
+ * Remove the duplicate vertices, same result as SAGE_OptimizeEntity
+ */
+static void OptimizeObject(Object *object)
+{
+  int *remap, *head, *next, idx, search, corner, nb_vertices;
+  unsigned int hash;
+  Vertex *vertices;
+
+  remap = malloc(sizeof(int) * (object->nb_vertices + 1));
+  next = malloc(sizeof(int) * (object->nb_vertices + 1));
+  head = malloc(sizeof(int) * HASH_SIZE);
+  vertices = malloc(sizeof(Vertex) * (object->nb_vertices + 1));
+  if (remap == NULL || next == NULL || head == NULL || vertices == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  memset(head, -1, sizeof(int) * HASH_SIZE);
+  nb_vertices = 0;
+  for (idx = 0;idx < object->nb_vertices;idx++) {
+    hash = HashVertex(&(object->vertices[idx]));
+    for (search = head[hash];search >= 0;search = next[search]) {
+      if (vertices[search].x == object->vertices[idx].x && vertices[search].y == object->vertices[idx].y && vertices[search].z == object->vertices[idx].z) {
+        break;
+      }
+    }
+    if (search < 0) {
+      search = nb_vertices++;
+      vertices[search] = object->vertices[idx];
+      next[search] = head[hash];
+      head[hash] = search;
+    }
+    remap[idx] = search;
+  }
+  for (idx = 0;idx < object->nb_faces;idx++) {
+    for (corner = 0;corner < 4;corner++) {
+      if (corner < 3 || object->faces[idx].is_quad) {
+        object->faces[idx].p[corner] = remap[object->faces[idx].p[corner]];
+      }
+    }
+  }
+  free(object->vertices);
+  object->vertices = vertices;
+  object->nb_vertices = nb_vertices;
+  free(remap);
+  free(next);
+  free(head);
+}
+
+/**
+ * Compute the faces normal and the radius, same as SAGE_InitEntity
+ */
+static void InitObject(Object *object)
+{
+  Vertex u, v, *p1, *p2, *p3, *normal;
+  float length, radius;
+  int idx;
+
+  object->normals = malloc(sizeof(Vertex) * (object->nb_faces + 1));
+  if (object->normals == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  for (idx = 0;idx < object->nb_faces;idx++) {
+    p1 = &(object->vertices[object->faces[idx].p[0]]);
+    p2 = &(object->vertices[object->faces[idx].p[1]]);
+    p3 = &(object->vertices[object->faces[idx].p[2]]);
+    u.x = p2->x - p1->x;
+    u.y = p2->y - p1->y;
+    u.z = p2->z - p1->z;
+    v.x = p3->x - p1->x;
+    v.y = p3->y - p1->y;
+    v.z = p3->z - p1->z;
+    normal = &(object->normals[idx]);
+    normal->x = u.y*v.z - u.z*v.y;
+    normal->y = u.z*v.x - u.x*v.z;
+    normal->z = u.x*v.y - u.y*v.x;
+    length = (float)sqrt((normal->x*normal->x) + (normal->y*normal->y) + (normal->z*normal->z));
+    if (length != 0.0) {
+      normal->x /= length;
+      normal->y /= length;
+      normal->z /= length;
+    }
+  }
+  object->radius = 0.0;
+  for (idx = 0;idx < object->nb_vertices;idx++) {
+    p1 = &(object->vertices[idx]);
+    radius = (float)sqrt((p1->x*p1->x) + (p1->y*p1->y) + (p1->z*p1->z));
+    if (radius > object->radius) {
+      object->radius = radius;
+    }
+  }
+}
+
+/**
+ * Check the object indices before writing it
+ */
+static int CheckObject(Object *object)
+{
+  int idx, corner, point, texture;
+
+  if (object->nb_faces > SEN_MAXFACES) {
+    fprintf(stderr, "Too much faces (%d)\n", object->nb_faces);
+    return 0;
+  }
+  for (idx = 0;idx < object->nb_faces;idx++) {
+    for (corner = 0;corner < (object->faces[idx].is_quad ? 4 : 3);corner++) {
+      point = object->faces[idx].p[corner];
+      texture = object->faces[idx].t[corner];
+      if (point < 0 || point >= object->nb_vertices || texture >= object->nb_vertexts) {
+        fprintf(stderr, "Face %d has a bad index\n", idx + 1);
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * Release the object arrays
+ */
+static void ReleaseObject(Object *object)
+{
+  free(object->vertices);
+  free(object->vertexts);
+  free(object->faces);
+  free(object->materials);
+  free(object->normals);
+  memset(object, 0, sizeof(Object));
+}
+
+/** Big endian writers */
+
+static void PutWord(FILE *fd, uint16_t value)
+{
+  fputc((value >> 8) & 0xff, fd);
+  fputc(value & 0xff, fd);
+}
+
+static void PutLong(FILE *fd, uint32_t value)
+{
+  PutWord(fd, (uint16_t)(value >> 16));
+  PutWord(fd, (uint16_t)value);
+}
+
+static void PutFloat(FILE *fd, float value)
+{
+  uint32_t bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+  PutLong(fd, bits);
+}
+
+/**
+ * Get a face texture coordinate, 0 when the corner has none
+ */
+static void GetFaceUV(Object *object, Face *face, int corner, float *u, float *v)
+{
+  *u = *v = 0.0;
+  if (corner < 3 || face->is_quad) {
+    if (face->t[corner] >= 0) {
+      *u = object->vertexts[face->t[corner]].u;
+      *v = object->vertexts[face->t[corner]].v;
+    }
+  }
+}
+
+/**
+ * Write the SEN file
+ */
+static int WriteEntity(const char *path, Object *object)
+{
+  int idx, corner;
+  float u, v;
+  Face *face;
+  FILE *fd;
+
+  if ((fd = fopen(path, "wb")) == NULL) {
+    fprintf(stderr, "Can't create %s\n", path);
+    return 0;
+  }
+  // SAGE_SENHeader
+  PutLong(fd, SEN_TAG);
+  PutWord(fd, SEN_VERSION);
+  PutWord(fd, (uint16_t)object->nb_materials);
+  PutWord(fd, (uint16_t)object->nb_vertices);
+  PutWord(fd, (uint16_t)object->nb_faces);
+  PutFloat(fd, object->radius);
+  // SAGE_SENMaterial
+  for (idx = 0;idx < object->nb_materials;idx++) {
+    fwrite(object->materials[idx].file, 1, SEN_FILESIZE, fd);
+    PutLong(fd, object->materials[idx].color);
+    PutLong(fd, object->materials[idx].tcolor);
+    PutWord(fd, object->materials[idx].transparent ? 0xffff : 0);
+    PutWord(fd, (uint16_t)SEN_NOMATERIAL);
+  }
+  // SAGE_Vertex
+  for (idx = 0;idx < object->nb_vertices;idx++) {
+    PutFloat(fd, object->vertices[idx].x);
+    PutFloat(fd, object->vertices[idx].y);
+    PutFloat(fd, object->vertices[idx].z);
+  }
+  // SAGE_Face
+  for (idx = 0;idx < object->nb_faces;idx++) {
+    face = &(object->faces[idx]);
+    PutWord(fd, face->is_quad ? 0xffff : 0);      // is_quad
+    PutWord(fd, 0);                               // culled
+    PutWord(fd, 0);                               // clipped
+    PutWord(fd, (uint16_t)face->material);        // texture
+    for (corner = 0;corner < 4;corner++) {
+      PutWord(fd, (uint16_t)((corner < 3 || face->is_quad) ? face->p[corner] : 0));
+    }
+    PutLong(fd, 0);                               // color
+    for (corner = 0;corner < 4;corner++) {
+      GetFaceUV(object, face, corner, &u, &v);
+      PutFloat(fd, u);
+      PutFloat(fd, v);
+    }
+  }
+  // SAGE_Vector
+  for (idx = 0;idx < object->nb_faces;idx++) {
+    PutFloat(fd, object->normals[idx].x);
+    PutFloat(fd, object->normals[idx].y);
+    PutFloat(fd, object->normals[idx].z);
+  }
+  if (fclose(fd) != 0) {
+    fprintf(stderr, "Can't write %s\n", path);
+    return 0;
+  }
+  return 1;
+}
+
+/** Big endian readers */
+
+static uint16_t GetWord(const uint8_t *data)
+{
+  return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static uint32_t GetLong(const uint8_t *data)
+{
+  return ((uint32_t)GetWord(data) << 16) | GetWord(data + 2);
+}
+
+static float GetFloat(const uint8_t *data)
+{
+  uint32_t bits;
+  float value;
+
+  bits = GetLong(data);
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/**
+ * Map a SEN file in memory and check it without copying the arrays
+ */
+static int CheckEntity(const char *path)
+{
+  unsigned int nb_materials, nb_vertices, nb_faces, idx, corner, point;
+  const uint8_t *data, *materials, *faces;
+  size_t expected;
+  struct stat info;
+  int fd, valid;
+  int16_t material;
+
+  if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &info) != 0) {
+    fprintf(stderr, "Can't open %s\n", path);
+    return 0;
+  }
+  if ((size_t)info.st_size < SEN_HEADERSIZE) {
+    fprintf(stderr, "%s is too small\n", path);
+    close(fd);
+    return 0;
+  }
+  data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "Can't map %s\n", path);
+    return 0;
+  }
+  valid = 0;
+  nb_materials = GetWord(data + 6);
+  nb_vertices = GetWord(data + 8);
+  nb_faces = GetWord(data + 10);
+  expected = SEN_HEADERSIZE + nb_materials * SEN_MATERIALSIZE + nb_vertices * SEN_VERTEXSIZE + nb_faces * (SEN_FACESIZE + SEN_NORMALSIZE);
+  if (GetLong(data) != SEN_TAG || GetWord(data + 4) != SEN_VERSION) {
+    fprintf(stderr, "%s is not a SEN file\n", path);
+  } else if ((size_t)info.st_size != expected) {
+    fprintf(stderr, "%s has %ld bytes, %ld expected\n", path, (long)info.st_size, (long)expected);
+  } else {
+    materials = data + SEN_HEADERSIZE;
+    faces = materials + nb_materials * SEN_MATERIALSIZE + nb_vertices * SEN_VERTEXSIZE;
+    valid = 1;
+    for (idx = 0;idx < nb_faces && valid;idx++) {
+      material = (int16_t)GetWord(faces + idx * SEN_FACESIZE + 6);
+      if (material < SEN_NOMATERIAL || material >= (int)nb_materials) {
+        valid = 0;
+      }
+      for (corner = 0;corner < (GetWord(faces + idx * SEN_FACESIZE) ? 4u : 3u);corner++) {
+        point = GetWord(faces + idx * SEN_FACESIZE + 8 + corner * 2);
+        if (point >= nb_vertices) {
+          valid = 0;
+        }
+      }
+      if (!valid) {
+        fprintf(stderr, "Face %u has a bad index\n", idx + 1);
+      }
+    }
+    if (valid) {
+      printf("%s : %u materials, %u vertices, %u faces, radius %f\n", path, nb_materials, nb_vertices, nb_faces, GetFloat(data + 12));
+      for (idx = 0;idx < nb_materials;idx++) {
+        printf(" material %u : color %06x, texture \"%.*s\"\n", idx, (unsigned int)GetLong(materials + idx * SEN_MATERIALSIZE + SEN_FILESIZE), SEN_FILESIZE, (const char *)(materials + idx * SEN_MATERIALSIZE));
+      }
+    }
+  }
+  munmap((void *)data, info.st_size);
+  return valid;
+}
+
+int main(int argc, char **argv)
+{
+  Object object;
+  int success;
+
+  if (argc == 3 && strcmp(argv[1], "-c") == 0) {
+    return CheckEntity(argv[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (argc != 3) {
+    fprintf(stderr, "usage : obj2sen file.obj file.sen\n        obj2sen -c file.sen\n");
+    return EXIT_FAILURE;
+  }
+  memset(&object, 0, sizeof(Object));
+  success = 0;
+  if (ParseWavefrontFile(argv[1], &object) && CheckObject(&object)) {
+    printf("%s : %d vertices, %d faces, %d materials\n", argv[1], object.nb_vertices, object.nb_faces, object.nb_materials);
+    OptimizeObject(&object);
+    if (object.nb_vertices >= SEN_MAXVERTICES) {
+      fprintf(stderr, "Too much vertices (%d)\n", object.nb_vertices);
+    } else {
+      InitObject(&object);
+      if (WriteEntity(argv[2], &object)) {
+        printf("%s : %d vertices, %d faces, radius %f\n", argv[2], object.nb_vertices, object.nb_faces, object.radius);
+        success = 1;
+      }
+    }
+  }
+  ReleaseObject(&object);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,260 @@
+/**
+ * sortbench.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, benchmark the radix sort against the quick sort of the 3D queue
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -o sortbench sortbench.c host/amiga.c
+ *           ../src/sage_3dsort.c ../src/sage_logger.c -lm
+ * Usage : sortbench [loops] [queue file]
+ * 
+ * The tool links sage_3dsort.c with the host shims and sorts rendering queues
+ * with the quick sort (the old sort) and the radix sort, in descending and
+ * ascending order. Both sorts must give the same depth order and the times
+ * are compared. Without a queue file, the queues are the random, mesh and
+ * coherent queues of the render3d_3dsort test. A queue file holds queues
+ * captured from a game, one element depth by line and an empty line after
+ * each queue.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <sage/sage_3dsort.h>
+
+// PI comes from the SAS/C math.h
+#ifndef PI
+#define PI                  3.14159265358979323846
+#endif
+
+#define QUEUE_RANDOM        0
+#define QUEUE_MESH          1
+#define QUEUE_COHERENT      2
+#define QUEUE_TYPES         3
+
+#define QUEUE_SIZE          S3DR_MAX_ELEMENTS
+#define MAX_QUEUES          256
+#define BENCH_LOOPS         20
+
+#define MESH_RINGS          64
+#define MESH_SEGMENTS       128
+#define MESH_RADIUS         100.0
+#define MESH_DISTANCE       400.0
+
+/** A rendering queue to sort */
+typedef struct {
+  char name[32];
+  FLOAT *depths;
+  long size;
+} Queue;
+
+Queue Queues[MAX_QUEUES];
+long NbQueues = 0;
+
+SAGE_3DElement Elements[QUEUE_SIZE];
+SAGE_SortedElement Ordered[QUEUE_SIZE + 1], Buffer[QUEUE_SIZE], Sorted[QUEUE_SIZE];
+ULONG SortKeys[2][QUEUE_SIZE];
+SAGE_Render Render;
+
+/**
+ * Add an empty queue
+ */
+Queue *AddQueue(const char *name)
+{
+  Queue *queue;
+
+  if (NbQueues >= MAX_QUEUES) {
+    return NULL;
+  }
+  queue = &(Queues[NbQueues]);
+  if ((queue->depths = calloc(QUEUE_SIZE, sizeof(FLOAT))) == NULL) {
+    return NULL;
+  }
+  strncpy(queue->name, name, sizeof(queue->name) - 1);
+  queue->size = 0;
+  NbQueues++;
+  return queue;
+}
+
+/**
+ * Build the queues of the render3d_3dsort test, same depths as BuildQueue
+ */
+BOOL BuildQueues(long loops)
+{
+  static const char *names[QUEUE_TYPES] = { "random", "mesh", "coherent" };
+  Queue *queue;
+  long type, loop, index, ring, segment;
+  double theta, phi, x, z, angle;
+
+  for (type = 0;type < QUEUE_TYPES;type++) {
+    srand(1);
+    for (loop = 0;loop < loops;loop++) {
+      if ((queue = AddQueue(names[type])) == NULL) {
+        return FALSE;
+      }
+      for (index = 0;index < QUEUE_SIZE;index++) {
+        switch (type) {
+          case QUEUE_RANDOM:
+            queue->depths[index] = (FLOAT)(10.0 + (rand() % 99000) / 100.0);
+            break;
+          case QUEUE_MESH:
+            ring = (index / MESH_SEGMENTS) % MESH_RINGS;
+            segment = index % MESH_SEGMENTS;
+            angle = (double)loop * PI / 180.0;
+            theta = PI * ((double)ring + 0.5) / (double)MESH_RINGS;
+            phi = 2.0 * PI * ((double)segment + 0.5) / (double)MESH_SEGMENTS;
+            x = MESH_RADIUS * sin(theta) * cos(phi);
+            z = MESH_RADIUS * sin(theta) * sin(phi);
+            queue->depths[index] = (FLOAT)(MESH_DISTANCE + x * sin(angle) + z * cos(angle));
+            break;
+          default:
+            queue->depths[index] = (FLOAT)(1000.0 - index * 0.1 + (rand() % 100) / 200.0);
+            break;
+        }
+      }
+      queue->size = QUEUE_SIZE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Load the captured queues, one depth by line and an empty line after each
+ * queue
+ */
+BOOL LoadQueues(const char *filename)
+{
+  FILE *file;
+  Queue *queue;
+  char line[64];
+
+  if ((file = fopen(filename, "r")) == NULL) {
+    fprintf(stderr, "Can't open %s\n", filename);
+    return FALSE;
+  }
+  queue = NULL;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (line[0] == '\n' || line[0] == '\r') {
+      queue = NULL;
+    } else {
+      if (queue == NULL && (queue = AddQueue("captured")) == NULL) {
+        fprintf(stderr, "Too many queues in %s (%d max)\n", filename, MAX_QUEUES);
+        fclose(file);
+        return FALSE;
+      }
+      if (queue->size >= QUEUE_SIZE) {
+        fprintf(stderr, "Queue %ld of %s is too large (%d elements max)\n", NbQueues, filename, QUEUE_SIZE);
+        fclose(file);
+        return FALSE;
+      }
+      queue->depths[queue->size++] = (FLOAT)atof(line);
+    }
+  }
+  fclose(file);
+  return TRUE;
+}
+
+/**
+ * Push a queue in the renderer, as SAGE_Push3DElement does for points
+ */
+void PushQueue(Queue *queue)
+{
+  long index;
+
+  for (index = 0;index < queue->size;index++) {
+    Elements[index].type = S3DR_ELEM_POINT;
+    Elements[index].z1 = queue->depths[index];
+    Ordered[index].element = &(Elements[index]);
+    Ordered[index].avgz = Elements[index].z1;
+  }
+  Render.render_elements = (UWORD)queue->size;
+}
+
+/**
+ * Sort a queue with the quick sort or the radix sort, return the sort time
+ */
+clock_t SortQueue(Queue *queue, BOOL radix, BOOL ascending)
+{
+  clock_t start;
+
+  PushQueue(queue);
+  Render.options = radix ? S3DR_RADIXSORT : 0;
+  start = clock();
+  SAGE_FullSortElements(&Render, ascending);
+  return clock() - start;
+}
+
+/**
+ * Check the order of the sorted queue and compare it with the saved order
+ */
+BOOL CheckOrder(long size, BOOL ascending)
+{
+  long index;
+
+  for (index = 0;index < size;index++) {
+    if (Ordered[index].avgz != Sorted[index].avgz) {
+      return FALSE;
+    }
+    if (index > 0 && (ascending ? (Ordered[index-1].avgz > Ordered[index].avgz) : (Ordered[index-1].avgz < Ordered[index].avgz))) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+int main(int argc, char **argv)
+{
+  clock_t quick_time, radix_time;
+  long loops, first, last, queue, errors, elements;
+  BOOL ascending;
+
+  loops = argc > 1 ? atol(argv[1]) : BENCH_LOOPS;
+  if (loops < 1 || loops * QUEUE_TYPES > MAX_QUEUES) {
+    fprintf(stderr, "Usage : sortbench [loops] [queue file]\n");
+    return 1;
+  }
+  if ((argc > 2 ? !LoadQueues(argv[2]) : !BuildQueues(loops)) || NbQueues == 0) {
+    fprintf(stderr, "No queue to sort\n");
+    return 1;
+  }
+  Render.max_elements = QUEUE_SIZE;
+  Render.s3d_elements = Elements;
+  Render.ordered_elements = Ordered;
+  Render.sort_buffer = Buffer;
+  Render.sort_keys[0] = SortKeys[0];
+  Render.sort_keys[1] = SortKeys[1];
+  errors = 0;
+  for (first = 0;first < NbQueues;first = last) {
+    // Queues of the same name are sorted as a set
+    for (last = first + 1;last < NbQueues && strcmp(Queues[last].name, Queues[first].name) == 0;last++);
+    for (ascending = FALSE;ascending <= TRUE;ascending++) {
+      quick_time = 0;
+      radix_time = 0;
+      elements = 0;
+      for (queue = first;queue < last;queue++) {
+        quick_time += SortQueue(&(Queues[queue]), FALSE, ascending);
+        memcpy(Sorted, Ordered, sizeof(SAGE_SortedElement) * Queues[queue].size);
+        radix_time += SortQueue(&(Queues[queue]), TRUE, ascending);
+        if (!CheckOrder(Queues[queue].size, ascending)) {
+          printf("Queue %ld (%s) : the radix sort doesn't give the quick sort order\n", queue, Queues[queue].name);
+          errors++;
+        }
+        elements += Queues[queue].size;
+      }
+      printf("Queue %s (%s) : %ld queues of %ld elements\n", Queues[first].name, ascending ? "ascending" : "descending", last - first, elements / (last - first));
+      printf("  Quick sort : %.1f us per queue\n", (double)quick_time * 1000000.0 / CLOCKS_PER_SEC / (last - first));
+      printf("  Radix sort : %.1f us per queue\n", (double)radix_time * 1000000.0 / CLOCKS_PER_SEC / (last - first));
+    }
+  }
+  printf("%ld errors\n", errors);
+  for (queue = 0;queue < NbQueues;queue++) {
+    free(Queues[queue].depths);
+  }
+  return errors != 0;
+}
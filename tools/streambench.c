@@ -0,0 +1,399 @@
+/**
+ * streambench.c
+ * 
+ * SAGE (Simple Amiga Game Engine) project
+ * Host tool, benchmark the vertex streams against the transformed vertices
+ * 
+ * @author Fabrice Labrador <fabrice.labrador@gmail.com>
+ * @version 25.1 June 2025 (updated: 26/06/2025)
+ * 
+ * Build : cc -O2 -Ihost -I../include -o streambench streambench.c
+ *           ../src/sage_3dstream.c -lm
+ * Usage : streambench [frames]
+ * 
+ * The tool transforms the sphere of the engine3d_3dstream test (140 rings of
+ * 144 vertices) with the two entity pipelines of sage_3dengine.c : the array
+ * of SAGE_TransformedVertex (array of structures) and the kernels of
+ * sage_3dstream.c (structure of arrays). The sphere turns in front of the
+ * camera, the back faces are culled and the visible vertices go through the
+ * local to world, world to camera and projection steps. Both pipelines must
+ * give the same projected vertices and the times are compared. The array of
+ * structures steps are copies of the engine functions without the metrics
+ * and the debug logs, sage_3dengine.c needs the whole engine.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include <sage/sage_3dstream.h>
+
+// PI comes from the SAS/C math.h
+#ifndef PI
+#define PI                  3.14159265358979323846
+#endif
+
+#define SPHERE_RINGS        140
+#define SPHERE_SEGMENTS     144
+#define SPHERE_RADIUS       100.0
+#define SPHERE_DISTANCE     400.0
+
+#define NB_VERTICES         (SPHERE_RINGS * SPHERE_SEGMENTS)
+#define NB_FACES            ((SPHERE_RINGS - 1) * SPHERE_SEGMENTS)
+
+#define VIEW_DIST           320.0
+#define CENTER_X            320.0
+#define CENTER_Y            240.0
+
+#define BENCH_FRAMES        100
+#define MAX_ERROR           0.01
+
+/** Camera of the benchmark */
+typedef struct {
+  FLOAT posx, posy, posz;
+  FLOAT view_dist, centerx, centery;
+} Camera;
+
+SAGE_Vertex Vertices[NB_VERTICES];
+SAGE_Vector Normals[NB_FACES];
+SAGE_Face Faces[NB_FACES];
+SAGE_TransformedVertex Transformed[NB_VERTICES];
+SAGE_Matrix EntityMatrix, CameraMatrix;
+FLOAT EntityX = 0.0, EntityY = 0.0, EntityZ = 0.0;
+
+/**
+ * Build the sphere of the engine3d_3dstream test, the normals point out of
+ * the sphere
+ */
+void BuildSphere(void)
+{
+  long ring, segment, index;
+  double theta, phi;
+  SAGE_Vertex *p1, *p3;
+
+  for (ring = 0;ring < SPHERE_RINGS;ring++) {
+    theta = PI * (double)(ring + 1) / (double)(SPHERE_RINGS + 1);
+    for (segment = 0;segment < SPHERE_SEGMENTS;segment++) {
+      phi = 2.0 * PI * (double)segment / (double)SPHERE_SEGMENTS;
+      index = ring * SPHERE_SEGMENTS + segment;
+      Vertices[index].x = (FLOAT)(SPHERE_RADIUS * sin(theta) * cos(phi));
+      Vertices[index].y = (FLOAT)(SPHERE_RADIUS * cos(theta));
+      Vertices[index].z = (FLOAT)(SPHERE_RADIUS * sin(theta) * sin(phi));
+    }
+  }
+  index = 0;
+  for (ring = 0;ring < (SPHERE_RINGS - 1);ring++) {
+    for (segment = 0;segment < SPHERE_SEGMENTS;segment++) {
+      Faces[index].is_quad = TRUE;
+      Faces[index].p1 = ring * SPHERE_SEGMENTS + segment;
+      Faces[index].p2 = ring * SPHERE_SEGMENTS + ((segment + 1) % SPHERE_SEGMENTS);
+      Faces[index].p3 = (ring + 1) * SPHERE_SEGMENTS + ((segment + 1) % SPHERE_SEGMENTS);
+      Faces[index].p4 = (ring + 1) * SPHERE_SEGMENTS + segment;
+      p1 = &(Vertices[Faces[index].p1]);
+      p3 = &(Vertices[Faces[index].p3]);
+      Normals[index].x = (p1->x + p3->x) / 2.0;
+      Normals[index].y = (p1->y + p3->y) / 2.0;
+      Normals[index].z = (p1->z + p3->z) / 2.0;
+      index++;
+    }
+  }
+}
+
+/**
+ * Set the entity matrix, rotation around the Y then the X axis
+ */
+void SetEntityMatrix(double ax, double ay)
+{
+  FLOAT cx = cos(ax), sx = sin(ax), cy = cos(ay), sy = sin(ay);
+
+  EntityMatrix.m11 = cy;       EntityMatrix.m12 = 0.0;  EntityMatrix.m13 = -sy;
+  EntityMatrix.m21 = sx * sy;  EntityMatrix.m22 = cx;   EntityMatrix.m23 = sx * cy;
+  EntityMatrix.m31 = cx * sy;  EntityMatrix.m32 = -sx;  EntityMatrix.m33 = cx * cy;
+}
+
+/*****************************************************************************
+ *            ARRAY OF STRUCTURES (sage_3dengine.c)
+ *****************************************************************************/
+
+/**
+ * SAGE_ClearTransformedVertices
+ */
+void ClearTransformedVertices(SAGE_TransformedVertex *vertices, UWORD nb_vertices)
+{
+  UWORD index;
+
+  for (index = 0;index < nb_vertices;index++) {
+    vertices[index].calculated = FALSE;
+    vertices[index].visible = FALSE;
+  }
+}
+
+/**
+ * SAGE_EntityBackfaceCulling
+ */
+void EntityBackfaceCulling(Camera *camera, SAGE_TransformedVertex *vertices)
+{
+  UWORD index, point;
+  FLOAT res, x, y, z, tx, ty, tz;
+  SAGE_Vector sight, normal;
+
+  for (index = 0;index < NB_FACES;index++) {
+    x = Normals[index].x;
+    y = Normals[index].y;
+    z = Normals[index].z;
+    normal.x = x*EntityMatrix.m11 + y*EntityMatrix.m21 + z*EntityMatrix.m31;
+    normal.y = x*EntityMatrix.m12 + y*EntityMatrix.m22 + z*EntityMatrix.m32;
+    normal.z = x*EntityMatrix.m13 + y*EntityMatrix.m23 + z*EntityMatrix.m33;
+    point = Faces[index].p1;
+    if (!vertices[point].calculated) {
+      x = Vertices[point].x;
+      y = Vertices[point].y;
+      z = Vertices[point].z;
+      vertices[point].wx = x*EntityMatrix.m11 + y*EntityMatrix.m21 + z*EntityMatrix.m31 + EntityX;
+      vertices[point].wy = x*EntityMatrix.m12 + y*EntityMatrix.m22 + z*EntityMatrix.m32 + EntityY;
+      vertices[point].wz = x*EntityMatrix.m13 + y*EntityMatrix.m23 + z*EntityMatrix.m33 + EntityZ;
+      vertices[point].calculated = TRUE;
+    }
+    tx = vertices[point].wx;
+    ty = vertices[point].wy;
+    tz = vertices[point].wz;
+    sight.x = camera->posx - tx;
+    sight.y = camera->posy - ty;
+    sight.z = camera->posz - tz;
+    res = (normal.x*sight.x) + (normal.y*sight.y) + (normal.z*sight.z);
+    if (res > 0.0) {
+      Faces[index].culled = FALSE;
+      vertices[point].visible = TRUE;
+      vertices[Faces[index].p2].visible = TRUE;
+      vertices[Faces[index].p3].visible = TRUE;
+      if (Faces[index].is_quad) {
+        vertices[Faces[index].p4].visible = TRUE;
+      }
+    } else {
+      Faces[index].culled = TRUE;
+    }
+  }
+}
+
+/**
+ * SAGE_EntityLocalToWorld
+ */
+void EntityLocalToWorld(SAGE_TransformedVertex *vertices)
+{
+  UWORD index;
+  FLOAT x, y, z;
+
+  for (index = 0;index < NB_VERTICES;index++) {
+    if (vertices[index].visible && !vertices[index].calculated) {
+      x = Vertices[index].x;
+      y = Vertices[index].y;
+      z = Vertices[index].z;
+      vertices[index].wx = x*EntityMatrix.m11 + y*EntityMatrix.m21 + z*EntityMatrix.m31 + EntityX;
+      vertices[index].wy = x*EntityMatrix.m12 + y*EntityMatrix.m22 + z*EntityMatrix.m32 + EntityY;
+      vertices[index].wz = x*EntityMatrix.m13 + y*EntityMatrix.m23 + z*EntityMatrix.m33 + EntityZ;
+      vertices[index].calculated = TRUE;
+    }
+  }
+}
+
+/**
+ * SAGE_EntityWorldToCamera
+ */
+void EntityWorldToCamera(Camera *camera, SAGE_TransformedVertex *vertices)
+{
+  UWORD index;
+  FLOAT x, y, z;
+
+  for (index = 0;index < NB_VERTICES;index++) {
+    if (vertices[index].visible) {
+      x = vertices[index].wx - camera->posx;
+      y = vertices[index].wy - camera->posy;
+      z = vertices[index].wz - camera->posz;
+      vertices[index].cx = x*CameraMatrix.m11 + y*CameraMatrix.m21 + z*CameraMatrix.m31;
+      vertices[index].cy = x*CameraMatrix.m12 + y*CameraMatrix.m22 + z*CameraMatrix.m32;
+      vertices[index].cz = x*CameraMatrix.m13 + y*CameraMatrix.m23 + z*CameraMatrix.m33;
+    }
+  }
+}
+
+/**
+ * SAGE_VerticesProjection
+ */
+unsigned long VerticesProjection(SAGE_TransformedVertex *vertices, UWORD nb_vertices, Camera *camera)
+{
+  unsigned long count = 0;
+  UWORD index;
+
+  for (index = 0;index < nb_vertices;index++) {
+    if (vertices[index].visible) {
+      if (vertices[index].cz > 0.0) {
+        vertices[index].px = (vertices[index].cx * camera->view_dist / vertices[index].cz) + camera->centerx;
+        vertices[index].py = (-vertices[index].cy * camera->view_dist / vertices[index].cz) + camera->centery;
+        vertices[index].pz = vertices[index].cz;
+        vertices[index].iz = (FLOAT)1.0 / vertices[index].cz;
+      } else {
+        vertices[index].px = 0.0;
+        vertices[index].py = 0.0;
+        vertices[index].pz = 0.0;
+        vertices[index].iz = 0.0;
+      }
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Array of structures pipeline, return the number of visible vertices
+ */
+unsigned long TransformVertices(Camera *camera)
+{
+  ClearTransformedVertices(Transformed, NB_VERTICES);
+  EntityBackfaceCulling(camera, Transformed);
+  EntityLocalToWorld(Transformed);
+  EntityWorldToCamera(camera, Transformed);
+  return VerticesProjection(Transformed, NB_VERTICES, camera);
+}
+
+/*****************************************************************************
+ *            STRUCTURE OF ARRAYS (sage_3dstream.c)
+ *****************************************************************************/
+
+/**
+ * SAGE_EntityStreamBackfaceCulling
+ */
+void EntityStreamBackfaceCulling(Camera *camera, SAGE_VertexStreams *streams)
+{
+  UWORD index, point;
+  FLOAT res, x, y, z;
+  SAGE_Vector sight, normal;
+
+  for (index = 0;index < NB_FACES;index++) {
+    x = Normals[index].x;
+    y = Normals[index].y;
+    z = Normals[index].z;
+    normal.x = x*EntityMatrix.m11 + y*EntityMatrix.m21 + z*EntityMatrix.m31;
+    normal.y = x*EntityMatrix.m12 + y*EntityMatrix.m22 + z*EntityMatrix.m32;
+    normal.z = x*EntityMatrix.m13 + y*EntityMatrix.m23 + z*EntityMatrix.m33;
+    point = Faces[index].p1;
+    sight.x = camera->posx - streams->x[point];
+    sight.y = camera->posy - streams->y[point];
+    sight.z = camera->posz - streams->z[point];
+    res = (normal.x*sight.x) + (normal.y*sight.y) + (normal.z*sight.z);
+    if (res > 0.0) {
+      Faces[index].culled = FALSE;
+      S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      point = Faces[index].p2;
+      S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      point = Faces[index].p3;
+      S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      if (Faces[index].is_quad) {
+        point = Faces[index].p4;
+        S3DE_STREAM_SETVISIBLE(streams->visible, point);
+      }
+    } else {
+      Faces[index].culled = TRUE;
+    }
+  }
+}
+
+/**
+ * Structure of arrays pipeline (SAGE_TransformStreamEntity), return the
+ * number of visible vertices
+ */
+unsigned long TransformStreams(Camera *camera, SAGE_VertexStreams *streams)
+{
+  SAGE_ClearStreamVisibility(streams, NB_VERTICES);
+  SAGE_StreamLocalToWorld(streams, Vertices, NB_VERTICES, &EntityMatrix, EntityX, EntityY, EntityZ);
+  EntityStreamBackfaceCulling(camera, streams);
+  SAGE_StreamWorldToCamera(streams, NB_VERTICES, &CameraMatrix, camera->posx, camera->posy, camera->posz);
+  return SAGE_StreamProjection(streams, NB_VERTICES, camera->view_dist, camera->centerx, camera->centery);
+}
+
+/**
+ * Count the visible vertices which are not projected at the same place by
+ * the two pipelines
+ */
+long CompareVertices(SAGE_VertexStreams *streams)
+{
+  long index, errors = 0;
+
+  for (index = 0;index < NB_VERTICES;index++) {
+    if ((Transformed[index].visible != 0) != (S3DE_STREAM_ISVISIBLE(streams->visible, index) != 0)) {
+      errors++;
+    } else if (Transformed[index].visible
+        && (fabs(Transformed[index].px - streams->px[index]) > MAX_ERROR
+        || fabs(Transformed[index].py - streams->py[index]) > MAX_ERROR
+        || fabs(Transformed[index].iz - streams->iz[index]) > MAX_ERROR)) {
+      errors++;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  SAGE_VertexStreams streams;
+  Camera camera;
+  long frames, frame, errors;
+  unsigned long aos_count, soa_count, visible;
+  clock_t start, aos_time, soa_time;
+
+  frames = argc > 1 ? atol(argv[1]) : BENCH_FRAMES;
+  if (frames < 1) {
+    fprintf(stderr, "Usage : streambench [frames]\n");
+    return 1;
+  }
+  streams.x = calloc(NB_VERTICES, sizeof(FLOAT));
+  streams.y = calloc(NB_VERTICES, sizeof(FLOAT));
+  streams.z = calloc(NB_VERTICES, sizeof(FLOAT));
+  streams.px = calloc(NB_VERTICES, sizeof(FLOAT));
+  streams.py = calloc(NB_VERTICES, sizeof(FLOAT));
+  streams.iz = calloc(NB_VERTICES, sizeof(FLOAT));
+  streams.visible = calloc(S3DE_STREAM_WORDS(NB_VERTICES), sizeof(ULONG));
+  if (streams.x == NULL || streams.y == NULL || streams.z == NULL || streams.px == NULL
+      || streams.py == NULL || streams.iz == NULL || streams.visible == NULL) {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+  BuildSphere();
+  CameraMatrix.m11 = 1.0; CameraMatrix.m12 = 0.0; CameraMatrix.m13 = 0.0;
+  CameraMatrix.m21 = 0.0; CameraMatrix.m22 = 1.0; CameraMatrix.m23 = 0.0;
+  CameraMatrix.m31 = 0.0; CameraMatrix.m32 = 0.0; CameraMatrix.m33 = 1.0;
+  camera.posx = 0.0;
+  camera.posy = 0.0;
+  camera.posz = -SPHERE_DISTANCE;
+  camera.view_dist = VIEW_DIST;
+  camera.centerx = CENTER_X;
+  camera.centery = CENTER_Y;
+  errors = 0;
+  visible = 0;
+  aos_time = 0;
+  soa_time = 0;
+  for (frame = 0;frame < frames;frame++) {
+    SetEntityMatrix(DEGTORAD(frame % 360), DEGTORAD((frame * 3) % 360));
+    start = clock();
+    aos_count = TransformVertices(&camera);
+    aos_time += clock() - start;
+    start = clock();
+    soa_count = TransformStreams(&camera, &streams);
+    soa_time += clock() - start;
+    visible += soa_count;
+    if (aos_count != soa_count || CompareVertices(&streams) != 0) {
+      printf("Frame %ld : %lu vertices for the structures, %lu vertices for the streams, %ld different vertices\n", frame, aos_count, soa_count, CompareVertices(&streams));
+      errors++;
+    }
+  }
+  printf("%d vertices, %ld frames, %lu visible vertices by frame, %ld errors\n", NB_VERTICES, frames, visible / frames, errors);
+  printf("  Array of structures : %.1f us per frame\n", (double)aos_time * 1000000.0 / CLOCKS_PER_SEC / frames);
+  printf("  Structure of arrays : %.1f us per frame\n", (double)soa_time * 1000000.0 / CLOCKS_PER_SEC / frames);
+  free(streams.visible);
+  free(streams.iz);
+  free(streams.py);
+  free(streams.px);
+  free(streams.z);
+  free(streams.y);
+  free(streams.x);
+  return errors != 0;
+}